@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file sliding_covariance.hpp
+ * @brief Скользящее окно снимков: Cholesky множитель ковариации без переразложения
+ *
+ * Окно сдвигается на k снимков: новые добавляются к L повышающими rank-1
+ * обновлениями (вращения Гивенса), вышедшие из окна — понижающими
+ * (гиперболические вращения), O(k·n²) вместо O(n³) на переразложение:
+ *
+ *   A = Σ_окно x x^H + K·δ·I = L L^H,   R = A / K
+ *
+ * MVDR веса от масштаба R не зависят, поэтому хранится L для A. Погрешность
+ * накапливается от сдвига к сдвигу; её ограничивает полное переразложение
+ * (HermitianCPUInverter::Factor) каждые refactor_interval вызовов Push по точной
+ * сумме Σ x x^H, которая ведётся в double. Если понижение теряет положительную
+ * определённость (округление), Push тоже переразлагает.
+ *
+ * Столбцы L хранятся подряд (планарно re / im): каждое вращение — проход по
+ * хвосту одного столбца, который векторизуется компилятором.
+ *
+ * @code
+ * cpu_linalg::SlidingCovariance window(channels, 4 * channels, 1e-2f);
+ * for (;;) {
+ *     window.Push(block, 8);                          // channels × 8, строка на канал
+ *     auto w = window.MVDRWeights(steering, num_beams);
+ * }
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "CPU/hermitian_cpu_inverter.hpp"
+#include <complex>
+#include <vector>
+
+namespace cpu_linalg {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: SlidingCovarianceStats - последний Push
+// ════════════════════════════════════════════════════════════════════════════
+
+struct SlidingCovarianceStats {
+    size_t added = 0;               ///< Новых снимков
+    size_t removed = 0;             ///< Вышедших из окна
+    bool refactored = false;        ///< Полное переразложение вместо обновлений
+    double sum_ms = 0.0;            ///< Точная сумма Σ x x^H (double)
+    double update_ms = 0.0;         ///< Повышающие и понижающие вращения
+    double refactor_ms = 0.0;       ///< Переразложение (если было)
+    double total_ms = 0.0;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: SlidingCovariance
+// ════════════════════════════════════════════════════════════════════════════
+
+class SlidingCovariance {
+public:
+    /**
+     * @param channels Каналов n
+     * @param window Снимков K в окне
+     * @param diagonal_loading δ в R = (1/K)·Σ x x^H + δI (> 0: окно может быть неполным)
+     * @param refactor_interval Полное переразложение каждые N вызовов Push (0 = только при сбое понижения)
+     * @param num_threads Потоков для переразложения (0 = hardware_concurrency)
+     * @throws std::invalid_argument если channels или window == 0, δ <= 0
+     */
+    SlidingCovariance(size_t channels, size_t window, float diagonal_loading,
+                      size_t refactor_interval = 64, size_t num_threads = 0);
+
+    /**
+     * @brief Добавить count снимков, вытеснив самые старые сверх окна
+     * @param snapshots channels × count (строка на канал, как X в CovarianceEstimator)
+     */
+    void Push(const std::complex<float>* snapshots, size_t count);
+    void Push(const std::vector<std::complex<float>>& snapshots, size_t count);
+
+    /// Переразложение по точной сумме окна
+    void Refactor();
+
+    /**
+     * @brief w = R^{-1}s / (s^H R^{-1} s) по текущему L (две подстановки)
+     * @param steering num_vectors × n; результат того же размера
+     */
+    std::vector<std::complex<float>> MVDRWeights(const std::vector<std::complex<float>>& steering,
+                                                 size_t num_vectors) const;
+
+    /// R = L L^H / K (n × n, для проверки дрейфа)
+    std::vector<std::complex<float>> GetCovariance() const;
+    /// R по точной сумме окна (то, что получило бы переразложение)
+    std::vector<std::complex<float>> GetExactCovariance() const;
+
+    size_t GetChannels() const { return n_; }
+    size_t GetWindow() const { return window_; }
+    size_t GetFilled() const { return filled_; }
+    const SlidingCovarianceStats& GetLastStats() const { return last_stats_; }
+
+private:
+    /// Столбцы L ← rank-1 вращения для count векторов (планарно, count × n, портятся);
+    /// sign = +1 повышение, -1 понижение. false — потеря положительной определённости
+    bool Rotate(std::vector<float>& xr, std::vector<float>& xi, size_t count, float sign);
+    void PushChunk(const std::complex<float>* snapshots, size_t stride, size_t count);
+    /// Σ x x^H (нижний треугольник) += sign · x x^H
+    void Accumulate(const std::vector<float>& xr, const std::vector<float>& xi, size_t count, double sign);
+
+    size_t n_ = 0;
+    size_t window_ = 0;
+    float loading_ = 0.0f;          ///< K·δ на диагонали A
+    size_t refactor_interval_ = 0;
+    size_t pushes_since_refactor_ = 0;
+
+    std::vector<float> l_re_, l_im_;                ///< L по столбцам: столбец k — [k·n, k·n + n), элементы i >= k
+    std::vector<double> sum_re_, sum_im_;           ///< Σ_окно x x^H, нижний треугольник n × n
+    std::vector<std::complex<float>> ring_;         ///< Снимки окна (window × n), кольцо
+    size_t head_ = 0;                               ///< Самый старый снимок
+    size_t filled_ = 0;
+
+    HermitianCPUInverter inverter_;
+    SlidingCovarianceStats last_stats_;
+};
+
+} // namespace cpu_linalg
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file thread_pool.hpp
+ * @brief Пул потоков хоста для параллельных циклов CPU модулей
+ *
+ * Один ParallelFor за раз: индексы 0..count-1 раздаются динамически (атомарный
+ * счётчик), вызывающий поток работает как worker 0. Номер worker'а передаётся
+ * в тело цикла, чтобы у каждого потока было своё рабочее пространство.
+ *
+ * @code
+ * cpu_linalg::ThreadPool pool;            // hardware_concurrency потоков
+ * pool.ParallelFor(batch, [&](size_t i, size_t worker) {
+ *     Solve(matrices[i], workspaces[worker]);
+ * });
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpu_linalg {
+
+class ThreadPool {
+public:
+    using Body = std::function<void(size_t index, size_t worker)>;
+
+    /// @param num_threads Всего потоков вместе с вызывающим (0 = hardware_concurrency)
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Потоков вместе с вызывающим
+    size_t Size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief body(i, worker) для i = 0..count-1, возврат после завершения всех
+     * @throws Первое исключение, выброшенное body (остальные индексы не запускаются)
+     */
+    void ParallelFor(size_t count, const Body& body);
+
+private:
+    void WorkerLoop(size_t worker);
+    void RunIndices(size_t worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+    const Body* body_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    size_t generation_ = 0;
+    size_t active_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace cpu_linalg
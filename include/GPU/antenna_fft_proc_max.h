@@ -1,10 +1,17 @@
 #pragma once
 
 #include "interface/antenna_fft_params.h"
+#include "interface/lfm_parameters.h"
+#include "GPU/cfar_detector.hpp"
+#include "GPU/beamformer.hpp"
 #include "ManagerOpenCL/opencl_compute_engine.hpp"
 #include "ManagerOpenCL/opencl_core.hpp"
 #include "ManagerOpenCL/command_queue_pool.hpp"
 #include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/i_memory_buffer.hpp"
+#include "ManagerOpenCL/svm_capabilities.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "ManagerOpenCL/work_group_tuner.hpp"
 #include <CL/cl.h>
 #include <clFFT.h>
 #include <memory>
@@ -49,6 +56,15 @@ namespace antenna_fft {
  * processor.PrintResults(result);
  * processor.SaveResultsToFile(result, "Reports/result.md");
  * ```
+ *
+ * НЕСКОЛЬКО УСТРОЙСТВ:
+ * Конструктор с ManagerOpenCL::DeviceContext работает на контексте/очереди
+ * переданного устройства, минуя синглтоны (см. MultiDeviceAntennaFFT).
+ *
+ * СЖАТИЕ ИМПУЛЬСА:
+ * SetPulseCompressionReference(lfm) + ProcessPulseCompression(input) —
+ * согласованный фильтр: FFT лучей × conj(спектр опоры) в post-callback, IFFT,
+ * поиск top-N по отсчётам дальности тем же post_kernel.
  */
 class AntennaFFTProcMax {
 public:
@@ -76,6 +92,14 @@ public:
      */
     explicit AntennaFFTProcMax(const AntennaFFTParams& params);
     
+    /**
+     * @brief Конструктор на заданном устройстве (без OpenCLComputeEngine)
+     * @param params Параметры обработки
+     * @param device Контекст/устройство/очередь (владелец — DeviceGroup, должен пережить процессор)
+     * @throws std::invalid_argument если device невалиден
+     */
+    AntennaFFTProcMax(const AntennaFFTParams& params, const ManagerOpenCL::DeviceContext& device);
+    
     /**
      * @brief Деструктор
      * Освобождает clFFT план и буферы
@@ -103,6 +127,29 @@ public:
      */
     AntennaFFTResult Process(const std::vector<std::complex<float>>& input_data);
     
+    /**
+     * @brief Обработка FFT из IMemoryBuffer (RegularBuffer / SVMBuffer / HybridBuffer)
+     * 
+     * SVM буфер читается ядром напрямую через clSetKernelArgSVMPointer,
+     * без копирования в промежуточный буфер. Обычный буфер идёт через Process(cl_mem).
+     * 
+     * @param input Буфер с beam_count * count_points комплексными элементами
+     * @return AntennaFFTResult с результатами для всех лучей
+     */
+    AntennaFFTResult Process(ManagerOpenCL::IMemoryBuffer* input);
+    
+    /**
+     * @brief Обработка FFT из SVM указателя (zero-copy)
+     * 
+     * Указатель должен быть получен через clSVMAlloc в контексте engine'а,
+     * либо быть любым указателем хоста при поддержке SVM_FINE_SYSTEM.
+     * Если устройство не поддерживает SVM, данные копируются в обычный буфер.
+     * 
+     * @param svm_input Указатель на beam_count * count_points комплексных элементов
+     * @return AntennaFFTResult с результатами для всех лучей
+     */
+    AntennaFFTResult ProcessSVM(const void* svm_input);
+    
     /**
      * @brief Новый метод обработки FFT с автоматическим выбором стратегии
      * 
@@ -126,6 +173,237 @@ public:
      */
     AntennaFFTResult ProcessWithBatchingNew(cl_mem input_signal);
     
+    /**
+     * @brief In-place FFT для ProcessNew() и batch режимов (CLFFT_INPLACE)
+     * 
+     * Буфер после padding преобразуется на месте, post_kernel читает его же:
+     * отдельный FFT output не выделяется, память FFT на луч — nFFT × 8 байт
+     * вместо × 16. EstimateRequiredMemory() и расчёт потоков
+     * ProcessWithBatchingNew() учитывают уменьшенный объём, поэтому в память
+     * помещается больше лучей на батч и больше параллельных потоков.
+     * Без callback'ов: окно fftshift для ExtractSparseSpectrum() не заполняется.
+     * index_point максимумов — бин FFT [0, out_count_points_fft), как у
+     * Process(cl_mem) (ZoomIndexMode::FFT_BIN).
+     * 
+     * Смена режима освобождает batch буферы и планы (создаются заново);
+     * включение освобождает и FFT output одиночного режима — Process()
+     * создаст его снова при необходимости.
+     */
+    void SetInPlaceFFT(bool enable);
+    bool IsInPlaceFFT() const { return batch_config_.inplace_fft; }
+    
+    /**
+     * @brief Раскладка входного кадра (порядок АЦП, шаги, смещение, int16 IQ)
+     * 
+     * Учитывается всеми путями, читающими вход cl_mem через padding: Process(),
+     * ProcessNew(), batch режимы, ProcessInPlace, ProcessCFAR, ProcessSparse,
+     * ProcessPulseCompression. Для нестандартной раскладки padding выполняет
+     * ядро layout_convert (общее с IQFrameSource): тайлы 16×16 через local memory (чтение по лучам
+     * подряд, запись по отсчётам подряд) + преобразование int16 → float.
+     * Process() с pre-callback (чтение beam-major) в этом режиме идёт через
+     * padding + FFT без callback'ов.
+     * 
+     * Данные хоста std::vector<complex<float>> — всегда beam-major: при
+     * нестандартной раскладке используйте ProcessRawFrame().
+     * RefinePeaks() читает вход напрямую и ожидает beam-major float2
+     * (при другой раскладке — std::invalid_argument).
+     */
+    void SetInputLayout(const InputLayoutDesc& layout);
+    const InputLayoutDesc& GetInputLayout() const { return input_layout_; }
+    
+    /**
+     * @brief Сырой кадр с хоста в раскладке SetInputLayout() → загрузка как есть → Process()
+     * @param bytes Не меньше GetFrameSamples() × GetSampleBytes()
+     */
+    AntennaFFTResult ProcessRawFrame(const void* frame, size_t bytes);
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Сжатие импульса (согласованный фильтр ЛЧМ)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    /**
+     * @brief Задать опорный ЛЧМ для сжатия импульса
+     * 
+     * Опорный сигнал строится по той же формуле, что kernel_lfm_basic в GeneratorGPU
+     * (lfm.count_points отсчётов, не больше count_points). Его спектр считается один раз
+     * на устройстве, сопрягается и кэшируется до смены опоры или UpdateParams().
+     * 
+     * @throws std::invalid_argument если lfm невалиден
+     */
+    void SetPulseCompressionReference(const LFMParameters& lfm);
+    
+    /**
+     * @brief Задать произвольный опорный сигнал (длина 1..count_points)
+     */
+    void SetPulseCompressionReference(const std::vector<std::complex<float>>& reference);
+    
+    bool HasPulseCompressionReference() const { return !pc_reference_.empty(); }
+    
+    /**
+     * @brief Сжатие импульса всех лучей: FFT → × conj(спектр опоры) → IFFT → top-N
+     * 
+     * Умножение выполняется в post-callback прямого clFFT плана, всё на устройстве.
+     * Поиск максимумов идёт по первым out_count_points_fft отсчётам дальности:
+     * index_point — задержка в отсчётах, freq_offset — её дробная часть
+     * (параболическая интерполяция), refined_frequency не используется.
+     * 
+     * @param input_signal beam_count * count_points комплексных отсчётов
+     * @throws std::runtime_error если опора не задана или обработка не удалась
+     */
+    AntennaFFTResult ProcessPulseCompression(cl_mem input_signal);
+    
+    /**
+     * @brief Сжатие импульса для данных хоста
+     */
+    AntennaFFTResult ProcessPulseCompression(const std::vector<std::complex<float>>& input_data);
+    
+    /**
+     * @brief CFAR обнаружение вместо фиксированного top-N
+     * 
+     * padding → FFT → |X|² первых out_count_points_fft бинов → CFARDetector.
+     * Число обнаружений на луч переменное (порог по шуму соседних бинов),
+     * CFARDetection::index — номер бина FFT, как index_point у post_kernel.
+     * 
+     * @param input_signal beam_count * count_points комплексных отсчётов
+     * @throws std::invalid_argument если cfar невалиден
+     */
+    CFARResult ProcessCFAR(cl_mem input_signal, const CFARParams& cfar);
+    
+    /**
+     * @brief CFAR обнаружение для данных хоста
+     */
+    CFARResult ProcessCFAR(const std::vector<std::complex<float>>& input_data, const CFARParams& cfar);
+    
+    /**
+     * @brief Формирование лучей + FFT: элементы решётки → Beamformer → top-N
+     * 
+     * GEMM пишет лучи сразу в буфер FFT с шагом nFFT и нулевым хвостом
+     * (вместо padding_kernel), далее in-place FFT и post_kernel как в Process().
+     * pre_callback_time_ms — время формирования лучей. SetInputLayout() здесь
+     * не действует: раскладку element_data задаёт Beamformer.
+     * 
+     * @param element_data num_elements * count_points отсчётов (строка на канал)
+     * @param beamformer Формирователь на том же контексте, с заданными весами;
+     *        GetNumBeams() == beam_count, GetNumSamples() == count_points
+     */
+    AntennaFFTResult ProcessBeamformed(cl_mem element_data, Beamformer& beamformer);
+    
+    /**
+     * @brief top-N по уже готовому спектру (например, блок StreamingFFTProcessor)
+     * 
+     * Тот же post_kernel, что и в Process(): первые out_count_points_fft бинов
+     * каждого луча, ширина бина = sample_rate / spectrum_stride.
+     * Буфер должен принадлежать контексту процессора.
+     * 
+     * @param spectrum beam_count строк по spectrum_stride комплексных отсчётов
+     * @throws std::invalid_argument если spectrum_stride < out_count_points_fft
+     */
+    AntennaFFTResult FindMaximaInSpectrum(cl_mem spectrum, size_t spectrum_stride);
+    
+    /**
+     * @brief Уточнить частоту/фазу грубых максимумов (zoom-DTFT на устройстве)
+     * 
+     * Для каждого максимума луча вычисляется DTFT входного сигнала на сетке
+     * 2·span_bins·zoom_factor + 1 точек вокруг бина (банк Гёрцеля: фаза по
+     * целочисленному индексу, точна для любой длины луча). Стоимость
+     * пропорциональна числу максимумов × точек × count_points, а не nFFT·zoom.
+     * Максимум сетки уточняется параболой.
+     * 
+     * @param input_signal Тот же вход, по которому получен coarse
+     * @param coarse Результат Process()/ProcessNew() (индексы по zoom.index_mode)
+     * @throws std::invalid_argument если SetInputLayout() задал не beam-major float2
+     */
+    ZoomFFTResult RefinePeaks(cl_mem input_signal, const AntennaFFTResult& coarse, const ZoomFFTParams& zoom);
+    
+    /**
+     * @brief Уточнение для данных хоста
+     */
+    ZoomFFTResult RefinePeaks(const std::vector<std::complex<float>>& input_data,
+                              const AntennaFFTResult& coarse, const ZoomFFTParams& zoom);
+    
+    /**
+     * @brief Разреженный спектр: только бины выше порога (уплотнение на устройстве)
+     * 
+     * Предикат |X| > порог луча → префиксная сумма в work-group → один atomic_add
+     * на группу → запись (beam, bin, re, im, |X|) в плотный буфер. На хост
+     * читаются счётчик и занятые записи: объём передачи ~ числу бинов выше
+     * порога, а не beam_count × out_count_points_fft.
+     * 
+     * @param spectrum beam_count строк комплексного спектра
+     * @param spectrum_stride Шаг строки (элементов); окно = первые min(out_count_points_fft, stride) бинов
+     * @param wait_event Событие, после которого спектр готов (или nullptr)
+     * @throws std::invalid_argument если sparse невалиден
+     */
+    SparseSpectrumResult ExtractSparseSpectrum(cl_mem spectrum, size_t spectrum_stride,
+                                               const SparseSpectrumParams& sparse,
+                                               cl_event wait_event = nullptr);
+    
+    /**
+     * @brief Разреженный вывод окна последнего ProcessNew() (после fftshift, как в SaveResultsToFile)
+     * @throws std::runtime_error если ProcessNew() ещё не вызывался
+     */
+    SparseSpectrumResult ExtractSparseSpectrum(const SparseSpectrumParams& sparse);
+    
+    /**
+     * @brief padding → FFT → разреженный спектр (бины FFT, как index_point у post_kernel)
+     */
+    SparseSpectrumResult ProcessSparse(cl_mem input_signal, const SparseSpectrumParams& sparse);
+    
+    /**
+     * @brief Разреженный спектр для данных хоста
+     */
+    SparseSpectrumResult ProcessSparse(const std::vector<std::complex<float>>& input_data,
+                                       const SparseSpectrumParams& sparse);
+    
+    /**
+     * @brief top-N для вещественного входа (R2C FFT)
+     * 
+     * Вход — float, beam_count × count_points (вдвое меньше памяти, чем float2).
+     * padding (float) → clFFT CLFFT_REAL → CLFFT_HERMITIAN_INTERLEAVED
+     * (nFFT/2 + 1 бинов на луч, примерно половина работы комплексного FFT) →
+     * окно out_count_points_fft бинов восстанавливается из половины спектра
+     * (X[nFFT - k] = conj(X[k])) → тот же post_kernel, что в Process().
+     * 
+     * @param input_signal beam_count * count_points вещественных отсчётов
+     * @param fftshift_window false: index_point = бин FFT [0, out_count_points_fft), как Process();
+     *                        true: окно после fftshift (нулевая частота в out_count_points_fft/2), как ProcessNew()
+     */
+    AntennaFFTResult ProcessReal(cl_mem input_signal, bool fftshift_window = false);
+    
+    /**
+     * @brief R2C обработка для вещественных данных хоста
+     */
+    AntennaFFTResult ProcessReal(const std::vector<float>& input_data, bool fftshift_window = false);
+    
+    /**
+     * @brief Некогерентное накопление по кадрам (слабые цели)
+     * 
+     * Каждый кадр: padding → FFT → integrate_frame добавляет |X| (или |X|²)
+     * первых out_count_points_fft бинов в накопитель на устройстве. Раз в
+     * frames кадров тот же kernel пишет окно с накопленной амплитудой и фазой
+     * текущего кадра, по нему работает post_kernel, и top-N читается на хост.
+     * Остальные кадры ничего не читают: обмен с хостом в frames раз меньше.
+     * 
+     * Смена параметров сбрасывает накопитель.
+     * @throws std::invalid_argument если integration невалиден
+     */
+    void SetIntegration(const IntegrationParams& integration);
+    const IntegrationParams& GetIntegration() const { return integration_params_; }
+    
+    /// Обнулить накопитель (начало новой последовательности кадров)
+    void ResetIntegration();
+    
+    /**
+     * @brief Добавить кадр; result.ready раз в frames кадров
+     * @param input_signal beam_count * count_points (раскладка SetInputLayout)
+     */
+    IntegrationResult ProcessIntegrated(cl_mem input_signal);
+    
+    /**
+     * @brief Накопление для данных хоста
+     */
+    IntegrationResult ProcessIntegrated(const std::vector<std::complex<float>>& input_data);
+    
     /**
      * @brief Вывести результаты в консоль (таблица)
      * @param result Результаты обработки
@@ -187,11 +465,68 @@ private:
      */
     size_t NextPowerOf2(size_t n) const;
     
+    /**
+     * @brief Создать clFFT план nFFT × batch_size (interleaved), без bake
+     */
+    clfftPlanHandle CreateBatchedPlan(size_t batch_size, bool in_place = false) const;
+    
+    /**
+     * @brief Создать и bake inplace_plan_handle_ при первом вызове (ProcessInPlace, ProcessBeamformed)
+     */
+    void EnsureInPlacePlan();
+    
+    /**
+     * @brief padding → in-place FFT → post_kernel (ProcessNew при inplace_fft)
+     */
+    AntennaFFTResult ProcessInPlace(cl_mem input_signal);
+    
     /**
      * @brief Создать или переиспользовать clFFT план
      */
     void CreateOrReuseFFTPlan();
     
+    /**
+     * @brief Спектр опоры + планы сжатия импульса (прямой с умножением, обратный)
+     */
+    void CreatePulseCompressionResources();
+    
+    /**
+     * @brief Освободить планы и userdata сжатия импульса (опора сохраняется)
+     */
+    void ReleasePulseCompressionResources();
+    
+    /**
+     * @brief Создать zoom_kernel_ (DTFT по сетке вокруг максимумов)
+     */
+    void CreateZoomKernel();
+    
+    /**
+     * @brief Создать sparse_kernel_ (порог + уплотнение спектра)
+     */
+    void CreateSparseKernel();
+    
+    /**
+     * @brief R2C план + real_padding_kernel_ / hermitian_window_kernel_
+     */
+    void CreateRealInputResources();
+    
+    /**
+     * @brief Создать integration_kernel_ (накопление |X| + окно для post_kernel)
+     */
+    void CreateIntegrationKernel();
+    
+    /**
+     * @brief Уплотнение спектра, начинающегося со spectrum_offset элементов float2
+     */
+    SparseSpectrumResult ExtractSparseSpectrum(cl_mem spectrum, size_t spectrum_stride,
+                                               const SparseSpectrumParams& sparse,
+                                               cl_event wait_event, size_t spectrum_offset);
+    
+    /**
+     * @brief Post-callback прямого FFT: умножение на сопряжённый спектр опоры
+     */
+    std::string GetPulseCompressionCallbackSource() const;
+    
     /**
      * @brief Освободить clFFT план
      */
@@ -226,11 +561,87 @@ private:
      */
     void CreateFFTPlanWithPreCallbackOnly();
     
+    /**
+     * @brief Создать clFFT план без callback'ов для SVM входа (direct_plan_handle_)
+     */
+    void CreateDirectInputPlan();
+    
+    /**
+     * @brief Общая часть конструкторов (device == nullptr → синглтоны)
+     */
+    AntennaFFTProcMax(const AntennaFFTParams& params, const ManagerOpenCL::DeviceContext* device);
+    
+    /**
+     * @brief Создать буфер в контексте процессора (context_ / queue_)
+     */
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(
+        size_t num_elements, ManagerOpenCL::MemoryType type);
+    
+    /**
+     * @brief Очередь для батча: пул engine'а или собственная очередь устройства
+     */
+    cl_command_queue AcquireQueue();
+    
+    /**
+     * @brief Создать буфер максимумов (beam_count * max_peaks_count MaxValue) если его нет
+     */
+    void EnsureMaximaBuffer();
+    
+    /**
+     * @brief Поставить в очередь post-kernel (magnitude + max + phase) над fft_output
+     * @param spectrum_stride Шаг строк спектра в отсчётах (0 = nFFT_)
+     * @return Код ошибки OpenCL
+     */
+    cl_int EnqueuePostKernel(cl_mem fft_output, cl_event wait_event, cl_event* out_event,
+                             size_t spectrum_stride = 0);
+    
+    /**
+     * @brief Прочитать buffer_maxima_ и преобразовать в AntennaFFTResult
+     */
+    AntennaFFTResult ReadMaximaResult();
+    
     /**
      * @brief Создать kernel для padding данных
      */
     void CreatePaddingKernel();
     
+    /**
+     * @brief Поставить в очередь padding_kernel_ (аргументы уже выставлены)
+     *
+     * При первом вызове без записи в базе WorkGroupTuner подбирает local size
+     * и отсчётов на work-item (grid-stride цикл ядра). Прогоны подбора пишут
+     * тот же выход, поэтому только перед ними список ожидания ждётся на хосте;
+     * основной запуск получает его в clEnqueueNDRangeKernel.
+     */
+    cl_int EnqueuePaddingKernel(cl_command_queue queue, size_t total_work, cl_event* out_event,
+                                cl_uint num_wait_events = 0, const cl_event* wait_list = nullptr);
+    
+    /**
+     * @brief padding лучей [beam_offset, beam_offset + num_beams) входа в output (num_beams × nFFT)
+     * 
+     * Стандартная раскладка — padding_kernel_, иначе layout_padding_kernel_
+     * по input_layout_. Список ожидания передаётся в очередь (без ожидания на хосте).
+     */
+    cl_int EnqueueInputPadding(cl_command_queue queue, cl_mem input, cl_mem output,
+                               size_t num_beams, size_t beam_offset,
+                               cl_uint num_wait_events, const cl_event* wait_list, cl_event* out_event);
+    
+    /**
+     * @brief Создать layout_padding_kernel_ (тайловое транспонирование, формат из input_layout_)
+     */
+    void CreateLayoutPaddingKernel();
+    
+    /**
+     * @brief Данные хоста std::vector<complex<float>> — только для стандартной раскладки
+     * @throws std::invalid_argument если задана другая раскладка
+     */
+    void RequireDefaultLayout(const char* where) const;
+    
+    /**
+     * @brief Local size для findMaximaAndPhase (аргументы уже выставлены)
+     */
+    size_t GetReductionLocalSize(cl_command_queue queue);
+    
     /**
      * @brief Создать kernel для post-processing (magnitude + select)
      */
@@ -397,10 +808,17 @@ private:
     cl_context context_;                   // OpenCL контекст
     cl_command_queue queue_;               // Command queue
     cl_device_id device_;                 // OpenCL устройство
+    ManagerOpenCL::SVMCapabilities svm_caps_;  // SVM возможности device_
     
     // clFFT ресурсы
     clfftPlanHandle plan_handle_;         // Handle плана FFT
     bool plan_created_;                    // Флаг создания плана
+    clfftPlanHandle direct_plan_handle_;  // План без callback'ов (SVM вход через padding_kernel)
+    clfftPlanHandle inplace_plan_handle_ = 0;  // Как direct, но CLFFT_INPLACE (buffer_fft_input_)
+    
+    // Раскладка входа (SetInputLayout)
+    InputLayoutDesc input_layout_;
+    cl_kernel layout_padding_kernel_ = nullptr;  // Пересобирается при смене формата
     
     // Буферы GPU (persistent для переиспользования)
     std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_input_;      // Входной буфер (может быть внешним)
@@ -424,6 +842,44 @@ private:
     // Отладочные kernel'ы (без callback'ов)
     cl_kernel padding_kernel_;             // Kernel для padding данных (основной)
     cl_kernel post_kernel_;                // Kernel для magnitude + select (основной)
+    ManagerOpenCL::WorkGroupConfig padding_wg_;    // Local size padding_kernel (WorkGroupTuner)
+    ManagerOpenCL::WorkGroupConfig reduction_wg_;  // Local size findMaximaAndPhase (WorkGroupTuner)
+    
+    // Сжатие импульса
+    std::vector<std::complex<float>> pc_reference_;  // Опорный сигнал (время), пусто = не задан
+    cl_mem pc_callback_userdata_ = nullptr;          // params | conj(FFT(опора)), nFFT отсчётов
+    clfftPlanHandle pc_forward_plan_ = 0;            // FFT + умножение в post-callback
+    clfftPlanHandle pc_inverse_plan_ = 0;            // IFFT без callback'ов
+    
+    // CFAR (создаётся при первом ProcessCFAR на контексте/очереди процессора)
+    std::unique_ptr<CFARDetector> cfar_;
+    
+    // Уточнение максимумов (zoom-DTFT)
+    cl_kernel zoom_kernel_ = nullptr;
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_zoom_tasks_;   // long2: (m0, луч) на максимум
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_zoom_output_;  // float2: точки сетки
+    
+    // Разреженный вывод спектра
+    cl_kernel sparse_kernel_ = nullptr;
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_sparse_thresholds_;  // float на луч
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_sparse_entries_;     // SparseEntryGPU × max_entries
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_sparse_count_;       // uint счётчик
+    
+    // Вещественный вход (R2C)
+    clfftPlanHandle real_plan_handle_ = 0;         // CLFFT_REAL → CLFFT_HERMITIAN_INTERLEAVED
+    cl_kernel real_padding_kernel_ = nullptr;
+    cl_kernel hermitian_window_kernel_ = nullptr;
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_real_input_;     // float: beam_count × nFFT
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_real_spectrum_;  // float2: beam_count × (nFFT/2 + 1)
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_real_window_;    // float2: beam_count × out_count_points_fft
+    
+    // Некогерентное накопление
+    IntegrationParams integration_params_;
+    cl_kernel integration_kernel_ = nullptr;
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_integration_acc_;     // float: beam_count × out_count_points_fft
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_integration_window_;  // float2: то же, для post_kernel
+    size_t integration_count_ = 0;      // Кадров с последней выдачи
+    bool integration_primed_ = false;   // В накопителе есть данные (EMA — продолжается после выдачи)
     
     // Массивы kernel'ов для ПАРАЛЛЕЛЬНОЙ обработки (по одному на поток)
     static constexpr size_t MAX_PARALLEL_KERNELS = 8;  // Максимум параллельных потоков
@@ -486,6 +942,7 @@ private:
         double batch_size_ratio = 0.22;      // 10% лучей на батч
         size_t min_beams_for_batch = 10;    // Минимум лучей для batch режима
         size_t num_parallel_streams = 3;    // 3 параллельных потока
+        bool inplace_fft = false;           // CLFFT_INPLACE: без отдельного FFT output
     };
     BatchConfig batch_config_;
     
@@ -499,6 +956,7 @@ private:
     
     // Кэш для планов FFT (ключ: hash параметров)
     struct PlanCacheKey {
+        cl_context context;                // План запечён для конкретного контекста
         size_t beam_count;
         size_t count_points;
         size_t nFFT;
@@ -506,7 +964,8 @@ private:
         size_t max_peaks_count;
         
         bool operator==(const PlanCacheKey& other) const {
-            return beam_count == other.beam_count &&
+            return context == other.context &&
+                   beam_count == other.beam_count &&
                    count_points == other.count_points &&
                    nFFT == other.nFFT &&
                    out_count_points_fft == other.out_count_points_fft &&
@@ -516,7 +975,8 @@ private:
     
     struct PlanCacheKeyHash {
         size_t operator()(const PlanCacheKey& key) const {
-            return std::hash<size_t>()(key.beam_count) ^
+            return std::hash<const void*>()(key.context) ^
+                   std::hash<size_t>()(key.beam_count) ^
                    (std::hash<size_t>()(key.count_points) << 1) ^
                    (std::hash<size_t>()(key.nFFT) << 2) ^
                    (std::hash<size_t>()(key.out_count_points_fft) << 3) ^
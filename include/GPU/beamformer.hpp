@@ -0,0 +1,178 @@
+#pragma once
+
+/**
+ * @file beamformer.hpp
+ * @brief Цифровое формирование лучей на GPU: Y = W·X (тайловое комплексное GEMM)
+ *
+ * X — данные элементов решётки num_elements × num_samples (строка на канал),
+ * Y — лучи num_beams × output_stride: вход AntennaFFTProcMax. Веса по углам
+ * LFMParameters (num_beams, angle_start_deg / angle_stop_deg / angle_step_deg)
+ * для эквидистантной линейной решётки:
+ *
+ *   y_b = w_b^H x,   w_b[m] = exp(j·2π·d·m·sin θ_b) / num_elements
+ *
+ * (единичное усиление в направлении θ_b). Веса считаются на хосте один раз на
+ * набор углов и хранятся на устройстве: повторный SetSteering с теми же
+ * параметрами только переключает буфер.
+ *
+ * РЕАЛИЗАЦИЯ:
+ * - Группа 16 × 16 считает тайл 64 луча × 64 отсчёта, поток — 4 × 4 выхода
+ *   в регистрах; шаг по элементам 16, тайлы W и X в local memory
+ * - Отсчёты потока чередуются с шагом 16: запись Y и чтение X по строкам
+ * - Если устройство допускает меньше 256 потоков в группе (CL_KERNEL_WORK_GROUP_SIZE
+ *   на CPU), ядро собирается с тайлом 8 (4, ...) — GetTile()
+ * - output_stride > num_samples: хвост строки [num_samples, output_stride)
+ *   заполняется нулями — то же, что делает padding перед FFT, поэтому
+ *   AntennaFFTProcMax::ProcessBeamformed пишет лучи сразу во вход FFT
+ *
+ * @code
+ * BeamformerParams bf;
+ * bf.num_elements = 64;
+ * bf.num_samples = lfm.count_points;
+ * Beamformer beamformer(bf);
+ * beamformer.SetSteering(lfm);                       // lfm.num_beams лучей
+ * auto result = processor.ProcessBeamformed(elements, beamformer);
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "interface/lfm_parameters.h"
+#include <CL/cl.h>
+#include <complex>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры
+// ════════════════════════════════════════════════════════════════════════════
+
+struct BeamformerParams {
+    size_t num_elements = 0;        ///< Каналов решётки (строк X)
+    size_t num_samples = 0;         ///< Отсчётов на канал (столбцов X)
+    float element_spacing = 0.5f;   ///< Шаг решётки в длинах волн
+
+    bool IsValid() const { return num_elements > 0 && num_samples > 0 && element_spacing > 0.0f; }
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: Beamformer
+// ════════════════════════════════════════════════════════════════════════════
+
+class Beamformer {
+public:
+    static constexpr size_t TILE = 16;            ///< Наибольший шаг по элементам (GetTile() — фактический)
+    static constexpr size_t REGISTER_BLOCK = 4;   ///< Выходов на поток по каждой оси
+
+    /// На OpenCLComputeEngine (должен быть инициализирован)
+    explicit Beamformer(const BeamformerParams& params);
+
+    /// На контексте/очереди устройства (DeviceContext должен пережить формирователь)
+    Beamformer(const BeamformerParams& params, const ManagerOpenCL::DeviceContext& device);
+
+    ~Beamformer();
+
+    Beamformer(const Beamformer&) = delete;
+    Beamformer& operator=(const Beamformer&) = delete;
+
+    /**
+     * @brief Лучи по углам LFMParameters (веса кэшируются по набору углов)
+     *
+     * angle_stop_deg != angle_start_deg: num_beams углов равномерно от start до stop
+     * (как задержки в генераторе), иначе start + b · angle_step_deg.
+     * @throws std::invalid_argument если num_beams == 0
+     */
+    void SetSteering(const LFMParameters& lfm);
+
+    /**
+     * @brief Произвольные веса (например, MVDR): y_b = w_b^H x
+     * @param weights num_beams × num_elements, строка — w_b
+     */
+    void SetWeights(const std::vector<std::complex<float>>& weights, size_t num_beams);
+
+    /**
+     * @brief Y = W·X на устройстве, с ожиданием и профилированием
+     * @param input batch_count блоков num_elements × num_samples float2
+     * @param output batch_count блоков num_beams × output_stride float2
+     * @param output_stride Шаг строки Y (0 = num_samples); хвост строки обнуляется
+     */
+    void Apply(cl_mem input, cl_mem output, size_t output_stride = 0, size_t batch_count = 1);
+
+    /// Хостовая перегрузка: num_beams × num_samples на блок
+    std::vector<std::complex<float>> Apply(const std::vector<std::complex<float>>& input, size_t batch_count = 1);
+
+    /**
+     * @brief Поставить GEMM в очередь без ожидания (для цепочки с FFT)
+     * @param out_event Событие завершения (освобождает вызывающий)
+     * @param num_wait_events, wait_list События, после которых стартует GEMM (загрузка X в другой очереди)
+     */
+    void Enqueue(cl_mem input, cl_mem output, size_t output_stride, size_t batch_count, cl_event* out_event,
+                 cl_uint num_wait_events = 0, const cl_event* wait_list = nullptr);
+
+    /// Углы лучей по правилу SetSteering
+    static std::vector<float> BeamAngles(const LFMParameters& lfm);
+
+    /// Веса w_b (num_angles × num_elements) для линейной решётки
+    static std::vector<std::complex<float>> SteeringWeights(const std::vector<float>& angles_deg,
+                                                            size_t num_elements, float element_spacing);
+
+    size_t GetNumBeams() const { return num_beams_; }
+    size_t GetNumElements() const { return params_.num_elements; }
+    size_t GetNumSamples() const { return params_.num_samples; }
+    /// Группа GetTile() × GetTile(): TILE или меньше по CL_KERNEL_WORK_GROUP_SIZE устройства
+    size_t GetTile() const { return tile_; }
+    const std::vector<float>& GetAngles() const { return angles_; }
+    size_t GetCachedSteeringCount() const { return steering_cache_.size(); }
+    double GetLastTimeMs() const { return last_time_ms_; }
+
+private:
+    Beamformer(const BeamformerParams& params, const ManagerOpenCL::DeviceContext* device);
+
+    /// Ключ кэша: num_beams, angle_start, angle_stop, angle_step
+    using SteeringKey = std::tuple<size_t, float, float, float>;
+
+    struct WeightSet {
+        std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer;   ///< num_beams × num_elements, conj(w)
+        size_t num_beams = 0;
+        std::vector<float> angles;
+    };
+
+    void BuildKernel();
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+    /// conj(w) → новый WeightSet на устройстве
+    WeightSet UploadWeights(const std::vector<std::complex<float>>& weights, size_t num_beams);
+    void RequireWeights(const char* where) const;
+
+    BeamformerParams params_;
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    cl_program program_ = nullptr;
+    cl_kernel gemm_kernel_ = nullptr;
+    size_t tile_ = TILE;                           ///< BF_TILE собранного ядра
+
+    std::map<SteeringKey, WeightSet> steering_cache_;
+    WeightSet custom_weights_;                     ///< SetWeights
+    cl_mem weights_ = nullptr;                     ///< Активный набор (из кэша или custom_weights_)
+    size_t num_beams_ = 0;
+    std::vector<float> angles_;                    ///< Пусто для SetWeights
+
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_input_;    ///< Для хостовой перегрузки
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_output_;
+    size_t input_capacity_ = 0;
+    size_t output_capacity_ = 0;
+
+    double last_time_ms_ = 0.0;
+};
+
+} // namespace antenna_fft
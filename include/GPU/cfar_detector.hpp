@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * @file cfar_detector.hpp
+ * @brief CFAR обнаружитель (CA / GO / SO / OS) по буферу мощности на GPU
+ *
+ * Альтернатива фиксированному top-N поиску (findMaximaAndPhase / post_kernel):
+ * порог для каждой ячейки строится по обучающим ячейкам слева и справа
+ * (за защитными ячейками), поэтому число обнаружений зависит от уровня шума.
+ *
+ * РЕАЛИЗАЦИЯ:
+ * - Work-group обрабатывает тайл из local_size ячеек одного луча и загружает
+ *   в local memory тайл + (guard + training) ячеек с каждой стороны
+ * - Суммы окон CA/GO/SO — разности префиксных сумм в local memory
+ * - OS — k-я порядковая статистика обучающих ячеек (частичная сортировка)
+ * - Обнаружения уплотняются: scan флагов внутри группы + один atomic_add
+ *   на группу к счётчику луча → переменная длина выхода, счётчик на луч
+ *
+ * Края луча: учитываются только обучающие ячейки внутри [0, num_cells).
+ *
+ * @code
+ * CFARParams cfar;
+ * cfar.method = CFARMethod::OS;
+ * cfar.pfa = 1e-5;
+ * CFARDetector detector(cfar);
+ * CFARResult result = detector.Detect(power_buffer, beam_count, num_cells);
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include <CL/cl.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры
+// ════════════════════════════════════════════════════════════════════════════
+
+/// Вариант оценки шума
+enum class CFARMethod {
+    CA,   ///< Cell-averaging: среднее по обеим сторонам
+    GO,   ///< Greatest-of: максимум из средних левой/правой стороны
+    SO,   ///< Smallest-of: минимум из средних
+    OS    ///< Ordered-statistic: k-я по величине обучающая ячейка
+};
+
+std::string CFARMethodToString(CFARMethod method);
+
+/**
+ * @struct CFARParams
+ * @brief Параметры обнаружителя (вход — мощность |X|², квадратичный детектор)
+ */
+struct CFARParams {
+    CFARMethod method = CFARMethod::CA;
+    size_t guard_cells = 2;                ///< Защитных ячеек с каждой стороны
+    size_t training_cells = 16;            ///< Обучающих ячеек с каждой стороны (OS: <= 32)
+    size_t os_rank = 0;                    ///< OS: k в [1, 2·training], 0 = 3/4 · 2·training
+    double pfa = 1e-6;                     ///< Вероятность ложной тревоги (если threshold_factor == 0)
+    float threshold_factor = 0.0f;         ///< Множитель порога alpha; 0 = из pfa
+    size_t max_detections_per_beam = 64;   ///< Ёмкость выхода на луч
+
+    bool IsValid() const;
+
+    /// Фактический k для OS
+    size_t GetOSRank() const;
+
+    /**
+     * @brief Множитель порога: threshold = alpha · noise
+     *
+     * CA/GO/SO: alpha = N (Pfa^(-1/N) - 1), N = 2·training (для GO/SO — приближение CA).
+     * OS: решение Pfa = Π_{i=0}^{k-1} (N - i) / (N - i + alpha) бисекцией.
+     */
+    float GetThresholdFactor() const;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Результаты
+// ════════════════════════════════════════════════════════════════════════════
+
+struct CFARDetection {
+    size_t index = 0;      ///< Ячейка (бин) в луче
+    float value = 0.0f;    ///< Мощность ячейки
+    float noise = 0.0f;    ///< Оценка шума (без alpha)
+
+    /// Отношение сигнал/шум, дБ
+    float GetSNRdB() const;
+};
+
+struct CFARBeamResult {
+    std::vector<CFARDetection> detections;  ///< По возрастанию index
+    size_t total_count = 0;                 ///< Сколько обнаружено (может быть > detections.size())
+
+    bool Overflowed() const { return total_count > detections.size(); }
+};
+
+struct CFARResult {
+    std::vector<CFARBeamResult> beams;
+    size_t num_cells = 0;
+    float threshold_factor = 0.0f;
+    double kernel_time_ms = 0.0;
+
+    size_t TotalDetections() const;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: CFARDetector
+// ════════════════════════════════════════════════════════════════════════════
+
+class CFARDetector {
+public:
+    /// На OpenCLComputeEngine (должен быть инициализирован)
+    explicit CFARDetector(const CFARParams& params);
+
+    /// На контексте/очереди устройства (DeviceContext должен пережить детектор)
+    CFARDetector(const CFARParams& params, const ManagerOpenCL::DeviceContext& device);
+
+    ~CFARDetector();
+
+    CFARDetector(const CFARDetector&) = delete;
+    CFARDetector& operator=(const CFARDetector&) = delete;
+
+    /**
+     * @brief Обнаружение по буферу мощности
+     * @param power float, beam_count строк по row_stride (0 = num_cells) элементов
+     * @param wait_event Событие, которого ждать перед запуском (может быть nullptr)
+     * @throws std::runtime_error при ошибке OpenCL
+     */
+    CFARResult Detect(cl_mem power, size_t beam_count, size_t num_cells,
+                      size_t row_stride = 0, cl_event wait_event = nullptr);
+
+    /**
+     * @brief Обнаружение по комплексному спектру: сначала |X|² первых num_cells бинов
+     * @param spectrum float2, beam_count строк по spectrum_stride элементов
+     */
+    CFARResult DetectSpectrum(cl_mem spectrum, size_t beam_count, size_t num_cells,
+                              size_t spectrum_stride, cl_event wait_event = nullptr);
+
+    void SetParams(const CFARParams& params);
+    const CFARParams& GetParams() const { return params_; }
+
+private:
+    CFARDetector(const CFARParams& params, const ManagerOpenCL::DeviceContext* device);
+
+    void BuildKernels();
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+    void EnsureBuffers(size_t beam_count, size_t num_cells, bool need_power);
+    CFARResult ReadResult(size_t beam_count, size_t num_cells, cl_event detect_event);
+
+    CFARParams params_;
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    cl_program program_ = nullptr;
+    cl_kernel detect_kernel_ = nullptr;
+    cl_kernel power_kernel_ = nullptr;
+    size_t local_size_ = 0;
+
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_power_;       ///< Для DetectSpectrum
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_detections_;  ///< beam × max_detections
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_counts_;      ///< uint на луч
+    size_t power_capacity_ = 0;      ///< float
+    size_t detection_capacity_ = 0;  ///< записей
+    size_t count_capacity_ = 0;      ///< лучей
+};
+
+} // namespace antenna_fft
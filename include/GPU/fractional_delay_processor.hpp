@@ -39,6 +39,8 @@
 namespace ManagerOpenCL {
     class OpenCLComputeEngine;
     class GPUMemoryBuffer;
+    class IMemoryBuffer;
+    struct DeviceContext;
 }
 
 namespace radar {
@@ -129,9 +131,10 @@ struct DelayParams {
 struct FractionalDelayConfig {
     uint32_t num_beams;              ///< Количество лучей/антенн [1..256]
     uint32_t num_samples;            ///< Количество отсчётов на луч [16..1310720]
-    uint32_t local_work_size;        ///< Размер workgroup для OpenCL [64..512]
+    uint32_t local_work_size;        ///< Размер workgroup для OpenCL [64..512] (fallback при auto_tune)
     bool     verbose;                ///< Подробный вывод
     bool     enable_profiling;       ///< Включить GPU профилирование
+    bool     auto_tune = true;       ///< Подбирать local size / отсчётов на work-item (WorkGroupTuner)
     
     /// Стандартная конфигурация (64 луча, 8K отсчётов)
     static FractionalDelayConfig Standard() {
@@ -186,7 +189,7 @@ struct FDPProfilingResults {
  * @struct LagrangeMatrix
  * @brief Матрица коэффициентов Лагранжа 48×5
  * 
- * Загружается из lagrange_matrix.json
+ * Загружается из lagrange_matrix.json или его бинарной копии (SaveBinary)
  * Каждая строка соответствует дробной части задержки:
  * Row 0: frac = 0.00, Row 1: frac ≈ 0.02, ..., Row 47: frac ≈ 0.98
  */
@@ -196,6 +199,15 @@ struct LagrangeMatrix {
     /// Загрузить из JSON файла
     static LagrangeMatrix LoadFromJSON(const std::string& filepath);
     
+    /// Загрузить из бинарного контейнера (MappedArrayFile, float32/float64 [48, 5])
+    static LagrangeMatrix LoadFromBinary(const std::string& filepath);
+    
+    /// Бинарный контейнер или JSON — по сигнатуре файла
+    static LagrangeMatrix Load(const std::string& filepath);
+    
+    /// Сохранить в бинарный контейнер (float32 [48, 5])
+    void SaveBinary(const std::string& filepath) const;
+    
     /// Получить коэффициенты для строки
     const std::array<float, LAGRANGE_COLS>& GetRow(uint32_t row) const {
         return coefficients[row % LAGRANGE_ROWS];
@@ -279,6 +291,17 @@ public:
         const LagrangeMatrix& lagrange_matrix
     );
     
+    /**
+     * @brief Конструктор на заданном устройстве (без OpenCLComputeEngine)
+     * @param device - контекст/очередь устройства (владелец DeviceGroup, должен пережить процессор)
+     * @throws std::invalid_argument если device невалиден
+     */
+    FractionalDelayProcessor(
+        const FractionalDelayConfig& config,
+        const LagrangeMatrix& lagrange_matrix,
+        const ManagerOpenCL::DeviceContext& device
+    );
+    
     /// Деструктор с освобождением GPU ресурсов
     ~FractionalDelayProcessor();
     
@@ -321,6 +344,29 @@ public:
      */
     void ProcessWithDelay(cl_mem gpu_buffer, float delay_samples);
     
+    /**
+     * @brief Обработка IN-PLACE буфера IMemoryBuffer (Regular / SVM / Hybrid)
+     * 
+     * SVM буфер передаётся в kernel через clSetKernelArgSVMPointer без
+     * промежуточных копий; обычный буфер обрабатывается как cl_mem.
+     * 
+     * @param buffer - буфер с данными (не меньше num_beams × num_samples complex)
+     * @param delays - вектор параметров задержки для каждого луча
+     */
+    void Process(ManagerOpenCL::IMemoryBuffer* buffer, const std::vector<DelayParams>& delays);
+    
+    /**
+     * @brief Обработка IN-PLACE по SVM указателю (zero-copy)
+     * 
+     * Указатель от clSVMAlloc в контексте engine'а, либо любой указатель хоста
+     * при SVM_FINE_SYSTEM. Без поддержки SVM данные прозрачно проходят через
+     * обычный буфер (upload → обработка → download).
+     * 
+     * @param svm_ptr - указатель на num_beams × num_samples complex
+     * @param delays - вектор параметров задержки для каждого луча
+     */
+    void ProcessSVM(void* svm_ptr, const std::vector<DelayParams>& delays);
+    
     /**
      * @brief Batch обработка - несколько буферов последовательно
      * 
@@ -370,11 +416,15 @@ private:
     cl_device_id device_;
     cl_kernel kernel_;
     cl_program program_;
+    bool svm_supported_;                ///< SVM поддерживается device_
+    size_t work_group_size_;            ///< Local size запуска (0 = ещё не подобран)
+    size_t items_per_work_item_;        ///< Отсчётов на work-item (grid-stride цикл ядра)
     
     // GPU буферы
     std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_lagrange_;  ///< Матрица Лагранжа 48×5
     std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_delays_;    ///< Параметры задержек для лучей
     std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_temp_;      ///< Временный буфер для IN-PLACE
+    void* svm_temp_;                                                    ///< SVM временный буфер (создаётся при первом SVM вызове)
     
     // Статистика
     FDPProfilingResults last_profiling_;
@@ -385,18 +435,43 @@ private:
     // ПРИВАТНЫЕ МЕТОДЫ
     // ========================================================================
     
+    /// Общая часть конструкторов (device == nullptr → синглтоны)
+    FractionalDelayProcessor(
+        const FractionalDelayConfig& config,
+        const LagrangeMatrix& lagrange_matrix,
+        const ManagerOpenCL::DeviceContext* device
+    );
+    
     /// Инициализировать процессор
-    void Initialize();
+    void Initialize(const ManagerOpenCL::DeviceContext* device);
+    
+    /// Создать буфер в контексте процессора (context_ / queue_)
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements, bool read_only);
     
     /// Загрузить и скомпилировать OpenCL kernel
     void LoadKernel();
     
+    /// Взять local size из базы WorkGroupTuner (или config_.local_work_size)
+    void ResolveWorkGroup();
+    
+    /// Global size для текущих work_group_size_ / items_per_work_item_
+    size_t GetGlobalSize(size_t total_work) const;
+    
     /// Создать GPU буферы
     void CreateBuffers();
     
     /// Загрузить матрицу Лагранжа на GPU
     void UploadLagrangeMatrix();
     
+    /// Общий конвейер: вход либо cl_mem, либо SVM указатель (svm_ptr != nullptr)
+    void ProcessInternal(cl_mem gpu_buffer, void* svm_ptr, const std::vector<DelayParams>& delays);
+    
+    /// Создать svm_temp_ если его нет
+    void EnsureSVMTemp();
+    
+    /// Освободить svm_temp_
+    void ReleaseSVMTemp();
+    
     /// Получить исходный код kernel'а
     static std::string GetKernelSource();
     
@@ -0,0 +1,239 @@
+#pragma once
+
+/**
+ * @file frame_replay.hpp
+ * @brief Запись входных кадров с параметрами конвейера и их воспроизведение для бенчмарков
+ *
+ * Бенчмарк по воспроизведённой записи не включает время генерации входа
+ * (GeneratorGPU) и повторяется на одних и тех же данных между коммитами.
+ *
+ * ФОРМАТ (little-endian, кадры дописываются потоком):
+ *
+ *   [0, 128)                      FrameRecordHeader
+ *   [128, 128 + 8·delay_count)    radar::DelayParams
+ *   далее с выравниванием 64:     кадры — FrameRecordEntry (16 байт) + beam_count × count_points float2
+ *
+ * frame_count в заголовке обновляется при Close(); запись, прерванная до
+ * Close(), читается по длине файла (неполный последний кадр отбрасывается).
+ *
+ * ВОСПРОИЗВЕДЕНИЕ (FrameReplayer):
+ * - Темп: максимальный (без пауз), rate_hz или метки времени записи
+ * - Модель источника реального времени: кадр приходит в свой момент
+ *   независимо от обработки; если к освобождению обработчика ждут больше
+ *   queue_depth кадров, старшие сбрасываются (dropped)
+ * - Задержка кадра = окончание обработки − момент прихода; время обслуживания =
+ *   окончание − начало (загрузка на устройство + обработчик)
+ *
+ * @code
+ * FrameRecordingInfo info;
+ * info.fft = AntennaFFTParams(beams, points, 512, 3);
+ * FrameRecorder recorder("Reports/replay/run.lchrec", info);
+ * for (...) recorder.Append(generator.signal_base(), queue);
+ * recorder.Close();
+ *
+ * FrameRecording recording("Reports/replay/run.lchrec");
+ * FrameReplayer replayer(recording);
+ * ReplayOptions options;
+ * options.rate_hz = 1000.0;
+ * auto stats = replayer.RunPipeline(options, &lagrange);   // FDP (если записан) → AntennaFFTProcMax
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/fractional_delay_processor.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "interface/antenna_fft_params.h"
+#include <CL/cl.h>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Формат
+// ════════════════════════════════════════════════════════════════════════════
+
+struct FrameRecordHeader {
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t FLAG_FFT = 1u << 0;            ///< Записаны AntennaFFTParams
+    static constexpr uint32_t FLAG_FDP = 1u << 1;            ///< Записан FractionalDelayConfig
+    static constexpr uint32_t FLAG_FDP_AUTO_TUNE = 1u << 2;
+    static constexpr size_t FRAME_ALIGNMENT = 64;
+
+    char magic[8];                  ///< "LCHFRAME"
+    uint32_t version;
+    uint32_t header_bytes;          ///< sizeof(FrameRecordHeader)
+    uint32_t flags;
+    uint32_t beam_count;            ///< Кадр: beam_count × count_points float2 (beam-major)
+    uint32_t count_points;
+    uint32_t out_count_points_fft;  ///< AntennaFFTParams
+    uint32_t max_peaks_count;
+    uint32_t fdp_local_work_size;   ///< FractionalDelayConfig (num_beams/num_samples = размеры кадра)
+    uint32_t delay_count;           ///< DelayParams после заголовка (0 или beam_count)
+    uint32_t reserved0;
+    uint64_t frames_offset;         ///< Начало первого кадра
+    uint64_t frame_count;
+    uint64_t frame_period_ns;       ///< Номинальный период источника (0 = по меткам)
+    uint8_t reserved[56];
+};
+
+static_assert(sizeof(FrameRecordHeader) == 128, "FrameRecordHeader must be 128 bytes");
+
+struct FrameRecordEntry {
+    uint64_t timestamp_ns;          ///< От начала записи
+    uint64_t index;
+};
+
+static_assert(sizeof(FrameRecordEntry) == 16, "FrameRecordEntry must be 16 bytes");
+
+/// Параметры конвейера, сохраняемые вместе с кадрами
+struct FrameRecordingInfo {
+    AntennaFFTParams fft;                      ///< beam_count == 0 — без AntennaFFTProcMax
+    bool has_fdp = false;
+    radar::FractionalDelayConfig fdp = radar::FractionalDelayConfig::Standard();
+    std::vector<radar::DelayParams> delays;    ///< Пусто или по одной на луч
+    size_t beam_count = 0;                     ///< Размер кадра; 0 = из fft / fdp
+    size_t count_points = 0;
+    uint64_t frame_period_ns = 0;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: FrameRecorder
+// ════════════════════════════════════════════════════════════════════════════
+
+class FrameRecorder {
+public:
+    /**
+     * @brief Создать файл записи (перезаписывается) и сохранить параметры
+     * @throws std::invalid_argument если размеры кадра не заданы или не согласованы
+     * @throws std::runtime_error если файл не открыт
+     */
+    FrameRecorder(const std::string& path, const FrameRecordingInfo& info);
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /// Кадр beam_count × count_points; timestamp_ns — от начала записи (UINT64_MAX = текущее время)
+    void Append(const std::complex<float>* frame, uint64_t timestamp_ns = UINT64_MAX);
+    void Append(const std::vector<std::complex<float>>& frame, uint64_t timestamp_ns = UINT64_MAX);
+
+    /// Кадр с устройства (чтение в queue с ожиданием), например выход GeneratorGPU
+    void Append(cl_mem frame, cl_command_queue queue, uint64_t timestamp_ns = UINT64_MAX);
+
+    /// Дописать frame_count в заголовок и закрыть (вызывается деструктором)
+    void Close();
+
+    size_t GetFrameCount() const { return frame_count_; }
+    size_t GetFrameElements() const { return frame_elements_; }
+
+private:
+    std::ofstream file_;
+    std::string path_;
+    FrameRecordHeader header_{};
+    size_t frame_elements_ = 0;
+    size_t frame_count_ = 0;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<std::complex<float>> scratch_;   ///< Для Append(cl_mem)
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: FrameRecording - чтение записи
+// ════════════════════════════════════════════════════════════════════════════
+
+class FrameRecording {
+public:
+    /**
+     * @brief Открыть запись: заголовок, параметры и все кадры в память
+     * @throws std::runtime_error если файл не открыт, не запись кадров или повреждён
+     */
+    explicit FrameRecording(const std::string& path);
+
+    const FrameRecordingInfo& GetInfo() const { return info_; }
+    size_t GetFrameCount() const { return timestamps_ns_.size(); }
+    size_t GetFrameElements() const { return info_.beam_count * info_.count_points; }
+    const std::complex<float>* GetFrame(size_t index) const;
+    uint64_t GetTimestampNs(size_t index) const { return timestamps_ns_.at(index); }
+    /// Средний интервал между метками (или frame_period_ns записи)
+    uint64_t GetFramePeriodNs() const;
+    const std::string& GetPath() const { return path_; }
+
+    static bool IsRecordingFile(const std::string& path);
+
+private:
+    std::string path_;
+    FrameRecordingInfo info_;
+    std::vector<uint64_t> timestamps_ns_;
+    std::vector<std::complex<float>> frames_;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Воспроизведение
+// ════════════════════════════════════════════════════════════════════════════
+
+struct ReplayOptions {
+    double rate_hz = 0.0;           ///< Кадров/с; 0 = максимальная скорость
+    bool recorded_timing = false;   ///< Темп по меткам записи (rate_hz игнорируется)
+    size_t queue_depth = 1;         ///< Ожидающих кадров до сброса старших
+    size_t loops = 1;               ///< Проходов по записи
+    size_t warmup = 1;              ///< Кадров до замеров (вне статистики, без пауз)
+};
+
+struct LatencySummary {
+    double min_ms = 0.0;
+    double median_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    double mean_ms = 0.0;
+
+    static LatencySummary From(std::vector<double> samples_ms);
+};
+
+struct ReplayStats {
+    size_t frames_offered = 0;      ///< Пришло от источника (loops × кадров)
+    size_t frames_processed = 0;
+    size_t frames_dropped = 0;
+    double wall_ms = 0.0;
+    double frames_per_sec = 0.0;    ///< Обработано / wall
+    double samples_per_sec = 0.0;
+    std::vector<double> latency_ms;  ///< На обработанный кадр
+    std::vector<double> service_ms;
+    LatencySummary latency;
+    LatencySummary service;
+};
+
+class FrameReplayer {
+public:
+    /// Обработчик кадра на устройстве; должен вернуть управление после окончания обработки
+    using FrameHandler = std::function<void(cl_mem frame, size_t index)>;
+
+    /// На OpenCLComputeEngine (должен быть инициализирован); recording должна пережить replayer
+    explicit FrameReplayer(const FrameRecording& recording);
+
+    /// Кадры загружаются на устройство перед handler (загрузка входит во время обслуживания)
+    ReplayStats Run(const ReplayOptions& options, const FrameHandler& handler);
+
+    /**
+     * @brief Конвейер из параметров записи: FractionalDelayProcessor (если записан) → AntennaFFTProcMax
+     * @param lagrange Нужна, если в записи есть FDP
+     * @throws std::invalid_argument если в записи нет ни одного этапа или нет lagrange для FDP
+     */
+    ReplayStats RunPipeline(const ReplayOptions& options, const radar::LagrangeMatrix* lagrange);
+
+private:
+    const FrameRecording& recording_;
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_command_queue queue_ = nullptr;   ///< Загрузка кадров
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_frame_;
+};
+
+} // namespace antenna_fft
@@ -14,6 +14,7 @@ namespace ManagerOpenCL {
     class OpenCLComputeEngine;
     class KernelProgram;
     class GPUMemoryBuffer;
+    struct DeviceContext;
 }
 
 struct LFMParameters;
@@ -62,6 +63,9 @@ namespace radar {
  * auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
  * auto result = engine.ReadBufferFromGPU(signal_gpu, total_size);
  * ```
+ *
+ * Конструктор с ManagerOpenCL::DeviceContext генерирует на контексте/очереди
+ * заданного устройства без синглтонов (см. MultiDeviceGenerator).
  */
 class GeneratorGPU {
 public:
@@ -76,6 +80,13 @@ public:
      */
     explicit GeneratorGPU(const LFMParameters& params);
 
+    /**
+     * @brief Конструктор на заданном устройстве (без OpenCLComputeEngine)
+     * @param device Контекст/устройство/очередь (владелец DeviceGroup, должен пережить генератор)
+     * @throws std::invalid_argument если параметры или device невалидны
+     */
+    GeneratorGPU(const LFMParameters& params, const ManagerOpenCL::DeviceContext& device);
+
     /**
      * @brief Деструктор
      * ✅ Ресурсы управляются OpenCLComputeEngine, не нужно очищать вручную
@@ -305,6 +316,12 @@ private:
     /// ✅ Указатель на главный фасад (НЕ создаём свой контекст!)
     ManagerOpenCL::OpenCLComputeEngine* engine_;
 
+    /// OpenCL объекты (из engine либо из DeviceContext)
+    cl_context context_;
+    cl_device_id device_;
+    cl_command_queue queue_;         // nullptr в режиме engine → CommandQueuePool
+    cl_program device_program_;      // Своя программа в режиме DeviceContext (владеем)
+
     /// Параметры ЛЧМ сигнала
     LFMParameters params_;
 
@@ -331,6 +348,27 @@ private:
     // PRIVATE METHODS - ИНИЦИАЛИЗАЦИЯ И УТИЛИТЫ
     // ════════════════════════════════════════════════════════════════
 
+    /**
+     * @brief Общая часть конструкторов (device == nullptr → синглтоны)
+     */
+    GeneratorGPU(const LFMParameters& params, const ManagerOpenCL::DeviceContext* device);
+
+    /**
+     * @brief Буфер в контексте генератора
+     */
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements, bool read_only);
+
+    /**
+     * @brief Буфер с данными хоста (любой POD тип)
+     */
+    template <typename T>
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateTypedBuffer(const std::vector<T>& data);
+
+    /**
+     * @brief Очередь для операции: собственная или следующая из пула
+     */
+    cl_command_queue AcquireQueue() const;
+
     /**
      * @brief Инициализировать (получить контекст из engine)
      * ✅ Больше не создаём свой контекст - берём из OpenCLComputeEngine!
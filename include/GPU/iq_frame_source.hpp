@@ -0,0 +1,196 @@
+#pragma once
+
+/**
+ * @file iq_frame_source.hpp
+ * @brief Источник кадров из записи int16 IQ (mmap → pinned кольцо → int16 → float2 на устройстве)
+ *
+ * Записи с АЦП — interleaved int16 I/Q длиной в десятки ГБ. Файл отображается
+ * в память целиком, кадр (channel_count × samples_per_frame отсчётов) копируется
+ * в pinned буфер кольца и загружается на устройство как есть — вдвое меньше
+ * трафика по PCIe, чем float2 после преобразования на хосте. Ядро вычитает
+ * постоянную составляющую, умножает на усиление канала и пишет плотный
+ * beam-major float2 — вход AntennaFFTProcMax::Process / FractionalDelayProcessor::Process.
+ *
+ * КОНВЕЙЕР (ring_size слотов: pinned буфер + int16 буфер устройства):
+ * - NextFrame() держит загруженными следующие ring_size кадров: копирование
+ *   mmap → pinned и clEnqueueWriteBuffer идут в отдельной очереди передач,
+ *   пока устройство обрабатывает текущий кадр
+ * - Запись в слот ждёт (событием, без хоста) окончания преобразования
+ *   предыдущего кадра этого слота; преобразование ждёт своей загрузки
+ * - Прочитанные страницы записи отдаются ядру (MADV_DONTNEED): резидентная
+ *   память не растёт с длиной файла
+ *
+ * Формат файла:
+ * - Сырой: header_bytes пропускаются, далее кадры подряд
+ * - Контейнер MappedArrayFile (ComplexInt16): смещение payload из заголовка,
+ *   последнее измерение shape сверяется с channel_count (SAMPLE_MAJOR)
+ *
+ * Порядок отсчётов: SAMPLE_MAJOR (порядок АЦП: отсчёт — все каналы подряд,
+ * транспонируется тайлами в local memory) или BEAM_MAJOR (кадр — каналы подряд).
+ *
+ * @code
+ * IQFrameSourceConfig config;
+ * config.channel_count = params.beam_count;
+ * config.samples_per_frame = params.count_points;
+ * config.dc_offset = calibration.dc;     // в единицах АЦП
+ * IQFrameSource source("capture.iq", config);
+ * while (source.NextFrame()) {
+ *     auto result = processor.Process(source.GetFrameBuffer());
+ * }
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/layout_convert_kernel.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "interface/antenna_fft_params.h"
+#include <CL/cl.h>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры
+// ════════════════════════════════════════════════════════════════════════════
+
+struct IQFrameSourceConfig {
+    size_t channel_count = 0;                    ///< Каналов (лучей/антенн) в записи
+    size_t samples_per_frame = 0;                ///< Отсчётов на канал в кадре (count_points)
+    InputLayout layout = InputLayout::SAMPLE_MAJOR;
+    size_t header_bytes = 0;                     ///< Сырой файл: байт до первого кадра
+    float scale = 1.0f / 32768.0f;               ///< Общий множитель (→ [-1, 1))
+    std::vector<std::complex<float>> dc_offset;  ///< На канал, в единицах АЦП (пусто = 0)
+    std::vector<float> gain;                     ///< На канал (пусто = 1)
+    size_t ring_size = 3;                        ///< Слотов в кольце загрузки
+
+    bool IsValid() const {
+        return channel_count > 0 && samples_per_frame > 0 && ring_size > 0 && scale > 0.0f &&
+               (dc_offset.empty() || dc_offset.size() == channel_count) &&
+               (gain.empty() || gain.size() == channel_count);
+    }
+
+    size_t GetFrameBytes() const { return channel_count * samples_per_frame * 2 * sizeof(int16_t); }
+};
+
+struct IQFrameSourceStats {
+    size_t frames = 0;
+    uint64_t bytes_uploaded = 0;    ///< int16 по PCIe (float2 на хосте было бы вдвое больше)
+    double host_copy_ms = 0.0;      ///< mmap → pinned (wall)
+    double upload_ms = 0.0;         ///< clEnqueueWriteBuffer по событиям
+    double convert_ms = 0.0;        ///< Ядро преобразования по событиям
+    double wait_ms = 0.0;           ///< Ожидание готовности кадра в NextFrame (wall)
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: IQFrameSource
+// ════════════════════════════════════════════════════════════════════════════
+
+class IQFrameSource {
+public:
+    static constexpr size_t TILE = LAYOUT_CONVERT_TILE;   ///< Тайл транспонирования SAMPLE_MAJOR
+
+    /**
+     * @brief На OpenCLComputeEngine (должен быть инициализирован)
+     * @throws std::invalid_argument при неверной конфигурации или формате файла
+     * @throws std::runtime_error если файл не открыт или короче одного кадра
+     */
+    IQFrameSource(const std::string& path, const IQFrameSourceConfig& config);
+
+    /// На контексте/очереди устройства (DeviceContext должен пережить источник)
+    IQFrameSource(const std::string& path, const IQFrameSourceConfig& config,
+                  const ManagerOpenCL::DeviceContext& device);
+
+    ~IQFrameSource();
+
+    IQFrameSource(const IQFrameSource&) = delete;
+    IQFrameSource& operator=(const IQFrameSource&) = delete;
+
+    /**
+     * @brief Следующий кадр в output (channel_count × samples_per_frame float2, beam-major)
+     *
+     * Возвращает после окончания преобразования: output можно сразу отдавать
+     * процессору на другой очереди.
+     * @return false, если кадры записи кончились (output не изменён)
+     */
+    bool NextFrame(cl_mem output);
+
+    /// Следующий кадр в собственный буфер (GetFrameBuffer)
+    bool NextFrame();
+
+    cl_mem GetFrameBuffer() const;
+
+    /// Перейти к кадру frame (следующий NextFrame вернёт его); frame <= GetFrameCount()
+    void Seek(size_t frame);
+
+    /// Постоянная составляющая и усиление каналов (размеры как в IQFrameSourceConfig)
+    void SetChannelCorrection(const std::vector<std::complex<float>>& dc_offset, const std::vector<float>& gain);
+
+    size_t GetFrameCount() const { return frame_count_; }
+    size_t GetFrameIndex() const { return next_frame_; }
+    const IQFrameSourceConfig& GetConfig() const { return config_; }
+    const IQFrameSourceStats& GetStats() const { return stats_; }
+    void ResetStats() { stats_ = IQFrameSourceStats{}; }
+
+private:
+    IQFrameSource(const std::string& path, const IQFrameSourceConfig& config,
+                  const ManagerOpenCL::DeviceContext* device);
+
+    struct Slot {
+        cl_mem pinned = nullptr;         ///< CL_MEM_ALLOC_HOST_PTR, отображён постоянно
+        void* host = nullptr;
+        cl_mem raw = nullptr;            ///< int16 кадр на устройстве
+        cl_event upload = nullptr;
+        cl_event convert = nullptr;
+    };
+
+    void OpenFile(const std::string& path);
+    void CloseFile();
+    void BuildKernels();
+    void CreateRing();
+    void ReleaseRing();
+    /// mmap → pinned слота, асинхронная загрузка после преобразования прошлого кадра слота
+    void Prefetch(size_t frame);
+    void Drain();
+    static double EventMs(cl_event event);
+
+    IQFrameSourceConfig config_;
+    size_t frame_bytes_ = 0;
+    size_t frame_count_ = 0;
+    size_t next_frame_ = 0;
+    size_t prefetched_ = 0;              ///< Кадры [next_frame_, prefetched_) в кольце
+
+    // Файл
+    std::string path_;
+    uint64_t data_offset_ = 0;           ///< Байт до первого кадра
+    const uint8_t* mapping_ = nullptr;   ///< Весь файл (POSIX)
+    size_t mapping_bytes_ = 0;
+    size_t released_bytes_ = 0;          ///< Начало файла, уже отданное MADV_DONTNEED
+    std::ifstream file_;                 ///< _WIN32: чтение кадров без mmap
+
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;           ///< Преобразование
+    cl_command_queue transfer_queue_ = nullptr;  ///< Загрузки (своя, in-order)
+
+    cl_program program_ = nullptr;
+    cl_kernel convert_kernel_ = nullptr;         ///< BEAM_MAJOR (layout_convert_rows)
+    cl_kernel transpose_kernel_ = nullptr;       ///< SAMPLE_MAJOR (layout_convert)
+
+    std::vector<Slot> ring_;
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_channels_;  ///< float4 на канал: (dc.re, dc.im, gain, 0)
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_frame_;     ///< Для NextFrame()
+
+    IQFrameSourceStats stats_;
+};
+
+} // namespace antenna_fft
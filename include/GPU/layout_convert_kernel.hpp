@@ -0,0 +1,45 @@
+#pragma once
+
+/**
+ * @file layout_convert_kernel.hpp
+ * @brief Общее ядро разбора входного кадра: раскладка/шаги, int16 IQ → float2, DC/усиление канала
+ *
+ * Используется AntennaFFTProcMax (layout_padding при нестандартной InputLayoutDesc)
+ * и IQFrameSource (преобразование кадра записи). Выход — плотный beam-major float2
+ * с длиной строки row_length; отсчёты pos >= count_points заполняются нулями.
+ *
+ * Ядра (одинаковый список аргументов, см. SetLayoutConvertArgs):
+ * - layout_convert      — тайл LAYOUT_CONVERT_TILE × LAYOUT_CONVERT_TILE через local memory:
+ *                         чтение подряд по лучам (SAMPLE_MAJOR), запись подряд по отсчётам;
+ *                         global = {row_length, beam_count}, округлённые до тайла
+ * - layout_convert_rows — без транспонирования, для sample_stride == 1 (BEAM_MAJOR);
+ *                         global = {row_length, beam_count}, local = {N, 1}
+ *
+ * Сборка: -DINPUT_INT16=1 — вход short2 (отсчёт · scale), иначе float2 (scale не используется).
+ *
+ * Коррекция канала: channel — float4 (dc.re, dc.im, gain, 0) на луч, индекс
+ * beam_offset + beam; значение (v - dc) · gain до масштабирования, т.е. dc
+ * в единицах входа (АЦП). channel = nullptr — без коррекции.
+ */
+
+#include <CL/cl.h>
+#include <cstddef>
+
+namespace antenna_fft {
+
+/// Тайл ядра layout_convert (reqd_work_group_size)
+constexpr size_t LAYOUT_CONVERT_TILE = 16;
+
+/// Исходник ядер layout_convert / layout_convert_rows
+extern const char* const kLayoutConvertKernelSource;
+
+/**
+ * @brief Аргументы ядра layout_convert / layout_convert_rows
+ * @return CL_SUCCESS или ненулевой код (коды clSetKernelArg объединены через |)
+ */
+cl_int SetLayoutConvertArgs(cl_kernel kernel, cl_mem input, cl_mem output,
+                            cl_uint beam_count, cl_uint count_points, cl_uint row_length,
+                            cl_uint beam_offset, cl_ulong offset, cl_ulong beam_stride,
+                            cl_ulong sample_stride, float scale, cl_mem channel);
+
+} // namespace antenna_fft
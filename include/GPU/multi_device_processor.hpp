@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file multi_device_processor.hpp
+ * @brief Распределение лучей между несколькими OpenCL устройствами
+ *
+ * Координаторы поверх ManagerOpenCL::DeviceGroup:
+ * - MultiDeviceAntennaFFT      — FFT + поиск максимумов, общий AntennaFFTResult
+ * - MultiDeviceFractionalDelay — дробная задержка (in-place в памяти хоста)
+ * - MultiDeviceGenerator       — генерация ЛЧМ сигналов
+ *
+ * Каждое устройство получает непрерывный диапазон лучей (DeviceGroup::PartitionBeams),
+ * собственный процессор (контекст/очередь/план clFFT устройства) и свой поток хоста.
+ * После прогона время каждого устройства обновляет веса группы, так что следующее
+ * разбиение следует измеренной пропускной способности.
+ *
+ * @code
+ * auto group = ManagerOpenCL::DeviceGroup::FromSubDevices(ManagerOpenCL::DeviceType::CPU, 2);
+ * antenna_fft::MultiDeviceAntennaFFT fft(params, group);
+ * auto result = fft.Process(host_signal);   // result.results[i] — луч i
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/antenna_fft_proc_max.h"
+#include "GPU/fractional_delay_processor.hpp"
+#include "GPU/generator_gpu_new.h"
+#include "ManagerOpenCL/device_group.hpp"
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceAntennaFFT
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class MultiDeviceAntennaFFT
+ * @brief AntennaFFTProcMax на нескольких устройствах с объединённым результатом
+ */
+class MultiDeviceAntennaFFT {
+public:
+    /**
+     * @param params Параметры для всех лучей (beam_count — общее количество)
+     * @param group Группа устройств (должна пережить объект)
+     */
+    MultiDeviceAntennaFFT(const AntennaFFTParams& params, ManagerOpenCL::DeviceGroup& group);
+
+    /**
+     * @brief Обработать beam_count * count_points отсчётов хоста
+     * @return Результат в порядке лучей, total_beams == beam_count
+     * @throws std::runtime_error первая ошибка любого устройства
+     */
+    AntennaFFTResult Process(const std::vector<std::complex<float>>& input_data);
+
+    /// Обновлять веса группы по времени устройств (по умолчанию включено)
+    void SetAdaptive(bool adaptive) { adaptive_ = adaptive; }
+
+    const std::vector<ManagerOpenCL::BeamRange>& GetLastPartition() const { return ranges_; }
+    const std::vector<double>& GetLastDeviceTimes() const { return device_ms_; }
+
+private:
+    void Repartition();
+
+    AntennaFFTParams params_;
+    ManagerOpenCL::DeviceGroup& group_;
+    std::vector<std::unique_ptr<AntennaFFTProcMax>> processors_;   ///< По устройству, nullptr если 0 лучей
+    std::vector<ManagerOpenCL::BeamRange> ranges_;
+    std::vector<double> device_ms_;
+    bool adaptive_ = true;
+};
+
+} // namespace antenna_fft
+
+namespace radar {
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceFractionalDelay
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class MultiDeviceFractionalDelay
+ * @brief FractionalDelayProcessor на нескольких устройствах
+ */
+class MultiDeviceFractionalDelay {
+public:
+    MultiDeviceFractionalDelay(const FractionalDelayConfig& config,
+                               const LagrangeMatrix& lagrange_matrix,
+                               ManagerOpenCL::DeviceGroup& group);
+
+    /**
+     * @brief IN-PLACE задержка num_beams * num_samples отсчётов хоста
+     * @param delays Задержка для каждого луча (размер == num_beams)
+     */
+    void Process(std::vector<std::complex<float>>& data, const std::vector<DelayParams>& delays);
+
+    void SetAdaptive(bool adaptive) { adaptive_ = adaptive; }
+
+    const std::vector<ManagerOpenCL::BeamRange>& GetLastPartition() const { return ranges_; }
+    const std::vector<double>& GetLastDeviceTimes() const { return device_ms_; }
+
+private:
+    void Repartition();
+
+    FractionalDelayConfig config_;
+    LagrangeMatrix lagrange_matrix_;
+    ManagerOpenCL::DeviceGroup& group_;
+    std::vector<std::unique_ptr<FractionalDelayProcessor>> processors_;
+    std::vector<ManagerOpenCL::BeamRange> ranges_;
+    std::vector<double> device_ms_;
+    bool adaptive_ = true;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceGenerator
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class MultiDeviceGenerator
+ * @brief GeneratorGPU на нескольких устройствах, результат собирается на хосте
+ *
+ * Лучи независимы (задержки берутся по индексу луча), поэтому устройство с
+ * диапазоном [start, start + count) генерирует count лучей с параметрами
+ * задержек этого диапазона.
+ */
+class MultiDeviceGenerator {
+public:
+    MultiDeviceGenerator(const LFMParameters& params, ManagerOpenCL::DeviceGroup& group);
+
+    /// Базовый ЛЧМ сигнал, num_beams * count_points отсчётов
+    std::vector<std::complex<float>> SignalBase();
+
+    /// ЛЧМ с задержками по лучам (num_delay_params == num_beams)
+    std::vector<std::complex<float>> SignalDelayed(const DelayParameter* m_delay, size_t num_delay_params);
+
+    /// ЛЧМ с комбинированными задержками (num_delay_params == num_beams)
+    std::vector<std::complex<float>> SignalCombinedDelays(const CombinedDelayParam* combined_delays,
+                                                          size_t num_delay_params);
+
+    void SetAdaptive(bool adaptive) { adaptive_ = adaptive; }
+
+    const std::vector<ManagerOpenCL::BeamRange>& GetLastPartition() const { return ranges_; }
+    const std::vector<double>& GetLastDeviceTimes() const { return device_ms_; }
+
+private:
+    /// Тип сигнала для прогона на одном устройстве
+    enum class Kind { BASE, DELAYED, COMBINED };
+
+    std::vector<std::complex<float>> Run(Kind kind, const DelayParameter* delays,
+                                         const CombinedDelayParam* combined);
+    void Repartition();
+
+    LFMParameters params_;
+    ManagerOpenCL::DeviceGroup& group_;
+    std::vector<std::unique_ptr<GeneratorGPU>> generators_;
+    std::vector<ManagerOpenCL::BeamRange> ranges_;
+    std::vector<double> device_ms_;
+    bool adaptive_ = true;
+};
+
+} // namespace radar
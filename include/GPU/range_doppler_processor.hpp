@@ -0,0 +1,184 @@
+#pragma once
+
+/**
+ * @file range_doppler_processor.hpp
+ * @brief Дальность-доплер: куб импульсов на устройстве + два батчевых clFFT
+ *
+ * Импульсы (снимки beam_count × count_points, как вход AntennaFFTProcMax)
+ * копируются в куб на устройстве. Куб хранится pulse-major
+ * (импульсы × лучи × дальность): тогда оба преобразования — один батчевый
+ * план clFFT каждое, без явного транспонирования:
+ * - fast-time: длина nRange, stride 1, distance nRange, batch nDoppler·beams
+ * - slow-time: длина nDoppler, stride beams·nRange, distance 1, batch beams·nRange
+ *
+ * Затем мощность |X|² раскладывается в карту лучи × доплер × дальность
+ * (доплер сдвинут fftshift: строка nDoppler/2 — нулевая частота), по которой
+ * работают top-N (как post_kernel) и CFARDetector (по дальности в каждой
+ * доплеровской строке).
+ *
+ * nRange = NextPow2(count_points), nDoppler = NextPow2(pulse_count);
+ * недостающие отсчёты и импульсы — нули.
+ *
+ * @code
+ * RangeDopplerParams params;
+ * params.beam_count = 8; params.pulse_count = 64; params.count_points = 1024;
+ * RangeDopplerProcessor rd(params);
+ * for (size_t p = 0; p < 64; ++p) rd.SetPulse(p, snapshots[p]);
+ * rd.Compute();
+ * auto peaks = rd.FindPeaks();
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/cfar_detector.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include <CL/cl.h>
+#include <clFFT.h>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры и результаты
+// ════════════════════════════════════════════════════════════════════════════
+
+struct RangeDopplerParams {
+    size_t beam_count = 0;
+    size_t pulse_count = 0;          ///< Импульсов в пачке (slow-time)
+    size_t count_points = 0;         ///< Отсчётов дальности на импульс (fast-time)
+    size_t out_range_bins = 0;       ///< Бинов дальности в карте (0 = nRange)
+    size_t max_peaks_count = 3;      ///< top-N на луч (<= 16)
+    float pulse_repetition_frequency = 0.0f;  ///< Гц, для doppler_hz (0 = не считать)
+
+    bool IsValid() const {
+        return beam_count > 0 && pulse_count > 0 && count_points > 0 &&
+               max_peaks_count > 0 && max_peaks_count <= 16;
+    }
+};
+
+struct RangeDopplerPeak {
+    size_t range_bin = 0;
+    int doppler_bin = 0;         ///< Со знаком: 0 — неподвижная цель
+    float doppler_hz = 0.0f;
+    float magnitude = 0.0f;
+    float real = 0.0f;
+    float imag = 0.0f;
+    float phase = 0.0f;          ///< Градусы
+};
+
+struct RangeDopplerDetection {
+    size_t range_bin = 0;
+    int doppler_bin = 0;
+    float power = 0.0f;
+    float noise = 0.0f;
+};
+
+struct RangeDopplerResult {
+    size_t n_range = 0;
+    size_t n_doppler = 0;
+    std::vector<std::vector<RangeDopplerPeak>> peaks;   ///< [beam][peak]
+    double fast_time_ms = 0.0;
+    double slow_time_ms = 0.0;
+    double map_ms = 0.0;
+    double search_ms = 0.0;
+};
+
+struct RangeDopplerCFARResult {
+    std::vector<std::vector<RangeDopplerDetection>> beams;  ///< По (doppler, range)
+    size_t dropped = 0;          ///< Не поместилось в max_detections_per_beam строк
+    double kernel_time_ms = 0.0;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: RangeDopplerProcessor
+// ════════════════════════════════════════════════════════════════════════════
+
+class RangeDopplerProcessor {
+public:
+    explicit RangeDopplerProcessor(const RangeDopplerParams& params);
+    RangeDopplerProcessor(const RangeDopplerParams& params, const ManagerOpenCL::DeviceContext& device);
+    ~RangeDopplerProcessor();
+
+    RangeDopplerProcessor(const RangeDopplerProcessor&) = delete;
+    RangeDopplerProcessor& operator=(const RangeDopplerProcessor&) = delete;
+
+    /**
+     * @brief Положить снимок импульса в куб (копия на устройстве, без хоста)
+     * @param snapshot beam_count × count_points комплексных отсчётов
+     */
+    void SetPulse(size_t pulse_index, cl_mem snapshot);
+    void SetPulse(size_t pulse_index, const std::vector<std::complex<float>>& snapshot);
+
+    /// Вся пачка с хоста: pulse_count × beam_count × count_points
+    void SetCube(const std::vector<std::complex<float>>& pulses);
+
+    /// fast-time FFT → slow-time FFT → карта мощности
+    void Compute();
+
+    /// top-N по карте каждого луча (после Compute)
+    RangeDopplerResult FindPeaks();
+
+    /// CFAR по дальности в каждой доплеровской строке карты (после Compute)
+    RangeDopplerCFARResult DetectCFAR(const CFARParams& cfar);
+
+    /// Compute + FindPeaks
+    RangeDopplerResult Process();
+
+    /// Карта мощности: beam_count × n_doppler × out_range_bins (доплер со сдвигом)
+    std::vector<float> ReadPowerMap();
+
+    /// Буфер карты на устройстве (для своих ядер)
+    cl_mem GetPowerMapBuffer() const;
+
+    size_t GetRangeFFTSize() const { return n_range_; }
+    size_t GetDopplerFFTSize() const { return n_doppler_; }
+    size_t GetOutRangeBins() const { return out_range_; }
+    const RangeDopplerParams& GetParams() const { return params_; }
+
+private:
+    RangeDopplerProcessor(const RangeDopplerParams& params, const ManagerOpenCL::DeviceContext* device);
+
+    void CreatePlans();
+    void BuildKernels();
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+    int DopplerBin(size_t shifted_row) const;
+    double EventMs(cl_event event) const;
+
+    RangeDopplerParams params_;
+    size_t n_range_ = 0;
+    size_t n_doppler_ = 0;
+    size_t out_range_ = 0;
+
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    clfftPlanHandle fast_plan_ = 0;     ///< cube → work
+    clfftPlanHandle slow_plan_ = 0;     ///< work in-place, strided
+
+    cl_program program_ = nullptr;
+    cl_kernel map_kernel_ = nullptr;
+    cl_kernel peaks_kernel_ = nullptr;
+    size_t peaks_local_size_ = 0;       ///< rd_top_n: <= RD_TOP_N_LOCAL и пределов устройства
+
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_cube_;   ///< Импульсы (нули в хвостах)
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_work_;   ///< Спектр дальность-доплер
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_map_;    ///< float мощность
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_peaks_;
+    std::unique_ptr<CFARDetector> cfar_;
+
+    double last_fast_ms_ = 0.0;
+    double last_slow_ms_ = 0.0;
+    double last_map_ms_ = 0.0;
+    bool computed_ = false;
+};
+
+} // namespace antenna_fft
@@ -0,0 +1,151 @@
+#pragma once
+
+/**
+ * @file streaming_fft_processor.hpp
+ * @brief Потоковая FFT фильтрация блоками (overlap-save / overlap-add)
+ *
+ * Для записей длиннее одного кадра: поток каждого луча подаётся блоками по
+ * block_size отсчётов, перекрытие между вызовами хранится на устройстве.
+ * Память ограничена несколькими буферами beam_count × fft_size независимо
+ * от длины потока.
+ *
+ * Блок (fft_size = N, block_size = L, перекрытие T = N - L):
+ * - OVERLAP_SAVE: кадр = [T отсчётов истории | L новых] → FFT → × H → IFFT,
+ *   выход — последние L отсчётов кадра; история = последние T отсчётов кадра
+ * - OVERLAP_ADD:  кадр = [L новых | нули] → FFT → × H → IFFT,
+ *   выход = первые L + хвост прошлых блоков; хвост (T отсчётов) копится дальше
+ *
+ * Сборка кадра и выборка выхода — clEnqueueCopyBufferRect, без хоста.
+ * Спектр кадра (до умножения на H) доступен через GetBlockSpectrum(), например
+ * для AntennaFFTProcMax::FindMaximaInSpectrum().
+ *
+ * Без фильтра (SetFilter не вызван) H = 1: выход совпадает со входом.
+ *
+ * @code
+ * StreamingFFTParams params;
+ * params.beam_count = 8; params.block_size = 4096;
+ * params.filter_length = taps.size();
+ * StreamingFFTProcessor stream(params);
+ * stream.SetFilter(taps);
+ * while (source.Next(block)) {
+ *     auto filtered = stream.ProcessBlock(block);
+ * }
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include <CL/cl.h>
+#include <clFFT.h>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры
+// ════════════════════════════════════════════════════════════════════════════
+
+enum class StreamingMethod {
+    OVERLAP_SAVE,
+    OVERLAP_ADD
+};
+
+struct StreamingFFTParams {
+    size_t beam_count = 0;
+    size_t block_size = 0;          ///< Новых отсчётов на луч за вызов (L)
+    size_t filter_length = 1;       ///< Максимальная длина импульсной характеристики (M)
+    size_t fft_size = 0;            ///< N; 0 = NextPow2(L + M - 1)
+    StreamingMethod method = StreamingMethod::OVERLAP_SAVE;
+
+    bool IsValid() const {
+        return beam_count > 0 && block_size > 0 && filter_length > 0 &&
+               (fft_size == 0 || fft_size >= block_size + filter_length - 1);
+    }
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: StreamingFFTProcessor
+// ════════════════════════════════════════════════════════════════════════════
+
+class StreamingFFTProcessor {
+public:
+    explicit StreamingFFTProcessor(const StreamingFFTParams& params);
+    StreamingFFTProcessor(const StreamingFFTParams& params, const ManagerOpenCL::DeviceContext& device);
+    ~StreamingFFTProcessor();
+
+    StreamingFFTProcessor(const StreamingFFTProcessor&) = delete;
+    StreamingFFTProcessor& operator=(const StreamingFFTProcessor&) = delete;
+
+    /**
+     * @brief Задать КИХ фильтр (общий для всех лучей)
+     * @param impulse_response 1..filter_length коэффициентов
+     * @throws std::invalid_argument если длина вне диапазона
+     */
+    void SetFilter(const std::vector<std::complex<float>>& impulse_response);
+
+    /**
+     * @brief Обработать очередной блок
+     * @param input beam_count × block_size отсчётов
+     * @param output beam_count × block_size отсчётов или nullptr (только спектр)
+     */
+    void ProcessBlock(cl_mem input, cl_mem output);
+
+    /// Блок с хоста → отфильтрованный блок на хосте
+    std::vector<std::complex<float>> ProcessBlock(const std::vector<std::complex<float>>& input);
+
+    /// Обнулить перекрытие (начало нового потока)
+    void Reset();
+
+    /// Спектр последнего кадра: beam_count × fft_size (до умножения на H)
+    cl_mem GetBlockSpectrum() const;
+
+    size_t GetFFTSize() const { return fft_size_; }
+    size_t GetOverlap() const { return overlap_; }
+    uint64_t GetSamplesProcessed() const { return samples_processed_; }
+    double GetLastBlockTimeMs() const { return last_block_ms_; }
+    const StreamingFFTParams& GetParams() const { return params_; }
+
+private:
+    StreamingFFTProcessor(const StreamingFFTParams& params, const ManagerOpenCL::DeviceContext* device);
+
+    void CreatePlan();
+    void BuildKernels();
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+    void CopyRows(cl_mem src, size_t src_offset, size_t src_pitch,
+                  cl_mem dst, size_t dst_offset, size_t dst_pitch, size_t row_elements);
+
+    StreamingFFTParams params_;
+    size_t fft_size_ = 0;
+    size_t overlap_ = 0;             ///< T = N - L
+
+    ManagerOpenCL::OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    clfftPlanHandle plan_ = 0;       ///< Out-of-place, batch = beam_count (вперёд и назад)
+    cl_program program_ = nullptr;
+    cl_kernel multiply_kernel_ = nullptr;
+    cl_kernel accumulate_kernel_ = nullptr;
+
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_frame_;     ///< Кадр / результат IFFT
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_spectrum_;  ///< FFT кадра
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_product_;   ///< Спектр × H
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_filter_;    ///< H, fft_size
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_overlap_[2];///< История (OS) / хвост (OA)
+    std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> buffer_io_;        ///< Вход/выход для хостового ProcessBlock
+    size_t overlap_index_ = 0;       ///< Текущий буфер хвоста OA
+
+    uint64_t samples_processed_ = 0;
+    double last_block_ms_ = 0.0;
+};
+
+} // namespace antenna_fft
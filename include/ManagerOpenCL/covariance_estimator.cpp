@@ -0,0 +1,249 @@
+#include "covariance_estimator.hpp"
+#include "opencl_compute_engine.hpp"
+#include "opencl_core.hpp"
+#include "command_queue_pool.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace ManagerOpenCL {
+
+namespace {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ядро: группа TILE × TILE на блок (bi, bj) нижнего треугольника,
+// get_group_id(0) — линейный номер блока, get_global_id(2) — номер матрицы
+// ════════════════════════════════════════════════════════════════════════════
+
+const char* kCovarianceKernelSource = R"CL(
+#define TILE 16
+
+// a * conj(b)
+inline float2 cmul_conj(float2 a, float2 b) {
+    return (float2)(a.x * b.x + a.y * b.y, a.y * b.x - a.x * b.y);
+}
+
+__kernel void herm_covariance(__global const float2* X, __global float2* R, uint n, uint snapshots,
+                              uint row_stride, float scale, float loading) {
+    __local float2 At[TILE][TILE + 1];
+    __local float2 Bt[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    size_t m = get_global_id(2);
+
+    // t = bi·(bi+1)/2 + bj, bj <= bi
+    uint t = get_group_id(0);
+    uint bi = (uint)((sqrt(8.0f * t + 1.0f) - 1.0f) * 0.5f);
+    while ((bi + 1) * (bi + 2) / 2 <= t) ++bi;
+    while (bi * (bi + 1) / 2 > t) --bi;
+    uint bj = t - bi * (bi + 1) / 2;
+
+    __global const float2* x = X + m * n * row_stride;
+    uint ri = bi * TILE + ly;
+    uint rj = bj * TILE + ly;
+
+    float2 acc = (float2)(0.0f, 0.0f);
+    for (uint k0 = 0; k0 < snapshots; k0 += TILE) {
+        uint k = k0 + lx;
+        At[ly][lx] = (ri < n && k < snapshots) ? x[(size_t)ri * row_stride + k] : (float2)(0.0f, 0.0f);
+        Bt[ly][lx] = (rj < n && k < snapshots) ? x[(size_t)rj * row_stride + k] : (float2)(0.0f, 0.0f);
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint c = 0; c < TILE; ++c) acc += cmul_conj(At[ly][c], Bt[lx][c]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // Тайл R_ij в local memory: верхний блок R_ji = conj(R_ij)^T пишется по строкам
+    At[ly][lx] = acc * scale;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    __global float2* r = R + m * n * n;
+    uint i = bi * TILE + ly;
+    uint j = bj * TILE + lx;
+    float2 v = At[ly][lx];
+    float2 vt = At[lx][ly];
+    vt.y = -vt.y;
+    if (bi == bj) {
+        // Диагональный блок: выше диагонали — отражение нижнего треугольника
+        if (i < n && j < n) {
+            if (j > i) v = vt;
+            if (i == j) v = (float2)(v.x + loading, 0.0f);
+            r[(size_t)i * n + j] = v;
+        }
+    } else {
+        if (i < n && j < n) r[(size_t)i * n + j] = v;
+        uint it = bj * TILE + ly;
+        uint jt = bi * TILE + lx;
+        if (it < n && jt < n) r[(size_t)it * n + jt] = vt;
+    }
+}
+)CL";
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+CovarianceEstimator::CovarianceEstimator(size_t channels, size_t snapshots)
+    : CovarianceEstimator(channels, snapshots, static_cast<const DeviceContext*>(nullptr)) {
+}
+
+CovarianceEstimator::CovarianceEstimator(size_t channels, size_t snapshots, const DeviceContext& device)
+    : CovarianceEstimator(channels, snapshots, &device) {
+}
+
+CovarianceEstimator::CovarianceEstimator(size_t channels, size_t snapshots, const DeviceContext* device)
+    : channels_(channels), snapshots_(snapshots) {
+    if (channels_ == 0 || snapshots_ == 0) {
+        throw std::invalid_argument("CovarianceEstimator: channels and snapshots must be > 0");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("CovarianceEstimator: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &OpenCLComputeEngine::GetInstance();
+        auto& core = OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = CommandQueuePool::GetNextQueue();
+    }
+
+    num_blocks_ = (channels_ + TILE - 1) / TILE;
+    BuildKernel();
+}
+
+CovarianceEstimator::~CovarianceEstimator() {
+    if (kernel_) clReleaseKernel(kernel_);
+    if (program_) clReleaseProgram(program_);
+}
+
+std::unique_ptr<GPUMemoryBuffer> CovarianceEstimator::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<GPUMemoryBuffer>(context_, queue_, num_elements, MemoryType::GPU_READ_WRITE);
+}
+
+void CovarianceEstimator::BuildKernel() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kCovarianceKernelSource;
+    size_t src_len = std::char_traits<char>::length(kCovarianceKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create covariance program: " + std::to_string(err));
+    }
+    err = clBuildProgram(program_, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "Covariance kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build covariance program: " + std::to_string(err));
+    }
+
+    kernel_ = clCreateKernel(program_, "herm_covariance", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create herm_covariance kernel: " + std::to_string(err));
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Оценка
+// ════════════════════════════════════════════════════════════════════════════
+
+void CovarianceEstimator::Estimate(cl_mem input, cl_mem output, size_t batch_count, float diagonal_loading,
+                                   size_t row_stride) {
+    if (input == nullptr || output == nullptr || batch_count == 0) {
+        throw std::invalid_argument("CovarianceEstimator::Estimate: null buffer or empty batch");
+    }
+    if (row_stride == 0) row_stride = snapshots_;
+    if (row_stride < snapshots_) {
+        throw std::invalid_argument("CovarianceEstimator::Estimate: row_stride " + std::to_string(row_stride) +
+                                    " < snapshots " + std::to_string(snapshots_));
+    }
+
+    cl_uint n = static_cast<cl_uint>(channels_);
+    cl_uint k = static_cast<cl_uint>(snapshots_);
+    cl_uint stride = static_cast<cl_uint>(row_stride);
+    cl_float scale = 1.0f / static_cast<float>(snapshots_);
+    cl_float loading = diagonal_loading;
+
+    clSetKernelArg(kernel_, 0, sizeof(cl_mem), &input);
+    clSetKernelArg(kernel_, 1, sizeof(cl_mem), &output);
+    clSetKernelArg(kernel_, 2, sizeof(cl_uint), &n);
+    clSetKernelArg(kernel_, 3, sizeof(cl_uint), &k);
+    clSetKernelArg(kernel_, 4, sizeof(cl_uint), &stride);
+    clSetKernelArg(kernel_, 5, sizeof(cl_float), &scale);
+    clSetKernelArg(kernel_, 6, sizeof(cl_float), &loading);
+
+    const size_t triangle_blocks = num_blocks_ * (num_blocks_ + 1) / 2;
+    size_t global[3] = {triangle_blocks * TILE, TILE, batch_count};
+    size_t local[3] = {TILE, TILE, 1};
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue_, kernel_, 3, nullptr, global, local, 0, nullptr, &event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (herm_covariance) failed: " + std::to_string(err));
+    }
+    err = clWaitForEvents(1, &event);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event);
+        throw std::runtime_error("clWaitForEvents (herm_covariance) failed: " + std::to_string(err));
+    }
+
+    last_time_ms_ = 0.0;
+    cl_ulong start = 0, end = 0;
+    if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) == CL_SUCCESS &&
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) == CL_SUCCESS &&
+        end >= start) {
+        last_time_ms_ = (end - start) * 1e-6;
+    }
+    clReleaseEvent(event);
+}
+
+std::vector<std::complex<float>> CovarianceEstimator::Estimate(const std::vector<std::complex<float>>& snapshots,
+                                                               size_t batch_count, float diagonal_loading) {
+    const size_t input_elements = batch_count * channels_ * snapshots_;
+    if (batch_count == 0 || snapshots.size() != input_elements) {
+        throw std::invalid_argument("CovarianceEstimator::Estimate: expected " + std::to_string(input_elements) +
+                                    " elements, got " + std::to_string(snapshots.size()));
+    }
+    const size_t output_elements = batch_count * channels_ * channels_;
+    if (input_capacity_ < input_elements) {
+        buffer_input_ = CreateBuffer(input_elements);
+        input_capacity_ = input_elements;
+    }
+    if (output_capacity_ < output_elements) {
+        buffer_output_ = CreateBuffer(output_elements);
+        output_capacity_ = output_elements;
+    }
+
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_input_->Get(), CL_FALSE, 0,
+                                      input_elements * sizeof(std::complex<float>), snapshots.data(),
+                                      0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (covariance) failed: " + std::to_string(err));
+    }
+
+    Estimate(buffer_input_->Get(), buffer_output_->Get(), batch_count, diagonal_loading);
+
+    std::vector<std::complex<float>> covariance(output_elements);
+    err = clEnqueueReadBuffer(queue_, buffer_output_->Get(), CL_TRUE, 0,
+                              output_elements * sizeof(std::complex<float>), covariance.data(),
+                              0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (covariance) failed: " + std::to_string(err));
+    }
+    return covariance;
+}
+
+} // namespace ManagerOpenCL
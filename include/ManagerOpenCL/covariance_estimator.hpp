@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * @file covariance_estimator.hpp
+ * @brief Выборочная ковариационная матрица на устройстве: R = (1/K)·X·X^H + δI
+ *
+ * X — блок channels × snapshots (строка на канал/луч, как выход генератора и
+ * вход AntennaFFTProcMax: beam_count × count_points), уже лежащий на устройстве.
+ * Результат n × n row-major — формат входа HermitianInverter, поэтому оценка,
+ * обращение и MVDR веса идут без передач через хост:
+ *
+ * @code
+ * CovarianceEstimator estimator(channels, snapshots);
+ * HermitianInverter inverter(channels);
+ * estimator.Estimate(signal, covariance, 1, 1e-2f);
+ * inverter.MVDRWeights(covariance, steering, weights, num_vectors, 1);
+ * @endcode
+ *
+ * R эрмитова: считается только нижний треугольник блоков TILE × TILE
+ * (nb·(nb+1)/2 групп вместо nb²), верхний записывается сопряжённым
+ * транспонированием тайла через local memory (запись остаётся по строкам).
+ * Пакетный режим: третье измерение NDRange — номер блока X / матрицы R.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "device_group.hpp"
+#include "gpu_memory_buffer.hpp"
+#include <CL/cl.h>
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+class OpenCLComputeEngine;
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: CovarianceEstimator
+// ════════════════════════════════════════════════════════════════════════════
+
+class CovarianceEstimator {
+public:
+    static constexpr size_t TILE = 16;
+
+    /**
+     * @param channels Каналов (размер R)
+     * @param snapshots Отсчётов K на канал
+     * @throws std::invalid_argument если channels или snapshots == 0
+     * @throws std::runtime_error если engine не инициализирован
+     */
+    CovarianceEstimator(size_t channels, size_t snapshots);
+    CovarianceEstimator(size_t channels, size_t snapshots, const DeviceContext& device);
+    ~CovarianceEstimator();
+
+    CovarianceEstimator(const CovarianceEstimator&) = delete;
+    CovarianceEstimator& operator=(const CovarianceEstimator&) = delete;
+
+    /**
+     * @brief R = (1/K)·X·X^H + δI на устройстве
+     * @param input batch_count блоков channels × row_stride float2 (используются первые snapshots столбцов)
+     * @param output batch_count × channels × channels float2
+     * @param diagonal_loading δ (абсолютная, добавляется к диагонали)
+     * @param row_stride Шаг строки X в элементах (0 = snapshots; например, nFFT выхода FFT)
+     */
+    void Estimate(cl_mem input, cl_mem output, size_t batch_count = 1, float diagonal_loading = 0.0f,
+                  size_t row_stride = 0);
+
+    /// Хостовая перегрузка: snapshots — batch_count × channels × snapshots
+    std::vector<std::complex<float>> Estimate(const std::vector<std::complex<float>>& snapshots,
+                                              size_t batch_count = 1, float diagonal_loading = 0.0f);
+
+    size_t GetChannels() const { return channels_; }
+    size_t GetSnapshots() const { return snapshots_; }
+    /// Время ядра последнего Estimate (профилирование события)
+    double GetLastTimeMs() const { return last_time_ms_; }
+
+private:
+    CovarianceEstimator(size_t channels, size_t snapshots, const DeviceContext* device);
+
+    void BuildKernel();
+    std::unique_ptr<GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+
+    size_t channels_ = 0;
+    size_t snapshots_ = 0;
+    size_t num_blocks_ = 0;         ///< ceil(channels / TILE)
+
+    OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    cl_program program_ = nullptr;
+    cl_kernel kernel_ = nullptr;
+
+    std::unique_ptr<GPUMemoryBuffer> buffer_input_;     ///< Для хостовой перегрузки
+    std::unique_ptr<GPUMemoryBuffer> buffer_output_;
+    size_t input_capacity_ = 0;
+    size_t output_capacity_ = 0;
+
+    double last_time_ms_ = 0.0;
+};
+
+} // namespace ManagerOpenCL
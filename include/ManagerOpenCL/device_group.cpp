@@ -0,0 +1,321 @@
+#include "device_group.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace ManagerOpenCL {
+
+namespace {
+
+cl_device_type ToCLDeviceType(DeviceType type) {
+    return (type == DeviceType::GPU) ? CL_DEVICE_TYPE_GPU : CL_DEVICE_TYPE_CPU;
+}
+
+std::vector<cl_device_id> QueryDevices(DeviceType type) {
+    cl_uint num_platforms = 0;
+    cl_int err = clGetPlatformIDs(0, nullptr, &num_platforms);
+    if (err != CL_SUCCESS || num_platforms == 0) {
+        throw std::runtime_error("DeviceGroup: no OpenCL platforms: " + std::to_string(err));
+    }
+
+    std::vector<cl_platform_id> platforms(num_platforms);
+    clGetPlatformIDs(num_platforms, platforms.data(), nullptr);
+
+    std::vector<cl_device_id> result;
+    for (cl_platform_id platform : platforms) {
+        cl_uint num_devices = 0;
+        err = clGetDeviceIDs(platform, ToCLDeviceType(type), 0, nullptr, &num_devices);
+        if (err != CL_SUCCESS || num_devices == 0) {
+            continue;
+        }
+        std::vector<cl_device_id> devices(num_devices);
+        clGetDeviceIDs(platform, ToCLDeviceType(type), num_devices, devices.data(), nullptr);
+        result.insert(result.end(), devices.begin(), devices.end());
+    }
+    return result;
+}
+
+std::string QueryDeviceName(cl_device_id device) {
+    size_t size = 0;
+    clGetDeviceInfo(device, CL_DEVICE_NAME, 0, nullptr, &size);
+    std::string name(size, '\0');
+    clGetDeviceInfo(device, CL_DEVICE_NAME, size, &name[0], nullptr);
+    while (!name.empty() && name.back() == '\0') {
+        name.pop_back();
+    }
+    return name;
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Фабрики
+// ════════════════════════════════════════════════════════════════════════════
+
+DeviceGroup DeviceGroup::FromAllDevices(DeviceType type, size_t max_devices) {
+    auto devices = QueryDevices(type);
+    if (devices.empty()) {
+        throw std::runtime_error("DeviceGroup: no devices of requested type");
+    }
+    if (max_devices > 0 && devices.size() > max_devices) {
+        devices.resize(max_devices);
+    }
+
+    DeviceGroup group;
+    for (cl_device_id device : devices) {
+        group.AddDevice(device);
+    }
+    group.NormalizeWeights();
+    return group;
+}
+
+DeviceGroup DeviceGroup::FromSubDevices(DeviceType type, size_t num_sub_devices) {
+    if (num_sub_devices == 0) {
+        throw std::invalid_argument("DeviceGroup: num_sub_devices must be > 0");
+    }
+
+    auto devices = QueryDevices(type);
+    if (devices.empty()) {
+        throw std::runtime_error("DeviceGroup: no devices of requested type");
+    }
+    cl_device_id parent = devices[0];
+
+    cl_uint compute_units = 0;
+    clGetDeviceInfo(parent, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_uint), &compute_units, nullptr);
+    if (compute_units < num_sub_devices) {
+        throw std::runtime_error("DeviceGroup: device has " + std::to_string(compute_units) +
+                                 " compute units, cannot split into " +
+                                 std::to_string(num_sub_devices));
+    }
+
+    cl_device_partition_property props[] = {
+        CL_DEVICE_PARTITION_EQUALLY,
+        static_cast<cl_device_partition_property>(compute_units / num_sub_devices),
+        0
+    };
+
+    cl_uint num_created = 0;
+    cl_int err = clCreateSubDevices(parent, props, 0, nullptr, &num_created);
+    if (err != CL_SUCCESS || num_created == 0) {
+        throw std::runtime_error("DeviceGroup: clCreateSubDevices failed: " + std::to_string(err));
+    }
+
+    std::vector<cl_device_id> sub_devices(num_created);
+    err = clCreateSubDevices(parent, props, num_created, sub_devices.data(), nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("DeviceGroup: clCreateSubDevices failed: " + std::to_string(err));
+    }
+
+    // Остаток от деления (compute_units % n) даёт лишнее под-устройство — отбрасываем
+    for (size_t i = num_sub_devices; i < sub_devices.size(); ++i) {
+        clReleaseDevice(sub_devices[i]);
+    }
+    sub_devices.resize(std::min<size_t>(sub_devices.size(), num_sub_devices));
+
+    DeviceGroup group;
+    group.sub_devices_ = sub_devices;
+    for (cl_device_id device : sub_devices) {
+        group.AddDevice(device);
+    }
+    group.NormalizeWeights();
+    return group;
+}
+
+void DeviceGroup::AddDevice(cl_device_id device) {
+    DeviceContext dc;
+    dc.device = device;
+    dc.index = devices_.size();
+    dc.name = QueryDeviceName(device);
+    clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_uint), &dc.compute_units, nullptr);
+
+    cl_int err = CL_SUCCESS;
+    dc.context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+    if (err != CL_SUCCESS) {
+        Release();
+        throw std::runtime_error("DeviceGroup: clCreateContext failed: " + std::to_string(err));
+    }
+
+    dc.queue = clCreateCommandQueue(dc.context, device, CL_QUEUE_PROFILING_ENABLE, &err);
+    if (err != CL_SUCCESS) {
+        clReleaseContext(dc.context);
+        Release();
+        throw std::runtime_error("DeviceGroup: clCreateCommandQueue failed: " + std::to_string(err));
+    }
+
+    devices_.push_back(dc);
+    weights_.push_back(static_cast<double>(std::max<cl_uint>(dc.compute_units, 1)));
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Жизненный цикл
+// ════════════════════════════════════════════════════════════════════════════
+
+DeviceGroup::~DeviceGroup() {
+    Release();
+}
+
+DeviceGroup::DeviceGroup(DeviceGroup&& other) noexcept
+    : devices_(std::move(other.devices_)),
+      weights_(std::move(other.weights_)),
+      sub_devices_(std::move(other.sub_devices_)) {
+    other.devices_.clear();
+    other.weights_.clear();
+    other.sub_devices_.clear();
+}
+
+DeviceGroup& DeviceGroup::operator=(DeviceGroup&& other) noexcept {
+    if (this != &other) {
+        Release();
+        devices_ = std::move(other.devices_);
+        weights_ = std::move(other.weights_);
+        sub_devices_ = std::move(other.sub_devices_);
+        other.devices_.clear();
+        other.weights_.clear();
+        other.sub_devices_.clear();
+    }
+    return *this;
+}
+
+void DeviceGroup::Release() {
+    for (auto& dc : devices_) {
+        if (dc.queue) {
+            clFinish(dc.queue);
+            clReleaseCommandQueue(dc.queue);
+        }
+        if (dc.context) {
+            clReleaseContext(dc.context);
+        }
+    }
+    devices_.clear();
+    weights_.clear();
+
+    for (cl_device_id device : sub_devices_) {
+        clReleaseDevice(device);
+    }
+    sub_devices_.clear();
+}
+
+const DeviceContext& DeviceGroup::Get(size_t index) const {
+    if (index >= devices_.size()) {
+        throw std::out_of_range("DeviceGroup::Get: index " + std::to_string(index) +
+                                " >= " + std::to_string(devices_.size()));
+    }
+    return devices_[index];
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Веса и разбиение лучей
+// ════════════════════════════════════════════════════════════════════════════
+
+void DeviceGroup::NormalizeWeights() {
+    double sum = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+    if (sum <= 0.0) {
+        std::fill(weights_.begin(), weights_.end(), 1.0 / std::max<size_t>(weights_.size(), 1));
+        return;
+    }
+    for (double& w : weights_) {
+        w /= sum;
+    }
+}
+
+void DeviceGroup::SetWeights(const std::vector<double>& weights) {
+    if (weights.size() != devices_.size()) {
+        throw std::invalid_argument("DeviceGroup::SetWeights: expected " +
+                                    std::to_string(devices_.size()) + " weights, got " +
+                                    std::to_string(weights.size()));
+    }
+    for (double w : weights) {
+        if (w < 0.0) {
+            throw std::invalid_argument("DeviceGroup::SetWeights: negative weight");
+        }
+    }
+    if (std::accumulate(weights.begin(), weights.end(), 0.0) <= 0.0) {
+        throw std::invalid_argument("DeviceGroup::SetWeights: sum of weights must be > 0");
+    }
+    weights_ = weights;
+    NormalizeWeights();
+}
+
+std::vector<BeamRange> DeviceGroup::PartitionBeams(size_t total_beams) const {
+    const size_t n = devices_.size();
+    std::vector<BeamRange> ranges(n);
+    if (n == 0) {
+        return ranges;
+    }
+
+    // Целые части + остатки; недостающие лучи — устройствам с наибольшим остатком
+    std::vector<std::pair<double, size_t>> remainders(n);
+    size_t assigned = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double exact = weights_[i] * static_cast<double>(total_beams);
+        ranges[i].count = static_cast<size_t>(exact);
+        remainders[i] = {exact - static_cast<double>(ranges[i].count), i};
+        assigned += ranges[i].count;
+    }
+
+    std::stable_sort(remainders.begin(), remainders.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t k = 0; assigned < total_beams; k = (k + 1) % n) {
+        ranges[remainders[k].second].count++;
+        assigned++;
+    }
+
+    size_t start = 0;
+    for (auto& r : ranges) {
+        r.start = start;
+        start += r.count;
+    }
+    return ranges;
+}
+
+void DeviceGroup::UpdateWeights(const std::vector<BeamRange>& ranges,
+                                const std::vector<double>& elapsed_ms,
+                                double smoothing) {
+    if (ranges.size() != devices_.size() || elapsed_ms.size() != devices_.size()) {
+        throw std::invalid_argument("DeviceGroup::UpdateWeights: size mismatch");
+    }
+    smoothing = std::clamp(smoothing, 0.0, 1.0);
+
+    // Пропускная способность (лучей/мс) только для устройств, которые работали
+    std::vector<double> throughput(devices_.size(), 0.0);
+    double measured_weight = 0.0;
+    double throughput_sum = 0.0;
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        if (ranges[i].count > 0 && elapsed_ms[i] > 0.0) {
+            throughput[i] = static_cast<double>(ranges[i].count) / elapsed_ms[i];
+            throughput_sum += throughput[i];
+            measured_weight += weights_[i];
+        }
+    }
+    if (throughput_sum <= 0.0) {
+        return;
+    }
+
+    // Доля измеренных устройств сохраняется, внутри неё — смесь старых весов и замера
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        if (throughput[i] > 0.0) {
+            double measured = measured_weight * throughput[i] / throughput_sum;
+            weights_[i] = (1.0 - smoothing) * weights_[i] + smoothing * measured;
+        }
+    }
+    NormalizeWeights();
+}
+
+std::string DeviceGroup::ToString() const {
+    std::ostringstream oss;
+    oss << "DeviceGroup (" << devices_.size() << " devices";
+    if (!sub_devices_.empty()) {
+        oss << ", sub-devices";
+    }
+    oss << ")\n";
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        oss << "  [" << i << "] " << devices_[i].name
+            << "  CU=" << devices_[i].compute_units
+            << "  weight=" << std::fixed << std::setprecision(3) << weights_[i] << "\n";
+    }
+    return oss.str();
+}
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,137 @@
+#pragma once
+
+/**
+ * @file device_group.hpp
+ * @brief Группа OpenCL устройств для распределения лучей между устройствами
+ *
+ * Каждое устройство группы получает собственный контекст и очередь
+ * (DeviceContext). Процессоры (AntennaFFTProcMax, FractionalDelayProcessor,
+ * GeneratorGPU) создаются поверх DeviceContext и не используют синглтоны.
+ *
+ * Лучи делятся пропорционально весам устройств. Начальный вес = число
+ * вычислительных блоков, далее веса уточняются по измеренной пропускной
+ * способности (лучей/мс) после каждого прогона.
+ *
+ * Для отладки на обычной Linux машине группа собирается из под-устройств
+ * одного CPU устройства (device fission, CL_DEVICE_PARTITION_EQUALLY) — PoCL
+ * это поддерживает.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "opencl_core.hpp"
+#include <CL/cl.h>
+#include <string>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: DeviceContext - ресурсы одного устройства группы
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @struct DeviceContext
+ * @brief Контекст, устройство и очередь (владелец — DeviceGroup)
+ */
+struct DeviceContext {
+    cl_context context = nullptr;
+    cl_device_id device = nullptr;
+    cl_command_queue queue = nullptr;   ///< In-order очередь с профилированием
+    std::string name;
+    cl_uint compute_units = 0;
+    size_t index = 0;                   ///< Позиция в группе
+
+    bool IsValid() const { return context && device && queue; }
+};
+
+/**
+ * @struct BeamRange
+ * @brief Непрерывный диапазон лучей, назначенный одному устройству
+ */
+struct BeamRange {
+    size_t start = 0;
+    size_t count = 0;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: DeviceGroup
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class DeviceGroup
+ * @brief Набор устройств с весами для деления лучей
+ *
+ * @code
+ * auto group = DeviceGroup::FromSubDevices(DeviceType::CPU, 2);
+ * auto ranges = group.PartitionBeams(256);   // {0..k}, {k..256}
+ * // ... прогон на каждом устройстве, замер времени ...
+ * group.UpdateWeights(ranges, elapsed_ms);
+ * @endcode
+ */
+class DeviceGroup {
+public:
+    /**
+     * @brief Все устройства заданного типа на всех платформах
+     * @param max_devices Ограничение количества (0 = без ограничения)
+     * @throws std::runtime_error если устройств не найдено
+     */
+    static DeviceGroup FromAllDevices(DeviceType type = DeviceType::GPU, size_t max_devices = 0);
+
+    /**
+     * @brief Под-устройства первого устройства заданного типа (device fission)
+     *
+     * Вычислительные блоки делятся поровну на num_sub_devices частей.
+     * @throws std::runtime_error если разбиение не поддерживается
+     */
+    static DeviceGroup FromSubDevices(DeviceType type = DeviceType::CPU, size_t num_sub_devices = 2);
+
+    ~DeviceGroup();
+
+    DeviceGroup(DeviceGroup&& other) noexcept;
+    DeviceGroup& operator=(DeviceGroup&& other) noexcept;
+    DeviceGroup(const DeviceGroup&) = delete;
+    DeviceGroup& operator=(const DeviceGroup&) = delete;
+
+    size_t Size() const { return devices_.size(); }
+    const DeviceContext& Get(size_t index) const;
+    const std::vector<DeviceContext>& GetDevices() const { return devices_; }
+
+    /**
+     * @brief Разбить total_beams лучей пропорционально весам
+     *
+     * Метод наибольших остатков: сумма count == total_beams, диапазоны идут
+     * подряд в порядке устройств. Устройство может получить 0 лучей.
+     */
+    std::vector<BeamRange> PartitionBeams(size_t total_beams) const;
+
+    /// Задать веса вручную (размер == Size(), все >= 0, сумма > 0)
+    void SetWeights(const std::vector<double>& weights);
+    const std::vector<double>& GetWeights() const { return weights_; }
+
+    /**
+     * @brief Обновить веса по измеренной пропускной способности
+     *
+     * weight = (1 - smoothing) * weight + smoothing * (beams / elapsed_ms),
+     * обе части нормированы на сумму. Устройства без лучей не обновляются.
+     */
+    void UpdateWeights(const std::vector<BeamRange>& ranges,
+                       const std::vector<double>& elapsed_ms,
+                       double smoothing = 0.5);
+
+    std::string ToString() const;
+
+private:
+    DeviceGroup() = default;
+
+    void AddDevice(cl_device_id device);
+    void Release();
+    void NormalizeWeights();
+
+    std::vector<DeviceContext> devices_;
+    std::vector<double> weights_;
+    std::vector<cl_device_id> sub_devices_;   ///< Освобождаются через clReleaseDevice
+};
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,1006 @@
+#include "hermitian_inverter.hpp"
+#include "opencl_compute_engine.hpp"
+#include "opencl_core.hpp"
+#include "command_queue_pool.hpp"
+#include "matrix_csv.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace ManagerOpenCL {
+
+namespace {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ядра: row-major матрицы padded_n × padded_n, группы TILE × TILE,
+// get_global_id(2) — номер матрицы в пакете
+// ════════════════════════════════════════════════════════════════════════════
+
+const char* kHermitianKernelSource = R"CL(
+#define TILE 16
+#define SOLVE_WG 64
+
+inline float2 cmul(float2 a, float2 b) {
+    return (float2)(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// a * conj(b)
+inline float2 cmul_conj(float2 a, float2 b) {
+    return (float2)(a.x * b.x + a.y * b.y, a.y * b.x - a.x * b.y);
+}
+
+// conj(a) * b
+inline float2 cconj_mul(float2 a, float2 b) {
+    return (float2)(a.x * b.x + a.y * b.y, a.x * b.y - a.y * b.x);
+}
+
+// n × n → np × np, дополнение единичной матрицей
+__kernel void herm_pack(__global const float2* input, __global float2* work, uint n, uint np) {
+    uint j = get_global_id(0);
+    uint i = get_global_id(1);
+    size_t m = get_global_id(2);
+
+    float2 v = (float2)(i == j ? 1.0f : 0.0f, 0.0f);
+    if (i < n && j < n) v = input[m * n * n + (size_t)i * n + j];
+    work[m * np * np + (size_t)i * np + j] = v;
+}
+
+// Cholesky диагонального блока k (одна группа на матрицу)
+__kernel void chol_diag(__global float2* A, __global int* info, uint np, uint k) {
+    __local float2 T[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    size_t m = get_global_id(2);
+    __global float2* a = A + m * np * np + (size_t)(k * TILE) * np + k * TILE;
+
+    T[ly][lx] = a[(size_t)ly * np + lx];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint j = 0; j < TILE; ++j) {
+        if (lx == j && ly == j) {
+            float d = T[j][j].x;
+            // !(d > 0) ловит и NaN из предыдущих блоков
+            if (!(d > 0.0f) && info[m] == 0) info[m] = (int)(k * TILE + j + 1);
+            T[j][j] = (float2)(sqrt(d), 0.0f);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (lx == j && ly > j) T[ly][j] = T[ly][j] / T[j][j].x;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (lx > j && ly >= lx) T[ly][lx] -= cmul_conj(T[ly][j], T[lx][j]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    a[(size_t)ly * np + lx] = ly >= lx ? T[ly][lx] : (float2)(0.0f, 0.0f);
+}
+
+// Панель: L_ik = A_ik L_kk^{-H}, группа на блок i > k
+__kernel void chol_panel(__global float2* A, uint np, uint k) {
+    __local float2 Lt[TILE][TILE + 1];
+    __local float2 Bt[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint bi = k + 1 + get_group_id(1);
+    __global float2* a = A + get_global_id(2) * np * np;
+    __global float2* b = a + (size_t)(bi * TILE + ly) * np + k * TILE + lx;
+
+    Lt[ly][lx] = a[(size_t)(k * TILE + ly) * np + k * TILE + lx];
+    Bt[ly][lx] = *b;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint c = 0; c < TILE; ++c) {
+        if (lx == c) Bt[ly][c] = Bt[ly][c] / Lt[c][c].x;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (lx > c) Bt[ly][lx] -= cmul_conj(Bt[ly][c], Lt[lx][c]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    *b = Bt[ly][lx];
+}
+
+// Хвост: A_ij -= L_ik L_jk^H для k < j <= i
+__kernel void chol_update(__global float2* A, uint np, uint k) {
+    __local float2 Li[TILE][TILE + 1];
+    __local float2 Lj[TILE][TILE + 1];
+    uint bj = k + 1 + get_group_id(0);
+    uint bi = k + 1 + get_group_id(1);
+    if (bj > bi) return;  // одинаково для всей группы
+
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    __global float2* a = A + get_global_id(2) * np * np;
+
+    Li[ly][lx] = a[(size_t)(bi * TILE + ly) * np + k * TILE + lx];
+    Lj[ly][lx] = a[(size_t)(bj * TILE + ly) * np + k * TILE + lx];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    float2 acc = (float2)(0.0f, 0.0f);
+    for (uint c = 0; c < TILE; ++c) acc += cmul_conj(Li[ly][c], Lj[lx][c]);
+    a[(size_t)(bi * TILE + ly) * np + bj * TILE + lx] -= acc;
+}
+
+// W_bb = L_bb^{-1} для всех диагональных блоков (прямая подстановка по строкам)
+__kernel void trtri_diag(__global const float2* L, __global float2* W, uint np) {
+    __local float2 Lt[TILE][TILE + 1];
+    __local float2 Wt[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint bb = get_group_id(1);
+    size_t offset = get_global_id(2) * np * np + (size_t)(bb * TILE) * np + bb * TILE;
+
+    Lt[ly][lx] = L[offset + (size_t)ly * np + lx];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint r = 0; r < TILE; ++r) {
+        if (ly == r) {
+            float2 s = (float2)(r == lx ? 1.0f : 0.0f, 0.0f);
+            for (uint c = 0; c < r; ++c) s -= cmul(Lt[r][c], Wt[c][lx]);
+            Wt[r][lx] = s / Lt[r][r].x;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    W[offset + (size_t)ly * np + lx] = Wt[ly][lx];
+}
+
+// Блочная диагональ d: W_ij = -W_ii Σ_{k=j}^{i-1} L_ik W_kj, i = j + d
+__kernel void trtri_offdiag(__global const float2* L, __global float2* W, uint np, uint d) {
+    __local float2 At[TILE][TILE + 1];
+    __local float2 Bt[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint bj = get_group_id(1);
+    uint bi = bj + d;
+    size_t m = get_global_id(2) * np * np;
+
+    float2 acc = (float2)(0.0f, 0.0f);
+    for (uint bk = bj; bk < bi; ++bk) {
+        At[ly][lx] = L[m + (size_t)(bi * TILE + ly) * np + bk * TILE + lx];
+        Bt[ly][lx] = W[m + (size_t)(bk * TILE + ly) * np + bj * TILE + lx];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint c = 0; c < TILE; ++c) acc += cmul(At[ly][c], Bt[c][lx]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    At[ly][lx] = acc;
+    Bt[ly][lx] = W[m + (size_t)(bi * TILE + ly) * np + bi * TILE + lx];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    float2 r = (float2)(0.0f, 0.0f);
+    for (uint c = 0; c < TILE; ++c) r += cmul(Bt[ly][c], At[c][lx]);
+    W[m + (size_t)(bi * TILE + ly) * np + bj * TILE + lx] = -r;
+}
+
+// A^{-1} = W^H W, выход n × n
+__kernel void herm_product(__global const float2* W, __global float2* output, uint n, uint np) {
+    __local float2 At[TILE][TILE + 1];
+    __local float2 Bt[TILE][TILE + 1];
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint bj = get_group_id(0);
+    uint bi = get_group_id(1);
+    uint nb = np / TILE;
+    size_t m = get_global_id(2);
+    __global const float2* w = W + m * np * np;
+
+    float2 acc = (float2)(0.0f, 0.0f);
+    for (uint bk = max(bi, bj); bk < nb; ++bk) {
+        At[ly][lx] = w[(size_t)(bk * TILE + ly) * np + bi * TILE + lx];
+        Bt[ly][lx] = w[(size_t)(bk * TILE + ly) * np + bj * TILE + lx];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint c = 0; c < TILE; ++c) acc += cconj_mul(At[c][ly], Bt[c][lx]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    uint i = bi * TILE + ly;
+    uint j = bj * TILE + lx;
+    if (i < n && j < n) output[m * n * n + (size_t)i * n + j] = acc;
+}
+
+// x = A^{-1} b по L из chol_*: группа SOLVE_WG на (правая часть, матрица),
+// x — n float2 в local memory. normalize != 0: x / (b^H x) — MVDR веса
+__kernel void chol_solve(__global const float2* L, __global const float2* rhs, __global float2* output,
+                         __local float2* x, uint n, uint np, uint rhs_stride, uint normalize) {
+    __local float2 red[SOLVE_WG];
+    uint lid = get_local_id(0);
+    uint r = get_group_id(1);
+    uint num_rhs = get_num_groups(1);
+    size_t m = get_global_id(2);
+    __global const float2* l = L + m * np * np;
+    __global const float2* b = rhs + m * rhs_stride + (size_t)r * n;
+
+    for (uint i = lid; i < n; i += SOLVE_WG) x[i] = b[i];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // L y = b по строкам: строка L читается подряд, сумма — редукцией в группе
+    for (uint i = 0; i < n; ++i) {
+        float2 s = (float2)(0.0f, 0.0f);
+        for (uint k = lid; k < i; k += SOLVE_WG) s += cmul(l[(size_t)i * np + k], x[k]);
+        red[lid] = s;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint h = SOLVE_WG / 2; h > 0; h >>= 1) {
+            if (lid < h) red[lid] += red[lid + h];
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+        if (lid == 0) x[i] = (x[i] - red[0]) / l[(size_t)i * np + i].x;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // L^H x = y по столбцам L^H (= строкам L): x_i готов, вычесть из x_k, k < i
+    for (uint i = n; i-- > 0;) {
+        float2 xi = x[i] / l[(size_t)i * np + i].x;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint k = lid; k < i; k += SOLVE_WG) x[k] -= cconj_mul(l[(size_t)i * np + k], xi);
+        if (lid == 0) x[i] = xi;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    float scale = 1.0f;
+    if (normalize) {
+        // b^H R^{-1} b вещественно для эрмитовой R
+        float2 s = (float2)(0.0f, 0.0f);
+        for (uint k = lid; k < n; k += SOLVE_WG) s += cconj_mul(b[k], x[k]);
+        red[lid] = s;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint h = SOLVE_WG / 2; h > 0; h >>= 1) {
+            if (lid < h) red[lid] += red[lid + h];
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+        scale = 1.0f / red[0].x;
+    }
+
+    __global float2* out = output + (m * num_rhs + r) * n;
+    for (uint i = lid; i < n; i += SOLVE_WG) out[i] = x[i] * scale;
+}
+
+// ── Итерационное уточнение ──────────────────────────────────────────────────
+// float-float: значение hi + lo, |lo| <= ulp(hi) / 2. Без сжатия в fma —
+// ошибки округления two_sum должны вычисляться точно
+#pragma OPENCL FP_CONTRACT OFF
+
+inline float2 ff_two_sum(float a, float b) {
+    float s = a + b;
+    float bb = s - a;
+    return (float2)(s, (a - (s - bb)) + (b - bb));
+}
+
+inline float2 ff_add(float2 a, float2 b) {
+    float2 s = ff_two_sum(a.x, b.x);
+    float lo = s.y + a.y + b.y;
+    float hi = s.x + lo;
+    return (float2)(hi, lo - (hi - s.x));
+}
+
+// a * b точно: p + fma(a, b, -p)
+inline float2 ff_prod(float a, float b) {
+    float p = a * b;
+    return (float2)(p, fma(a, b, -p));
+}
+
+// acc2 — комплексный аккумулятор повышенной точности
+#ifdef HAS_FP64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+typedef double2 acc2;
+
+inline acc2 acc_zero(void) { return (acc2)(0.0, 0.0); }
+
+// s + a * (xh + xl); произведение float на float точно в double
+inline acc2 acc_mad(acc2 s, float2 a, float2 xh, float2 xl) {
+    double2 x = convert_double2(xh) + convert_double2(xl);
+    double2 ad = convert_double2(a);
+    return s + (double2)(ad.x * x.x - ad.y * x.y, ad.x * x.y + ad.y * x.x);
+}
+
+inline acc2 acc_add(acc2 a, acc2 b) { return a + b; }
+inline acc2 acc_sub_from(float2 b, acc2 s) { return convert_double2(b) - s; }
+inline float2 acc_round(acc2 s) { return convert_float2(s); }
+#else
+typedef float4 acc2;   // (re.hi, re.lo, im.hi, im.lo)
+
+inline acc2 acc_zero(void) { return (acc2)(0.0f); }
+
+inline acc2 acc_mad(acc2 s, float2 a, float2 xh, float2 xl) {
+    float2 re = ff_add(s.xy, ff_prod(a.x, xh.x));
+    re = ff_add(re, ff_prod(-a.y, xh.y));
+    re = ff_add(re, (float2)(a.x * xl.x - a.y * xl.y, 0.0f));
+    float2 im = ff_add(s.zw, ff_prod(a.x, xh.y));
+    im = ff_add(im, ff_prod(a.y, xh.x));
+    im = ff_add(im, (float2)(a.x * xl.y + a.y * xl.x, 0.0f));
+    return (acc2)(re, im);
+}
+
+inline acc2 acc_add(acc2 a, acc2 b) { return (acc2)(ff_add(a.xy, b.xy), ff_add(a.zw, b.zw)); }
+inline acc2 acc_sub_from(float2 b, acc2 s) {
+    return (acc2)(ff_add((float2)(b.x, 0.0f), -s.xy), ff_add((float2)(b.y, 0.0f), -s.zw));
+}
+inline float2 acc_round(acc2 s) { return (float2)(s.x + s.y, s.z + s.w); }
+#endif
+
+// r = b - A (x_hi + x_lo) по исходным n × n матрицам: группа SOLVE_WG на (правая часть, матрица),
+// строка A — редукцией в группе. norms: (max|r|, max|x|, max|b|, ||A||_inf)
+__kernel void refine_residual(__global const float2* A, __global const float2* rhs,
+                              __global const float2* x_hi, __global const float2* x_lo,
+                              __global float2* residual, __global float4* norms, uint n, uint rhs_stride) {
+    __local acc2 red[SOLVE_WG];
+    __local float red_abs[SOLVE_WG];
+    uint lid = get_local_id(0);
+    uint r = get_group_id(1);
+    uint num_rhs = get_num_groups(1);
+    size_t m = get_global_id(2);
+    __global const float2* a = A + m * n * n;
+    __global const float2* b = rhs + m * rhs_stride + (size_t)r * n;
+    size_t offset = (m * num_rhs + r) * n;
+    __global const float2* xh = x_hi + offset;
+    __global const float2* xl = x_lo + offset;
+
+    float r_max = 0.0f, a_norm = 0.0f;
+    for (uint i = 0; i < n; ++i) {
+        acc2 s = acc_zero();
+        float row = 0.0f;
+        for (uint k = lid; k < n; k += SOLVE_WG) {
+            float2 aik = a[(size_t)i * n + k];
+            s = acc_mad(s, aik, xh[k], xl[k]);
+            row += length(aik);
+        }
+        red[lid] = s;
+        red_abs[lid] = row;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint h = SOLVE_WG / 2; h > 0; h >>= 1) {
+            if (lid < h) {
+                red[lid] = acc_add(red[lid], red[lid + h]);
+                red_abs[lid] += red_abs[lid + h];
+            }
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+        if (lid == 0) {
+            float2 ri = acc_round(acc_sub_from(b[i], red[0]));
+            residual[offset + i] = ri;
+            r_max = fmax(r_max, length(ri));
+            a_norm = fmax(a_norm, red_abs[0]);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // max|x|, max|b|: две редукции максимума
+    float x_max = 0.0f, b_max = 0.0f;
+    for (uint k = lid; k < n; k += SOLVE_WG) {
+        x_max = fmax(x_max, length(xh[k]));
+        b_max = fmax(b_max, length(b[k]));
+    }
+    red_abs[lid] = x_max;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint h = SOLVE_WG / 2; h > 0; h >>= 1) {
+        if (lid < h) red_abs[lid] = fmax(red_abs[lid], red_abs[lid + h]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    x_max = red_abs[0];
+    barrier(CLK_LOCAL_MEM_FENCE);
+    red_abs[lid] = b_max;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint h = SOLVE_WG / 2; h > 0; h >>= 1) {
+        if (lid < h) red_abs[lid] = fmax(red_abs[lid], red_abs[lid + h]);
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lid == 0) norms[m * num_rhs + r] = (float4)(r_max, x_max, red_abs[0], a_norm);
+}
+
+// (x_hi, x_lo) += d покомпонентно в float-float
+__kernel void refine_update(__global float2* x_hi, __global float2* x_lo, __global const float2* d, uint count) {
+    uint i = get_global_id(0);
+    if (i >= count) return;
+    float2 h = x_hi[i], l = x_lo[i], c = d[i];
+    float2 re = ff_add((float2)(h.x, l.x), (float2)(c.x, 0.0f));
+    float2 im = ff_add((float2)(h.y, l.y), (float2)(c.y, 0.0f));
+    x_hi[i] = (float2)(re.x, im.x);
+    x_lo[i] = (float2)(re.y, im.y);
+}
+)CL";
+
+cl_kernel CreateKernel(cl_program program, const char* name) {
+    cl_int err = CL_SUCCESS;
+    cl_kernel kernel = clCreateKernel(program, name, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error(std::string("Failed to create ") + name + " kernel: " + std::to_string(err));
+    }
+    return kernel;
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+HermitianInverter::HermitianInverter(size_t n)
+    : HermitianInverter(n, static_cast<const DeviceContext*>(nullptr)) {
+}
+
+HermitianInverter::HermitianInverter(size_t n, const DeviceContext& device)
+    : HermitianInverter(n, &device) {
+}
+
+HermitianInverter::HermitianInverter(size_t n, const DeviceContext* device)
+    : n_(n) {
+    if (n_ == 0) {
+        throw std::invalid_argument("HermitianInverter: matrix size must be > 0");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("HermitianInverter: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &OpenCLComputeEngine::GetInstance();
+        auto& core = OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = CommandQueuePool::GetNextQueue();
+    }
+
+    padded_n_ = (n_ + TILE - 1) / TILE * TILE;
+    num_blocks_ = padded_n_ / TILE;
+
+    BuildKernels();
+    EnsureCapacity(1);
+}
+
+HermitianInverter::~HermitianInverter() {
+    for (cl_kernel kernel : {pack_kernel_, diag_kernel_, panel_kernel_, update_kernel_,
+                             trtri_diag_kernel_, trtri_offdiag_kernel_, product_kernel_, solve_kernel_,
+                             residual_kernel_, refine_update_kernel_}) {
+        if (kernel) clReleaseKernel(kernel);
+    }
+    if (program_) clReleaseProgram(program_);
+}
+
+std::unique_ptr<GPUMemoryBuffer> HermitianInverter::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<GPUMemoryBuffer>(context_, queue_, num_elements, MemoryType::GPU_READ_WRITE);
+}
+
+void HermitianInverter::BuildKernels() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kHermitianKernelSource;
+    size_t src_len = std::char_traits<char>::length(kHermitianKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create hermitian program: " + std::to_string(err));
+    }
+
+    // Невязка уточнения в double, если устройство его поддерживает
+    cl_device_fp_config fp64_config = 0;
+    if (clGetDeviceInfo(device_, CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(fp64_config), &fp64_config, nullptr) ==
+        CL_SUCCESS) {
+        has_fp64_ = fp64_config != 0;
+    }
+    const char* options = has_fp64_ ? "-DHAS_FP64" : nullptr;
+
+    err = clBuildProgram(program_, 1, &device_, options, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "Hermitian kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build hermitian program: " + std::to_string(err));
+    }
+
+    pack_kernel_ = CreateKernel(program_, "herm_pack");
+    diag_kernel_ = CreateKernel(program_, "chol_diag");
+    panel_kernel_ = CreateKernel(program_, "chol_panel");
+    update_kernel_ = CreateKernel(program_, "chol_update");
+    trtri_diag_kernel_ = CreateKernel(program_, "trtri_diag");
+    trtri_offdiag_kernel_ = CreateKernel(program_, "trtri_offdiag");
+    product_kernel_ = CreateKernel(program_, "herm_product");
+    solve_kernel_ = CreateKernel(program_, "chol_solve");
+    residual_kernel_ = CreateKernel(program_, "refine_residual");
+    refine_update_kernel_ = CreateKernel(program_, "refine_update");
+}
+
+void HermitianInverter::EnsureCapacity(size_t batch_count) {
+    if (batch_count <= capacity_) return;
+    const size_t matrix_elements = padded_n_ * padded_n_;
+    buffer_factor_ = CreateBuffer(batch_count * matrix_elements);
+    buffer_inverse_ = CreateBuffer(batch_count * matrix_elements);
+    // int на матрицу, буфер в элементах complex<float>
+    buffer_info_ = CreateBuffer((batch_count + 1) / 2);
+    capacity_ = batch_count;
+}
+
+void HermitianInverter::EnsureBuffer(std::unique_ptr<GPUMemoryBuffer>& buffer, size_t& capacity,
+                                     size_t elements) {
+    if (capacity >= elements) return;
+    buffer = CreateBuffer(elements);
+    capacity = elements;
+}
+
+void HermitianInverter::Upload(cl_mem buffer, const std::vector<std::complex<float>>& data) {
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer, CL_FALSE, 0, data.size() * sizeof(std::complex<float>),
+                                      data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (hermitian) failed: " + std::to_string(err));
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Запуски
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianInverter::Launch(cl_kernel kernel, size_t groups_x, size_t groups_y, size_t batch_count,
+                               std::vector<cl_event>& events) {
+    size_t global[3] = {groups_x * TILE, groups_y * TILE, batch_count};
+    size_t local[3] = {TILE, TILE, 1};
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue_, kernel, 3, nullptr, global, local, 0, nullptr, &event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (hermitian) failed: " + std::to_string(err));
+    }
+    events.push_back(event);
+}
+
+double HermitianInverter::SumEventsMs(std::vector<cl_event>& events) {
+    double total = 0.0;
+    for (cl_event event : events) {
+        cl_ulong start = 0, end = 0;
+        if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) == CL_SUCCESS &&
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) == CL_SUCCESS &&
+            end >= start) {
+            total += (end - start) * 1e-6;
+        }
+        clReleaseEvent(event);
+    }
+    events.clear();
+    return total;
+}
+
+void HermitianInverter::EnqueueFactor(cl_mem input, size_t batch_count, std::vector<cl_event>& events) {
+    cl_mem work = buffer_factor_->Get();
+    cl_mem info = buffer_info_->Get();
+    cl_uint n = static_cast<cl_uint>(n_);
+    cl_uint np = static_cast<cl_uint>(padded_n_);
+
+    cl_int zero = 0;
+    cl_int err = clEnqueueFillBuffer(queue_, info, &zero, sizeof(zero), 0, batch_count * sizeof(cl_int),
+                                     0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueFillBuffer (hermitian info) failed: " + std::to_string(err));
+    }
+
+    clSetKernelArg(pack_kernel_, 0, sizeof(cl_mem), &input);
+    clSetKernelArg(pack_kernel_, 1, sizeof(cl_mem), &work);
+    clSetKernelArg(pack_kernel_, 2, sizeof(cl_uint), &n);
+    clSetKernelArg(pack_kernel_, 3, sizeof(cl_uint), &np);
+    Launch(pack_kernel_, num_blocks_, num_blocks_, batch_count, events);
+
+    clSetKernelArg(diag_kernel_, 0, sizeof(cl_mem), &work);
+    clSetKernelArg(diag_kernel_, 1, sizeof(cl_mem), &info);
+    clSetKernelArg(diag_kernel_, 2, sizeof(cl_uint), &np);
+    clSetKernelArg(panel_kernel_, 0, sizeof(cl_mem), &work);
+    clSetKernelArg(panel_kernel_, 1, sizeof(cl_uint), &np);
+    clSetKernelArg(update_kernel_, 0, sizeof(cl_mem), &work);
+    clSetKernelArg(update_kernel_, 1, sizeof(cl_uint), &np);
+
+    for (size_t k = 0; k < num_blocks_; ++k) {
+        cl_uint kb = static_cast<cl_uint>(k);
+        clSetKernelArg(diag_kernel_, 3, sizeof(cl_uint), &kb);
+        Launch(diag_kernel_, 1, 1, batch_count, events);
+
+        const size_t tail = num_blocks_ - k - 1;
+        if (tail == 0) break;
+        clSetKernelArg(panel_kernel_, 2, sizeof(cl_uint), &kb);
+        Launch(panel_kernel_, 1, tail, batch_count, events);
+        clSetKernelArg(update_kernel_, 2, sizeof(cl_uint), &kb);
+        Launch(update_kernel_, tail, tail, batch_count, events);
+    }
+}
+
+void HermitianInverter::EnqueueTriangularInverse(size_t batch_count, std::vector<cl_event>& events) {
+    cl_mem factor = buffer_factor_->Get();
+    cl_mem inverse = buffer_inverse_->Get();
+    cl_uint np = static_cast<cl_uint>(padded_n_);
+
+    clSetKernelArg(trtri_diag_kernel_, 0, sizeof(cl_mem), &factor);
+    clSetKernelArg(trtri_diag_kernel_, 1, sizeof(cl_mem), &inverse);
+    clSetKernelArg(trtri_diag_kernel_, 2, sizeof(cl_uint), &np);
+    Launch(trtri_diag_kernel_, 1, num_blocks_, batch_count, events);
+
+    clSetKernelArg(trtri_offdiag_kernel_, 0, sizeof(cl_mem), &factor);
+    clSetKernelArg(trtri_offdiag_kernel_, 1, sizeof(cl_mem), &inverse);
+    clSetKernelArg(trtri_offdiag_kernel_, 2, sizeof(cl_uint), &np);
+    for (size_t d = 1; d < num_blocks_; ++d) {
+        cl_uint distance = static_cast<cl_uint>(d);
+        clSetKernelArg(trtri_offdiag_kernel_, 3, sizeof(cl_uint), &distance);
+        Launch(trtri_offdiag_kernel_, 1, num_blocks_ - d, batch_count, events);
+    }
+}
+
+void HermitianInverter::EnqueueProduct(cl_mem output, size_t batch_count, std::vector<cl_event>& events) {
+    cl_mem inverse = buffer_inverse_->Get();
+    cl_uint n = static_cast<cl_uint>(n_);
+    cl_uint np = static_cast<cl_uint>(padded_n_);
+
+    clSetKernelArg(product_kernel_, 0, sizeof(cl_mem), &inverse);
+    clSetKernelArg(product_kernel_, 1, sizeof(cl_mem), &output);
+    clSetKernelArg(product_kernel_, 2, sizeof(cl_uint), &n);
+    clSetKernelArg(product_kernel_, 3, sizeof(cl_uint), &np);
+    Launch(product_kernel_, num_blocks_, num_blocks_, batch_count, events);
+}
+
+void HermitianInverter::EnqueueSolve(cl_mem rhs, size_t rhs_stride, cl_mem output, size_t num_rhs,
+                                     size_t batch_count, bool normalize, std::vector<cl_event>& events) {
+    cl_mem factor = buffer_factor_->Get();
+    cl_uint n = static_cast<cl_uint>(n_);
+    cl_uint np = static_cast<cl_uint>(padded_n_);
+    cl_uint stride = static_cast<cl_uint>(rhs_stride);
+    cl_uint norm = normalize ? 1u : 0u;
+
+    clSetKernelArg(solve_kernel_, 0, sizeof(cl_mem), &factor);
+    clSetKernelArg(solve_kernel_, 1, sizeof(cl_mem), &rhs);
+    clSetKernelArg(solve_kernel_, 2, sizeof(cl_mem), &output);
+    clSetKernelArg(solve_kernel_, 3, n_ * sizeof(std::complex<float>), nullptr);
+    clSetKernelArg(solve_kernel_, 4, sizeof(cl_uint), &n);
+    clSetKernelArg(solve_kernel_, 5, sizeof(cl_uint), &np);
+    clSetKernelArg(solve_kernel_, 6, sizeof(cl_uint), &stride);
+    clSetKernelArg(solve_kernel_, 7, sizeof(cl_uint), &norm);
+
+    size_t global[3] = {SOLVE_WG, num_rhs, batch_count};
+    size_t local[3] = {SOLVE_WG, 1, 1};
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue_, solve_kernel_, 3, nullptr, global, local, 0, nullptr, &event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (chol_solve) failed: " + std::to_string(err));
+    }
+    events.push_back(event);
+}
+
+double HermitianInverter::EnqueueResidual(cl_mem matrices, cl_mem rhs, cl_mem solution_hi, cl_mem solution_lo,
+                                          size_t num_rhs, size_t batch_count, std::vector<cl_event>& events) {
+    cl_mem residual = buffer_residual_->Get();
+    cl_mem norms = buffer_norms_->Get();
+    cl_uint n = static_cast<cl_uint>(n_);
+    cl_uint stride = static_cast<cl_uint>(num_rhs * n_);
+
+    clSetKernelArg(residual_kernel_, 0, sizeof(cl_mem), &matrices);
+    clSetKernelArg(residual_kernel_, 1, sizeof(cl_mem), &rhs);
+    clSetKernelArg(residual_kernel_, 2, sizeof(cl_mem), &solution_hi);
+    clSetKernelArg(residual_kernel_, 3, sizeof(cl_mem), &solution_lo);
+    clSetKernelArg(residual_kernel_, 4, sizeof(cl_mem), &residual);
+    clSetKernelArg(residual_kernel_, 5, sizeof(cl_mem), &norms);
+    clSetKernelArg(residual_kernel_, 6, sizeof(cl_uint), &n);
+    clSetKernelArg(residual_kernel_, 7, sizeof(cl_uint), &stride);
+
+    size_t global[3] = {SOLVE_WG, num_rhs, batch_count};
+    size_t local[3] = {SOLVE_WG, 1, 1};
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue_, residual_kernel_, 3, nullptr, global, local, 0, nullptr, &event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (refine_residual) failed: " + std::to_string(err));
+    }
+    events.push_back(event);
+
+    // (max|r|, max|x|, max|b|, ||A||_inf) на (матрица, правая часть)
+    std::vector<cl_float4> values(batch_count * num_rhs);
+    err = clEnqueueReadBuffer(queue_, norms, CL_TRUE, 0, values.size() * sizeof(cl_float4), values.data(),
+                              0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (refine norms) failed: " + std::to_string(err));
+    }
+    double worst = 0.0;
+    for (const cl_float4& v : values) {
+        const double denom = static_cast<double>(v.s[3]) * v.s[1] + v.s[2];
+        if (denom > 0.0) worst = std::max(worst, v.s[0] / denom);
+    }
+    return worst;
+}
+
+void HermitianInverter::EnqueueRefineUpdate(cl_mem solution_hi, cl_mem solution_lo, size_t count,
+                                            std::vector<cl_event>& events) {
+    cl_mem correction = buffer_correction_->Get();
+    cl_uint total = static_cast<cl_uint>(count);
+
+    clSetKernelArg(refine_update_kernel_, 0, sizeof(cl_mem), &solution_hi);
+    clSetKernelArg(refine_update_kernel_, 1, sizeof(cl_mem), &solution_lo);
+    clSetKernelArg(refine_update_kernel_, 2, sizeof(cl_mem), &correction);
+    clSetKernelArg(refine_update_kernel_, 3, sizeof(cl_uint), &total);
+
+    size_t global = (count + SOLVE_WG - 1) / SOLVE_WG * SOLVE_WG;
+    size_t local = SOLVE_WG;
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue_, refine_update_kernel_, 1, nullptr, &global, &local,
+                                        0, nullptr, &event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (refine_update) failed: " + std::to_string(err));
+    }
+    events.push_back(event);
+}
+
+void HermitianInverter::CheckInfo(size_t batch_count) {
+    std::vector<cl_int> info(batch_count, 0);
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_info_->Get(), CL_TRUE, 0, batch_count * sizeof(cl_int),
+                                     info.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (hermitian info) failed: " + std::to_string(err));
+    }
+    for (size_t m = 0; m < batch_count; ++m) {
+        if (info[m] != 0) {
+            throw std::runtime_error("HermitianInverter: matrix " + std::to_string(m) +
+                                     " is not positive definite (column " + std::to_string(info[m] - 1) + ")");
+        }
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Обращение
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianInverter::InvertBatched(cl_mem input, cl_mem output, size_t batch_count) {
+    if (input == nullptr || output == nullptr || batch_count == 0) {
+        throw std::invalid_argument("HermitianInverter::InvertBatched: null buffer or empty batch");
+    }
+    EnsureCapacity(batch_count);
+
+    std::vector<cl_event> factor_events, invert_events, product_events;
+    // input читается только в herm_pack, поэтому output может совпадать с input
+    EnqueueFactor(input, batch_count, factor_events);
+    EnqueueTriangularInverse(batch_count, invert_events);
+    EnqueueProduct(output, batch_count, product_events);
+
+    cl_int err = clFinish(queue_);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clFinish (hermitian) failed: " + std::to_string(err));
+    }
+
+    last_stats_ = HermitianInverseStats{};
+    last_stats_.batch_count = batch_count;
+    last_stats_.factor_ms = SumEventsMs(factor_events);
+    last_stats_.invert_ms = SumEventsMs(invert_events);
+    last_stats_.product_ms = SumEventsMs(product_events);
+    last_stats_.total_ms = last_stats_.factor_ms + last_stats_.invert_ms + last_stats_.product_ms;
+
+    CheckInfo(batch_count);
+}
+
+std::vector<std::complex<float>> HermitianInverter::InvertBatched(
+    const std::vector<std::complex<float>>& matrices, size_t batch_count) {
+    const size_t expected = batch_count * n_ * n_;
+    if (batch_count == 0 || matrices.size() != expected) {
+        throw std::invalid_argument("HermitianInverter::InvertBatched: expected " + std::to_string(expected) +
+                                    " elements, got " + std::to_string(matrices.size()));
+    }
+
+    EnsureBuffer(buffer_io_, io_capacity_, expected);
+    Upload(buffer_io_->Get(), matrices);
+
+    InvertBatched(buffer_io_->Get(), buffer_io_->Get(), batch_count);
+
+    std::vector<std::complex<float>> inverse(expected);
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_io_->Get(), CL_TRUE, 0,
+                              expected * sizeof(std::complex<float>), inverse.data(),
+                              0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (hermitian) failed: " + std::to_string(err));
+    }
+    return inverse;
+}
+
+std::vector<std::complex<float>> HermitianInverter::Invert(const std::vector<std::complex<float>>& matrix) {
+    return InvertBatched(matrix, 1);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Решение без обращения (MVDR)
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianInverter::RunSolve(cl_mem matrices, cl_mem rhs, size_t rhs_stride, cl_mem output,
+                                 size_t num_rhs, size_t batch_count, bool normalize) {
+    if (matrices == nullptr || rhs == nullptr || output == nullptr || num_rhs == 0 || batch_count == 0) {
+        throw std::invalid_argument("HermitianInverter: null buffer, no right-hand sides or empty batch");
+    }
+    EnsureCapacity(batch_count);
+
+    std::vector<cl_event> factor_events, solve_events;
+    EnqueueFactor(matrices, batch_count, factor_events);
+    EnqueueSolve(rhs, rhs_stride, output, num_rhs, batch_count, normalize, solve_events);
+
+    cl_int err = clFinish(queue_);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clFinish (hermitian solve) failed: " + std::to_string(err));
+    }
+
+    last_stats_ = HermitianInverseStats{};
+    last_stats_.batch_count = batch_count;
+    last_stats_.factor_ms = SumEventsMs(factor_events);
+    last_stats_.solve_ms = SumEventsMs(solve_events);
+    last_stats_.total_ms = last_stats_.factor_ms + last_stats_.solve_ms;
+
+    CheckInfo(batch_count);
+}
+
+std::vector<std::complex<float>> HermitianInverter::RunSolveHost(const std::vector<std::complex<float>>& matrices,
+                                                                 const std::vector<std::complex<float>>& rhs,
+                                                                 size_t rhs_stride, size_t num_rhs,
+                                                                 size_t batch_count, bool normalize) {
+    const size_t expected = batch_count * n_ * n_;
+    const size_t expected_rhs = (rhs_stride == 0 ? 1 : batch_count) * num_rhs * n_;
+    if (batch_count == 0 || num_rhs == 0 || matrices.size() != expected || rhs.size() != expected_rhs) {
+        throw std::invalid_argument("HermitianInverter: expected " + std::to_string(expected) + " matrix and " +
+                                    std::to_string(expected_rhs) + " vector elements, got " +
+                                    std::to_string(matrices.size()) + " and " + std::to_string(rhs.size()));
+    }
+    const size_t solution_elements = batch_count * num_rhs * n_;
+    EnsureBuffer(buffer_io_, io_capacity_, expected);
+    EnsureBuffer(buffer_rhs_, rhs_capacity_, expected_rhs);
+    EnsureBuffer(buffer_solution_, solution_capacity_, solution_elements);
+    Upload(buffer_io_->Get(), matrices);
+    Upload(buffer_rhs_->Get(), rhs);
+
+    RunSolve(buffer_io_->Get(), buffer_rhs_->Get(), rhs_stride, buffer_solution_->Get(), num_rhs,
+             batch_count, normalize);
+
+    std::vector<std::complex<float>> solution(solution_elements);
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_solution_->Get(), CL_TRUE, 0,
+                                     solution_elements * sizeof(std::complex<float>), solution.data(),
+                                     0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (hermitian solve) failed: " + std::to_string(err));
+    }
+    return solution;
+}
+
+void HermitianInverter::SolveBatched(cl_mem matrices, cl_mem rhs, cl_mem output, size_t num_rhs,
+                                     size_t batch_count) {
+    RunSolve(matrices, rhs, num_rhs * n_, output, num_rhs, batch_count, false);
+}
+
+std::vector<std::complex<float>> HermitianInverter::SolveBatched(const std::vector<std::complex<float>>& matrices,
+                                                                 const std::vector<std::complex<float>>& rhs,
+                                                                 size_t num_rhs, size_t batch_count) {
+    return RunSolveHost(matrices, rhs, num_rhs * n_, num_rhs, batch_count, false);
+}
+
+void HermitianInverter::MVDRWeights(cl_mem covariances, cl_mem steering, cl_mem weights, size_t num_vectors,
+                                    size_t batch_count) {
+    RunSolve(covariances, steering, 0, weights, num_vectors, batch_count, true);
+}
+
+std::vector<std::complex<float>> HermitianInverter::MVDRWeights(const std::vector<std::complex<float>>& covariances,
+                                                                const std::vector<std::complex<float>>& steering,
+                                                                size_t num_vectors, size_t batch_count) {
+    return RunSolveHost(covariances, steering, 0, num_vectors, batch_count, true);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Смешанная точность
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianInverter::SolveRefinedBatched(cl_mem matrices, cl_mem rhs, cl_mem solution_hi, cl_mem solution_lo,
+                                            size_t num_rhs, size_t batch_count, size_t max_iterations,
+                                            double tolerance) {
+    if (matrices == nullptr || rhs == nullptr || solution_hi == nullptr || solution_lo == nullptr ||
+        num_rhs == 0 || batch_count == 0) {
+        throw std::invalid_argument("HermitianInverter::SolveRefinedBatched: null buffer, no right-hand sides "
+                                    "or empty batch");
+    }
+    EnsureCapacity(batch_count);
+    const size_t count = batch_count * num_rhs * n_;
+    EnsureBuffer(buffer_residual_, residual_capacity_, count);
+    EnsureBuffer(buffer_correction_, correction_capacity_, count);
+    // float4 = два complex<float>
+    EnsureBuffer(buffer_norms_, norms_capacity_, 2 * batch_count * num_rhs);
+
+    std::vector<cl_event> factor_events, solve_events, refine_events;
+    EnqueueFactor(matrices, batch_count, factor_events);
+    EnqueueSolve(rhs, num_rhs * n_, solution_hi, num_rhs, batch_count, false, solve_events);
+    const std::complex<float> zero(0.0f, 0.0f);
+    cl_int err = clEnqueueFillBuffer(queue_, solution_lo, &zero, sizeof(zero), 0, count * sizeof(zero),
+                                     0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueFillBuffer (refine solution_lo) failed: " + std::to_string(err));
+    }
+    // Проверка разложения до поправок: для не положительно определённой матрицы они бессмысленны
+    err = clFinish(queue_);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clFinish (hermitian refine) failed: " + std::to_string(err));
+    }
+    CheckInfo(batch_count);
+
+    double eta = EnqueueResidual(matrices, rhs, solution_hi, solution_lo, num_rhs, batch_count, refine_events);
+    const double initial_eta = eta;
+    size_t iterations = 0;
+    while (iterations < max_iterations && eta > tolerance) {
+        EnqueueSolve(buffer_residual_->Get(), num_rhs * n_, buffer_correction_->Get(), num_rhs, batch_count,
+                     false, refine_events);
+        EnqueueRefineUpdate(solution_hi, solution_lo, count, refine_events);
+        const double previous = eta;
+        eta = EnqueueResidual(matrices, rhs, solution_hi, solution_lo, num_rhs, batch_count, refine_events);
+        ++iterations;
+        // Застой: κ(A)·eps_float близко к 1, дальше поправки не сходятся
+        if (eta > 0.5 * previous) break;
+    }
+
+    last_stats_ = HermitianInverseStats{};
+    last_stats_.batch_count = batch_count;
+    last_stats_.factor_ms = SumEventsMs(factor_events);
+    last_stats_.solve_ms = SumEventsMs(solve_events);
+    last_stats_.refine_ms = SumEventsMs(refine_events);
+    last_stats_.refine_iterations = iterations;
+    last_stats_.initial_residual = initial_eta;
+    last_stats_.residual = eta;
+    last_stats_.total_ms = last_stats_.factor_ms + last_stats_.solve_ms + last_stats_.refine_ms;
+}
+
+std::vector<std::complex<double>> HermitianInverter::SolveRefinedBatched(
+    const std::vector<std::complex<float>>& matrices, const std::vector<std::complex<float>>& rhs,
+    size_t num_rhs, size_t batch_count, size_t max_iterations, double tolerance) {
+    const size_t expected = batch_count * n_ * n_;
+    const size_t count = batch_count * num_rhs * n_;
+    if (batch_count == 0 || num_rhs == 0 || matrices.size() != expected || rhs.size() != count) {
+        throw std::invalid_argument("HermitianInverter::SolveRefinedBatched: expected " + std::to_string(expected) +
+                                    " matrix and " + std::to_string(count) + " vector elements, got " +
+                                    std::to_string(matrices.size()) + " and " + std::to_string(rhs.size()));
+    }
+    EnsureBuffer(buffer_io_, io_capacity_, expected);
+    EnsureBuffer(buffer_rhs_, rhs_capacity_, count);
+    EnsureBuffer(buffer_solution_, solution_capacity_, count);
+    EnsureBuffer(buffer_solution_lo_, solution_lo_capacity_, count);
+    Upload(buffer_io_->Get(), matrices);
+    Upload(buffer_rhs_->Get(), rhs);
+
+    SolveRefinedBatched(buffer_io_->Get(), buffer_rhs_->Get(), buffer_solution_->Get(), buffer_solution_lo_->Get(),
+                        num_rhs, batch_count, max_iterations, tolerance);
+
+    std::vector<std::complex<float>> hi(count), lo(count);
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_solution_->Get(), CL_FALSE, 0,
+                                     count * sizeof(std::complex<float>), hi.data(), 0, nullptr, nullptr);
+    if (err == CL_SUCCESS) {
+        err = clEnqueueReadBuffer(queue_, buffer_solution_lo_->Get(), CL_TRUE, 0,
+                                  count * sizeof(std::complex<float>), lo.data(), 0, nullptr, nullptr);
+    }
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (hermitian refine) failed: " + std::to_string(err));
+    }
+
+    std::vector<std::complex<double>> solution(count);
+    for (size_t i = 0; i < count; ++i) {
+        solution[i] = std::complex<double>(hi[i]) + std::complex<double>(lo[i]);
+    }
+    return solution;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Проверка и загрузка
+// ════════════════════════════════════════════════════════════════════════════
+
+float HermitianInverter::FrobeniusError(const std::vector<std::complex<float>>& matrix,
+                                        const std::vector<std::complex<float>>& inverse, size_t n) {
+    if (matrix.size() < n * n || inverse.size() < n * n) {
+        throw std::invalid_argument("HermitianInverter::FrobeniusError: matrix smaller than n x n");
+    }
+    float error = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            std::complex<float> sum(0.0f, 0.0f);
+            for (size_t k = 0; k < n; ++k) {
+                sum += matrix[i * n + k] * inverse[k * n + j];
+            }
+            if (i == j) sum -= 1.0f;
+            error += std::norm(sum);
+        }
+    }
+    return std::sqrt(error);
+}
+
+std::vector<std::complex<float>> HermitianInverter::LoadMatrixCSV(const std::string& path, size_t* n) {
+    return ReadComplexMatrixCSV(path, n);
+}
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,262 @@
+#pragma once
+
+/**
+ * @file hermitian_inverter.hpp
+ * @brief Обращение эрмитовых положительно определённых матриц на OpenCL (Cholesky)
+ *
+ * Переносимая замена rocSOLVER cpotrf/cpotri из Matrix/: работает на том же
+ * контексте, что FFT конвейер (OpenCLComputeEngine или DeviceContext), в том
+ * числе на CPU OpenCL устройстве.
+ *
+ * A^{-1} = L^{-H} L^{-1}, три этапа на устройстве (тайлы TILE × TILE в local memory):
+ * 1. Блочный right-looking Cholesky A = L L^H: на каждый блочный столбец k —
+ *    диагональный блок (одна группа), панель L_ik = A_ik L_kk^{-H},
+ *    обновление хвоста A_ij -= L_ik L_jk^H (нижний треугольник блоков)
+ * 2. W = L^{-1}: обращение диагональных блоков, затем по блочным диагоналям
+ *    d = 1..nb-1: W_ij = -W_ii Σ_{k=j}^{i-1} L_ik W_kj
+ * 3. A^{-1} = W^H W (k от max(i, j): W нижнетреугольная)
+ *
+ * Пакетный режим: batch_count матриц n × n подряд, третье измерение NDRange —
+ * номер матрицы (те же ядра, один запуск на шаг для всего пакета). Размер
+ * дополняется до кратного TILE единичной матрицей: diag(A, I)^{-1} = diag(A^{-1}, I).
+ *
+ * Solve / MVDRWeights: только этап 1 и подстановки L y = b, L^H x = y
+ * (группа SOLVE_WG на правую часть), без W и без записи n × n результата.
+ *
+ * SolveRefinedBatched: то же разложение в float, затем итерационное уточнение
+ * x += A^{-1}(b - A x). Решение хранится парой float (x_hi + x_lo), невязка
+ * накапливается в double при cl_khr_fp64, иначе в float-float (two_sum /
+ * two_prod через fma) — на устройствах без fp64 точность та же.
+ *
+ * @code
+ * size_t n = 0;
+ * auto R = HermitianInverter::LoadMatrixCSV("Matrix/data/R_85.csv", &n);
+ * HermitianInverter inverter(n);
+ * auto R_inv = inverter.Invert(R);
+ * float err = HermitianInverter::FrobeniusError(R, R_inv, n);  // ||R·R_inv - I||_F
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "device_group.hpp"
+#include "gpu_memory_buffer.hpp"
+#include <CL/cl.h>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+class OpenCLComputeEngine;
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: HermitianInverseStats - время этапов последнего обращения
+// ════════════════════════════════════════════════════════════════════════════
+
+struct HermitianInverseStats {
+    size_t batch_count = 0;
+    double factor_ms = 0.0;      ///< Упаковка + Cholesky
+    double invert_ms = 0.0;      ///< L^{-1}
+    double product_ms = 0.0;     ///< W^H W
+    double solve_ms = 0.0;       ///< Подстановки (Solve / MVDRWeights)
+    double refine_ms = 0.0;      ///< Невязки, поправки и их подстановки (SolveRefinedBatched)
+    size_t refine_iterations = 0;   ///< Поправок после первого решения
+    double initial_residual = 0.0;  ///< Обратная ошибка решения в float (худшая по пакету)
+    double residual = 0.0;          ///< Обратная ошибка после уточнения
+    double total_ms = 0.0;       ///< Сумма по событиям (без передач хоста)
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: HermitianInverter
+// ════════════════════════════════════════════════════════════════════════════
+
+class HermitianInverter {
+public:
+    static constexpr size_t TILE = 16;
+    static constexpr size_t SOLVE_WG = 64;   ///< Work-items на правую часть в подстановках
+
+    /**
+     * @brief Обращение матриц n × n на устройстве OpenCLComputeEngine
+     * @throws std::runtime_error если engine не инициализирован
+     */
+    explicit HermitianInverter(size_t n);
+    HermitianInverter(size_t n, const DeviceContext& device);
+    ~HermitianInverter();
+
+    HermitianInverter(const HermitianInverter&) = delete;
+    HermitianInverter& operator=(const HermitianInverter&) = delete;
+
+    /**
+     * @brief A^{-1} для одной матрицы (row-major n × n)
+     * @throws std::invalid_argument при неверном размере
+     * @throws std::runtime_error если матрица не положительно определена
+     */
+    std::vector<std::complex<float>> Invert(const std::vector<std::complex<float>>& matrix);
+
+    /// batch_count матриц подряд (batch_count × n × n) → обратные в том же порядке
+    std::vector<std::complex<float>> InvertBatched(const std::vector<std::complex<float>>& matrices,
+                                                   size_t batch_count);
+
+    /**
+     * @brief Обращение на устройстве: input и output — batch_count × n × n float2
+     *
+     * input не изменяется (разложение идёт в рабочем буфере), output может совпадать с input.
+     */
+    void InvertBatched(cl_mem input, cl_mem output, size_t batch_count);
+
+    /**
+     * @brief x = A^{-1} b без явного A^{-1}: разложение + две подстановки
+     * @param rhs batch_count × num_rhs × n (правые части каждой матрицы подряд)
+     * @return Решения в том же порядке
+     * @throws std::runtime_error если матрица не положительно определена
+     */
+    std::vector<std::complex<float>> SolveBatched(const std::vector<std::complex<float>>& matrices,
+                                                  const std::vector<std::complex<float>>& rhs,
+                                                  size_t num_rhs, size_t batch_count);
+
+    /// Решения на устройстве: rhs и output — batch_count × num_rhs × n float2
+    void SolveBatched(cl_mem matrices, cl_mem rhs, cl_mem output, size_t num_rhs, size_t batch_count);
+
+    /**
+     * @brief MVDR веса w = R^{-1}s / (s^H R^{-1} s) для каждой матрицы пакета
+     * @param steering num_vectors × n, общие для всех матриц
+     * @return batch_count × num_vectors × n (w^H s = 1)
+     */
+    std::vector<std::complex<float>> MVDRWeights(const std::vector<std::complex<float>>& covariances,
+                                                 const std::vector<std::complex<float>>& steering,
+                                                 size_t num_vectors, size_t batch_count);
+
+    /// Веса на устройстве: steering — num_vectors × n, weights — batch_count × num_vectors × n
+    void MVDRWeights(cl_mem covariances, cl_mem steering, cl_mem weights, size_t num_vectors, size_t batch_count);
+
+    /**
+     * @brief Решение со смешанной точностью: Cholesky в float, уточнение невязкой повышенной точности
+     *
+     * Поправки повторяются, пока обратная ошибка
+     * η = ||b - A x||_inf / (||A||_inf ||x||_inf + ||b||_inf) (худшая по пакету и правым частям)
+     * больше tolerance, но не более max_iterations раз и пока η убывает хотя бы вдвое.
+     * Достигнутое η — GetLastStats().residual.
+     * @param rhs batch_count × num_rhs × n
+     * @return x_hi + x_lo в том же порядке
+     */
+    std::vector<std::complex<double>> SolveRefinedBatched(const std::vector<std::complex<float>>& matrices,
+                                                          const std::vector<std::complex<float>>& rhs,
+                                                          size_t num_rhs, size_t batch_count,
+                                                          size_t max_iterations = 5, double tolerance = 1e-14);
+
+    /// Решения на устройстве парой float2: x = solution_hi + solution_lo (batch_count × num_rhs × n)
+    void SolveRefinedBatched(cl_mem matrices, cl_mem rhs, cl_mem solution_hi, cl_mem solution_lo,
+                             size_t num_rhs, size_t batch_count, size_t max_iterations = 5,
+                             double tolerance = 1e-14);
+
+    /// Невязка уточнения в double (cl_khr_fp64), иначе в float-float
+    bool HasFP64() const { return has_fp64_; }
+
+    size_t GetSize() const { return n_; }
+    size_t GetPaddedSize() const { return padded_n_; }
+    const HermitianInverseStats& GetLastStats() const { return last_stats_; }
+
+    /**
+     * @brief ||A · A_inv - I||_F (как compute_frobenius_error в Matrix/)
+     */
+    static float FrobeniusError(const std::vector<std::complex<float>>& matrix,
+                                const std::vector<std::complex<float>>& inverse, size_t n);
+
+    /**
+     * @brief Квадратная матрица из CSV (строки матрицы, элементы "re+imi" через запятую)
+     * 
+     * Обёртка над ReadComplexMatrixCSV (matrix_csv.hpp).
+     * @param n Если не nullptr — размер матрицы
+     * @throws std::runtime_error если файл не открыт или матрица не квадратная
+     */
+    static std::vector<std::complex<float>> LoadMatrixCSV(const std::string& path, size_t* n = nullptr);
+
+private:
+    HermitianInverter(size_t n, const DeviceContext* device);
+
+    void BuildKernels();
+    void EnsureCapacity(size_t batch_count);
+    std::unique_ptr<GPUMemoryBuffer> CreateBuffer(size_t num_elements);
+
+    /// Упаковка input → buffer_factor_, Cholesky на месте
+    void EnqueueFactor(cl_mem input, size_t batch_count, std::vector<cl_event>& events);
+    /// L (buffer_factor_) → W (buffer_inverse_)
+    void EnqueueTriangularInverse(size_t batch_count, std::vector<cl_event>& events);
+    /// W^H W → output (n × n на матрицу)
+    void EnqueueProduct(cl_mem output, size_t batch_count, std::vector<cl_event>& events);
+    /// Подстановки по L (buffer_factor_); rhs_stride — шаг правых частей между матрицами (0 = общие)
+    void EnqueueSolve(cl_mem rhs, size_t rhs_stride, cl_mem output, size_t num_rhs, size_t batch_count,
+                      bool normalize, std::vector<cl_event>& events);
+    /// EnqueueFactor + EnqueueSolve, ожидание и статистика
+    void RunSolve(cl_mem matrices, cl_mem rhs, size_t rhs_stride, cl_mem output, size_t num_rhs,
+                  size_t batch_count, bool normalize);
+    /// Хостовые данные → buffer_io_ / buffer_rhs_, результат → вектор
+    std::vector<std::complex<float>> RunSolveHost(const std::vector<std::complex<float>>& matrices,
+                                                  const std::vector<std::complex<float>>& rhs,
+                                                  size_t rhs_stride, size_t num_rhs, size_t batch_count,
+                                                  bool normalize);
+    /// Буфер не меньше elements (пересоздаётся при росте)
+    void EnsureBuffer(std::unique_ptr<GPUMemoryBuffer>& buffer, size_t& capacity, size_t elements);
+    void Upload(cl_mem buffer, const std::vector<std::complex<float>>& data);
+    /// r = b - A x (buffer_residual_) и нормы; возвращает худшую обратную ошибку (ждёт очередь)
+    double EnqueueResidual(cl_mem matrices, cl_mem rhs, cl_mem solution_hi, cl_mem solution_lo,
+                           size_t num_rhs, size_t batch_count, std::vector<cl_event>& events);
+    /// (solution_hi, solution_lo) += buffer_correction_ в float-float
+    void EnqueueRefineUpdate(cl_mem solution_hi, cl_mem solution_lo, size_t count,
+                             std::vector<cl_event>& events);
+    /// Прочитать buffer_info_ и бросить исключение для первой не положительно определённой матрицы
+    void CheckInfo(size_t batch_count);
+
+    /// Группы TILE × TILE: groups_x × groups_y × batch_count; событие — в events
+    void Launch(cl_kernel kernel, size_t groups_x, size_t groups_y, size_t batch_count,
+                std::vector<cl_event>& events);
+    static double SumEventsMs(std::vector<cl_event>& events);
+
+    size_t n_ = 0;
+    size_t padded_n_ = 0;           ///< Кратно TILE
+    size_t num_blocks_ = 0;
+
+    OpenCLComputeEngine* engine_ = nullptr;
+    cl_context context_ = nullptr;
+    cl_device_id device_ = nullptr;
+    cl_command_queue queue_ = nullptr;
+
+    cl_program program_ = nullptr;
+    cl_kernel pack_kernel_ = nullptr;
+    cl_kernel diag_kernel_ = nullptr;
+    cl_kernel panel_kernel_ = nullptr;
+    cl_kernel update_kernel_ = nullptr;
+    cl_kernel trtri_diag_kernel_ = nullptr;
+    cl_kernel trtri_offdiag_kernel_ = nullptr;
+    cl_kernel product_kernel_ = nullptr;
+    cl_kernel solve_kernel_ = nullptr;
+    cl_kernel residual_kernel_ = nullptr;
+    cl_kernel refine_update_kernel_ = nullptr;
+    bool has_fp64_ = false;
+
+    size_t capacity_ = 0;           ///< Матриц в рабочих буферах
+    std::unique_ptr<GPUMemoryBuffer> buffer_factor_;    ///< A → L (padded_n × padded_n на матрицу)
+    std::unique_ptr<GPUMemoryBuffer> buffer_inverse_;   ///< W = L^{-1}
+    std::unique_ptr<GPUMemoryBuffer> buffer_info_;      ///< int на матрицу: 0 или столбец + 1
+    std::unique_ptr<GPUMemoryBuffer> buffer_io_;        ///< Вход/выход для хостовых перегрузок
+    size_t io_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_rhs_;       ///< Правые части / векторы наведения
+    size_t rhs_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_solution_;  ///< Решения / веса для хостовых перегрузок
+    size_t solution_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_solution_lo_; ///< Младшая часть решения для хостовой перегрузки
+    size_t solution_lo_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_residual_;    ///< b - A x (float2), правая часть поправки
+    size_t residual_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_correction_;  ///< Поправка A^{-1} r
+    size_t correction_capacity_ = 0;
+    std::unique_ptr<GPUMemoryBuffer> buffer_norms_;       ///< float4 на (матрица, правая часть)
+    size_t norms_capacity_ = 0;
+
+    HermitianInverseStats last_stats_;
+};
+
+} // namespace ManagerOpenCL
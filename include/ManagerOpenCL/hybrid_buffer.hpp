@@ -19,6 +19,7 @@
 #include "svm_buffer.hpp"
 #include "regular_buffer.hpp"
 #include "svm_capabilities.hpp"
+#include "transfer_calibration.hpp"
 #include "memory_type.hpp"
 #include <CL/cl.h>
 #include <memory>
@@ -65,6 +66,9 @@ struct BufferConfig {
     /// Предпочитать coarse-grain SVM (более совместим)
     bool prefer_coarse_grain = true;
     
+    /// Выбирать стратегию по измерениям TransferCalibration (если она задана)
+    bool use_calibration = true;
+    
     /// Выводить диагностику при создании буферов
     bool verbose = false;
     
@@ -241,6 +245,18 @@ public:
      */
     void SetConfig(const BufferConfig& config) { config_ = config; }
     
+    /**
+     * @brief Задать результаты калибровки передач (используются AUTO стратегией)
+     */
+    void SetCalibration(std::shared_ptr<const TransferCalibration> calibration) {
+        calibration_ = std::move(calibration);
+    }
+    
+    /**
+     * @brief Получить результаты калибровки (может быть nullptr)
+     */
+    std::shared_ptr<const TransferCalibration> GetCalibration() const { return calibration_; }
+    
     /**
      * @brief Определить стратегию для данного размера
      * @param size_bytes Размер в байтах
@@ -272,6 +288,7 @@ private:
     cl_device_id     device_;
     SVMCapabilities  capabilities_;
     BufferConfig     config_;
+    std::shared_ptr<const TransferCalibration> calibration_;
     
     // Статистика
     mutable std::mutex stats_mutex_;
@@ -331,12 +348,17 @@ inline MemoryStrategy BufferFactory::DetermineStrategy(
         return MemoryStrategy::REGULAR_BUFFER;
     }
     
-    // 3. Маленькие буферы - Regular (SVM overhead не оправдан)
+    // 3. Есть измерения на этом хосте - выбор по оценке стоимости передач
+    if (config_.use_calibration && calibration_ && calibration_->IsValid()) {
+        return calibration_->SelectStrategy(size_bytes, hint);
+    }
+    
+    // 4. Маленькие буферы - Regular (SVM overhead не оправдан)
     if (size_bytes < config_.small_buffer_threshold) {
         return MemoryStrategy::REGULAR_BUFFER;
     }
     
-    // 4. Средние и большие буферы - SVM если доступен
+    // 5. Средние и большие буферы - SVM если доступен
     if (capabilities_.HasAnySVM()) {
         // Для буферов с частым обменом хост-GPU предпочитаем SVM
         if (hint.frequent_host_read || hint.frequent_host_write) {
@@ -362,7 +384,7 @@ inline MemoryStrategy BufferFactory::DetermineStrategy(
         }
     }
     
-    // 5. Fallback
+    // 6. Fallback
     return MemoryStrategy::REGULAR_BUFFER;
 }
 
@@ -485,6 +507,14 @@ inline void BufferFactory::PrintInfo() const {
     std::cout << "  Force SVM:       " << (config_.force_svm ? "YES" : "NO") << "\n";
     std::cout << "  Force Regular:   " << (config_.force_regular ? "YES" : "NO") << "\n";
     std::cout << "  Prefer Coarse:   " << (config_.prefer_coarse_grain ? "YES" : "NO") << "\n";
+    std::cout << "  Calibration:     "
+              << (calibration_ && calibration_->IsValid()
+                      ? (config_.use_calibration ? "ON" : "OFF (disabled in config)")
+                      : "NONE") << "\n";
+    
+    if (calibration_ && calibration_->IsValid()) {
+        std::cout << calibration_->ToString();
+    }
     
     std::cout << "\n" << std::string(70, '═') << "\n";
 }
@@ -0,0 +1,354 @@
+#include "mapped_array_file.hpp"
+#include "matrix_csv.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ManagerOpenCL {
+
+namespace {
+
+constexpr char kMagic[8] = {'L', 'C', 'H', 'A', 'R', 'R', 'A', 'Y'};
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+size_t ArrayDTypeSize(ArrayDType dtype) {
+    switch (dtype) {
+        case ArrayDType::Float32:      return 4;
+        case ArrayDType::Float64:      return 8;
+        case ArrayDType::Complex64:    return 8;
+        case ArrayDType::Complex128:   return 16;
+        case ArrayDType::Int16:        return 2;
+        case ArrayDType::ComplexInt16: return 4;
+    }
+    return 0;
+}
+
+const char* ArrayDTypeName(ArrayDType dtype) {
+    switch (dtype) {
+        case ArrayDType::Float32:      return "float32";
+        case ArrayDType::Float64:      return "float64";
+        case ArrayDType::Complex64:    return "complex64";
+        case ArrayDType::Complex128:   return "complex128";
+        case ArrayDType::Int16:        return "int16";
+        case ArrayDType::ComplexInt16: return "complex_int16";
+    }
+    return "unknown";
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Открытие / закрытие
+// ════════════════════════════════════════════════════════════════════════════
+
+MappedArrayFile::MappedArrayFile(const std::string& path) : path_(path) {
+#ifdef _WIN32
+    // Без mmap: файл целиком в память
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("MappedArrayFile: cannot open " + path);
+    }
+    mapping_bytes_ = static_cast<size_t>(file.tellg());
+    mapping_ = std::malloc(mapping_bytes_ ? mapping_bytes_ : 1);
+    if (!mapping_) {
+        throw std::runtime_error("MappedArrayFile: out of memory for " + path);
+    }
+    file.seekg(0);
+    if (!file.read(static_cast<char*>(mapping_), static_cast<std::streamsize>(mapping_bytes_))) {
+        Release();
+        throw std::runtime_error("MappedArrayFile: read failed for " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedArrayFile: cannot open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedArrayFile: fstat failed for " + path);
+    }
+    mapping_bytes_ = static_cast<size_t>(st.st_size);
+    if (mapping_bytes_ < sizeof(BinaryArrayHeader)) {
+        ::close(fd);
+        throw std::runtime_error("MappedArrayFile: " + path + " is too small (" +
+                                 std::to_string(mapping_bytes_) + " bytes)");
+    }
+    void* mapping = ::mmap(nullptr, mapping_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("MappedArrayFile: mmap failed for " + path);
+    }
+    mapping_ = mapping;
+    // Payload читается один раз подряд (загрузка в буфер устройства)
+    ::madvise(mapping_, mapping_bytes_, MADV_SEQUENTIAL);
+    ::madvise(mapping_, mapping_bytes_, MADV_WILLNEED);
+#endif
+
+    try {
+        Validate(mapping_bytes_);
+    } catch (...) {
+        Release();
+        throw;
+    }
+}
+
+MappedArrayFile::~MappedArrayFile() {
+    Release();
+}
+
+MappedArrayFile::MappedArrayFile(MappedArrayFile&& other) noexcept
+    : path_(std::move(other.path_)),
+      header_(other.header_),
+      description_(std::move(other.description_)),
+      mapping_(other.mapping_),
+      mapping_bytes_(other.mapping_bytes_),
+      payload_(other.payload_),
+      num_elements_(other.num_elements_) {
+    other.mapping_ = nullptr;
+    other.mapping_bytes_ = 0;
+    other.payload_ = nullptr;
+    other.num_elements_ = 0;
+}
+
+MappedArrayFile& MappedArrayFile::operator=(MappedArrayFile&& other) noexcept {
+    if (this != &other) {
+        Release();
+        path_ = std::move(other.path_);
+        header_ = other.header_;
+        description_ = std::move(other.description_);
+        mapping_ = other.mapping_;
+        mapping_bytes_ = other.mapping_bytes_;
+        payload_ = other.payload_;
+        num_elements_ = other.num_elements_;
+        other.mapping_ = nullptr;
+        other.mapping_bytes_ = 0;
+        other.payload_ = nullptr;
+        other.num_elements_ = 0;
+    }
+    return *this;
+}
+
+void MappedArrayFile::Release() {
+    if (mapping_) {
+#ifdef _WIN32
+        std::free(mapping_);
+#else
+        ::munmap(mapping_, mapping_bytes_);
+#endif
+    }
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+    payload_ = nullptr;
+}
+
+void MappedArrayFile::Validate(size_t file_size) {
+    if (file_size < sizeof(BinaryArrayHeader)) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " is too small (" +
+                                 std::to_string(file_size) + " bytes)");
+    }
+    std::memcpy(&header_, mapping_, sizeof(BinaryArrayHeader));
+
+    if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " is not an array file (bad magic)");
+    }
+    if (header_.version != BinaryArrayHeader::VERSION || header_.header_bytes != sizeof(BinaryArrayHeader)) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " has unsupported version " +
+                                 std::to_string(header_.version));
+    }
+    const size_t element_size = ArrayDTypeSize(GetDType());
+    if (element_size == 0) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " has unknown dtype " +
+                                 std::to_string(header_.dtype));
+    }
+    if (header_.ndim == 0 || header_.ndim > BinaryArrayHeader::MAX_DIMS) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " has invalid ndim " +
+                                 std::to_string(header_.ndim));
+    }
+    // Сравнения без сложений: поля заголовка из файла могут быть сколь угодно большими
+    if (header_.description_bytes > file_size - sizeof(BinaryArrayHeader)) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " has invalid description size");
+    }
+    if (header_.payload_offset % BinaryArrayHeader::PAYLOAD_ALIGNMENT != 0 ||
+        header_.payload_offset < sizeof(BinaryArrayHeader) ||
+        header_.payload_offset - sizeof(BinaryArrayHeader) < header_.description_bytes ||
+        header_.payload_offset > file_size || header_.payload_bytes > file_size - header_.payload_offset) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " is truncated or has invalid payload offset");
+    }
+
+    // Последний байт последнего элемента должен лежать в payload
+    const auto overflow = [this]() {
+        return std::runtime_error("MappedArrayFile: " + path_ + " shape/strides overflow");
+    };
+    uint64_t elements = 1;
+    uint64_t extent = element_size;
+    for (uint32_t d = 0; d < header_.ndim; ++d) {
+        if (header_.shape[d] == 0) {
+            elements = 0;
+            extent = 0;
+            break;
+        }
+        if (elements > UINT64_MAX / header_.shape[d]) {
+            throw overflow();
+        }
+        elements *= header_.shape[d];
+        if (header_.strides[d] % element_size != 0) {
+            throw std::runtime_error("MappedArrayFile: " + path_ + " has stride not multiple of " +
+                                     ArrayDTypeName(GetDType()) + " size");
+        }
+        const uint64_t steps = header_.shape[d] - 1;
+        if (steps != 0 && header_.strides[d] > UINT64_MAX / steps) {
+            throw overflow();
+        }
+        const uint64_t span = steps * header_.strides[d];
+        if (span > UINT64_MAX - extent) {
+            throw overflow();
+        }
+        extent += span;
+    }
+    if (elements > SIZE_MAX) {
+        throw overflow();
+    }
+    num_elements_ = static_cast<size_t>(elements);
+    if (extent > header_.payload_bytes) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " shape/strides exceed payload (" +
+                                 std::to_string(extent) + " > " + std::to_string(header_.payload_bytes) + " bytes)");
+    }
+
+    const char* base = static_cast<const char*>(mapping_);
+    description_.assign(base + sizeof(BinaryArrayHeader), static_cast<size_t>(header_.description_bytes));
+    payload_ = base + header_.payload_offset;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Доступ
+// ════════════════════════════════════════════════════════════════════════════
+
+std::vector<size_t> MappedArrayFile::GetShape() const {
+    return std::vector<size_t>(header_.shape, header_.shape + header_.ndim);
+}
+
+std::vector<size_t> MappedArrayFile::GetStrides() const {
+    return std::vector<size_t>(header_.strides, header_.strides + header_.ndim);
+}
+
+bool MappedArrayFile::IsContiguous() const {
+    uint64_t expected = ArrayDTypeSize(GetDType());
+    for (uint32_t d = header_.ndim; d-- > 0;) {
+        if (header_.shape[d] > 1 && header_.strides[d] != expected) return false;
+        expected *= header_.shape[d];
+    }
+    return true;
+}
+
+void MappedArrayFile::RequireDType(ArrayDType dtype) const {
+    if (GetDType() != dtype) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " holds " + ArrayDTypeName(GetDType()) +
+                                 ", requested " + ArrayDTypeName(dtype));
+    }
+}
+
+void MappedArrayFile::RequireContiguous() const {
+    if (!IsContiguous()) {
+        throw std::runtime_error("MappedArrayFile: " + path_ + " is not contiguous");
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Запись и конвертеры
+// ════════════════════════════════════════════════════════════════════════════
+
+void MappedArrayFile::Write(const std::string& path, ArrayDType dtype, const std::vector<size_t>& shape,
+                            const void* data, const std::string& description) {
+    const size_t element_size = ArrayDTypeSize(dtype);
+    if (element_size == 0) {
+        throw std::invalid_argument("MappedArrayFile::Write: unknown dtype");
+    }
+    if (shape.empty() || shape.size() > BinaryArrayHeader::MAX_DIMS) {
+        throw std::invalid_argument("MappedArrayFile::Write: ndim must be 1.." +
+                                    std::to_string(BinaryArrayHeader::MAX_DIMS));
+    }
+
+    BinaryArrayHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = BinaryArrayHeader::VERSION;
+    header.dtype = static_cast<uint32_t>(dtype);
+    header.ndim = static_cast<uint32_t>(shape.size());
+    header.header_bytes = sizeof(BinaryArrayHeader);
+    for (size_t d = 0; d < BinaryArrayHeader::MAX_DIMS; ++d) header.shape[d] = 1;
+
+    uint64_t stride = element_size;
+    for (size_t d = shape.size(); d-- > 0;) {
+        header.shape[d] = shape[d];
+        header.strides[d] = stride;
+        stride *= shape[d];
+    }
+    for (size_t d = shape.size(); d < BinaryArrayHeader::MAX_DIMS; ++d) header.strides[d] = stride;
+    header.description_bytes = description.size();
+    header.payload_offset = AlignUp(sizeof(BinaryArrayHeader) + description.size(),
+                                    BinaryArrayHeader::PAYLOAD_ALIGNMENT);
+    header.payload_bytes = stride;
+    if (header.payload_bytes > 0 && data == nullptr) {
+        throw std::invalid_argument("MappedArrayFile::Write: data is null");
+    }
+
+    // Запись во временный файл и rename: читатели не видят половину файла
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("MappedArrayFile::Write: cannot open " + tmp_path);
+        }
+        const std::vector<char> padding(header.payload_offset - sizeof(BinaryArrayHeader) - description.size(), 0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(description.data(), static_cast<std::streamsize>(description.size()));
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(header.payload_bytes));
+        if (!file) {
+            throw std::runtime_error("MappedArrayFile::Write: write failed for " + tmp_path);
+        }
+    }
+    // POSIX rename заменяет существующий файл атомарно; на Windows rename не
+    // перезаписывает — MoveFileEx с заменой (старый файл остаётся при ошибке)
+#ifdef _WIN32
+    const bool renamed = MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool renamed = std::rename(tmp_path.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("MappedArrayFile::Write: cannot rename " + tmp_path + " to " + path);
+    }
+}
+
+size_t MappedArrayFile::ConvertMatrixCSV(const std::string& csv_path, const std::string& output_path) {
+    size_t n = 0;
+    auto matrix = ReadComplexMatrixCSV(csv_path, &n);
+    Write(output_path, {n, n}, matrix, "matrix " + std::to_string(n) + "x" + std::to_string(n) + " from " + csv_path);
+    return n;
+}
+
+bool MappedArrayFile::IsArrayFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+} // namespace ManagerOpenCL
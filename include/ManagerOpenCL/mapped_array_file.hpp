@@ -0,0 +1,186 @@
+#pragma once
+
+/**
+ * @file mapped_array_file.hpp
+ * @brief Бинарный контейнер массивов (матрицы, сигналы) с чтением через mmap
+ *
+ * Замена текстовым CSV/JSON для больших входных данных: файл читается без
+ * разбора, payload отображается в память и передаётся в CreateBufferWithData
+ * напрямую со страниц файла (без промежуточного std::vector).
+ *
+ * ФОРМАТ (little-endian):
+ *
+ *   [0, 128)                 BinaryArrayHeader
+ *   [128, 128 + desc)        описание UTF-8 (без завершающего нуля)
+ *   [payload_offset, ...)    данные, payload_offset кратен 64
+ *
+ * Заголовок хранит dtype, shape и strides (в байтах, как у numpy), поэтому
+ * файл самоописывающийся: R_341.bin — Complex64 [341, 341], таблица Лагранжа —
+ * Float64 [48, 5].
+ *
+ * @code
+ * MappedArrayFile::ConvertMatrixCSV("Matrix/data/R_341.csv", "Matrix/data/R_341.bin");
+ *
+ * MappedArrayFile file("Matrix/data/R_341.bin");
+ * auto buffer = engine.CreateBufferWithData(file.Data<std::complex<float>>(), file.GetNumElements());
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Формат
+// ════════════════════════════════════════════════════════════════════════════
+
+enum class ArrayDType : uint32_t {
+    Float32 = 1,
+    Float64 = 2,
+    Complex64 = 3,      ///< std::complex<float> / cl_float2
+    Complex128 = 4,     ///< std::complex<double>
+    Int16 = 5,
+    ComplexInt16 = 6,   ///< I/Q int16 пары
+};
+
+/// Размер элемента в байтах (0 для неизвестного типа)
+size_t ArrayDTypeSize(ArrayDType dtype);
+
+/// Имя типа для сообщений ("complex64", ...)
+const char* ArrayDTypeName(ArrayDType dtype);
+
+/// Тип элемента C++ → ArrayDType
+template <typename T> struct ArrayDTypeOf;
+template <> struct ArrayDTypeOf<float> { static constexpr ArrayDType value = ArrayDType::Float32; };
+template <> struct ArrayDTypeOf<double> { static constexpr ArrayDType value = ArrayDType::Float64; };
+template <> struct ArrayDTypeOf<std::complex<float>> { static constexpr ArrayDType value = ArrayDType::Complex64; };
+template <> struct ArrayDTypeOf<std::complex<double>> { static constexpr ArrayDType value = ArrayDType::Complex128; };
+template <> struct ArrayDTypeOf<int16_t> { static constexpr ArrayDType value = ArrayDType::Int16; };
+
+struct BinaryArrayHeader {
+    static constexpr size_t MAX_DIMS = 4;
+    static constexpr size_t PAYLOAD_ALIGNMENT = 64;
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];                  ///< "LCHARRAY"
+    uint32_t version;
+    uint32_t dtype;                 ///< ArrayDType
+    uint32_t ndim;                  ///< 1..MAX_DIMS
+    uint32_t header_bytes;          ///< sizeof(BinaryArrayHeader)
+    uint64_t shape[MAX_DIMS];       ///< Неиспользуемые измерения = 1
+    uint64_t strides[MAX_DIMS];     ///< В байтах
+    uint64_t description_bytes;
+    uint64_t payload_offset;
+    uint64_t payload_bytes;
+    uint8_t reserved[16];
+};
+
+static_assert(sizeof(BinaryArrayHeader) == 128, "BinaryArrayHeader must be 128 bytes");
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: MappedArrayFile
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Файл массива, отображённый в память только для чтения
+ *
+ * Заголовок проверяется при открытии (сигнатура, версия, dtype, выход
+ * shape/strides за payload). Указатели Data() действительны до разрушения
+ * объекта.
+ */
+class MappedArrayFile {
+public:
+    /// @throws std::runtime_error если файл не открыт или заголовок невалиден
+    explicit MappedArrayFile(const std::string& path);
+    ~MappedArrayFile();
+
+    MappedArrayFile(const MappedArrayFile&) = delete;
+    MappedArrayFile& operator=(const MappedArrayFile&) = delete;
+    MappedArrayFile(MappedArrayFile&& other) noexcept;
+    MappedArrayFile& operator=(MappedArrayFile&& other) noexcept;
+
+    /**
+     * @brief Записать плотный row-major массив
+     * @param shape Размерности (1..MAX_DIMS), произведение = число элементов data
+     * @throws std::invalid_argument при неверной форме, std::runtime_error при ошибке записи
+     */
+    static void Write(const std::string& path, ArrayDType dtype, const std::vector<size_t>& shape,
+                      const void* data, const std::string& description = "");
+
+    template <typename T>
+    static void Write(const std::string& path, const std::vector<size_t>& shape, const std::vector<T>& data,
+                      const std::string& description = "") {
+        size_t count = 1;
+        for (size_t dim : shape) count *= dim;
+        if (count != data.size()) {
+            throw std::invalid_argument("MappedArrayFile::Write: shape has " + std::to_string(count) +
+                                        " elements, data " + std::to_string(data.size()));
+        }
+        Write(path, ArrayDTypeOf<T>::value, shape, data.data(), description);
+    }
+
+    /**
+     * @brief CSV матрицы (формат ReadComplexMatrixCSV, matrix_csv.hpp) → Complex64 [n, n]
+     * @return n
+     */
+    static size_t ConvertMatrixCSV(const std::string& csv_path, const std::string& output_path);
+
+    /// Начинается ли файл с сигнатуры контейнера (без проверки остального)
+    static bool IsArrayFile(const std::string& path);
+
+    const BinaryArrayHeader& GetHeader() const { return header_; }
+    ArrayDType GetDType() const { return static_cast<ArrayDType>(header_.dtype); }
+    size_t GetNumDims() const { return header_.ndim; }
+    std::vector<size_t> GetShape() const;
+    std::vector<size_t> GetStrides() const;
+    size_t GetNumElements() const { return num_elements_; }
+    size_t GetPayloadBytes() const { return static_cast<size_t>(header_.payload_bytes); }
+    /// Плотный row-major (strides совпадают с вычисленными по shape)
+    bool IsContiguous() const;
+    const std::string& GetDescription() const { return description_; }
+    const std::string& GetPath() const { return path_; }
+
+    const void* GetData() const { return payload_; }
+
+    /**
+     * @brief Payload как массив T
+     * @throws std::runtime_error если dtype файла не совпадает с T
+     */
+    template <typename T>
+    const T* Data() const {
+        RequireDType(ArrayDTypeOf<T>::value);
+        return static_cast<const T*>(payload_);
+    }
+
+    /// Копия плотного payload (для API, принимающих std::vector)
+    template <typename T>
+    std::vector<T> ToVector() const {
+        RequireContiguous();
+        const T* data = Data<T>();
+        return std::vector<T>(data, data + num_elements_);
+    }
+
+private:
+    void Release();
+    void Validate(size_t file_size);
+    void RequireDType(ArrayDType dtype) const;
+    void RequireContiguous() const;
+
+    std::string path_;
+    BinaryArrayHeader header_{};
+    std::string description_;
+    void* mapping_ = nullptr;           ///< Весь файл
+    size_t mapping_bytes_ = 0;
+    const void* payload_ = nullptr;
+    size_t num_elements_ = 0;
+};
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,68 @@
+#include "matrix_csv.hpp"
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace ManagerOpenCL {
+
+/// Граница re/im — последний знак не после экспоненты
+bool ParseComplexToken(const std::string& token, std::complex<float>& value) {
+    std::string t;
+    for (char c : token) {
+        if (!std::isspace(static_cast<unsigned char>(c))) t += c;
+    }
+    if (t.empty()) return false;
+
+    if (t.back() != 'i' && t.back() != 'j') {
+        value = {std::stof(t), 0.0f};
+        return true;
+    }
+    t.pop_back();
+    size_t split = std::string::npos;
+    for (size_t p = t.size(); p-- > 1;) {
+        if ((t[p] == '+' || t[p] == '-') && t[p - 1] != 'e' && t[p - 1] != 'E') {
+            split = p;
+            break;
+        }
+    }
+    if (split == std::string::npos) {
+        value = {0.0f, std::stof(t)};
+    } else {
+        value = {std::stof(t.substr(0, split)), std::stof(t.substr(split))};
+    }
+    return true;
+}
+
+std::vector<std::complex<float>> ReadComplexMatrixCSV(const std::string& path, size_t* n) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("ReadComplexMatrixCSV: cannot open " + path);
+    }
+
+    std::vector<std::complex<float>> data;
+    size_t rows = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string token;
+        size_t columns = 0;
+        while (std::getline(ss, token, ',')) {
+            std::complex<float> value;
+            if (ParseComplexToken(token, value)) {
+                data.push_back(value);
+                ++columns;
+            }
+        }
+        if (columns > 0) ++rows;
+    }
+
+    if (rows == 0 || data.size() != rows * rows) {
+        throw std::runtime_error("ReadComplexMatrixCSV: " + path + " is not a square matrix (" +
+                                 std::to_string(rows) + " rows, " + std::to_string(data.size()) + " elements)");
+    }
+    if (n) *n = rows;
+    return data;
+}
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file matrix_csv.hpp
+ * @brief Чтение квадратной комплексной матрицы из CSV (Matrix/data/R_*.csv)
+ *
+ * Общий разбор для HermitianInverter::LoadMatrixCSV и
+ * MappedArrayFile::ConvertMatrixCSV: без OpenCL и без зависимостей между ними.
+ *
+ * Формат: строка файла — строка матрицы, элементы через запятую в виде
+ * "re+imi" / "re-imi" / "re" (допускается суффикс 'j'), пробелы игнорируются.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include <complex>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+/**
+ * @brief Квадратная матрица из CSV (row-major)
+ * @param n Если не nullptr — размер матрицы
+ * @throws std::runtime_error если файл не открыт или матрица не квадратная
+ */
+std::vector<std::complex<float>> ReadComplexMatrixCSV(const std::string& path, size_t* n = nullptr);
+
+/// Элемент CSV → complex; false для пустого токена
+bool ParseComplexToken(const std::string& token, std::complex<float>& value);
+
+} // namespace ManagerOpenCL
@@ -243,6 +243,7 @@ void GPUMemoryBuffer::PrintStats() const {
 std::unique_ptr<OpenCLComputeEngine> OpenCLComputeEngine::instance_ = nullptr;
 bool OpenCLComputeEngine::initialized_ = false;
 std::mutex OpenCLComputeEngine::initialization_mutex_;
+TransferCalibrationConfig OpenCLComputeEngine::calibration_config_;
 
 OpenCLComputeEngine::OpenCLComputeEngine()
     : total_allocated_bytes_(0),
@@ -266,11 +267,40 @@ void OpenCLComputeEngine::Initialize(DeviceType device_type) {
 
     // Создать сам engine
     instance_ = std::unique_ptr<OpenCLComputeEngine>(new OpenCLComputeEngine());
+
+    // Калибровка передач для AUTO стратегии BufferFactory
+    if (calibration_config_.enabled) {
+        instance_->RunTransferCalibration();
+    }
+
     initialized_ = true;
 
     std::cout << "[OK] OpenCLComputeEngine initialized\n";
 }
 
+void OpenCLComputeEngine::SetCalibrationConfig(const TransferCalibrationConfig& config) {
+    std::lock_guard<std::mutex> lock(initialization_mutex_);
+    calibration_config_ = config;
+}
+
+void OpenCLComputeEngine::RunTransferCalibration() {
+    auto& core = OpenCLCore::GetInstance();
+    try {
+        calibration_ = std::make_shared<const TransferCalibration>(
+            TransferCalibration::LoadOrMeasure(
+                core.GetContext(),
+                CommandQueuePool::GetNextQueue(),
+                core.GetDevice(),
+                calibration_config_));
+        std::cout << "[OK] Transfer calibration "
+                  << (calibration_->IsFromCache() ? "loaded from cache" : "measured") << "\n";
+    } catch (const std::exception& e) {
+        calibration_.reset();
+        std::cerr << "[WARNING] Transfer calibration failed, using static heuristics: "
+                  << e.what() << "\n";
+    }
+}
+
 OpenCLComputeEngine& OpenCLComputeEngine::GetInstance() {
     if (!initialized_) {
         throw std::runtime_error(
@@ -333,6 +363,16 @@ std::unique_ptr<GPUMemoryBuffer> OpenCLComputeEngine::CreateBuffer(
 std::unique_ptr<GPUMemoryBuffer> OpenCLComputeEngine::CreateBufferWithData(
     const std::vector<std::complex<float>>& data,
     MemoryType type) {
+    return CreateBufferWithData(data.data(), data.size(), type);
+}
+
+std::unique_ptr<GPUMemoryBuffer> OpenCLComputeEngine::CreateBufferWithData(
+    const std::complex<float>* data,
+    size_t num_elements,
+    MemoryType type) {
+    if (!data || num_elements == 0) {
+        throw std::invalid_argument("CreateBufferWithData: data is null or empty");
+    }
     auto& core = OpenCLCore::GetInstance();
     // Используем CommandQueuePool для получения очереди
     cl_command_queue queue = CommandQueuePool::GetNextQueue();
@@ -340,9 +380,9 @@ std::unique_ptr<GPUMemoryBuffer> OpenCLComputeEngine::CreateBufferWithData(
     auto buffer = std::make_unique<GPUMemoryBuffer>(
         core.GetContext(),
         queue,
-        data.data(),
-        data.size() * sizeof(std::complex<float>),
-        data.size(),
+        data,
+        num_elements * sizeof(std::complex<float>),
+        num_elements,
         type
     );
 
@@ -455,12 +495,14 @@ std::unique_ptr<BufferFactory> OpenCLComputeEngine::CreateBufferFactory(
     auto& core = OpenCLCore::GetInstance();
     cl_command_queue queue = CommandQueuePool::GetNextQueue();
     
-    return std::make_unique<BufferFactory>(
+    auto factory = std::make_unique<BufferFactory>(
         core.GetContext(),
         queue,
         core.GetDevice(),
         config
     );
+    factory->SetCalibration(calibration_);
+    return factory;
 }
 
 std::unique_ptr<IMemoryBuffer> OpenCLComputeEngine::CreateHybridBuffer(
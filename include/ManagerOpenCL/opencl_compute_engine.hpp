@@ -7,6 +7,7 @@
 #include "gpu_memory_buffer.hpp"
 #include "svm_capabilities.hpp"
 #include "hybrid_buffer.hpp"
+#include "transfer_calibration.hpp"
 #include <CL/cl.h>
 #include <memory>
 #include <string>
@@ -92,6 +93,14 @@ public:
      */
     static void Cleanup();
 
+    /**
+     * @brief Задать настройки калибровки передач (вызывать до Initialize)
+     *
+     * По умолчанию калибровка выключена (AUTO по статическим эвристикам);
+     * включённая кэшируется в TransferCalibration::DefaultCacheDir().
+     */
+    static void SetCalibrationConfig(const TransferCalibrationConfig& config);
+
     // ═══════════════════════════════════════════════════════════════
     // Программы и kernels
     // ═══════════════════════════════════════════════════════════════
@@ -134,6 +143,16 @@ public:
         MemoryType type = MemoryType::GPU_READ_ONLY
     );
 
+    /**
+     * @brief Создать GPU буфер из произвольной памяти хоста (например, MappedArrayFile)
+     * Данные копируются прямо со страниц источника, без промежуточного std::vector
+     */
+    std::unique_ptr<GPUMemoryBuffer> CreateBufferWithData(
+        const std::complex<float>* data,
+        size_t num_elements,
+        MemoryType type = MemoryType::GPU_READ_ONLY
+    );
+
     /**
      * @brief Создать GPU буфер с начальными данными для любого POD-типа
      */
@@ -253,6 +272,11 @@ public:
      */
     std::string GetSVMInfo() const;
 
+    /**
+     * @brief Результаты калибровки передач (nullptr если калибровка отключена/не удалась)
+     */
+    std::shared_ptr<const TransferCalibration> GetTransferCalibration() const { return calibration_; }
+
     // ═══════════════════════════════════════════════════════════════
     // Информация и статистика
     // ═══════════════════════════════════════════════════════════════
@@ -291,6 +315,10 @@ private:
     static std::unique_ptr<OpenCLComputeEngine> instance_;
     static bool initialized_;
     static std::mutex initialization_mutex_;
+    static TransferCalibrationConfig calibration_config_;
+
+    /// Загрузить калибровку из кэша или измерить (ошибки не фатальны)
+    void RunTransferCalibration();
 
     // ═══════════════════════════════════════════════════════════════
     // Члены класса
@@ -299,6 +327,7 @@ private:
     size_t total_allocated_bytes_;
     size_t num_buffers_;
     size_t kernel_executions_;
+    std::shared_ptr<const TransferCalibration> calibration_;
 };
 
 // ==========================
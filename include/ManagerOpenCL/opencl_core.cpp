@@ -93,17 +93,25 @@ void OpenCLCore::InitializeOpenCL(DeviceType device_type) {
     err = clGetPlatformIDs(num_platforms, platforms.data(), nullptr);
     CheckCLError(err, "clGetPlatformIDs (get)");
 
-    platform_ = platforms[0];  // Используем первую платформу
-
     // 2. Получить девайсы
     cl_device_type cl_device_type =
         (device_type == DeviceType::GPU) ? CL_DEVICE_TYPE_GPU : CL_DEVICE_TYPE_CPU;
 
+    // Первая платформа, у которой есть девайс нужного типа
+    // (CPU часто живёт на отдельной платформе, например PoCL рядом с GPU драйвером)
     cl_uint num_devices = 0;
-    err = clGetDeviceIDs(platform_, cl_device_type, 0, nullptr, &num_devices);
-    CheckCLError(err, "clGetDeviceIDs (count)");
+    platform_ = nullptr;
+    for (cl_platform_id platform : platforms) {
+        cl_uint count = 0;
+        err = clGetDeviceIDs(platform, cl_device_type, 0, nullptr, &count);
+        if (err == CL_SUCCESS && count > 0) {
+            platform_ = platform;
+            num_devices = count;
+            break;
+        }
+    }
 
-    if (num_devices == 0) {
+    if (!platform_ || num_devices == 0) {
         throw std::runtime_error("No OpenCL devices found for specified type");
     }
 
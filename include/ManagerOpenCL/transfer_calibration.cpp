@@ -0,0 +1,431 @@
+#include "transfer_calibration.hpp"
+#include "hybrid_buffer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace ManagerOpenCL {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Ядро для оценки доступа устройства к памяти стратегии (чтение + запись)
+const char* kCalibrationKernelSource = R"CL(
+    __kernel void calib_touch(__global float2* data, uint n) {
+        uint gid = get_global_id(0);
+        if (gid < n) {
+            data[gid] = data[gid] * 1.0001f;
+        }
+    }
+)CL";
+
+constexpr const char* kCacheHeader = "# lch transfer calibration v2";
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool ParseStrategy(const std::string& text, MemoryStrategy& out) {
+    for (MemoryStrategy s : {MemoryStrategy::REGULAR_BUFFER, MemoryStrategy::SVM_COARSE_GRAIN,
+                             MemoryStrategy::SVM_FINE_GRAIN, MemoryStrategy::SVM_FINE_SYSTEM}) {
+        if (MemoryStrategyToString(s) == text) {
+            out = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string QueryDeviceString(cl_device_id device, cl_device_info param) {
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, nullptr, &size) != CL_SUCCESS || size == 0) {
+        return "unknown";
+    }
+    std::string value(size, '\0');
+    clGetDeviceInfo(device, param, size, &value[0], nullptr);
+    while (!value.empty() && value.back() == '\0') value.pop_back();
+    return value;
+}
+
+cl_kernel BuildCalibrationKernel(cl_context context, cl_device_id device, cl_program& program) {
+    cl_int err;
+    program = clCreateProgramWithSource(context, 1, &kCalibrationKernelSource, nullptr, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Calibration: clCreateProgramWithSource failed: " + std::to_string(err));
+    }
+
+    err = clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size + 1, '\0');
+        clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Calibration kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        program = nullptr;
+        throw std::runtime_error("Calibration: clBuildProgram failed: " + std::to_string(err));
+    }
+
+    cl_kernel kernel = clCreateKernel(program, "calib_touch", &err);
+    if (err != CL_SUCCESS) {
+        clReleaseProgram(program);
+        program = nullptr;
+        throw std::runtime_error("Calibration: clCreateKernel failed: " + std::to_string(err));
+    }
+    return kernel;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Измерение
+// ════════════════════════════════════════════════════════════════════════════
+
+TransferCalibration TransferCalibration::Measure(
+    cl_context context,
+    cl_command_queue queue,
+    cl_device_id device,
+    const TransferCalibrationConfig& config) {
+
+    TransferCalibration calib;
+    calib.device_key_ = DeviceKey(device);
+
+    // Factory без калибровки: стратегии задаются явно
+    BufferConfig factory_config = BufferConfig::Default();
+    factory_config.use_calibration = false;
+    BufferFactory factory(context, queue, device, factory_config);
+    const SVMCapabilities& caps = factory.GetCapabilities();
+
+    std::vector<MemoryStrategy> strategies = {MemoryStrategy::REGULAR_BUFFER};
+    if (caps.svm_supported && caps.coarse_grain_buffer) strategies.push_back(MemoryStrategy::SVM_COARSE_GRAIN);
+    if (caps.svm_supported && caps.fine_grain_buffer)   strategies.push_back(MemoryStrategy::SVM_FINE_GRAIN);
+    if (caps.svm_supported && caps.fine_grain_system)   strategies.push_back(MemoryStrategy::SVM_FINE_SYSTEM);
+
+    cl_program program = nullptr;
+    cl_kernel kernel = BuildCalibrationKernel(context, device, program);
+
+    const size_t repeats = std::max<size_t>(1, config.repeats);
+
+    try {
+        for (MemoryStrategy strategy : strategies) {
+            for (size_t size_bytes : config.sizes_bytes) {
+                const size_t num_elements =
+                    std::max<size_t>(1, (size_bytes + sizeof(ComplexFloat) - 1) / sizeof(ComplexFloat));
+                const size_t bytes = num_elements * sizeof(ComplexFloat);
+
+                std::unique_ptr<IMemoryBuffer> buffer;
+                try {
+                    buffer = factory.CreateWithStrategy(num_elements, strategy);
+                } catch (const std::exception& e) {
+                    if (config.verbose) {
+                        std::cerr << "[Calibration] " << MemoryStrategyToString(strategy)
+                                  << " skipped: " << e.what() << "\n";
+                    }
+                    break;
+                }
+                // Factory мог откатиться на Regular - такие точки не нужны
+                if (buffer->GetStrategy() != strategy) {
+                    break;
+                }
+
+                std::vector<ComplexFloat> host(num_elements, ComplexFloat(1.0f, 0.0f));
+                cl_uint n = static_cast<cl_uint>(num_elements);
+                size_t global_size = ((num_elements + 63) / 64) * 64;
+
+                TransferSample sample;
+                sample.strategy = strategy;
+                sample.size_bytes = bytes;
+                sample.write_ms = sample.read_ms = sample.kernel_ms = 1e30;
+
+                for (size_t r = 0; r < repeats; ++r) {
+                    auto t0 = Clock::now();
+                    buffer->WriteRaw(host.data(), bytes);
+                    clFinish(queue);
+                    sample.write_ms = std::min(sample.write_ms, ElapsedMs(t0));
+
+                    t0 = Clock::now();
+                    buffer->SetAsKernelArg(kernel, 0);
+                    clSetKernelArg(kernel, 1, sizeof(cl_uint), &n);
+                    cl_int err = clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &global_size,
+                                                        nullptr, 0, nullptr, nullptr);
+                    if (err != CL_SUCCESS) {
+                        throw std::runtime_error("Calibration: clEnqueueNDRangeKernel failed: " +
+                                                 std::to_string(err));
+                    }
+                    clFinish(queue);
+                    sample.kernel_ms = std::min(sample.kernel_ms, ElapsedMs(t0));
+
+                    t0 = Clock::now();
+                    buffer->ReadRaw(host.data(), bytes);
+                    clFinish(queue);
+                    sample.read_ms = std::min(sample.read_ms, ElapsedMs(t0));
+                }
+
+                calib.samples_.push_back(sample);
+            }
+        }
+    } catch (...) {
+        clReleaseKernel(kernel);
+        clReleaseProgram(program);
+        throw;
+    }
+
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+
+    if (config.verbose) {
+        std::cout << calib.ToString();
+    }
+    return calib;
+}
+
+TransferCalibration TransferCalibration::LoadOrMeasure(
+    cl_context context,
+    cl_command_queue queue,
+    cl_device_id device,
+    const TransferCalibrationConfig& config) {
+
+    const std::string path = CachePath(config.cache_dir.empty() ? DefaultCacheDir() : config.cache_dir, device);
+
+    if (config.use_cache) {
+        TransferCalibration cached;
+        if (cached.LoadFromFile(path, DeviceKey(device))) {
+            if (config.verbose) {
+                std::cout << "[Calibration] Loaded from " << path << "\n";
+            }
+            return cached;
+        }
+    }
+
+    TransferCalibration calib = Measure(context, queue, device, config);
+
+    if (config.use_cache) {
+        try {
+            calib.SaveToFile(path);
+            if (config.verbose) {
+                std::cout << "[Calibration] Saved to " << path << "\n";
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[WARNING] Calibration cache not saved: " << e.what() << "\n";
+        }
+    }
+    return calib;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Кэш на диске
+// ════════════════════════════════════════════════════════════════════════════
+
+std::string TransferCalibration::DeviceKey(cl_device_id device) {
+    std::string key = QueryDeviceString(device, CL_DEVICE_NAME) + "_" +
+                      QueryDeviceString(device, CL_DRIVER_VERSION);
+    for (char& c : key) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-') {
+            c = '_';
+        }
+    }
+    return key;
+}
+
+std::string TransferCalibration::DefaultCacheDir() {
+    if (const char* dir = std::getenv("LCH_CALIBRATION_DIR"); dir && *dir) {
+        return dir;
+    }
+    std::filesystem::path base;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        base = std::filesystem::path(home) / ".cache";
+    } else {
+        base = std::filesystem::temp_directory_path();
+    }
+    return (base / "lch-farrow" / "calibration").string();
+}
+
+std::string TransferCalibration::CachePath(const std::string& cache_dir, cl_device_id device) {
+    return (std::filesystem::path(cache_dir) / (DeviceKey(device) + ".csv")).string();
+}
+
+bool TransferCalibration::LoadFromFile(const std::string& path, const std::string& device_key) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kCacheHeader) {
+        return false;
+    }
+    if (!std::getline(in, line) || line != "device=" + device_key) {
+        return false;
+    }
+    std::getline(in, line);  // заголовок колонок
+
+    std::vector<TransferSample> samples;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string field;
+        TransferSample s;
+
+        if (!std::getline(ss, field, ',') || !ParseStrategy(field, s.strategy)) return false;
+        try {
+            std::getline(ss, field, ','); s.size_bytes = std::stoull(field);
+            std::getline(ss, field, ','); s.write_ms = std::stod(field);
+            std::getline(ss, field, ','); s.read_ms = std::stod(field);
+            std::getline(ss, field, ','); s.kernel_ms = std::stod(field);
+        } catch (const std::exception&) {
+            return false;
+        }
+        samples.push_back(s);
+    }
+
+    if (samples.empty()) {
+        return false;
+    }
+    samples_ = std::move(samples);
+    device_key_ = device_key;
+    from_cache_ = true;
+    return true;
+}
+
+void TransferCalibration::SaveToFile(const std::string& path) const {
+    std::filesystem::path fs_path(path);
+    if (fs_path.has_parent_path()) {
+        std::filesystem::create_directories(fs_path.parent_path());
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+
+    out << kCacheHeader << "\n";
+    out << "device=" << device_key_ << "\n";
+    out << "strategy,size_bytes,write_ms,read_ms,kernel_ms\n";
+    out << std::setprecision(9);
+    for (const auto& s : samples_) {
+        out << MemoryStrategyToString(s.strategy) << ',' << s.size_bytes << ','
+            << s.write_ms << ',' << s.read_ms << ',' << s.kernel_ms << "\n";
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Модель и выбор стратегии
+// ════════════════════════════════════════════════════════════════════════════
+
+double TransferCalibration::SampleValue(const TransferSample& s, Op op) {
+    switch (op) {
+        case Op::WRITE:  return s.write_ms;
+        case Op::READ:   return s.read_ms;
+        case Op::KERNEL: return s.kernel_ms;
+    }
+    return 0.0;
+}
+
+TransferCalibration::Model TransferCalibration::FitModel(MemoryStrategy strategy, Op op) const {
+    std::vector<const TransferSample*> points;
+    for (const auto& s : samples_) {
+        if (s.strategy == strategy) points.push_back(&s);
+    }
+
+    Model model;
+    if (points.empty()) {
+        return model;
+    }
+    std::sort(points.begin(), points.end(),
+              [](const TransferSample* a, const TransferSample* b) { return a->size_bytes < b->size_bytes; });
+
+    const TransferSample& largest = *points.back();
+    const double t_max = SampleValue(largest, op);
+
+    // Пропускная способность - по наклону между двумя крупнейшими точками
+    if (points.size() >= 2) {
+        const TransferSample& prev = *points[points.size() - 2];
+        const double dt = t_max - SampleValue(prev, op);
+        const double ds = static_cast<double>(largest.size_bytes - prev.size_bytes);
+        if (dt > 0.0 && ds > 0.0) {
+            model.bytes_per_ms = ds / dt;
+        }
+    }
+    if (model.bytes_per_ms <= 0.0) {
+        model.bytes_per_ms = t_max > 0.0 ? largest.size_bytes / t_max : 1e12;
+    }
+
+    // Латентность - остаток на самой маленькой точке
+    const TransferSample& smallest = *points.front();
+    model.latency_ms = std::max(0.0, SampleValue(smallest, op) - smallest.size_bytes / model.bytes_per_ms);
+    return model;
+}
+
+double TransferCalibration::Estimate(MemoryStrategy strategy, Op op, size_t size_bytes) const {
+    return FitModel(strategy, op).Estimate(size_bytes);
+}
+
+std::vector<MemoryStrategy> TransferCalibration::GetStrategies() const {
+    std::vector<MemoryStrategy> result;
+    for (const auto& s : samples_) {
+        if (std::find(result.begin(), result.end(), s.strategy) == result.end()) {
+            result.push_back(s.strategy);
+        }
+    }
+    return result;
+}
+
+MemoryStrategy TransferCalibration::SelectStrategy(size_t size_bytes, const BufferUsageHint& hint) const {
+    // gpu_only сюда не доходит: HybridBuffer::DetermineStrategy отдаёт REGULAR раньше
+    const double w_write = hint.frequent_host_write ? 4.0 : 1.0;
+    const double w_read = hint.frequent_host_read ? 4.0 : 1.0;
+
+    MemoryStrategy best = MemoryStrategy::REGULAR_BUFFER;
+    double best_cost = -1.0;
+
+    for (MemoryStrategy strategy : GetStrategies()) {
+        const double cost = w_write * Estimate(strategy, Op::WRITE, size_bytes) +
+                            w_read * Estimate(strategy, Op::READ, size_bytes) +
+                            Estimate(strategy, Op::KERNEL, size_bytes);
+        if (best_cost < 0.0 || cost < best_cost) {
+            best_cost = cost;
+            best = strategy;
+        }
+    }
+    return best;
+}
+
+std::string TransferCalibration::ToString() const {
+    std::ostringstream oss;
+    oss << "\n" << std::string(66, '=') << "\n";
+    oss << "Transfer Calibration (" << device_key_ << (from_cache_ ? ", cached" : "") << ")\n";
+    oss << std::string(66, '=') << "\n";
+    oss << std::left << std::setw(18) << "Strategy" << std::right
+        << std::setw(12) << "Size KB" << std::setw(12) << "Write ms" << std::setw(12) << "Read ms"
+        << std::setw(12) << "Kernel ms" << "\n";
+    oss << std::string(66, '-') << "\n";
+    oss << std::fixed << std::setprecision(4);
+    for (const auto& s : samples_) {
+        oss << std::left << std::setw(18) << MemoryStrategyToString(s.strategy) << std::right
+            << std::setw(12) << std::setprecision(0) << s.size_bytes / 1024.0 << std::setprecision(4)
+            << std::setw(12) << s.write_ms << std::setw(12) << s.read_ms
+            << std::setw(12) << s.kernel_ms << "\n";
+    }
+    oss << std::string(66, '-') << "\n";
+    oss << std::setprecision(2);
+    for (MemoryStrategy strategy : GetStrategies()) {
+        oss << std::left << std::setw(18) << MemoryStrategyToString(strategy) << std::right
+            << "  write " << FitModel(strategy, Op::WRITE).GetBandwidthGBps() << " GB/s"
+            << "  read " << FitModel(strategy, Op::READ).GetBandwidthGBps() << " GB/s"
+            << "  kernel " << FitModel(strategy, Op::KERNEL).GetBandwidthGBps() << " GB/s\n";
+    }
+    oss << std::string(66, '=') << "\n";
+    return oss.str();
+}
+
+} // namespace ManagerOpenCL
@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file transfer_calibration.hpp
+ * @brief Калибровка пропускной способности передач для AUTO стратегии памяти
+ *
+ * По запросу (TransferCalibrationConfig::enabled) при инициализации
+ * OpenCLComputeEngine для каждой поддерживаемой стратегии
+ * (REGULAR / SVM_COARSE / SVM_FINE / SVM_SYSTEM) измеряется время:
+ * - write  : хост → буфер (WriteRaw; для SVM — через Map/Unmap)
+ * - read   : буфер → хост (ReadRaw)
+ * - kernel : проход ядра по буферу (чтение + запись на устройстве)
+ *
+ * По измерениям строится модель t(size) = latency + size / bandwidth
+ * и BufferFactory выбирает стратегию с минимальной оценкой стоимости.
+ * Результаты кэшируются по ключу устройства (имя + драйвер) в
+ * пользовательском каталоге кэша, повторный запуск на том же хосте
+ * калибровку не повторяет.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "svm_capabilities.hpp"
+#include <CL/cl.h>
+#include <string>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: TransferCalibrationConfig - настройки калибровки
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @struct TransferCalibrationConfig
+ * @brief Параметры калибровки (задаются до OpenCLComputeEngine::Initialize)
+ */
+struct TransferCalibrationConfig {
+    bool enabled = false;                         ///< Выполнять калибровку при Initialize
+    bool use_cache = true;                        ///< Читать/писать кэш на диске
+    std::string cache_dir;                        ///< Каталог кэша (файл на устройство); пусто = DefaultCacheDir()
+    std::vector<size_t> sizes_bytes = {           ///< Размеры тестовых буферов
+        4 * 1024,
+        256 * 1024,
+        4 * 1024 * 1024,
+        32 * 1024 * 1024
+    };
+    size_t repeats = 3;                           ///< Повторов на точку (берётся минимум)
+    bool verbose = false;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: TransferSample - одно измерение
+// ════════════════════════════════════════════════════════════════════════════
+
+struct TransferSample {
+    MemoryStrategy strategy = MemoryStrategy::REGULAR_BUFFER;
+    size_t size_bytes = 0;
+    double write_ms  = 0.0;
+    double read_ms   = 0.0;
+    double kernel_ms = 0.0;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: TransferCalibration
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class TransferCalibration
+ * @brief Измеренные характеристики передач и выбор стратегии по ним
+ *
+ * @code
+ * auto calib = TransferCalibration::LoadOrMeasure(context, queue, device, config);
+ * MemoryStrategy s = calib.SelectStrategy(16 * 1024 * 1024, BufferUsageHint::FrequentTransfer());
+ * @endcode
+ */
+class TransferCalibration {
+public:
+    /// Операции, для которых строится модель
+    enum class Op { WRITE, READ, KERNEL };
+
+    /// Модель t(size) = latency_ms + size / bytes_per_ms
+    struct Model {
+        double latency_ms = 0.0;
+        double bytes_per_ms = 0.0;
+
+        double Estimate(size_t size_bytes) const {
+            return bytes_per_ms > 0.0 ? latency_ms + size_bytes / bytes_per_ms : 0.0;
+        }
+        double GetBandwidthGBps() const { return bytes_per_ms * 1e3 / 1e9; }
+    };
+
+    TransferCalibration() = default;
+
+    /**
+     * @brief Выполнить измерения для всех стратегий, поддерживаемых устройством
+     * @throws std::runtime_error при ошибке OpenCL
+     */
+    static TransferCalibration Measure(
+        cl_context context,
+        cl_command_queue queue,
+        cl_device_id device,
+        const TransferCalibrationConfig& config = TransferCalibrationConfig{}
+    );
+
+    /**
+     * @brief Загрузить из кэша или измерить и сохранить
+     */
+    static TransferCalibration LoadOrMeasure(
+        cl_context context,
+        cl_command_queue queue,
+        cl_device_id device,
+        const TransferCalibrationConfig& config = TransferCalibrationConfig{}
+    );
+
+    /// Ключ устройства для кэша: имя + версия драйвера (без спецсимволов)
+    static std::string DeviceKey(cl_device_id device);
+
+    /// $LCH_CALIBRATION_DIR, иначе $XDG_CACHE_HOME (~/.cache)/lch-farrow/calibration
+    static std::string DefaultCacheDir();
+
+    /// Путь к файлу кэша для устройства
+    static std::string CachePath(const std::string& cache_dir, cl_device_id device);
+
+    /// Загрузить из файла (false если нет файла или другой device_key)
+    bool LoadFromFile(const std::string& path, const std::string& device_key);
+
+    /// Сохранить в файл (CSV с заголовком)
+    void SaveToFile(const std::string& path) const;
+
+    /**
+     * @brief Выбрать стратегию по оценке стоимости
+     *
+     * Стоимость = write + read + kernel (веса ×4 для frequent_host_write/read).
+     * gpu_only не учитывается: такие буферы — REGULAR до калибровки (DetermineStrategy).
+     */
+    MemoryStrategy SelectStrategy(size_t size_bytes, const BufferUsageHint& hint) const;
+
+    /// Оценка времени операции (мс) для стратегии
+    double Estimate(MemoryStrategy strategy, Op op, size_t size_bytes) const;
+
+    /// Есть ли измерения
+    bool IsValid() const { return !samples_.empty(); }
+
+    /// Стратегии, для которых есть измерения
+    std::vector<MemoryStrategy> GetStrategies() const;
+
+    const std::vector<TransferSample>& GetSamples() const { return samples_; }
+    const std::string& GetDeviceKey() const { return device_key_; }
+    bool IsFromCache() const { return from_cache_; }
+
+    /// Таблица измерений
+    std::string ToString() const;
+
+private:
+    Model FitModel(MemoryStrategy strategy, Op op) const;
+    static double SampleValue(const TransferSample& s, Op op);
+
+    std::vector<TransferSample> samples_;
+    std::string device_key_;
+    bool from_cache_ = false;
+};
+
+} // namespace ManagerOpenCL
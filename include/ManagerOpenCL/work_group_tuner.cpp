@@ -0,0 +1,311 @@
+#include "work_group_tuner.hpp"
+#include "transfer_calibration.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace ManagerOpenCL {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr const char* kDbHeader = "# lch work-group tuning v1";
+
+size_t RoundUpPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/**
+ * Время одного запуска: профилирование события, если очередь его поддерживает,
+ * иначе время хоста вокруг clWaitForEvents. Отрицательное значение — ошибка запуска.
+ */
+double TimeLaunch(cl_command_queue queue, const WorkGroupConfig& config,
+                  const WorkGroupTuner::LaunchFn& launch) {
+    cl_event event = nullptr;
+    auto host_start = Clock::now();
+    cl_int err = launch(queue, config, &event);
+    if (err != CL_SUCCESS || event == nullptr) {
+        if (event) clReleaseEvent(event);
+        return -1.0;
+    }
+    err = clWaitForEvents(1, &event);
+    double host_ms = std::chrono::duration<double, std::milli>(Clock::now() - host_start).count();
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event);
+        return -1.0;
+    }
+
+    cl_ulong start = 0, end = 0;
+    cl_int e1 = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr);
+    cl_int e2 = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr);
+    clReleaseEvent(event);
+
+    if (e1 == CL_SUCCESS && e2 == CL_SUCCESS && end > start) {
+        return (end - start) * 1e-6;
+    }
+    return host_ms;
+}
+
+} // anonymous namespace
+
+WorkGroupTunerConfig WorkGroupTuner::config_;
+std::unordered_map<std::string, WorkGroupConfig> WorkGroupTuner::entries_;
+std::unordered_map<cl_device_id, std::string> WorkGroupTuner::device_keys_;
+bool WorkGroupTuner::loaded_ = false;
+std::mutex WorkGroupTuner::mutex_;
+
+// ════════════════════════════════════════════════════════════════════════════
+// Настройки и ключи
+// ════════════════════════════════════════════════════════════════════════════
+
+void WorkGroupTuner::SetConfig(const WorkGroupTunerConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    entries_.clear();
+    loaded_ = false;
+}
+
+WorkGroupTunerConfig WorkGroupTuner::GetConfig() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+const std::string& WorkGroupTuner::DeviceKeyLocked(cl_device_id device) {
+    auto it = device_keys_.find(device);
+    if (it == device_keys_.end()) {
+        it = device_keys_.emplace(device, TransferCalibration::DeviceKey(device)).first;
+    }
+    return it->second;
+}
+
+std::string WorkGroupTuner::MakeKey(const std::string& kernel_name, cl_device_id device, size_t problem_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return DeviceKeyLocked(device) + "|" + kernel_name + "|" + std::to_string(RoundUpPow2(problem_size));
+}
+
+std::vector<size_t> WorkGroupTuner::CandidateLocalSizes(cl_kernel kernel, cl_device_id device, size_t max_local) {
+    size_t kernel_max = 0;
+    size_t multiple = 0;
+    if (clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(size_t), &kernel_max, nullptr) != CL_SUCCESS || kernel_max == 0) {
+        clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(size_t), &kernel_max, nullptr);
+    }
+    if (clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                 sizeof(size_t), &multiple, nullptr) != CL_SUCCESS || multiple == 0) {
+        multiple = 1;
+    }
+
+    size_t limit = kernel_max;
+    if (max_local > 0) limit = std::min(limit, max_local);
+    if (limit == 0) return {};
+
+    size_t min_local;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        min_local = config_.min_local_size;
+    }
+
+    std::vector<size_t> candidates;
+    for (size_t size = multiple; size <= limit; size *= 2) {
+        if (size >= min_local) {
+            candidates.push_back(size);
+        }
+    }
+    // Лимит меньше min_local_size (или multiple) — берём наибольший допустимый
+    if (candidates.empty()) {
+        candidates.push_back(multiple <= limit ? multiple : limit);
+    }
+    return candidates;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Поиск и подбор
+// ════════════════════════════════════════════════════════════════════════════
+
+bool WorkGroupTuner::Lookup(const std::string& kernel_name, cl_device_id device,
+                            size_t problem_size, WorkGroupConfig& out) {
+    const std::string key = MakeKey(kernel_name, device, problem_size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    EnsureLoaded();
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+WorkGroupConfig WorkGroupTuner::Tune(const std::string& kernel_name,
+                                     cl_kernel kernel,
+                                     cl_device_id device,
+                                     cl_command_queue queue,
+                                     size_t problem_size,
+                                     size_t fallback_local,
+                                     const std::vector<size_t>& items_candidates,
+                                     const LaunchFn& launch,
+                                     size_t max_local) {
+    WorkGroupConfig fallback;
+    fallback.local_size = fallback_local;
+
+    WorkGroupTunerConfig config = GetConfig();
+    if (!config.enabled) {
+        return fallback;
+    }
+
+    WorkGroupConfig cached;
+    if (Lookup(kernel_name, device, problem_size, cached)) {
+        return cached;
+    }
+
+    const std::string key = MakeKey(kernel_name, device, problem_size);
+    const std::vector<size_t> items_list = items_candidates.empty() ? std::vector<size_t>{1} : items_candidates;
+
+    WorkGroupConfig best;
+    best.time_ms = std::numeric_limits<double>::max();
+
+    for (size_t local : CandidateLocalSizes(kernel, device, max_local)) {
+        for (size_t items : items_list) {
+            WorkGroupConfig candidate;
+            candidate.local_size = local;
+            candidate.items_per_work_item = items;
+
+            bool failed = false;
+            for (size_t w = 0; w < config.warmup && !failed; ++w) {
+                failed = TimeLaunch(queue, candidate, launch) < 0.0;
+            }
+            double best_ms = std::numeric_limits<double>::max();
+            for (size_t r = 0; r < std::max<size_t>(config.repeats, 1) && !failed; ++r) {
+                double ms = TimeLaunch(queue, candidate, launch);
+                if (ms < 0.0) {
+                    failed = true;
+                } else {
+                    best_ms = std::min(best_ms, ms);
+                }
+            }
+            // Кандидат, который не запустился (CL_INVALID_WORK_GROUP_SIZE и т.п.), пропускаем
+            if (failed) {
+                continue;
+            }
+            if (config.verbose) {
+                std::cout << "[WorkGroupTuner] " << kernel_name << " local=" << local
+                          << " items=" << items << " : " << std::fixed << std::setprecision(4)
+                          << best_ms << " ms\n";
+            }
+            if (best_ms < best.time_ms) {
+                candidate.time_ms = best_ms;
+                best = candidate;
+            }
+        }
+    }
+
+    if (!best.IsValid()) {
+        std::cerr << "[WARNING] WorkGroupTuner: no valid candidate for " << kernel_name
+                  << ", using local=" << fallback_local << "\n";
+        return fallback;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key] = best;
+    if (config.use_cache && !config.db_path.empty()) {
+        try {
+            SaveLocked();
+        } catch (const std::exception& e) {
+            std::cerr << "[WARNING] Work-group tuning DB not saved: " << e.what() << "\n";
+        }
+    }
+    if (config.verbose) {
+        std::cout << "[WorkGroupTuner] " << key << " -> local=" << best.local_size
+                  << " items=" << best.items_per_work_item << "\n";
+    }
+    return best;
+}
+
+void WorkGroupTuner::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    loaded_ = false;
+}
+
+size_t WorkGroupTuner::GetCacheSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// База на диске
+// ════════════════════════════════════════════════════════════════════════════
+
+void WorkGroupTuner::EnsureLoaded() {
+    if (loaded_) {
+        return;
+    }
+    loaded_ = true;
+    if (!config_.use_cache || config_.db_path.empty()) {
+        return;
+    }
+
+    std::ifstream in(config_.db_path);
+    if (!in.is_open()) {
+        return;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kDbHeader) {
+        std::cerr << "[WARNING] WorkGroupTuner: unknown DB format in " << config_.db_path << "\n";
+        return;
+    }
+    std::getline(in, line);  // заголовок колонок
+
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string key, field;
+        WorkGroupConfig entry;
+        if (!std::getline(ss, key, ',')) continue;
+        try {
+            std::getline(ss, field, ','); entry.local_size = std::stoull(field);
+            std::getline(ss, field, ','); entry.items_per_work_item = std::stoull(field);
+            std::getline(ss, field, ','); entry.time_ms = std::stod(field);
+        } catch (const std::exception&) {
+            continue;
+        }
+        // Записи, подобранные в этом процессе, приоритетнее файла
+        if (entry.IsValid()) {
+            entries_.emplace(key, entry);
+        }
+    }
+}
+
+void WorkGroupTuner::SaveLocked() {
+    std::filesystem::path fs_path(config_.db_path);
+    if (fs_path.has_parent_path()) {
+        std::filesystem::create_directories(fs_path.parent_path());
+    }
+
+    // Через временный файл: параллельные процессы не увидят недописанную базу
+    const std::string tmp_path = config_.db_path + ".tmp";
+    {
+        std::ofstream out(tmp_path);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + tmp_path);
+        }
+        out << kDbHeader << "\n";
+        out << "key,local_size,items_per_work_item,time_ms\n";
+        out << std::setprecision(9);
+        for (const auto& [key, entry] : entries_) {
+            out << key << ',' << entry.local_size << ',' << entry.items_per_work_item << ','
+                << entry.time_ms << "\n";
+        }
+    }
+    std::filesystem::rename(tmp_path, config_.db_path);
+}
+
+} // namespace ManagerOpenCL
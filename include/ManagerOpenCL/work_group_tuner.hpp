@@ -0,0 +1,156 @@
+#pragma once
+
+/**
+ * @file work_group_tuner.hpp
+ * @brief Автоподбор local work size для ядер с сохранением результатов на диск
+ *
+ * Для пары (ядро, размер задачи, устройство) перебираются кандидаты local size —
+ * кратные CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE в пределах
+ * CL_KERNEL_WORK_GROUP_SIZE и ограничения ядра (локальные массивы), а для ядер
+ * с grid-stride циклом ещё и число элементов на work-item. Каждый кандидат
+ * запускается через функцию вызывающего кода, время берётся из профилирования
+ * событий (минимум из повторов). Победитель хранится в памяти процесса, а при
+ * заданном db_path пишется в CSV базу — повторный запуск на том же устройстве
+ * перебор не повторяет. По умолчанию db_path пуст: библиотека ничего не пишет
+ * на диск, пока вызывающий код не выберет каталог (например, рядом с кэшем
+ * TransferCalibration::DefaultCacheDir()).
+ *
+ * Размер задачи округляется вверх до степени двойки, чтобы близкие размеры
+ * делили одну запись.
+ *
+ * @code
+ * auto wg = WorkGroupTuner::Tune(
+ *     "fractional_delay_kernel", kernel, device, queue, total, 256, {1, 2, 4},
+ *     [&](cl_command_queue q, const WorkGroupConfig& c, cl_event* ev) {
+ *         size_t local = c.local_size;
+ *         size_t global = RoundUp(total / c.items_per_work_item, local);
+ *         return clEnqueueNDRangeKernel(q, kernel, 1, nullptr, &global, &local, 0, nullptr, ev);
+ *     });
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include <CL/cl.h>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ManagerOpenCL {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: WorkGroupTunerConfig - настройки тюнера
+// ════════════════════════════════════════════════════════════════════════════
+
+struct WorkGroupTunerConfig {
+    bool enabled = true;                              ///< false — всегда fallback, без замеров
+    bool use_cache = true;                            ///< Читать/писать базу на диске
+    std::string db_path;                              ///< CSV база; пусто — подбор только в памяти процесса
+    size_t warmup = 1;                                ///< Прогонов без замера на кандидата
+    size_t repeats = 3;                               ///< Замеров на кандидата (берётся минимум)
+    size_t min_local_size = 32;                       ///< Нижняя граница кандидатов
+    bool verbose = false;
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Struct: WorkGroupConfig - выбранная конфигурация запуска
+// ════════════════════════════════════════════════════════════════════════════
+
+struct WorkGroupConfig {
+    size_t local_size = 0;            ///< 0 = не определено
+    size_t items_per_work_item = 1;   ///< Элементов на work-item (grid-stride ядра)
+    double time_ms = 0.0;             ///< Лучшее измеренное время (0 для fallback)
+
+    bool IsValid() const { return local_size > 0 && items_per_work_item > 0; }
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Class: WorkGroupTuner - статический кэш + база настроек
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @class WorkGroupTuner
+ * @brief Подбор и хранение local size по ключу (устройство, ядро, размер)
+ *
+ * Потокобезопасен: замеры для разных устройств идут параллельно
+ * (мьютекс держится только на время доступа к таблице).
+ */
+class WorkGroupTuner {
+public:
+    /**
+     * @brief Запустить ядро с конфигурацией кандидата
+     *
+     * Аргументы ядра уже выставлены вызывающим кодом. Функция должна поставить
+     * ядро в очередь и вернуть событие в *event (для профилирования).
+     */
+    using LaunchFn = std::function<cl_int(cl_command_queue queue,
+                                          const WorkGroupConfig& config,
+                                          cl_event* event)>;
+
+    /// Задать настройки (до первого Tune/Lookup; сбрасывает загруженную базу)
+    static void SetConfig(const WorkGroupTunerConfig& config);
+    static WorkGroupTunerConfig GetConfig();
+
+    /**
+     * @brief Найти конфигурацию в кэше/базе без замеров
+     * @return false если записи нет
+     */
+    static bool Lookup(const std::string& kernel_name,
+                       cl_device_id device,
+                       size_t problem_size,
+                       WorkGroupConfig& out);
+
+    /**
+     * @brief Вернуть сохранённую конфигурацию или подобрать её замером
+     *
+     * @param fallback_local Local size, если тюнер выключен или все кандидаты упали
+     * @param items_candidates Кандидаты элементов на work-item ({1} — ядро без цикла)
+     * @param max_local Ограничение ядра сверху (0 = только лимиты устройства)
+     */
+    static WorkGroupConfig Tune(const std::string& kernel_name,
+                                cl_kernel kernel,
+                                cl_device_id device,
+                                cl_command_queue queue,
+                                size_t problem_size,
+                                size_t fallback_local,
+                                const std::vector<size_t>& items_candidates,
+                                const LaunchFn& launch,
+                                size_t max_local = 0);
+
+    /**
+     * @brief Кандидаты local size для ядра на устройстве
+     *
+     * preferred_multiple * 2^k, не больше min(CL_KERNEL_WORK_GROUP_SIZE, max_local),
+     * не меньше min_local_size (если возможно).
+     */
+    static std::vector<size_t> CandidateLocalSizes(cl_kernel kernel,
+                                                   cl_device_id device,
+                                                   size_t max_local = 0);
+
+    /// Ключ записи: устройство|ядро|размер (размер округлён до степени двойки)
+    static std::string MakeKey(const std::string& kernel_name, cl_device_id device, size_t problem_size);
+
+    /// Очистить кэш в памяти (база на диске не трогается)
+    static void Clear();
+
+    static size_t GetCacheSize();
+
+private:
+    static void EnsureLoaded();           // под mutex_
+    static void SaveLocked();             // под mutex_
+    static const std::string& DeviceKeyLocked(cl_device_id device);
+
+    static WorkGroupTunerConfig config_;
+    static std::unordered_map<std::string, WorkGroupConfig> entries_;
+    static std::unordered_map<cl_device_id, std::string> device_keys_;
+    static bool loaded_;
+    static std::mutex mutex_;
+
+    WorkGroupTuner() = delete;
+};
+
+} // namespace ManagerOpenCL
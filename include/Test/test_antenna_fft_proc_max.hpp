@@ -54,6 +54,54 @@ void test_process_new_small();
  */
 void test_process_new_large();
 
+/**
+ * @brief Тест 8: Сжатие импульса (ProcessPulseCompression)
+ * Короткий ЛЧМ импульс с разной задержкой в каждом луче → пик на отсчёте задержки
+ */
+void test_pulse_compression();
+
+/**
+ * @brief Тест 9: Уточнение максимумов zoom-DTFT (RefinePeaks)
+ * Тоны между бинами: частота до 0.01 бина и фаза против истинных
+ */
+void test_zoom_refinement();
+
+/**
+ * @brief Тест 10: Разреженный вывод спектра (ProcessSparse)
+ * Глобальный и по-лучевой порог, переполнение выходного буфера
+ */
+void test_sparse_spectrum();
+
+/**
+ * @brief Тест 11: Вещественный вход (ProcessReal, R2C)
+ * Совпадение с комплексным путём; окно fftshift из половины спектра
+ */
+void test_real_input();
+
+/**
+ * @brief Тест 12: In-place FFT (SetInPlaceFFT)
+ * ProcessNew и параллельные батчи in-place против out-of-place
+ */
+void test_inplace_fft();
+
+/**
+ * @brief Тест 13: Раскладка входа (SetInputLayout)
+ * SAMPLE_MAJOR float/int16 с заголовком и шаг строки против beam-major
+ */
+void test_input_layout();
+
+/**
+ * @brief Тест 14: Некогерентное накопление (ProcessIntegrated)
+ * Слабый тон в шуме: среднее и EMA по 16 кадрам, чтение раз в 16 кадров
+ */
+void test_integration();
+
+/**
+ * @brief Тест 15: Формирование лучей (Beamformer, тайловое GEMM)
+ * Y против CPU, нулевой хвост строки, кэш весов, ProcessBeamformed против Process(Y)
+ */
+void test_beamforming();
+
 /**
  * @brief Запуск всех тестов
  */
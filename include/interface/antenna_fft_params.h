@@ -53,6 +53,70 @@ struct FFTResult {
           task_id(task), module_name(module) {}
 };
 
+/**
+ * @brief Порядок отсчётов во входном буфере
+ */
+enum class InputLayout {
+    BEAM_MAJOR,    // [beam][sample]: beam * count_points + pos (по умолчанию)
+    SAMPLE_MAJOR   // [sample][beam]: pos * beam_count + beam (порядок АЦП)
+};
+
+/**
+ * @brief Формат комплексного отсчёта во входном буфере
+ */
+enum class InputSampleFormat {
+    FLOAT32_IQ,    // float2
+    INT16_IQ       // short2, масштабируется на int16_scale
+};
+
+/**
+ * @struct InputLayoutDesc
+ * @brief Описание раскладки входного кадра (padding читает кадр как есть, без транспонирования на CPU)
+ * 
+ * Отсчёт (beam, pos) лежит по индексу offset + beam * beam_stride + pos * sample_stride
+ * (в отсчётах выбранного формата). Нулевые шаги берутся из layout.
+ */
+struct InputLayoutDesc {
+    InputLayout layout;
+    InputSampleFormat format;
+    size_t offset;             // Отсчётов до первого (заголовок кадра)
+    size_t beam_stride;        // 0 = count_points (BEAM_MAJOR) / 1 (SAMPLE_MAJOR)
+    size_t sample_stride;      // 0 = 1 (BEAM_MAJOR) / beam_count (SAMPLE_MAJOR)
+    float int16_scale;         // INT16_IQ: множитель (1/32768 → [-1, 1))
+    
+    InputLayoutDesc()
+        : layout(InputLayout::BEAM_MAJOR), format(InputSampleFormat::FLOAT32_IQ),
+          offset(0), beam_stride(0), sample_stride(0), int16_scale(1.0f / 32768.0f) {}
+    
+    size_t GetBeamStride(size_t count_points) const noexcept {
+        if (beam_stride != 0) return beam_stride;
+        return layout == InputLayout::BEAM_MAJOR ? count_points : 1;
+    }
+    
+    size_t GetSampleStride(size_t beam_count) const noexcept {
+        if (sample_stride != 0) return sample_stride;
+        return layout == InputLayout::BEAM_MAJOR ? 1 : beam_count;
+    }
+    
+    size_t GetSampleBytes() const noexcept {
+        return format == InputSampleFormat::INT16_IQ ? 2 * sizeof(short) : 2 * sizeof(float);
+    }
+    
+    /// Отсчётов в кадре: до последнего используемого включительно
+    size_t GetFrameSamples(size_t beam_count, size_t count_points) const noexcept {
+        if (beam_count == 0 || count_points == 0) return offset;
+        return offset + (beam_count - 1) * GetBeamStride(count_points) +
+               (count_points - 1) * GetSampleStride(beam_count) + 1;
+    }
+    
+    /// Плотный beam-major float2: обрабатывается исходным padding_kernel / pre-callback
+    bool IsDefault(size_t beam_count, size_t count_points) const noexcept {
+        return format == InputSampleFormat::FLOAT32_IQ && offset == 0 &&
+               (beam_count <= 1 || GetBeamStride(count_points) == count_points) &&
+               GetSampleStride(beam_count) == 1;
+    }
+};
+
 /**
  * @struct AntennaFFTParams
  * @brief Входные параметры для AntennaFFTProcMax
@@ -105,6 +169,145 @@ struct AntennaFFTResult {
     }
 };
 
+/**
+ * @brief Как трактовать index_point грубых максимумов при уточнении
+ */
+enum class ZoomIndexMode {
+    FFT_BIN,          // Бин FFT [0, nFFT): Process(cl_mem) / post_kernel
+    FFTSHIFT_WINDOW   // Окно после fftshift [0, out_count_points_fft): findMaximaAndPhase
+};
+
+/**
+ * @struct ZoomFFTParams
+ * @brief Параметры уточнения частоты вокруг найденных максимумов (zoom-DTFT)
+ */
+struct ZoomFFTParams {
+    size_t zoom_factor;        // Точек сетки на один бин nFFT (16 → шаг 1/16 бина)
+    float span_bins;           // Полуширина полосы вокруг максимума, бинов nFFT
+    float sample_rate;         // Гц, для frequency_hz
+    ZoomIndexMode index_mode;
+    
+    ZoomFFTParams()
+        : zoom_factor(16), span_bins(1.0f), sample_rate(12.0e6f), index_mode(ZoomIndexMode::FFT_BIN) {}
+    
+    bool IsValid() const noexcept {
+        return zoom_factor > 0 && span_bins > 0.0f && sample_rate > 0.0f;
+    }
+};
+
+/**
+ * @struct RefinedPeak
+ * @brief Уточнённый максимум
+ */
+struct RefinedPeak {
+    size_t coarse_index;       // index_point грубого максимума
+    float refined_bin;         // Бин nFFT со знаком (отрицательный — отрицательные частоты)
+    float frequency_hz;
+    float amplitude;
+    float phase;               // Фаза в градусах
+    float real;
+    float imag;
+    
+    RefinedPeak() : coarse_index(0), refined_bin(0.0f), frequency_hz(0.0f), amplitude(0.0f),
+                    phase(0.0f), real(0.0f), imag(0.0f) {}
+};
+
+/**
+ * @struct ZoomFFTResult
+ * @brief Уточнённые максимумы всех лучей
+ */
+struct ZoomFFTResult {
+    std::vector<std::vector<RefinedPeak>> beams;   // [beam][peak], порядок как в грубом результате
+    size_t points_per_peak;                        // Точек сетки на максимум
+    double kernel_time_ms;
+    
+    ZoomFFTResult() : points_per_peak(0), kernel_time_ms(0.0) {}
+};
+
+/**
+ * @struct SparseSpectrumParams
+ * @brief Порог разреженного вывода спектра (только бины выше порога)
+ */
+struct SparseSpectrumParams {
+    float threshold;                    // Порог по |X| для всех лучей
+    std::vector<float> beam_thresholds; // Порог на луч (пусто = threshold), размер beam_count
+    size_t max_entries;                 // Ёмкость выходного буфера (все лучи вместе)
+    
+    SparseSpectrumParams() : threshold(0.0f), beam_thresholds(), max_entries(65536) {}
+    
+    bool IsValid(size_t beam_count) const noexcept {
+        return max_entries > 0 && (beam_thresholds.empty() || beam_thresholds.size() == beam_count);
+    }
+};
+
+/**
+ * @struct SparseSpectrumEntry
+ * @brief Бин спектра выше порога
+ */
+struct SparseSpectrumEntry {
+    size_t beam;
+    size_t bin;                // Индекс в окне (как index_point)
+    float real;
+    float imag;
+    float magnitude;
+    
+    SparseSpectrumEntry() : beam(0), bin(0), real(0.0f), imag(0.0f), magnitude(0.0f) {}
+};
+
+/**
+ * @struct SparseSpectrumResult
+ * @brief Разреженный спектр всех лучей, отсортирован по (beam, bin)
+ */
+struct SparseSpectrumResult {
+    std::vector<SparseSpectrumEntry> entries;
+    size_t total_count;        // Бинов выше порога (может быть > entries.size())
+    size_t num_bins;           // Бинов окна на луч
+    double kernel_time_ms;
+    
+    SparseSpectrumResult() : entries(), total_count(0), num_bins(0), kernel_time_ms(0.0) {}
+    
+    bool Overflowed() const noexcept { return total_count > entries.size(); }
+};
+
+/**
+ * @brief Как накапливать |X| (или |X|²) по кадрам
+ */
+enum class IntegrationMode {
+    AVERAGE,       // Среднее по frames кадрам; после выдачи накопитель обнуляется
+    EXPONENTIAL    // EMA: acc = (1 - alpha) * acc + alpha * v; выдача каждые frames кадров
+};
+
+/**
+ * @struct IntegrationParams
+ * @brief Некогерентное накопление спектра перед поиском максимумов
+ */
+struct IntegrationParams {
+    size_t frames;             // M: поиск максимумов и чтение на хост раз в M кадров
+    IntegrationMode mode;
+    bool use_power;            // Накапливать |X|² (amplitude результата = sqrt среднего)
+    float alpha;               // EXPONENTIAL: вес нового кадра, (0, 1]
+    
+    IntegrationParams()
+        : frames(4), mode(IntegrationMode::AVERAGE), use_power(false), alpha(0.25f) {}
+    
+    bool IsValid() const noexcept {
+        return frames > 0 && (mode != IntegrationMode::EXPONENTIAL || (alpha > 0.0f && alpha <= 1.0f));
+    }
+};
+
+/**
+ * @struct IntegrationResult
+ * @brief Результат очередного кадра накопления
+ */
+struct IntegrationResult {
+    bool ready;                // Максимумы найдены на этом кадре (каждый frames-й)
+    size_t frames_integrated;  // Кадров в накопителе (при ready — вошедших в результат)
+    AntennaFFTResult maxima;   // Только при ready; amplitude накопленная, phase/Re/Im — текущего кадра
+    double kernel_time_ms;     // integrate_frame (+ post_kernel при ready)
+    
+    IntegrationResult() : ready(false), frames_integrated(0), maxima(), kernel_time_ms(0.0) {}
+};
+
 /**
  * @struct FFTProfilingResults
  * @brief Результаты профилирования FFT операций
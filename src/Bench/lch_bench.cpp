@@ -0,0 +1,1045 @@
+/**
+ * @file lch_bench.cpp
+ * @brief lch_bench - бенчмарк GPU модулей с перебором параметров
+ *
+ * Перебирает сетку параметров и для каждой точки выполняет warm-up + N
+ * измеряемых итераций. Для каждого этапа (upload / FFT / post / kernel / wall)
+ * считаются min / median / p99 / mean, а также пропускная способность
+ * в отсчётах/сек и GB/s. Результаты пишутся в JSON и CSV, чтобы их можно было
+ * сравнивать между коммитами (в шапку JSON пишется git ревизия и устройство).
+ *
+ * МОДУЛИ:
+ * - fft : AntennaFFTProcMax::Process   (beams × count_points × out_fft × max_peaks)
+ * - fdp : FractionalDelayProcessor      (beams × samples)
+ * - gen : GeneratorGPU::signal_base     (beams × count_points)
+ * - inv : cpu_linalg::HermitianCPUInverter (batch × n; без OpenCL, цель из
+ *         Matrix/README.md — < 4 мс на матрицу 341 × 341; для n = 341 в JSON
+ *         target_met и PASS/FAIL в консоли)
+ *
+ * ЗАПИСЬ / ВОСПРОИЗВЕДЕНИЕ (antenna_fft::FrameRecorder / FrameReplayer):
+ * --record пишет кадры GeneratorGPU (beams[0] × points[0]) вместе с параметрами
+ * FFT / FDP; --replay прогоняет запись через FDP → AntennaFFTProcMax в заданном
+ * темпе и добавляет случай "replay": задержка кадра, время обслуживания,
+ * сброшенные кадры и устойчивая пропускная способность.
+ *
+ * ПРИМЕРЫ:
+ * @code
+ *   ./lch_bench --device cpu --quick
+ *   ./lch_bench --device gpu --modules fft --beams 64,256 --points 8192,65536 \
+ *               --out-fft 512 --peaks 3,5 --iters 50 --out Reports/bench/gpu
+ *   ./lch_bench --convert   # Matrix/data/R_*.csv, lagrange_matrix.json → .bin
+ *   ./lch_bench --record Reports/replay/run.lchrec --beams 64 --points 8192 --record-frames 256
+ *   ./lch_bench --replay Reports/replay/run.lchrec --rate 2000 --queue 2 --loops 4
+ * @endcode
+ *
+ * @author LCH-Farrow01 Project
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+#include "GPU/antenna_fft_proc_max.h"
+#include "GPU/fractional_delay_processor.hpp"
+#include "GPU/frame_replay.hpp"
+#include "GPU/generator_gpu_new.h"
+#include "interface/lfm_parameters.h"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/matrix_csv.hpp"
+#include "ManagerOpenCL/mapped_array_file.hpp"
+#include "CPU/hermitian_cpu_inverter.hpp"
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifndef LCH_GIT_REVISION
+#define LCH_GIT_REVISION "unknown"
+#endif
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+// ============================================================================
+// КОНФИГУРАЦИЯ ЗАПУСКА
+// ============================================================================
+
+struct BenchOptions {
+    ManagerOpenCL::DeviceType device = ManagerOpenCL::DeviceType::GPU;
+    size_t warmup = 3;
+    size_t iterations = 20;
+    bool run_fft = true;
+    bool run_fdp = true;
+    bool run_gen = true;
+    bool run_inv = true;
+    bool quiet = true;                         ///< Глушить std::cout модулей во время замеров
+    bool convert = false;                      ///< Только CSV/JSON → .bin и выход
+    bool calibrate = false;                    ///< Калибровка передач для AUTO стратегии при Initialize
+
+    std::vector<size_t> beams      = {16, 64, 256};
+    std::vector<size_t> points     = {1024, 8192, 65536};
+    std::vector<size_t> out_fft    = {512};
+    std::vector<size_t> peaks      = {3, 5};
+    std::vector<size_t> fdp_beams  = {16, 64, 256};
+    std::vector<size_t> fdp_points = {8192, 65536, 1048576};
+    std::vector<size_t> inv_sizes  = {85, 341};
+    std::vector<size_t> inv_batch  = {1, 16};
+    size_t inv_threads = 0;                    ///< 0 = hardware_concurrency
+    std::string matrix_dir = "Matrix/data";
+
+    std::string lagrange_path = "lagrange_matrix.json";
+    std::string out_prefix = "Reports/bench/lch_bench";
+
+    std::string record_path;                   ///< Записать кадры и выйти
+    size_t record_frames = 64;
+    std::string replay_path;                   ///< Воспроизвести запись (случай "replay")
+    antenna_fft::ReplayOptions replay;
+};
+
+// ============================================================================
+// СТАТИСТИКА
+// ============================================================================
+
+/// Замеры этапа; сводка — antenna_fft::LatencySummary::From (общая с FrameReplayer)
+struct Stage {
+    std::string name;
+    std::vector<double> samples_ms;
+};
+
+/**
+ * @brief Одна точка сетки параметров с замерами по этапам
+ *
+ * bytes_per_iter - оценка трафика глобальной памяти за итерацию
+ * (чтения + записи всех этапов), по ней считается GB/s.
+ */
+struct BenchCase {
+    std::string module;
+    size_t beams = 0;
+    size_t points = 0;
+    size_t out_fft = 0;
+    size_t peaks = 0;
+    size_t nfft = 0;
+    size_t samples_per_iter = 0;
+    size_t bytes_per_iter = 0;
+    std::vector<Stage> stages;
+    std::string error;
+
+    // Только "inv": размер матрицы, матриц за итерацию, потоков CPU
+    size_t matrix_size = 0;
+    size_t batch = 0;
+    size_t threads = 0;
+
+    // Только "replay": устойчивый темп по wall-clock и сброшенные кадры
+    size_t frames_offered = 0;
+    size_t frames_dropped = 0;
+    double frames_per_sec = 0.0;
+
+    Stage& AddStage(const std::string& name) {
+        stages.push_back({name, {}});
+        return stages.back();
+    }
+};
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНОЕ
+// ============================================================================
+
+/// Случай с AntennaFFTProcMax ("fft", "replay" с записанными FFT параметрами)
+bool HasFFTParams(const BenchCase& bc) {
+    return bc.out_fft > 0;
+}
+
+/// Глушит std::cout на время жизни объекта (модули печатают каждый вызов)
+class ScopedSilence {
+public:
+    explicit ScopedSilence(bool enabled) : old_(nullptr) {
+        if (enabled) old_ = std::cout.rdbuf(&null_buf_);
+    }
+    ~ScopedSilence() {
+        if (old_) std::cout.rdbuf(old_);
+    }
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+    };
+    NullBuffer null_buf_;
+    std::streambuf* old_;
+};
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<size_t> ParseList(const std::string& text) {
+    std::vector<size_t> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<size_t>(std::stoull(item)));
+    }
+    if (values.empty()) {
+        throw std::invalid_argument("empty list: '" + text + "'");
+    }
+    return values;
+}
+
+size_t NextPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+std::vector<std::complex<float>> MakeTestSignal(size_t beams, size_t points) {
+    std::vector<std::complex<float>> data(beams * points);
+    for (size_t b = 0; b < beams; ++b) {
+        const float freq = 0.01f + 0.002f * static_cast<float>(b % 64);
+        for (size_t i = 0; i < points; ++i) {
+            const float phase = 2.0f * 3.14159265f * freq * static_cast<float>(i);
+            data[b * points + i] = {std::cos(phase), std::sin(phase)};
+        }
+    }
+    return data;
+}
+
+// ============================================================================
+// МОДУЛЬ: AntennaFFTProcMax
+// ============================================================================
+
+BenchCase BenchAntennaFFT(const BenchOptions& opt, size_t beams, size_t points,
+                          size_t out_fft, size_t peaks) {
+    BenchCase bc;
+    bc.module = "fft";
+    bc.beams = beams;
+    bc.points = points;
+    bc.out_fft = out_fft;
+    bc.peaks = peaks;
+    bc.nfft = NextPow2(points) * 2;
+    bc.samples_per_iter = beams * points;
+    // copy input → userdata (R+W) + FFT (R+W nFFT) + post (R search_range)
+    bc.bytes_per_iter = 2 * beams * points * sizeof(std::complex<float>) +
+                        2 * beams * bc.nfft * sizeof(std::complex<float>) +
+                        beams * out_fft * sizeof(std::complex<float>);
+
+    auto& upload = bc.AddStage("upload");
+    auto& fft = bc.AddStage("fft");
+    auto& post = bc.AddStage("post");
+    auto& gpu_total = bc.AddStage("gpu_total");
+    auto& wall = bc.AddStage("wall");
+
+    try {
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto input = engine.CreateBufferWithData(MakeTestSignal(beams, points),
+                                                 ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+
+        antenna_fft::AntennaFFTParams params(beams, points, out_fft, peaks, "bench", "lch_bench");
+        ScopedSilence silence(opt.quiet);
+        antenna_fft::AntennaFFTProcMax processor(params);
+        bc.nfft = processor.GetNFFT();
+
+        for (size_t i = 0; i < opt.warmup; ++i) {
+            processor.Process(input->Get());
+        }
+
+        for (size_t i = 0; i < opt.iterations; ++i) {
+            auto t0 = Clock::now();
+            processor.Process(input->Get());
+            wall.samples_ms.push_back(ElapsedMs(t0));
+
+            const auto& prof = processor.GetLastProfilingResults();
+            upload.samples_ms.push_back(prof.upload_time_ms);
+            fft.samples_ms.push_back(prof.fft_time_ms);
+            post.samples_ms.push_back(prof.post_callback_time_ms);
+            gpu_total.samples_ms.push_back(prof.total_time_ms);
+        }
+    } catch (const std::exception& e) {
+        bc.error = e.what();
+    }
+    return bc;
+}
+
+// ============================================================================
+// МОДУЛЬ: FractionalDelayProcessor
+// ============================================================================
+
+BenchCase BenchFractionalDelay(const BenchOptions& opt, const radar::LagrangeMatrix& lagrange,
+                               size_t beams, size_t samples) {
+    BenchCase bc;
+    bc.module = "fdp";
+    bc.beams = beams;
+    bc.points = samples;
+    bc.samples_per_iter = beams * samples;
+    // kernel (R+W) + copy temp → input (R+W)
+    bc.bytes_per_iter = 4 * beams * samples * sizeof(radar::Complex);
+
+    auto& upload = bc.AddStage("upload");
+    auto& kernel = bc.AddStage("kernel");
+    auto& gpu_total = bc.AddStage("gpu_total");
+    auto& wall = bc.AddStage("wall");
+
+    try {
+        auto config = radar::FractionalDelayConfig::Standard();
+        config.num_beams = static_cast<uint32_t>(beams);
+        config.num_samples = static_cast<uint32_t>(samples);
+        config.verbose = false;
+        config.enable_profiling = true;
+        if (!config.IsValid()) {
+            throw std::invalid_argument("FractionalDelayConfig out of range");
+        }
+
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto buffer = engine.CreateBufferWithData(MakeTestSignal(beams, samples),
+                                                  ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+
+        std::vector<radar::DelayParams> delays(beams);
+        for (size_t b = 0; b < beams; ++b) {
+            delays[b] = radar::DelayParams::FromSamples(0.37f * static_cast<float>(b));
+        }
+
+        ScopedSilence silence(opt.quiet);
+        radar::FractionalDelayProcessor processor(config, lagrange);
+
+        for (size_t i = 0; i < opt.warmup; ++i) {
+            processor.Process(buffer->Get(), delays);
+        }
+
+        for (size_t i = 0; i < opt.iterations; ++i) {
+            auto t0 = Clock::now();
+            processor.Process(buffer->Get(), delays);
+            wall.samples_ms.push_back(ElapsedMs(t0));
+
+            const auto& prof = processor.GetLastProfiling();
+            upload.samples_ms.push_back(prof.upload_time_ms);
+            kernel.samples_ms.push_back(prof.kernel_time_ms);
+            gpu_total.samples_ms.push_back(prof.total_time_ms);
+        }
+    } catch (const std::exception& e) {
+        bc.error = e.what();
+    }
+    return bc;
+}
+
+// ============================================================================
+// МОДУЛЬ: GeneratorGPU
+// ============================================================================
+
+BenchCase BenchGenerator(const BenchOptions& opt, size_t beams, size_t points) {
+    BenchCase bc;
+    bc.module = "gen";
+    bc.beams = beams;
+    bc.points = points;
+    bc.samples_per_iter = beams * points;
+    bc.bytes_per_iter = beams * points * sizeof(std::complex<float>);
+
+    auto& wall = bc.AddStage("wall");
+
+    try {
+        LFMParameters lfm;
+        lfm.num_beams = beams;
+        lfm.count_points = points;
+        lfm.f_start = 100.0f;
+        lfm.f_stop = 500.0f;
+        lfm.sample_rate = 12.0e6f;
+
+        ScopedSilence silence(opt.quiet);
+        radar::GeneratorGPU generator(lfm);
+
+        for (size_t i = 0; i < opt.warmup; ++i) {
+            generator.signal_base();
+            ManagerOpenCL::CommandQueuePool::FinishAll();
+        }
+
+        for (size_t i = 0; i < opt.iterations; ++i) {
+            auto t0 = Clock::now();
+            generator.signal_base();
+            ManagerOpenCL::CommandQueuePool::FinishAll();
+            wall.samples_ms.push_back(ElapsedMs(t0));
+        }
+    } catch (const std::exception& e) {
+        bc.error = e.what();
+    }
+    return bc;
+}
+
+// ============================================================================
+// МОДУЛЬ: HermitianCPUInverter (обращение на CPU)
+// ============================================================================
+
+/// Цель Matrix/README.md: < 4 мс на одну матрицу 341 × 341
+constexpr size_t kInverseTargetSize = 341;
+constexpr double kInverseTargetMs = 4.0;
+
+/// Медиана per_matrix (мс на матрицу), 0 если этапа нет
+double InverseMsPerMatrix(const BenchCase& bc) {
+    for (const auto& st : bc.stages) {
+        if (st.name == "per_matrix") return antenna_fft::LatencySummary::From(st.samples_ms).median_ms;
+    }
+    return 0.0;
+}
+
+/// Цель задана только для n = kInverseTargetSize
+bool HasInverseTarget(const BenchCase& bc) {
+    return bc.module == "inv" && bc.matrix_size == kInverseTargetSize && bc.error.empty();
+}
+
+/**
+ * Матрица R_<n>.bin / R_<n>.csv из matrix_dir (если есть) или синтетическая
+ * B·B^H / n + I; диагональная нагрузка 1e-2·trace/n, как в test_cpu_linalg
+ */
+std::vector<std::complex<float>> MakeCovariance(const BenchOptions& opt, size_t n) {
+    std::vector<std::complex<float>> R;
+    const std::string bin_path = opt.matrix_dir + "/R_" + std::to_string(n) + ".bin";
+    const std::string path = opt.matrix_dir + "/R_" + std::to_string(n) + ".csv";
+    if (std::filesystem::exists(bin_path)) {
+        ManagerOpenCL::MappedArrayFile file(bin_path);
+        if (file.GetShape() == std::vector<size_t>{n, n}) {
+            R = file.ToVector<std::complex<float>>();
+        }
+    }
+    if (R.empty() && std::filesystem::exists(path)) {
+        size_t loaded = 0;
+        R = ManagerOpenCL::ReadComplexMatrixCSV(path, &loaded);
+        if (loaded != n) R.clear();
+    }
+    if (R.empty()) {
+        std::vector<std::complex<float>> B(n * n);
+        for (size_t i = 0; i < n * n; ++i) {
+            B[i] = {std::sin(0.37f * i), std::cos(0.11f * i + 0.5f)};
+        }
+        R.assign(n * n, {0.0f, 0.0f});
+        for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            std::complex<float> sum(0.0f, 0.0f);
+            for (size_t k = 0; k < n; ++k) sum += B[i * n + k] * std::conj(B[j * n + k]);
+            R[i * n + j] = sum / static_cast<float>(n);
+        }
+        for (size_t i = 0; i < n; ++i) R[i * n + i] += 1.0f;
+    }
+    float trace = 0.0f;
+    for (size_t i = 0; i < n; ++i) trace += R[i * n + i].real();
+    for (size_t i = 0; i < n; ++i) R[i * n + i] += 1e-2f * trace / n;
+    return R;
+}
+
+BenchCase BenchCPUInverse(const BenchOptions& opt, size_t n, size_t batch) {
+    BenchCase bc;
+    bc.module = "inv";
+    bc.matrix_size = n;
+    bc.batch = batch;
+    bc.samples_per_iter = batch;                     // матриц за итерацию
+    bc.bytes_per_iter = 2 * batch * n * n * sizeof(std::complex<float>);
+
+    auto& factor = bc.AddStage("factor");
+    auto& invert = bc.AddStage("trtri");
+    auto& product = bc.AddStage("product");
+    auto& per_matrix = bc.AddStage("per_matrix");
+    auto& wall = bc.AddStage("wall");
+
+    try {
+        const auto R = MakeCovariance(opt, n);
+        std::vector<std::complex<float>> input;
+        input.reserve(batch * n * n);
+        for (size_t b = 0; b < batch; ++b) input.insert(input.end(), R.begin(), R.end());
+        std::vector<std::complex<float>> output(input.size());
+
+        cpu_linalg::HermitianCPUInverter inverter(n, opt.inv_threads);
+        bc.threads = inverter.GetThreadCount();
+
+        for (size_t i = 0; i < opt.warmup; ++i) {
+            inverter.InvertBatched(input.data(), output.data(), batch);
+        }
+
+        for (size_t i = 0; i < opt.iterations; ++i) {
+            auto t0 = Clock::now();
+            inverter.InvertBatched(input.data(), output.data(), batch);
+            wall.samples_ms.push_back(ElapsedMs(t0));
+
+            const auto& stats = inverter.GetLastStats();
+            factor.samples_ms.push_back(stats.factor_ms);
+            invert.samples_ms.push_back(stats.invert_ms);
+            product.samples_ms.push_back(stats.product_ms);
+            per_matrix.samples_ms.push_back(stats.ms_per_matrix);
+        }
+    } catch (const std::exception& e) {
+        bc.error = e.what();
+    }
+    return bc;
+}
+
+// ============================================================================
+// ЗАПИСЬ / ВОСПРОИЗВЕДЕНИЕ КАДРОВ
+// ============================================================================
+
+/**
+ * Кадры GeneratorGPU::signal_base (beams[0] × points[0]) с параметрами
+ * AntennaFFT (out_fft[0], peaks[0]) и FDP (Standard, задержки 0.37·b, как
+ * в BenchFractionalDelay). Метки времени — моменты готовности кадров.
+ */
+int RecordFrames(const BenchOptions& opt) {
+    const size_t beams = opt.beams.front();
+    const size_t points = opt.points.front();
+    try {
+        antenna_fft::FrameRecordingInfo info;
+        info.fft = antenna_fft::AntennaFFTParams(beams, points, opt.out_fft.front(), opt.peaks.front(),
+                                                 "bench", "lch_bench");
+        info.fdp = radar::FractionalDelayConfig::Standard();
+        info.fdp.num_beams = static_cast<uint32_t>(beams);
+        info.fdp.num_samples = static_cast<uint32_t>(points);
+        info.fdp.verbose = false;
+        info.has_fdp = info.fdp.IsValid();
+        if (info.has_fdp) {
+            for (size_t b = 0; b < beams; ++b) {
+                info.delays.push_back(radar::DelayParams::FromSamples(0.37f * static_cast<float>(b)));
+            }
+        }
+
+        std::filesystem::path path(opt.record_path);
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        LFMParameters lfm;
+        lfm.num_beams = beams;
+        lfm.count_points = points;
+        lfm.f_start = 100.0f;
+        lfm.f_stop = 500.0f;
+        lfm.sample_rate = 12.0e6f;
+
+        ScopedSilence silence(opt.quiet);
+        radar::GeneratorGPU generator(lfm);
+        antenna_fft::FrameRecorder recorder(opt.record_path, info);
+        cl_command_queue queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+        for (size_t i = 0; i < opt.record_frames; ++i) {
+            cl_mem frame = generator.signal_base();
+            ManagerOpenCL::CommandQueuePool::FinishAll();
+            recorder.Append(frame, queue);
+        }
+        recorder.Close();
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Record failed: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "  📄 " << opt.record_path << " (" << opt.record_frames << " frames, "
+              << beams << " x " << points << ")\n";
+    return 0;
+}
+
+BenchCase BenchReplay(const BenchOptions& opt) {
+    BenchCase bc;
+    bc.module = "replay";
+
+    auto& latency = bc.AddStage("latency");
+    auto& service = bc.AddStage("service");    // последним: по нему ThroughputStage
+
+    try {
+        antenna_fft::FrameRecording recording(opt.replay_path);
+        const auto& info = recording.GetInfo();
+        bc.beams = info.beam_count;
+        bc.points = info.count_points;
+        bc.out_fft = info.fft.out_count_points_fft;
+        bc.peaks = info.fft.max_peaks_count;
+        bc.nfft = bc.out_fft > 0 ? NextPow2(info.count_points) * 2 : 0;
+        bc.samples_per_iter = recording.GetFrameElements();
+        // загрузка кадра (W) + FDP (4 прохода, как в BenchFractionalDelay)
+        bc.bytes_per_iter = (info.has_fdp ? 5 : 1) * recording.GetFrameElements() * sizeof(std::complex<float>);
+
+        std::unique_ptr<radar::LagrangeMatrix> lagrange;
+        if (info.has_fdp) {
+            lagrange = std::make_unique<radar::LagrangeMatrix>(radar::LagrangeMatrix::Load(opt.lagrange_path));
+        }
+
+        auto options = opt.replay;
+        options.warmup = opt.warmup;
+        ScopedSilence silence(opt.quiet);
+        antenna_fft::FrameReplayer replayer(recording);
+        auto stats = replayer.RunPipeline(options, lagrange.get());
+
+        latency.samples_ms = std::move(stats.latency_ms);
+        service.samples_ms = std::move(stats.service_ms);
+        bc.frames_offered = stats.frames_offered;
+        bc.frames_dropped = stats.frames_dropped;
+        bc.frames_per_sec = stats.frames_per_sec;
+    } catch (const std::exception& e) {
+        bc.error = e.what();
+    }
+    return bc;
+}
+
+// ============================================================================
+// ВЫВОД РЕЗУЛЬТАТОВ
+// ============================================================================
+
+/// Этап, по которому считается пропускная способность (wall-clock)
+const Stage* ThroughputStage(const BenchCase& bc) {
+    for (const auto& st : bc.stages) {
+        if (st.name == "wall") return &st;
+    }
+    return bc.stages.empty() ? nullptr : &bc.stages.back();
+}
+
+double SamplesPerSec(const BenchCase& bc, double ms) {
+    return ms > 0.0 ? bc.samples_per_iter * 1000.0 / ms : 0.0;
+}
+
+double GBytesPerSec(const BenchCase& bc, double ms) {
+    return ms > 0.0 ? bc.bytes_per_iter / (ms * 1e-3) / 1e9 : 0.0;
+}
+
+std::string JsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:   out += c; break;
+        }
+    }
+    return out;
+}
+
+std::string TimestampNow() {
+    auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm_buf;
+#ifdef _WIN32
+    localtime_s(&tm_buf, &time_t);
+#else
+    localtime_r(&time_t, &tm_buf);
+#endif
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm_buf);
+    return buf;
+}
+
+void WriteJSON(const std::string& path, const BenchOptions& opt,
+               const std::vector<BenchCase>& cases) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+
+    auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n";
+    out << "  \"tool\": \"lch_bench\",\n";
+    out << "  \"git_revision\": \"" << LCH_GIT_REVISION << "\",\n";
+    out << "  \"timestamp\": \"" << TimestampNow() << "\",\n";
+    out << "  \"device\": {\n";
+    out << "    \"type\": \"" << (opt.device == ManagerOpenCL::DeviceType::CPU ? "CPU" : "GPU") << "\",\n";
+    out << "    \"name\": \"" << JsonEscape(core.GetDeviceName()) << "\",\n";
+    out << "    \"vendor\": \"" << JsonEscape(core.GetVendor()) << "\",\n";
+    out << "    \"driver\": \"" << JsonEscape(core.GetDriverVersion()) << "\",\n";
+    out << "    \"compute_units\": " << core.GetComputeUnits() << ",\n";
+    out << "    \"global_memory_bytes\": " << core.GetGlobalMemorySize() << "\n";
+    out << "  },\n";
+    out << "  \"warmup\": " << opt.warmup << ",\n";
+    out << "  \"iterations\": " << opt.iterations << ",\n";
+    out << "  \"cases\": [\n";
+
+    for (size_t c = 0; c < cases.size(); ++c) {
+        const auto& bc = cases[c];
+        out << "    {\n";
+        out << "      \"module\": \"" << bc.module << "\",\n";
+        if (bc.module == "inv") {
+            out << "      \"matrix_size\": " << bc.matrix_size << ",\n";
+            out << "      \"batch\": " << bc.batch << ",\n";
+            out << "      \"threads\": " << bc.threads << ",\n";
+            if (HasInverseTarget(bc)) {
+                out << "      \"target_ms_per_matrix\": " << kInverseTargetMs << ",\n";
+                out << "      \"target_met\": " << (InverseMsPerMatrix(bc) < kInverseTargetMs ? "true" : "false") << ",\n";
+            }
+        } else {
+            out << "      \"beams\": " << bc.beams << ",\n";
+            out << "      \"count_points\": " << bc.points << ",\n";
+        }
+        if (HasFFTParams(bc)) {
+            out << "      \"out_count_points_fft\": " << bc.out_fft << ",\n";
+            out << "      \"max_peaks\": " << bc.peaks << ",\n";
+            out << "      \"nfft\": " << bc.nfft << ",\n";
+        }
+        out << "      \"samples_per_iter\": " << bc.samples_per_iter << ",\n";
+        out << "      \"bytes_per_iter\": " << bc.bytes_per_iter << ",\n";
+        if (!bc.error.empty()) {
+            out << "      \"error\": \"" << JsonEscape(bc.error) << "\",\n";
+        }
+        if (bc.module == "replay") {
+            out << "      \"frames_offered\": " << bc.frames_offered << ",\n";
+            out << "      \"dropped_frames\": " << bc.frames_dropped << ",\n";
+            out << "      \"frames_per_sec\": " << bc.frames_per_sec << ",\n";
+        }
+
+        const Stage* tp = ThroughputStage(bc);
+        const double tp_ms = tp ? antenna_fft::LatencySummary::From(tp->samples_ms).median_ms : 0.0;
+        out << "      \"samples_per_sec\": " << SamplesPerSec(bc, tp_ms) << ",\n";
+        out << "      \"gbytes_per_sec\": " << GBytesPerSec(bc, tp_ms) << ",\n";
+
+        out << "      \"stages\": {\n";
+        for (size_t s = 0; s < bc.stages.size(); ++s) {
+            const auto sum = antenna_fft::LatencySummary::From(bc.stages[s].samples_ms);
+            out << "        \"" << bc.stages[s].name << "\": {"
+                << "\"min_ms\": " << sum.min_ms << ", "
+                << "\"median_ms\": " << sum.median_ms << ", "
+                << "\"p99_ms\": " << sum.p99_ms << ", "
+                << "\"mean_ms\": " << sum.mean_ms << "}"
+                << (s + 1 < bc.stages.size() ? "," : "") << "\n";
+        }
+        out << "      }\n";
+        out << "    }" << (c + 1 < cases.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n";
+    out << "}\n";
+}
+
+void WriteCSV(const std::string& path, const std::vector<BenchCase>& cases) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+
+    // Неприменимые к модулю поля пустые
+    out << "git_revision,module,beams,count_points,out_count_points_fft,max_peaks,nfft,"
+           "matrix_size,batch,threads,"
+           "stage,min_ms,median_ms,p99_ms,mean_ms,samples_per_sec,gbytes_per_sec,error\n";
+    out << std::setprecision(6) << std::fixed;
+
+    for (const auto& bc : cases) {
+        const bool inv = bc.module == "inv";
+        for (const auto& st : bc.stages) {
+            const auto sum = antenna_fft::LatencySummary::From(st.samples_ms);
+            out << LCH_GIT_REVISION << ',' << bc.module << ',';
+            if (!inv) out << bc.beams << ',' << bc.points << ',';
+            else out << ",,";
+            if (HasFFTParams(bc)) out << bc.out_fft << ',' << bc.peaks << ',' << bc.nfft << ',';
+            else out << ",,,";
+            if (inv) out << bc.matrix_size << ',' << bc.batch << ',' << bc.threads << ',';
+            else out << ",,,";
+            out << st.name << ',' << sum.min_ms << ',' << sum.median_ms << ','
+                << sum.p99_ms << ',' << sum.mean_ms << ','
+                << SamplesPerSec(bc, sum.median_ms) << ','
+                << GBytesPerSec(bc, sum.median_ms) << ','
+                << '"' << bc.error << '"' << '\n';
+        }
+    }
+}
+
+void PrintCase(const BenchCase& bc) {
+    if (bc.module == "inv") {
+        // Вместо beams / points / outF / pk: n, пакет, потоки
+        char label[64];
+        snprintf(label, sizeof(label), "n=%zu batch=%zu thr=%zu", bc.matrix_size, bc.batch, bc.threads);
+        printf("  │ %-4s │ %-29s │", bc.module.c_str(), label);
+    } else if (HasFFTParams(bc)) {
+        printf("  │ %-4s │ %5zu │ %8zu │ %5zu │ %2zu │", bc.module.c_str(), bc.beams, bc.points,
+               bc.out_fft, bc.peaks);
+    } else {
+        printf("  │ %-4s │ %5zu │ %8zu │ %5s │ %2s │", bc.module.c_str(), bc.beams, bc.points, "-", "-");
+    }
+    if (!bc.error.empty()) {
+        printf(" ERROR: %s\n", bc.error.c_str());
+        return;
+    }
+    const Stage* tp = ThroughputStage(bc);
+    const auto sum = tp ? antenna_fft::LatencySummary::From(tp->samples_ms) : antenna_fft::LatencySummary{};
+    printf(" %9.3f │ %9.3f │ %9.3f │ %10.2f │ %7.2f │\n",
+           sum.min_ms, sum.median_ms, sum.p99_ms,
+           SamplesPerSec(bc, sum.median_ms) / 1e6, GBytesPerSec(bc, sum.median_ms));
+}
+
+/**
+ * CSV матрицы из matrix_dir и JSON таблицы Лагранжа → бинарные контейнеры
+ * рядом с исходниками (R_<n>.bin, <lagrange>.bin); OpenCL не нужен
+ */
+int ConvertFixtures(const BenchOptions& opt) {
+    int failures = 0;
+    if (std::filesystem::is_directory(opt.matrix_dir)) {
+        for (const auto& entry : std::filesystem::directory_iterator(opt.matrix_dir)) {
+            if (entry.path().extension() != ".csv") continue;
+            auto output = entry.path();
+            output.replace_extension(".bin");
+            try {
+                size_t n = ManagerOpenCL::MappedArrayFile::ConvertMatrixCSV(entry.path().string(), output.string());
+                std::cout << "  " << entry.path().string() << " -> " << output.string()
+                          << " (" << n << " x " << n << ")\n";
+            } catch (const std::exception& e) {
+                std::cerr << "  ⚠️ " << entry.path().string() << ": " << e.what() << "\n";
+                ++failures;
+            }
+        }
+    }
+    try {
+        auto output = std::filesystem::path(opt.lagrange_path).replace_extension(".bin");
+        radar::LagrangeMatrix::LoadFromJSON(opt.lagrange_path).SaveBinary(output.string());
+        std::cout << "  " << opt.lagrange_path << " -> " << output.string() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "  ⚠️ " << opt.lagrange_path << ": " << e.what() << "\n";
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void PrintUsage() {
+    std::cout <<
+        "Usage: lch_bench [options]\n"
+        "  --device cpu|gpu        OpenCL device type (default gpu)\n"
+        "  --modules fft,fdp,gen,inv  Modules to run (default all)\n"
+        "  --warmup N              Warm-up iterations (default 3)\n"
+        "  --iters N               Timed iterations (default 20)\n"
+        "  --beams a,b,...         AntennaFFT / generator beam counts\n"
+        "  --points a,b,...        AntennaFFT / generator count_points\n"
+        "  --out-fft a,b,...       out_count_points_fft values\n"
+        "  --peaks a,b,...         max_peaks_count values (3..5)\n"
+        "  --fdp-beams a,b,...     FractionalDelayProcessor beam counts\n"
+        "  --fdp-samples a,b,...   FractionalDelayProcessor samples per beam\n"
+        "  --inv-sizes a,b,...     CPU Hermitian inverse matrix sizes (default 85,341)\n"
+        "  --inv-batch a,b,...     CPU Hermitian inverse batch sizes (default 1,16)\n"
+        "  --threads N             CPU inverse threads (default hardware_concurrency)\n"
+        "  --matrix-dir PATH       R_<n>.bin / R_<n>.csv directory (default Matrix/data)\n"
+        "  --lagrange PATH         Lagrange matrix JSON or .bin (default lagrange_matrix.json)\n"
+        "  --calibrate             Calibrate transfer bandwidth for AUTO buffers at init\n"
+        "                          (cached in $LCH_CALIBRATION_DIR or ~/.cache/lch-farrow)\n"
+        "  --convert               Convert matrix-dir CSV and Lagrange JSON to .bin, then exit\n"
+        "  --record PATH           Record generator frames (first --beams/--points) with\n"
+        "                          FFT/FDP parameters, then exit\n"
+        "  --record-frames N       Frames to record (default 64)\n"
+        "  --replay PATH           Replay a recording through FDP -> AntennaFFT\n"
+        "                          (other modules off unless --modules follows)\n"
+        "  --rate HZ|max|recorded  Replay pacing (default max)\n"
+        "  --queue N               Frames allowed to wait before drops (default 1)\n"
+        "  --loops N               Passes over the recording (default 1)\n"
+        "  --out PREFIX            Output prefix, writes PREFIX.json/.csv\n"
+        "                          (default Reports/bench/lch_bench)\n"
+        "  --quick                 Small sweep for smoke runs\n"
+        "  --verbose               Do not silence module output\n";
+}
+
+BenchOptions ParseArgs(int argc, char* argv[]) {
+    BenchOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--device") {
+            std::string v = next();
+            if (v == "cpu" || v == "CPU") opt.device = ManagerOpenCL::DeviceType::CPU;
+            else if (v == "gpu" || v == "GPU") opt.device = ManagerOpenCL::DeviceType::GPU;
+            else throw std::invalid_argument("unknown device: " + v);
+        } else if (arg == "--modules") {
+            std::string v = next();
+            opt.run_fft = v.find("fft") != std::string::npos;
+            opt.run_fdp = v.find("fdp") != std::string::npos;
+            opt.run_gen = v.find("gen") != std::string::npos;
+            opt.run_inv = v.find("inv") != std::string::npos;
+        } else if (arg == "--warmup") {
+            opt.warmup = std::stoul(next());
+        } else if (arg == "--iters") {
+            opt.iterations = std::max<size_t>(1, std::stoul(next()));
+        } else if (arg == "--beams") {
+            opt.beams = ParseList(next());
+        } else if (arg == "--points") {
+            opt.points = ParseList(next());
+        } else if (arg == "--out-fft") {
+            opt.out_fft = ParseList(next());
+        } else if (arg == "--peaks") {
+            opt.peaks = ParseList(next());
+        } else if (arg == "--fdp-beams") {
+            opt.fdp_beams = ParseList(next());
+        } else if (arg == "--fdp-samples") {
+            opt.fdp_points = ParseList(next());
+        } else if (arg == "--inv-sizes") {
+            opt.inv_sizes = ParseList(next());
+        } else if (arg == "--inv-batch") {
+            opt.inv_batch = ParseList(next());
+        } else if (arg == "--threads") {
+            opt.inv_threads = std::stoul(next());
+        } else if (arg == "--matrix-dir") {
+            opt.matrix_dir = next();
+        } else if (arg == "--lagrange") {
+            opt.lagrange_path = next();
+        } else if (arg == "--out") {
+            opt.out_prefix = next();
+        } else if (arg == "--quick") {
+            opt.warmup = 1;
+            opt.iterations = 5;
+            opt.beams = {8, 32};
+            opt.points = {1024, 4096};
+            opt.out_fft = {256};
+            opt.peaks = {3};
+            opt.fdp_beams = {8, 32};
+            opt.fdp_points = {4096, 16384};
+            opt.inv_sizes = {85, 341};
+            opt.inv_batch = {1, 4};
+        } else if (arg == "--convert") {
+            opt.convert = true;
+        } else if (arg == "--calibrate") {
+            opt.calibrate = true;
+        } else if (arg == "--record") {
+            opt.record_path = next();
+        } else if (arg == "--record-frames") {
+            opt.record_frames = std::max<size_t>(1, std::stoul(next()));
+        } else if (arg == "--replay") {
+            opt.replay_path = next();
+            opt.run_fft = opt.run_fdp = opt.run_gen = opt.run_inv = false;
+        } else if (arg == "--rate") {
+            std::string v = next();
+            opt.replay.recorded_timing = (v == "recorded");
+            opt.replay.rate_hz = (v == "max" || v == "recorded") ? 0.0 : std::stod(v);
+        } else if (arg == "--queue") {
+            opt.replay.queue_depth = std::max<size_t>(1, std::stoul(next()));
+        } else if (arg == "--loops") {
+            opt.replay.loops = std::max<size_t>(1, std::stoul(next()));
+        } else if (arg == "--verbose") {
+            opt.quiet = false;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("unknown option: " + arg);
+        }
+    }
+    return opt;
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    try {
+        opt = ParseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "lch_bench: " << e.what() << "\n";
+        PrintUsage();
+        return 2;
+    }
+
+    if (opt.convert) {
+        return ConvertFixtures(opt);
+    }
+
+    try {
+        ManagerOpenCL::TransferCalibrationConfig calibration;
+        calibration.enabled = opt.calibrate;
+        ManagerOpenCL::OpenCLComputeEngine::SetCalibrationConfig(calibration);
+        ManagerOpenCL::OpenCLComputeEngine::Initialize(opt.device);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ OpenCL init failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (!opt.record_path.empty()) {
+        return RecordFrames(opt);
+    }
+
+    std::cout << "\n════════════════════════════════════════════════════════════════\n";
+    std::cout << "  lch_bench  (rev " << LCH_GIT_REVISION << ", warmup "
+              << opt.warmup << ", iters " << opt.iterations << ")\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  ┌──────┬───────┬──────────┬───────┬────┬───────────┬───────────┬───────────┬────────────┬─────────┐\n";
+    std::cout << "  │ mod  │ beams │  points  │ outF  │ pk │  min ms   │ median ms │  p99 ms   │  Msamp/s   │  GB/s   │\n";
+    std::cout << "  └──────┴───────┴──────────┴───────┴────┴───────────┴───────────┴───────────┴────────────┴─────────┘\n";
+
+    std::vector<BenchCase> cases;
+
+    if (opt.run_fft) {
+        for (size_t beams : opt.beams)
+        for (size_t points : opt.points)
+        for (size_t out_fft : opt.out_fft)
+        for (size_t peaks : opt.peaks) {
+            if (out_fft > NextPow2(points) * 2) continue;  // окно шире спектра
+            cases.push_back(BenchAntennaFFT(opt, beams, points, out_fft, peaks));
+            PrintCase(cases.back());
+        }
+    }
+
+    if (opt.run_fdp) {
+        try {
+            auto lagrange = radar::LagrangeMatrix::Load(opt.lagrange_path);
+            for (size_t beams : opt.fdp_beams)
+            for (size_t samples : opt.fdp_points) {
+                cases.push_back(BenchFractionalDelay(opt, lagrange, beams, samples));
+                PrintCase(cases.back());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "  ⚠️ FDP skipped: " << e.what() << "\n";
+        }
+    }
+
+    if (opt.run_gen) {
+        for (size_t beams : opt.beams)
+        for (size_t points : opt.points) {
+            cases.push_back(BenchGenerator(opt, beams, points));
+            PrintCase(cases.back());
+        }
+    }
+
+    if (opt.run_inv) {
+        for (size_t n : opt.inv_sizes)
+        for (size_t batch : opt.inv_batch) {
+            cases.push_back(BenchCPUInverse(opt, n, batch));
+            PrintCase(cases.back());
+        }
+        std::cout << "\n  CPU inverse (" << cpu_linalg::HermitianCPUInverter::GetISA()
+                  << "), target < " << kInverseTargetMs << " ms/matrix for n = " << kInverseTargetSize << ":\n";
+        for (const auto& bc : cases) {
+            if (bc.module != "inv" || !bc.error.empty()) continue;
+            const double ms = InverseMsPerMatrix(bc);
+            const char* verdict = !HasInverseTarget(bc) ? "" : ms < kInverseTargetMs ? "✅ PASS" : "❌ FAIL";
+            printf("    n = %4zu, batch %3zu, %2zu threads: %8.3f ms/matrix %s\n",
+                   bc.matrix_size, bc.batch, bc.threads, ms, verdict);
+        }
+    }
+
+    if (!opt.replay_path.empty()) {
+        cases.push_back(BenchReplay(opt));
+        PrintCase(cases.back());
+        // replay: min/median/p99 — время обслуживания кадра
+        const auto& bc = cases.back();
+        if (bc.error.empty()) {
+            const auto latency = antenna_fft::LatencySummary::From(bc.stages.front().samples_ms);
+            std::cout << "\n  Replay " << opt.replay_path << ": " << bc.frames_offered - bc.frames_dropped << "/"
+                      << bc.frames_offered << " frames, dropped " << bc.frames_dropped << ", "
+                      << std::setprecision(1) << std::fixed << bc.frames_per_sec << " frames/s sustained\n"
+                      << "    latency ms: median " << std::setprecision(3) << latency.median_ms
+                      << ", p99 " << latency.p99_ms << ", mean " << latency.mean_ms << "\n";
+        }
+    }
+
+    try {
+        std::filesystem::path prefix(opt.out_prefix);
+        if (prefix.has_parent_path()) {
+            std::filesystem::create_directories(prefix.parent_path());
+        }
+        WriteJSON(opt.out_prefix + ".json", opt, cases);
+        WriteCSV(opt.out_prefix + ".csv", cases);
+        std::cout << "\n  📄 " << opt.out_prefix << ".json\n";
+        std::cout << "  📄 " << opt.out_prefix << ".csv\n\n";
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Failed to write results: " << e.what() << "\n";
+        return 1;
+    }
+
+    size_t failed = std::count_if(cases.begin(), cases.end(),
+                                   [](const BenchCase& bc) { return !bc.error.empty(); });
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,933 @@
+#include "CPU/hermitian_cpu_inverter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+namespace cpu_linalg {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// SIMD: вектор float выбранной ширины
+// ════════════════════════════════════════════════════════════════════════════
+
+#if defined(__AVX512F__)
+struct Simd {
+    using V = __m512;
+    static constexpr size_t WIDTH = 16;
+    static constexpr const char* NAME = "avx512";
+    static V Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm512_storeu_ps(p, v); }
+    static V Set1(float x) { return _mm512_set1_ps(x); }
+    static V Zero() { return _mm512_setzero_ps(); }
+    static V Fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }     ///< a·b + c
+    static V Fnmadd(V a, V b, V c) { return _mm512_fnmadd_ps(a, b, c); }   ///< c - a·b
+};
+#elif defined(__AVX2__) && defined(__FMA__)
+struct Simd {
+    using V = __m256;
+    static constexpr size_t WIDTH = 8;
+    static constexpr const char* NAME = "avx2";
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Set1(float x) { return _mm256_set1_ps(x); }
+    static V Zero() { return _mm256_setzero_ps(); }
+    static V Fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V Fnmadd(V a, V b, V c) { return _mm256_fnmadd_ps(a, b, c); }
+};
+#else
+struct Simd {
+    using V = float;
+    static constexpr size_t WIDTH = 1;
+    static constexpr const char* NAME = "scalar";
+    static V Load(const float* p) { return *p; }
+    static void Store(float* p, V v) { *p = v; }
+    static V Set1(float x) { return x; }
+    static V Zero() { return 0.0f; }
+    static V Fmadd(V a, V b, V c) { return a * b + c; }
+    static V Fnmadd(V a, V b, V c) { return c - a * b; }
+};
+#endif
+
+/// Полоса столбцов: 2 вектора (16 комплексных отсчётов на AVX-512, 8 на AVX2)
+constexpr size_t STRIP = 2 * Simd::WIDTH;
+
+/// Форма X: LOWER — x[c][j] = 0 при j > c, UPPER — x[c][j] = 0 при c > j
+enum class Shape { FULL, LOWER, UPPER };
+
+/**
+ * y[j..j+NV·WIDTH) += Σ_{c=c_begin}^{c_end-1} a[c] · x[c][j..]  (планарные re/im)
+ * (ar + i·ai)(xr + i·xi): re += ar·xr - ai·xi, im += ar·xi + ai·xr — 4 FMA на вектор
+ */
+template <size_t NV>
+inline void StripKernel(const float* ar, const float* ai, size_t c_begin, size_t c_end,
+                        const float* xr, const float* xi, size_t ldx, float* yr, float* yi) {
+    typename Simd::V acc_r[NV], acc_i[NV];
+    for (size_t v = 0; v < NV; ++v) {
+        acc_r[v] = Simd::Load(yr + v * Simd::WIDTH);
+        acc_i[v] = Simd::Load(yi + v * Simd::WIDTH);
+    }
+    for (size_t c = c_begin; c < c_end; ++c) {
+        const auto a_r = Simd::Set1(ar[c]);
+        const auto a_i = Simd::Set1(ai[c]);
+        const float* row_r = xr + c * ldx;
+        const float* row_i = xi + c * ldx;
+        for (size_t v = 0; v < NV; ++v) {
+            const auto x_r = Simd::Load(row_r + v * Simd::WIDTH);
+            const auto x_i = Simd::Load(row_i + v * Simd::WIDTH);
+            acc_r[v] = Simd::Fmadd(a_r, x_r, acc_r[v]);
+            acc_r[v] = Simd::Fnmadd(a_i, x_i, acc_r[v]);
+            acc_i[v] = Simd::Fmadd(a_r, x_i, acc_i[v]);
+            acc_i[v] = Simd::Fmadd(a_i, x_r, acc_i[v]);
+        }
+    }
+    for (size_t v = 0; v < NV; ++v) {
+        Simd::Store(yr + v * Simd::WIDTH, acc_r[v]);
+        Simd::Store(yi + v * Simd::WIDTH, acc_i[v]);
+    }
+}
+
+/// Строк y на одну загрузку x (регистровый блок ROWS × ROW_NV векторов)
+constexpr size_t ROWS = 4;
+constexpr size_t ROW_NV = Simd::WIDTH >= 16 ? 2 : 1;
+
+/**
+ * То же для ROWS строк y с общими x: каждая загрузка x идёт в ROWS·4 FMA.
+ * Без блока по строкам внутренние циклы упираются в чтение x из L2, а не в FMA.
+ */
+template <size_t NV>
+inline void RowsKernel(const float* const* ar, const float* const* ai, size_t c_begin, size_t c_end,
+                       const float* xr, const float* xi, size_t ldx,
+                       float* const* yr, float* const* yi, size_t j) {
+    typename Simd::V acc_r[ROWS][NV], acc_i[ROWS][NV];
+    for (size_t q = 0; q < ROWS; ++q) {
+        for (size_t v = 0; v < NV; ++v) {
+            acc_r[q][v] = Simd::Load(yr[q] + j + v * Simd::WIDTH);
+            acc_i[q][v] = Simd::Load(yi[q] + j + v * Simd::WIDTH);
+        }
+    }
+    for (size_t c = c_begin; c < c_end; ++c) {
+        typename Simd::V x_r[NV], x_i[NV];
+        for (size_t v = 0; v < NV; ++v) {
+            x_r[v] = Simd::Load(xr + c * ldx + j + v * Simd::WIDTH);
+            x_i[v] = Simd::Load(xi + c * ldx + j + v * Simd::WIDTH);
+        }
+        for (size_t q = 0; q < ROWS; ++q) {
+            const auto a_r = Simd::Set1(ar[q][c]);
+            const auto a_i = Simd::Set1(ai[q][c]);
+            for (size_t v = 0; v < NV; ++v) {
+                acc_r[q][v] = Simd::Fmadd(a_r, x_r[v], acc_r[q][v]);
+                acc_r[q][v] = Simd::Fnmadd(a_i, x_i[v], acc_r[q][v]);
+                acc_i[q][v] = Simd::Fmadd(a_r, x_i[v], acc_i[q][v]);
+                acc_i[q][v] = Simd::Fmadd(a_i, x_r[v], acc_i[q][v]);
+            }
+        }
+    }
+    for (size_t q = 0; q < ROWS; ++q) {
+        for (size_t v = 0; v < NV; ++v) {
+            Simd::Store(yr[q] + j + v * Simd::WIDTH, acc_r[q][v]);
+            Simd::Store(yi[q] + j + v * Simd::WIDTH, acc_i[q][v]);
+        }
+    }
+}
+
+/**
+ * y[j] += Σ_c a[c] · x[c][j] для j ∈ [j_begin, j_end), c ∈ [c_begin, c_end)
+ * Полосы по STRIP; для треугольного X диапазон c сужается по полосе.
+ */
+void AccumulateRow(const float* ar, const float* ai, size_t c_begin, size_t c_end,
+                   const float* xr, const float* xi, size_t ldx,
+                   float* yr, float* yi, size_t j_begin, size_t j_end, Shape shape) {
+    size_t j = j_begin;
+    while (j < j_end) {
+        const size_t width = std::min(STRIP, j_end - j);
+        size_t cb = c_begin;
+        size_t ce = c_end;
+        if (shape == Shape::LOWER) cb = std::max(cb, j);
+        if (shape == Shape::UPPER) ce = std::min(ce, j + width);
+
+        if (cb < ce) {
+            if (width == STRIP) {
+                StripKernel<2>(ar, ai, cb, ce, xr + j, xi + j, ldx, yr + j, yi + j);
+            } else {
+                size_t k = 0;
+                for (; k + Simd::WIDTH <= width; k += Simd::WIDTH) {
+                    StripKernel<1>(ar, ai, cb, ce, xr + j + k, xi + j + k, ldx, yr + j + k, yi + j + k);
+                }
+                for (; k < width; ++k) {
+                    float sr = yr[j + k], si = yi[j + k];
+                    for (size_t c = cb; c < ce; ++c) {
+                        const float x_r = xr[c * ldx + j + k];
+                        const float x_i = xi[c * ldx + j + k];
+                        sr += ar[c] * x_r - ai[c] * x_i;
+                        si += ar[c] * x_i + ai[c] * x_r;
+                    }
+                    yr[j + k] = sr;
+                    yi[j + k] = si;
+                }
+            }
+        }
+        j += width;
+    }
+}
+
+/// AccumulateRow для ROWS строк сразу (X общий, форма FULL)
+void AccumulateRows(const float* const* ar, const float* const* ai, size_t c_begin, size_t c_end,
+                    const float* xr, const float* xi, size_t ldx,
+                    float* const* yr, float* const* yi, size_t j_begin, size_t j_end) {
+    size_t j = j_begin;
+    for (; j + STRIP <= j_end; j += STRIP) {
+        for (size_t k = 0; k < STRIP; k += ROW_NV * Simd::WIDTH) {
+            RowsKernel<ROW_NV>(ar, ai, c_begin, c_end, xr, xi, ldx, yr, yi, j + k);
+        }
+    }
+    if (j < j_end) {
+        for (size_t q = 0; q < ROWS; ++q) {
+            AccumulateRow(ar[q], ai[q], c_begin, c_end, xr, xi, ldx, yr[q], yi[q], j, j_end, Shape::FULL);
+        }
+    }
+}
+
+/// Невязка в double: блок RES_ROWS строк × RES_COLS правых частей в регистрах
+constexpr size_t RES_ROWS = 4;
+constexpr size_t RES_COLS = 8;
+
+/**
+ * r[q][c0..c0+RES_COLS) -= Σ_k A[q][k] · x[k][c0..] для RES_ROWS строк (планарные re/im).
+ * Каждая загрузка x идёт в RES_ROWS·4 FMA; ширина блока фиксирована — цикл по c
+ * полностью векторизуется компилятором.
+ */
+void ResidualRows(const double* a_re, const double* a_im, size_t lda, size_t n,
+                  const double* x_re, const double* x_im, size_t ldx,
+                  double* r_re, double* r_im, size_t c0) {
+    double acc_r[RES_ROWS][RES_COLS], acc_i[RES_ROWS][RES_COLS];
+    for (size_t q = 0; q < RES_ROWS; ++q) {
+        for (size_t c = 0; c < RES_COLS; ++c) {
+            acc_r[q][c] = r_re[q * ldx + c0 + c];
+            acc_i[q][c] = r_im[q * ldx + c0 + c];
+        }
+    }
+    for (size_t k = 0; k < n; ++k) {
+        const double* xr = x_re + k * ldx + c0;
+        const double* xi = x_im + k * ldx + c0;
+        for (size_t q = 0; q < RES_ROWS; ++q) {
+            const double ar = a_re[q * lda + k], ai = a_im[q * lda + k];
+            for (size_t c = 0; c < RES_COLS; ++c) {
+                acc_r[q][c] -= ar * xr[c];
+                acc_r[q][c] += ai * xi[c];
+                acc_i[q][c] -= ar * xi[c];
+                acc_i[q][c] -= ai * xr[c];
+            }
+        }
+    }
+    for (size_t q = 0; q < RES_ROWS; ++q) {
+        for (size_t c = 0; c < RES_COLS; ++c) {
+            r_re[q * ldx + c0 + c] = acc_r[q][c];
+            r_im[q * ldx + c0 + c] = acc_i[q][c];
+        }
+    }
+}
+
+/// Цикл по строкам/полосам: в пуле (деление матрицы) или в текущем потоке
+template <typename Body>
+void ForEach(ThreadPool* pool, size_t count, Body body) {
+    if (pool) {
+        pool->ParallelFor(count, [&](size_t i, size_t worker) { body(i, worker); });
+    } else {
+        for (size_t i = 0; i < count; ++i) body(i, 0);
+    }
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Рабочее пространство потока
+// ════════════════════════════════════════════════════════════════════════════
+
+struct HermitianCPUInverter::Workspace {
+    // Матрицы (планарно, n × ld): A → L и W = L^{-1}; только если поток обращает матрицы
+    std::vector<float> a_re, a_im;
+    std::vector<float> w_re, w_im;
+    std::vector<float> p_re, p_im;      ///< -conj(L) панели, транспонировано: BLOCK × ld
+    std::vector<float> u_re, u_im;      ///< L_kk^{-H}: BLOCK × BLOCK
+    // Временные строки (ROWS × ld) — у каждого потока свои
+    std::vector<float> t_re, t_im;
+    std::vector<float> y_re, y_im;
+
+    double factor_ms = 0.0;
+    double invert_ms = 0.0;
+    double product_ms = 0.0;
+
+    void AllocateTemps(size_t ld) {
+        t_re.assign(ROWS * ld, 0.0f); t_im.assign(ROWS * ld, 0.0f);
+        y_re.assign(ROWS * ld, 0.0f); y_im.assign(ROWS * ld, 0.0f);
+    }
+
+    void AllocateMatrices(size_t n, size_t ld) {
+        if (!a_re.empty()) return;
+        a_re.assign(n * ld, 0.0f); a_im.assign(n * ld, 0.0f);
+        w_re.assign(n * ld, 0.0f); w_im.assign(n * ld, 0.0f);
+        p_re.assign(BLOCK * ld, 0.0f); p_im.assign(BLOCK * ld, 0.0f);
+        u_re.assign(BLOCK * BLOCK, 0.0f); u_im.assign(BLOCK * BLOCK, 0.0f);
+    }
+};
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструктор
+// ════════════════════════════════════════════════════════════════════════════
+
+HermitianCPUInverter::HermitianCPUInverter(size_t n, size_t num_threads)
+    : n_(n), pool_(num_threads) {
+    if (n_ == 0) {
+        throw std::invalid_argument("HermitianCPUInverter: matrix size must be > 0");
+    }
+    ld_ = (n_ + 15) / 16 * 16;
+
+    workspaces_.resize(pool_.Size());
+    for (auto& ws : workspaces_) {
+        ws = std::make_unique<Workspace>();
+        ws->AllocateTemps(ld_);
+    }
+    workspaces_[0]->AllocateMatrices(n_, ld_);
+}
+
+HermitianCPUInverter::~HermitianCPUInverter() = default;
+
+const char* HermitianCPUInverter::GetISA() {
+    return Simd::NAME;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Этапы
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianCPUInverter::Load(const std::complex<float>* input, Workspace& ws) const {
+    for (size_t i = 0; i < n_; ++i) {
+        float* re = &ws.a_re[i * ld_];
+        float* im = &ws.a_im[i * ld_];
+        const std::complex<float>* row = input + i * n_;
+        for (size_t j = 0; j < n_; ++j) {
+            re[j] = row[j].real();
+            im[j] = row[j].imag();
+        }
+    }
+}
+
+void HermitianCPUInverter::FactorInPlace(Workspace& ws, ThreadPool* pool, size_t index) const {
+    const size_t n = n_, ld = ld_;
+    float* ar = ws.a_re.data();
+    float* ai = ws.a_im.data();
+
+    for (size_t kb = 0; kb < n; kb += BLOCK) {
+        const size_t kend = std::min(kb + BLOCK, n);
+        const size_t nbk = kend - kb;
+
+        // 1. Диагональный блок: неблочный Cholesky (обновления прошлых панелей уже внесены)
+        for (size_t j = kb; j < kend; ++j) {
+            float d = ar[j * ld + j];
+            if (!(d > 0.0f)) {
+                throw std::runtime_error("HermitianCPUInverter: matrix " + std::to_string(index) +
+                                         " is not positive definite (column " + std::to_string(j) + ")");
+            }
+            d = std::sqrt(d);
+            ar[j * ld + j] = d;
+            ai[j * ld + j] = 0.0f;
+            const float inv = 1.0f / d;
+            for (size_t i = j + 1; i < kend; ++i) {
+                ar[i * ld + j] *= inv;
+                ai[i * ld + j] *= inv;
+            }
+            for (size_t i = j + 1; i < kend; ++i) {
+                const float lr = ar[i * ld + j], li = ai[i * ld + j];
+                for (size_t q = j + 1; q <= i; ++q) {
+                    // A_iq -= L_ij · conj(L_qj)
+                    const float mr = ar[q * ld + j], mi = ai[q * ld + j];
+                    ar[i * ld + q] -= lr * mr + li * mi;
+                    ai[i * ld + q] -= li * mr - lr * mi;
+                }
+            }
+        }
+        if (kend == n) break;
+
+        // 2. U = L_kk^{-H} (верхняя треугольная): L_kk^{-1} по строкам, затем сопряжённое транспонирование
+        float inv_r[BLOCK][BLOCK], inv_i[BLOCK][BLOCK];
+        for (size_t r = 0; r < nbk; ++r) {
+            const size_t gr = kb + r;
+            const float diag = 1.0f / ar[gr * ld + gr];
+            for (size_t col = 0; col <= r; ++col) {
+                float sr = (col == r) ? 1.0f : 0.0f, si = 0.0f;
+                for (size_t m = col; m < r; ++m) {
+                    const float lr = ar[gr * ld + kb + m], li = ai[gr * ld + kb + m];
+                    sr -= lr * inv_r[m][col] - li * inv_i[m][col];
+                    si -= lr * inv_i[m][col] + li * inv_r[m][col];
+                }
+                inv_r[r][col] = sr * diag;
+                inv_i[r][col] = si * diag;
+            }
+        }
+        float* ur = ws.u_re.data();
+        float* ui = ws.u_im.data();
+        for (size_t c = 0; c < nbk; ++c) {
+            for (size_t j = 0; j < BLOCK; ++j) {
+                const bool upper = j >= c && j < nbk;
+                ur[c * BLOCK + j] = upper ? inv_r[j][c] : 0.0f;
+                ui[c * BLOCK + j] = upper ? -inv_i[j][c] : 0.0f;
+            }
+        }
+
+        // 3. Панель: L_ik = A_ik · U для строк i >= kend
+        ForEach(pool, n - kend, [&](size_t row, size_t worker) {
+            Workspace& tmp = pool ? *workspaces_[worker] : ws;
+            const size_t i = kend + row;
+            float* yr = ar + i * ld + kb;
+            float* yi = ai + i * ld + kb;
+            std::copy(yr, yr + nbk, tmp.t_re.data());
+            std::copy(yi, yi + nbk, tmp.t_im.data());
+            std::fill(yr, yr + nbk, 0.0f);
+            std::fill(yi, yi + nbk, 0.0f);
+            AccumulateRow(tmp.t_re.data(), tmp.t_im.data(), 0, nbk, ur, ui, BLOCK,
+                          yr, yi, 0, nbk, Shape::UPPER);
+        });
+
+        // 4. P[c][j] = -conj(L_{j, kb+c}) для j >= kend
+        float* pr = ws.p_re.data();
+        float* pi = ws.p_im.data();
+        for (size_t j = kend; j < n; ++j) {
+            for (size_t c = 0; c < nbk; ++c) {
+                pr[c * ld + j] = -ar[j * ld + kb + c];
+                pi[c * ld + j] = ai[j * ld + kb + c];
+            }
+        }
+
+        // 5. Хвост: A_ij += Σ_c L_ic · P[c][j], kend <= j <= i; строки блоками по ROWS
+        //    (j до конца блока: лишние элементы попадают в неиспользуемый верхний треугольник)
+        const size_t tail = n - kend;
+        ForEach(pool, (tail + ROWS - 1) / ROWS, [&](size_t group, size_t) {
+            const size_t i0 = kend + group * ROWS;
+            if (i0 + ROWS > n) {
+                for (size_t i = i0; i < n; ++i) {
+                    AccumulateRow(ar + i * ld + kb, ai + i * ld + kb, 0, nbk, pr, pi, ld,
+                                  ar + i * ld, ai + i * ld, kend, i + 1, Shape::FULL);
+                }
+                return;
+            }
+            const float* a_re[ROWS];
+            const float* a_im[ROWS];
+            float* y_re[ROWS];
+            float* y_im[ROWS];
+            for (size_t q = 0; q < ROWS; ++q) {
+                a_re[q] = ar + (i0 + q) * ld + kb;
+                a_im[q] = ai + (i0 + q) * ld + kb;
+                y_re[q] = ar + (i0 + q) * ld;
+                y_im[q] = ai + (i0 + q) * ld;
+            }
+            AccumulateRows(a_re, a_im, 0, nbk, pr, pi, ld, y_re, y_im, kend, i0 + ROWS);
+        });
+    }
+}
+
+void HermitianCPUInverter::InvertTriangular(Workspace& ws, ThreadPool* pool) const {
+    const size_t n = n_, ld = ld_;
+    const float* lr = ws.a_re.data();
+    const float* li = ws.a_im.data();
+    float* wr = ws.w_re.data();
+    float* wi = ws.w_im.data();
+
+    // W_rj = -(Σ_{m=j}^{r-1} L_rm W_mj) / L_rr, W_rr = 1 / L_rr
+    auto finish_row = [&](size_t r, size_t s, size_t j_end) {
+        const float inv = 1.0f / lr[r * ld + r];
+        for (size_t j = s; j < j_end; ++j) {
+            wr[r * ld + j] *= -inv;
+            wi[r * ld + j] *= -inv;
+        }
+        return inv;
+    };
+
+    // Полосы столбцов независимы: W[r][s..] зависит только от W[m][s..], m < r
+    const size_t num_strips = (n + STRIP - 1) / STRIP;
+    ForEach(pool, num_strips, [&](size_t strip, size_t) {
+        const size_t s = strip * STRIP;
+        const size_t s_end = std::min(s + STRIP, n);
+
+        // Треугольник полосы: строки по одной
+        for (size_t r = s; r < s_end; ++r) {
+            std::fill(wr + r * ld + s, wr + r * ld + s_end, 0.0f);
+            std::fill(wi + r * ld + s, wi + r * ld + s_end, 0.0f);
+            AccumulateRow(lr + r * ld, li + r * ld, s, r, wr, wi, ld,
+                          wr + r * ld, wi + r * ld, s, r, Shape::LOWER);
+            wr[r * ld + r] = finish_row(r, s, r);
+        }
+
+        // Ниже: блоки по ROWS строк — вклад строк m < r0 общим ядром, остаток внутри блока по одной
+        size_t r0 = s_end;
+        for (; r0 + ROWS <= n; r0 += ROWS) {
+            const float* ar[ROWS];
+            const float* ai[ROWS];
+            float* yr[ROWS];
+            float* yi[ROWS];
+            for (size_t q = 0; q < ROWS; ++q) {
+                ar[q] = lr + (r0 + q) * ld;
+                ai[q] = li + (r0 + q) * ld;
+                yr[q] = wr + (r0 + q) * ld;
+                yi[q] = wi + (r0 + q) * ld;
+                std::fill(yr[q] + s, yr[q] + s_end, 0.0f);
+                std::fill(yi[q] + s, yi[q] + s_end, 0.0f);
+            }
+            AccumulateRows(ar, ai, s, r0, wr, wi, ld, yr, yi, s, s_end);
+            for (size_t q = 0; q < ROWS; ++q) {
+                AccumulateRow(ar[q], ai[q], r0, r0 + q, wr, wi, ld, yr[q], yi[q], s, s_end, Shape::FULL);
+                finish_row(r0 + q, s, s_end);
+            }
+        }
+        for (size_t r = r0; r < n; ++r) {
+            std::fill(wr + r * ld + s, wr + r * ld + s_end, 0.0f);
+            std::fill(wi + r * ld + s, wi + r * ld + s_end, 0.0f);
+            AccumulateRow(lr + r * ld, li + r * ld, s, r, wr, wi, ld,
+                          wr + r * ld, wi + r * ld, s, s_end, Shape::FULL);
+            finish_row(r, s, s_end);
+        }
+    });
+}
+
+void HermitianCPUInverter::Product(std::complex<float>* output, Workspace& ws, ThreadPool* pool) const {
+    const size_t n = n_, ld = ld_;
+    const float* wr = ws.w_re.data();
+    const float* wi = ws.w_im.data();
+
+    // X_ij = Σ_{k>=i} conj(W_ki) W_kj для j <= i; X_ji = conj(X_ij). Строки блоками по ROWS:
+    // a_q[k] = 0 при k < i0 + q, лишние X_ij (j > i) внутри блока считаются, но не пишутся
+    const size_t num_groups = (n + ROWS - 1) / ROWS;
+    ForEach(pool, num_groups, [&](size_t group, size_t worker) {
+        Workspace& tmp = pool ? *workspaces_[worker] : ws;
+        const size_t i0 = group * ROWS;
+        const size_t rows = std::min(ROWS, n - i0);
+        const size_t j_end = i0 + rows;
+
+        const float* ar[ROWS];
+        const float* ai[ROWS];
+        float* yr[ROWS];
+        float* yi[ROWS];
+        for (size_t q = 0; q < ROWS; ++q) {
+            float* a_re = tmp.t_re.data() + q * ld;
+            float* a_im = tmp.t_im.data() + q * ld;
+            const size_t i = std::min(i0 + q, n - 1);
+            for (size_t k = i0; k < n; ++k) {
+                const bool used = q < rows && k >= i;
+                a_re[k] = used ? wr[k * ld + i] : 0.0f;
+                a_im[k] = used ? -wi[k * ld + i] : 0.0f;
+            }
+            ar[q] = a_re;
+            ai[q] = a_im;
+            yr[q] = tmp.y_re.data() + q * ld;
+            yi[q] = tmp.y_im.data() + q * ld;
+            std::fill(yr[q], yr[q] + j_end, 0.0f);
+            std::fill(yi[q], yi[q] + j_end, 0.0f);
+        }
+        AccumulateRows(ar, ai, i0, n, wr, wi, ld, yr, yi, 0, j_end);
+
+        for (size_t q = 0; q < rows; ++q) {
+            const size_t i = i0 + q;
+            for (size_t j = 0; j < i; ++j) {
+                output[i * n + j] = {yr[q][j], yi[q][j]};
+                output[j * n + i] = {yr[q][j], -yi[q][j]};
+            }
+            output[i * n + i] = {yr[q][i], 0.0f};
+        }
+    });
+}
+
+void HermitianCPUInverter::InvertOne(const std::complex<float>* input, std::complex<float>* output,
+                                     Workspace& ws, ThreadPool* pool, size_t index) {
+    auto t0 = Clock::now();
+    Load(input, ws);
+    FactorInPlace(ws, pool, index);
+    ws.factor_ms += ElapsedMs(t0);
+
+    t0 = Clock::now();
+    InvertTriangular(ws, pool);
+    ws.invert_ms += ElapsedMs(t0);
+
+    t0 = Clock::now();
+    Product(output, ws, pool);
+    ws.product_ms += ElapsedMs(t0);
+}
+
+void HermitianCPUInverter::PrepareSolve(const std::complex<float>* matrix, ThreadPool* pool) {
+    const size_t n = n_, ld = ld_;
+    Workspace& ws = *workspaces_[0];
+    Load(matrix, ws);
+    FactorInPlace(ws, pool, 0);
+
+    // L^H построчно (строка i — столбец i матрицы L, сопряжённый): обратный ход
+    // читает строки так же, как прямой, и идёт через тот же AccumulateRow
+    const float* lr = ws.a_re.data();
+    const float* li = ws.a_im.data();
+    float* hr = ws.w_re.data();
+    float* hi = ws.w_im.data();
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t i = 0; i < k; ++i) {
+            hr[i * ld + k] = lr[k * ld + i];
+            hi[i * ld + k] = -li[k * ld + i];
+        }
+    }
+}
+
+void HermitianCPUInverter::Substitute(float* yr, float* yi, size_t ldr, ThreadPool* pool) {
+    const size_t n = n_, ld = ld_;
+    const Workspace& ws = *workspaces_[0];
+    const float* lr = ws.a_re.data();
+    const float* li = ws.a_im.data();
+    const float* hr = ws.w_re.data();
+    const float* hi = ws.w_im.data();
+    std::vector<float> acc_r(ldr, 0.0f), acc_i(ldr, 0.0f);
+
+    // Полосы правых частей независимы: каждая проходит оба хода целиком
+    const size_t strips = (ldr + STRIP - 1) / STRIP;
+    ForEach(pool, strips, [&](size_t strip, size_t) {
+        const size_t j = strip * STRIP;
+        const size_t j_end = std::min(ldr, j + STRIP);
+        float* ar = acc_r.data();
+        float* ai = acc_i.data();
+
+        auto finish_row = [&](size_t i) {
+            const float inv_d = 1.0f / lr[i * ld + i];
+            for (size_t r = j; r < j_end; ++r) {
+                yr[i * ldr + r] = (yr[i * ldr + r] - ar[r]) * inv_d;
+                yi[i * ldr + r] = (yi[i * ldr + r] - ai[r]) * inv_d;
+                ar[r] = ai[r] = 0.0f;
+            }
+        };
+        // L y = b: y_i = (b_i - Σ_{k<i} L_ik y_k) / L_ii
+        for (size_t i = 0; i < n; ++i) {
+            AccumulateRow(lr + i * ld, li + i * ld, 0, i, yr, yi, ldr, ar, ai, j, j_end, Shape::FULL);
+            finish_row(i);
+        }
+        // L^H x = y: x_i = (y_i - Σ_{k>i} conj(L_ki) x_k) / L_ii
+        for (size_t i = n; i-- > 0;) {
+            AccumulateRow(hr + i * ld, hi + i * ld, i + 1, n, yr, yi, ldr, ar, ai, j, j_end, Shape::FULL);
+            finish_row(i);
+        }
+    });
+}
+
+void HermitianCPUInverter::SolveOne(const std::complex<float>* matrix, const std::complex<float>* rhs,
+                                    std::complex<float>* output, size_t num_rhs, bool normalize) {
+    const size_t n = n_;
+    ThreadPool* pool = pool_.Size() > 1 ? &pool_ : nullptr;
+
+    auto t0 = Clock::now();
+    PrepareSolve(matrix, pool);
+    const double factor_ms = ElapsedMs(t0);
+
+    // Правые части — столбцы планарной матрицы n × ldr, векторизация по ним;
+    // нулевые столбцы дополнения считаются вместе со всеми (без скалярного хвоста)
+    t0 = Clock::now();
+    const size_t ldr = (num_rhs + 15) / 16 * 16;
+    std::vector<float> yr(n * ldr, 0.0f), yi(n * ldr, 0.0f);
+    for (size_t r = 0; r < num_rhs; ++r) {
+        for (size_t k = 0; k < n; ++k) {
+            yr[k * ldr + r] = rhs[r * n + k].real();
+            yi[k * ldr + r] = rhs[r * n + k].imag();
+        }
+    }
+    Substitute(yr.data(), yi.data(), ldr, pool);
+
+    for (size_t r = 0; r < num_rhs; ++r) {
+        float scale = 1.0f;
+        if (normalize) {
+            // s^H R^{-1} s вещественно и положительно для R > 0
+            double d = 0.0;
+            for (size_t k = 0; k < n; ++k) {
+                d += static_cast<double>(rhs[r * n + k].real()) * yr[k * ldr + r] +
+                     static_cast<double>(rhs[r * n + k].imag()) * yi[k * ldr + r];
+            }
+            if (!(d > 0.0)) {
+                throw std::runtime_error("HermitianCPUInverter::MVDRWeights: steering vector " +
+                                         std::to_string(r) + " has zero response");
+            }
+            scale = static_cast<float>(1.0 / d);
+        }
+        for (size_t k = 0; k < n; ++k) {
+            output[r * n + k] = {yr[k * ldr + r] * scale, yi[k * ldr + r] * scale};
+        }
+    }
+
+    last_stats_ = CPUInverseStats{};
+    last_stats_.batch_count = 1;
+    last_stats_.threads = pool_.Size();
+    last_stats_.factor_ms = factor_ms;
+    last_stats_.solve_ms = ElapsedMs(t0);
+    last_stats_.total_ms = last_stats_.factor_ms + last_stats_.solve_ms;
+    last_stats_.ms_per_matrix = last_stats_.total_ms;
+}
+
+void HermitianCPUInverter::SolveRefinedOne(const std::complex<double>* matrix, const std::complex<double>* rhs,
+                                           std::complex<double>* output, size_t num_rhs,
+                                           size_t max_iterations, double tolerance) {
+    const size_t n = n_;
+    ThreadPool* pool = pool_.Size() > 1 ? &pool_ : nullptr;
+
+    // Разложение — по матрице, округлённой до float
+    auto t0 = Clock::now();
+    std::vector<std::complex<float>> rounded(n * n);
+    for (size_t i = 0; i < n * n; ++i) rounded[i] = std::complex<float>(matrix[i]);
+    PrepareSolve(rounded.data(), pool);
+    const double factor_ms = ElapsedMs(t0);
+
+    // A, x, b, r в double планарно, столбцы — правые части (шаг ldd): невязка
+    // r = b - A x считается блоками RES_ROWS × RES_COLS; строки A и r дополнены
+    // нулями до кратного RES_ROWS. Поправки d — в float с шагом ldr для Substitute
+    t0 = Clock::now();
+    const size_t ldr = (num_rhs + 15) / 16 * 16;
+    const size_t ldd = (num_rhs + RES_COLS - 1) / RES_COLS * RES_COLS;
+    const size_t rows = (n + RES_ROWS - 1) / RES_ROWS * RES_ROWS;
+    std::vector<double> a_re(rows * n, 0.0), a_im(rows * n, 0.0);
+    std::vector<double> b_re(rows * ldd, 0.0), b_im(rows * ldd, 0.0);
+    std::vector<double> x_re(n * ldd, 0.0), x_im(n * ldd, 0.0);
+    std::vector<double> r_re(rows * ldd, 0.0), r_im(rows * ldd, 0.0);
+    std::vector<float> d_re(n * ldr, 0.0f), d_im(n * ldr, 0.0f);
+    double a_norm = 0.0;   // ||A||_inf
+    for (size_t i = 0; i < n; ++i) {
+        double row_sum = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            const double re = matrix[i * n + k].real(), im = matrix[i * n + k].imag();
+            a_re[i * n + k] = re;
+            a_im[i * n + k] = im;
+            row_sum += std::sqrt(re * re + im * im);
+        }
+        a_norm = std::max(a_norm, row_sum);
+    }
+    for (size_t r = 0; r < num_rhs; ++r) {
+        for (size_t k = 0; k < n; ++k) {
+            b_re[k * ldd + r] = rhs[r * n + k].real();
+            b_im[k * ldd + r] = rhs[r * n + k].imag();
+        }
+    }
+
+    // Обратная ошибка η = ||b - A x||_inf / (||A||_inf ||x||_inf + ||b||_inf), худшая по правым частям
+    auto backward_error = [&]() {
+        double worst = 0.0;
+        for (size_t c = 0; c < num_rhs; ++c) {
+            double r_max = 0.0, x_max = 0.0, b_max = 0.0;
+            for (size_t k = 0; k < n; ++k) {
+                const size_t i = k * ldd + c;
+                r_max = std::max(r_max, r_re[i] * r_re[i] + r_im[i] * r_im[i]);
+                x_max = std::max(x_max, x_re[i] * x_re[i] + x_im[i] * x_im[i]);
+                b_max = std::max(b_max, b_re[i] * b_re[i] + b_im[i] * b_im[i]);
+            }
+            const double denom = a_norm * std::sqrt(x_max) + std::sqrt(b_max);
+            worst = std::max(worst, denom > 0.0 ? std::sqrt(r_max) / denom : 0.0);
+        }
+        return worst;
+    };
+    auto residual = [&]() {
+        r_re = b_re;
+        r_im = b_im;
+        ForEach(pool, rows / RES_ROWS, [&](size_t group, size_t) {
+            const size_t i0 = group * RES_ROWS;
+            for (size_t c0 = 0; c0 < ldd; c0 += RES_COLS) {
+                ResidualRows(&a_re[i0 * n], &a_im[i0 * n], n, n, x_re.data(), x_im.data(), ldd,
+                             &r_re[i0 * ldd], &r_im[i0 * ldd], c0);
+            }
+        });
+        return backward_error();
+    };
+
+    // x_0 = 0, r_0 = b: первая итерация — обычное решение в float
+    size_t iterations = 0;
+    r_re = b_re;
+    r_im = b_im;
+    double eta = 1.0;
+    double initial_eta = eta;
+    for (size_t step = 0; step <= max_iterations && eta > tolerance; ++step) {
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t c = 0; c < num_rhs; ++c) {
+                d_re[k * ldr + c] = static_cast<float>(r_re[k * ldd + c]);
+                d_im[k * ldr + c] = static_cast<float>(r_im[k * ldd + c]);
+            }
+        }
+        Substitute(d_re.data(), d_im.data(), ldr, pool);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t c = 0; c < num_rhs; ++c) {
+                x_re[k * ldd + c] += d_re[k * ldr + c];
+                x_im[k * ldd + c] += d_im[k * ldr + c];
+            }
+        }
+        const double previous = eta;
+        eta = residual();
+        if (step == 0) {
+            initial_eta = eta;
+        } else {
+            ++iterations;
+            // Застой: κ(A)·eps_float близко к 1, дальше поправки не сходятся
+            if (eta > 0.5 * previous) break;
+        }
+    }
+
+    for (size_t r = 0; r < num_rhs; ++r) {
+        for (size_t k = 0; k < n; ++k) {
+            output[r * n + k] = {x_re[k * ldd + r], x_im[k * ldd + r]};
+        }
+    }
+
+    last_stats_ = CPUInverseStats{};
+    last_stats_.batch_count = 1;
+    last_stats_.threads = pool_.Size();
+    last_stats_.factor_ms = factor_ms;
+    last_stats_.refine_ms = ElapsedMs(t0);
+    last_stats_.refine_iterations = iterations;
+    last_stats_.initial_residual = initial_eta;
+    last_stats_.residual = eta;
+    last_stats_.total_ms = last_stats_.factor_ms + last_stats_.refine_ms;
+    last_stats_.ms_per_matrix = last_stats_.total_ms;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Публичный API
+// ════════════════════════════════════════════════════════════════════════════
+
+void HermitianCPUInverter::InvertBatched(const std::complex<float>* input, std::complex<float>* output,
+                                         size_t batch_count) {
+    if (input == nullptr || output == nullptr || batch_count == 0) {
+        throw std::invalid_argument("HermitianCPUInverter::InvertBatched: null pointer or empty batch");
+    }
+    for (auto& ws : workspaces_) {
+        ws->factor_ms = ws->invert_ms = ws->product_ms = 0.0;
+    }
+
+    const size_t matrix_elements = n_ * n_;
+    auto t0 = Clock::now();
+    if (batch_count == 1 || pool_.Size() == 1) {
+        // Одна матрица (или один поток): этапы делятся между потоками пула
+        for (size_t b = 0; b < batch_count; ++b) {
+            InvertOne(input + b * matrix_elements, output + b * matrix_elements, *workspaces_[0],
+                      pool_.Size() > 1 ? &pool_ : nullptr, b);
+        }
+    } else {
+        for (auto& ws : workspaces_) {
+            ws->AllocateMatrices(n_, ld_);
+        }
+        pool_.ParallelFor(batch_count, [&](size_t b, size_t worker) {
+            InvertOne(input + b * matrix_elements, output + b * matrix_elements, *workspaces_[worker],
+                      nullptr, b);
+        });
+    }
+
+    last_stats_ = CPUInverseStats{};
+    last_stats_.batch_count = batch_count;
+    last_stats_.threads = pool_.Size();
+    last_stats_.total_ms = ElapsedMs(t0);
+    last_stats_.ms_per_matrix = last_stats_.total_ms / batch_count;
+    for (const auto& ws : workspaces_) {
+        last_stats_.factor_ms += ws->factor_ms / batch_count;
+        last_stats_.invert_ms += ws->invert_ms / batch_count;
+        last_stats_.product_ms += ws->product_ms / batch_count;
+    }
+}
+
+std::vector<std::complex<float>> HermitianCPUInverter::InvertBatched(
+    const std::vector<std::complex<float>>& matrices, size_t batch_count) {
+    const size_t expected = batch_count * n_ * n_;
+    if (batch_count == 0 || matrices.size() != expected) {
+        throw std::invalid_argument("HermitianCPUInverter::InvertBatched: expected " + std::to_string(expected) +
+                                    " elements, got " + std::to_string(matrices.size()));
+    }
+    std::vector<std::complex<float>> inverse(expected);
+    InvertBatched(matrices.data(), inverse.data(), batch_count);
+    return inverse;
+}
+
+std::vector<std::complex<float>> HermitianCPUInverter::Invert(const std::vector<std::complex<float>>& matrix) {
+    return InvertBatched(matrix, 1);
+}
+
+std::vector<std::complex<float>> HermitianCPUInverter::Factor(const std::vector<std::complex<float>>& matrix) {
+    if (matrix.size() != n_ * n_) {
+        throw std::invalid_argument("HermitianCPUInverter::Factor: expected " + std::to_string(n_ * n_) +
+                                    " elements, got " + std::to_string(matrix.size()));
+    }
+    Workspace& ws = *workspaces_[0];
+    Load(matrix.data(), ws);
+    FactorInPlace(ws, pool_.Size() > 1 ? &pool_ : nullptr, 0);
+
+    std::vector<std::complex<float>> L(n_ * n_, std::complex<float>(0.0f, 0.0f));
+    for (size_t i = 0; i < n_; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            L[i * n_ + j] = {ws.a_re[i * ld_ + j], ws.a_im[i * ld_ + j]};
+        }
+    }
+    return L;
+}
+
+std::vector<std::complex<float>> HermitianCPUInverter::Solve(const std::vector<std::complex<float>>& matrix,
+                                                             const std::vector<std::complex<float>>& rhs,
+                                                             size_t num_rhs) {
+    if (matrix.size() != n_ * n_ || num_rhs == 0 || rhs.size() != num_rhs * n_) {
+        throw std::invalid_argument("HermitianCPUInverter::Solve: expected " + std::to_string(n_ * n_) +
+                                    " matrix and " + std::to_string(num_rhs * n_) + " rhs elements, got " +
+                                    std::to_string(matrix.size()) + " and " + std::to_string(rhs.size()));
+    }
+    std::vector<std::complex<float>> solution(rhs.size());
+    SolveOne(matrix.data(), rhs.data(), solution.data(), num_rhs, false);
+    return solution;
+}
+
+std::vector<std::complex<float>> HermitianCPUInverter::MVDRWeights(
+    const std::vector<std::complex<float>>& covariance, const std::vector<std::complex<float>>& steering,
+    size_t num_vectors) {
+    if (covariance.size() != n_ * n_ || num_vectors == 0 || steering.size() != num_vectors * n_) {
+        throw std::invalid_argument("HermitianCPUInverter::MVDRWeights: expected " + std::to_string(n_ * n_) +
+                                    " covariance and " + std::to_string(num_vectors * n_) +
+                                    " steering elements, got " + std::to_string(covariance.size()) + " and " +
+                                    std::to_string(steering.size()));
+    }
+    std::vector<std::complex<float>> weights(steering.size());
+    SolveOne(covariance.data(), steering.data(), weights.data(), num_vectors, true);
+    return weights;
+}
+
+std::vector<std::complex<double>> HermitianCPUInverter::SolveRefined(
+    const std::vector<std::complex<double>>& matrix, const std::vector<std::complex<double>>& rhs,
+    size_t num_rhs, size_t max_iterations, double tolerance) {
+    if (matrix.size() != n_ * n_ || num_rhs == 0 || rhs.size() != num_rhs * n_) {
+        throw std::invalid_argument("HermitianCPUInverter::SolveRefined: expected " + std::to_string(n_ * n_) +
+                                    " matrix and " + std::to_string(num_rhs * n_) + " rhs elements, got " +
+                                    std::to_string(matrix.size()) + " and " + std::to_string(rhs.size()));
+    }
+    std::vector<std::complex<double>> solution(rhs.size());
+    SolveRefinedOne(matrix.data(), rhs.data(), solution.data(), num_rhs, max_iterations, tolerance);
+    return solution;
+}
+
+std::vector<std::complex<double>> HermitianCPUInverter::SolveRefined(
+    const std::vector<std::complex<float>>& matrix, const std::vector<std::complex<float>>& rhs,
+    size_t num_rhs, size_t max_iterations, double tolerance) {
+    return SolveRefined(std::vector<std::complex<double>>(matrix.begin(), matrix.end()),
+                        std::vector<std::complex<double>>(rhs.begin(), rhs.end()),
+                        num_rhs, max_iterations, tolerance);
+}
+
+std::vector<std::complex<double>> HermitianCPUInverter::InvertRefined(
+    const std::vector<std::complex<double>>& matrix, size_t max_iterations, double tolerance) {
+    // Столбец j обратной — решение для e_j; A^{-1} эрмитова, поэтому
+    // решения подряд (строки результата SolveRefined) — это conj строк A^{-1}
+    std::vector<std::complex<double>> identity(n_ * n_, std::complex<double>(0.0, 0.0));
+    for (size_t i = 0; i < n_; ++i) identity[i * n_ + i] = 1.0;
+    auto columns = SolveRefined(matrix, identity, n_, max_iterations, tolerance);
+    for (auto& v : columns) v = std::conj(v);
+    return columns;
+}
+
+} // namespace cpu_linalg
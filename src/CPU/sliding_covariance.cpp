@@ -0,0 +1,291 @@
+#include "CPU/sliding_covariance.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace cpu_linalg {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструктор
+// ════════════════════════════════════════════════════════════════════════════
+
+SlidingCovariance::SlidingCovariance(size_t channels, size_t window, float diagonal_loading,
+                                     size_t refactor_interval, size_t num_threads)
+    : n_(channels),
+      window_(window),
+      loading_(static_cast<float>(window) * diagonal_loading),
+      refactor_interval_(refactor_interval),
+      inverter_(channels == 0 ? 1 : channels, num_threads) {
+    if (n_ == 0 || window_ == 0) {
+        throw std::invalid_argument("SlidingCovariance: channels and window must be > 0");
+    }
+    if (!(diagonal_loading > 0.0f)) {
+        throw std::invalid_argument("SlidingCovariance: diagonal_loading must be > 0");
+    }
+
+    // Пустое окно: A = K·δ·I
+    l_re_.assign(n_ * n_, 0.0f);
+    l_im_.assign(n_ * n_, 0.0f);
+    for (size_t k = 0; k < n_; ++k) l_re_[k * n_ + k] = std::sqrt(loading_);
+    sum_re_.assign(n_ * n_, 0.0);
+    sum_im_.assign(n_ * n_, 0.0);
+    ring_.assign(window_ * n_, std::complex<float>(0.0f, 0.0f));
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Обновление
+// ════════════════════════════════════════════════════════════════════════════
+
+bool SlidingCovariance::Rotate(std::vector<float>& xr, std::vector<float>& xi, size_t count, float sign) {
+    const size_t n = n_;
+    for (size_t k = 0; k < n; ++k) {
+        float* cr = &l_re_[k * n];
+        float* ci = &l_im_[k * n];
+        // Все векторы по столбцу k подряд: столбец остаётся в кэше
+        for (size_t v = 0; v < count; ++v) {
+            float* vr = &xr[v * n];
+            float* vi = &xi[v * n];
+            const float a = cr[k];
+            const float br = vr[k], bi = vi[k];
+            const float r2 = a * a + sign * (br * br + bi * bi);
+            if (!(r2 > 0.0f) || !std::isfinite(r2)) {
+                return false;
+            }
+            const float r = std::sqrt(r2);
+            const float inv_r = 1.0f / r;
+            // l' = (a·l + sign·conj(b)·x) / r,  x' = (a·x - b·l) / r
+            for (size_t i = k + 1; i < n; ++i) {
+                const float l_r = cr[i], l_i = ci[i];
+                const float x_r = vr[i], x_i = vi[i];
+                cr[i] = (a * l_r + sign * (br * x_r + bi * x_i)) * inv_r;
+                ci[i] = (a * l_i + sign * (br * x_i - bi * x_r)) * inv_r;
+                vr[i] = (a * x_r - (br * l_r - bi * l_i)) * inv_r;
+                vi[i] = (a * x_i - (br * l_i + bi * l_r)) * inv_r;
+            }
+            cr[k] = r;
+        }
+    }
+    return true;
+}
+
+void SlidingCovariance::Accumulate(const std::vector<float>& xr, const std::vector<float>& xi, size_t count,
+                                   double sign) {
+    const size_t n = n_;
+    for (size_t v = 0; v < count; ++v) {
+        const float* x_r = &xr[v * n];
+        const float* x_i = &xi[v * n];
+        for (size_t i = 0; i < n; ++i) {
+            const double ar = sign * x_r[i];
+            const double ai = sign * x_i[i];
+            double* sr = &sum_re_[i * n];
+            double* si = &sum_im_[i * n];
+            // x_i · conj(x_j), j <= i
+            for (size_t j = 0; j <= i; ++j) {
+                sr[j] += ar * x_r[j] + ai * x_i[j];
+                si[j] += ai * x_r[j] - ar * x_i[j];
+            }
+        }
+    }
+}
+
+void SlidingCovariance::PushChunk(const std::complex<float>* snapshots, size_t stride, size_t count) {
+    const size_t n = n_;
+    const size_t removed = filled_ + count > window_ ? filled_ + count - window_ : 0;
+
+    // Планарные копии: вращения портят векторы
+    std::vector<float> new_re(count * n), new_im(count * n);
+    for (size_t c = 0; c < n; ++c) {
+        for (size_t t = 0; t < count; ++t) {
+            new_re[t * n + c] = snapshots[c * stride + t].real();
+            new_im[t * n + c] = snapshots[c * stride + t].imag();
+        }
+    }
+    std::vector<float> old_re(removed * n), old_im(removed * n);
+    for (size_t e = 0; e < removed; ++e) {
+        const std::complex<float>* x = &ring_[((head_ + e) % window_) * n];
+        for (size_t c = 0; c < n; ++c) {
+            old_re[e * n + c] = x[c].real();
+            old_im[e * n + c] = x[c].imag();
+        }
+    }
+
+    for (size_t t = 0; t < count; ++t) {
+        size_t slot;
+        if (filled_ == window_) {
+            slot = head_;
+            head_ = (head_ + 1) % window_;
+        } else {
+            slot = (head_ + filled_) % window_;
+            ++filled_;
+        }
+        for (size_t c = 0; c < n; ++c) ring_[slot * n + c] = snapshots[c * stride + t];
+    }
+
+    auto t0 = Clock::now();
+    Accumulate(new_re, new_im, count, 1.0);
+    Accumulate(old_re, old_im, removed, -1.0);
+    last_stats_.sum_ms += ElapsedMs(t0);
+    last_stats_.added += count;
+    last_stats_.removed += removed;
+
+    ++pushes_since_refactor_;
+    if (refactor_interval_ == 0 || pushes_since_refactor_ < refactor_interval_) {
+        // Сначала повышение: промежуточная матрица остаётся положительно определённой
+        t0 = Clock::now();
+        const bool ok = Rotate(new_re, new_im, count, 1.0f) && Rotate(old_re, old_im, removed, -1.0f);
+        last_stats_.update_ms += ElapsedMs(t0);
+        if (ok) return;
+    }
+    t0 = Clock::now();
+    Refactor();
+    last_stats_.refactor_ms += ElapsedMs(t0);
+    last_stats_.refactored = true;
+}
+
+void SlidingCovariance::Push(const std::complex<float>* snapshots, size_t count) {
+    if (snapshots == nullptr || count == 0) {
+        throw std::invalid_argument("SlidingCovariance::Push: null pointer or no snapshots");
+    }
+    last_stats_ = SlidingCovarianceStats{};
+    auto t0 = Clock::now();
+    // Порции не длиннее окна: вытесняются только снимки предыдущих порций
+    for (size_t offset = 0; offset < count; offset += window_) {
+        PushChunk(snapshots + offset, count, std::min(window_, count - offset));
+    }
+    last_stats_.total_ms = ElapsedMs(t0);
+}
+
+void SlidingCovariance::Push(const std::vector<std::complex<float>>& snapshots, size_t count) {
+    if (snapshots.size() != count * n_) {
+        throw std::invalid_argument("SlidingCovariance::Push: expected " + std::to_string(count * n_) +
+                                    " elements, got " + std::to_string(snapshots.size()));
+    }
+    Push(snapshots.data(), count);
+}
+
+void SlidingCovariance::Refactor() {
+    const auto A = GetExactCovariance();
+    std::vector<std::complex<float>> scaled(A.size());
+    const float scale = static_cast<float>(window_);
+    for (size_t i = 0; i < A.size(); ++i) scaled[i] = A[i] * scale;
+
+    const auto L = inverter_.Factor(scaled);
+    for (size_t k = 0; k < n_; ++k) {
+        for (size_t i = k; i < n_; ++i) {
+            l_re_[k * n_ + i] = L[i * n_ + k].real();
+            l_im_[k * n_ + i] = L[i * n_ + k].imag();
+        }
+    }
+    pushes_since_refactor_ = 0;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Веса и проверка
+// ════════════════════════════════════════════════════════════════════════════
+
+std::vector<std::complex<float>> SlidingCovariance::MVDRWeights(const std::vector<std::complex<float>>& steering,
+                                                                size_t num_vectors) const {
+    const size_t n = n_;
+    if (num_vectors == 0 || steering.size() != num_vectors * n) {
+        throw std::invalid_argument("SlidingCovariance::MVDRWeights: expected " + std::to_string(num_vectors * n) +
+                                    " elements, got " + std::to_string(steering.size()));
+    }
+    std::vector<std::complex<float>> weights(steering.size());
+    std::vector<float> yr(n), yi(n);
+    for (size_t v = 0; v < num_vectors; ++v) {
+        const std::complex<float>* s = &steering[v * n];
+        for (size_t i = 0; i < n; ++i) {
+            yr[i] = s[i].real();
+            yi[i] = s[i].imag();
+        }
+        // L y = s по столбцам: y_k готов, вычесть L_ik·y_k из хвоста
+        for (size_t k = 0; k < n; ++k) {
+            const float* cr = &l_re_[k * n];
+            const float* ci = &l_im_[k * n];
+            const float y_r = yr[k] / cr[k];
+            const float y_i = yi[k] / cr[k];
+            yr[k] = y_r;
+            yi[k] = y_i;
+            for (size_t i = k + 1; i < n; ++i) {
+                yr[i] -= cr[i] * y_r - ci[i] * y_i;
+                yi[i] -= cr[i] * y_i + ci[i] * y_r;
+            }
+        }
+        // L^H x = y: x_k = (y_k - Σ_{i>k} conj(L_ik)·x_i) / L_kk
+        for (size_t k = n; k-- > 0;) {
+            const float* cr = &l_re_[k * n];
+            const float* ci = &l_im_[k * n];
+            float sr = 0.0f, si = 0.0f;
+            for (size_t i = k + 1; i < n; ++i) {
+                sr += cr[i] * yr[i] + ci[i] * yi[i];
+                si += cr[i] * yi[i] - ci[i] * yr[i];
+            }
+            yr[k] = (yr[k] - sr) / cr[k];
+            yi[k] = (yi[k] - si) / cr[k];
+        }
+        // s^H R^{-1} s вещественно
+        double d = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            d += static_cast<double>(s[i].real()) * yr[i] + static_cast<double>(s[i].imag()) * yi[i];
+        }
+        if (!(d > 0.0)) {
+            throw std::runtime_error("SlidingCovariance::MVDRWeights: steering vector " + std::to_string(v) +
+                                     " has zero response");
+        }
+        const float scale = static_cast<float>(1.0 / d);
+        for (size_t i = 0; i < n; ++i) {
+            weights[v * n + i] = {yr[i] * scale, yi[i] * scale};
+        }
+    }
+    return weights;
+}
+
+std::vector<std::complex<float>> SlidingCovariance::GetCovariance() const {
+    const size_t n = n_;
+    const double scale = 1.0 / static_cast<double>(window_);
+    std::vector<std::complex<float>> R(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double re = 0.0, im = 0.0;
+            for (size_t k = 0; k <= j; ++k) {
+                const double ar = l_re_[k * n + i], ai = l_im_[k * n + i];
+                const double br = l_re_[k * n + j], bi = l_im_[k * n + j];
+                re += ar * br + ai * bi;
+                im += ai * br - ar * bi;
+            }
+            R[i * n + j] = {static_cast<float>(re * scale), static_cast<float>(im * scale)};
+            R[j * n + i] = std::conj(R[i * n + j]);
+        }
+    }
+    return R;
+}
+
+std::vector<std::complex<float>> SlidingCovariance::GetExactCovariance() const {
+    const size_t n = n_;
+    const double scale = 1.0 / static_cast<double>(window_);
+    std::vector<std::complex<float>> R(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double re = sum_re_[i * n + j];
+            if (i == j) re += loading_;
+            R[i * n + j] = {static_cast<float>(re * scale), static_cast<float>(sum_im_[i * n + j] * scale)};
+            R[j * n + i] = std::conj(R[i * n + j]);
+        }
+        R[i * n + i] = {R[i * n + i].real(), 0.0f};
+    }
+    return R;
+}
+
+} // namespace cpu_linalg
@@ -0,0 +1,93 @@
+#include "CPU/thread_pool.hpp"
+#include <algorithm>
+
+namespace cpu_linalg {
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(num_threads - 1);
+    for (size_t w = 1; w < num_threads; ++w) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& t : workers_) {
+        t.join();
+    }
+}
+
+void ThreadPool::RunIndices(size_t worker) {
+    for (;;) {
+        if (failed_.load(std::memory_order_relaxed)) return;
+        size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count_) return;
+        try {
+            (*body_)(i, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+            failed_ = true;
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop(size_t worker) {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        RunIndices(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const Body& body) {
+    if (count == 0) return;
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) body(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        next_ = 0;
+        failed_ = false;
+        error_ = nullptr;
+        active_ = workers_.size();
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    RunIndices(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return active_ == 0; });
+        body_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace cpu_linalg
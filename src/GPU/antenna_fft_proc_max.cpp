@@ -1,4 +1,5 @@
 #include "GPU/antenna_fft_proc_max.h"
+#include "GPU/layout_convert_kernel.hpp"
 #include "ManagerOpenCL/opencl_compute_engine.hpp"
 #include "ManagerOpenCL/opencl_core.hpp"
 #include "ManagerOpenCL/command_queue_pool.hpp"
@@ -29,7 +30,12 @@ struct MaxValue {
     cl_uint pad;              // Выравнивание до 32 байт
 };
 
-constexpr size_t kMaxReductionPoints = 1024;
+// Верхняя граница local size findMaximaAndPhase: размер его __local массивов
+// (RED_LOCAL_SIZE в исходнике ядра) и предел для WorkGroupTuner
+constexpr size_t kMaxReductionLocalSize = 256;
+
+// local size zoom_dtft и размер его partial[] (ZOOM_LOCAL_SIZE), степень двойки
+constexpr size_t kZoomLocalSize = 64;
 
 // ════════════════════════════════════════════════════════════════════════════
 // Статические члены для кэша планов
@@ -44,6 +50,16 @@ std::mutex AntennaFFTProcMax::plan_cache_mutex_;
 // ════════════════════════════════════════════════════════════════════════════
 
 AntennaFFTProcMax::AntennaFFTProcMax(const AntennaFFTParams& params)
+    : AntennaFFTProcMax(params, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+AntennaFFTProcMax::AntennaFFTProcMax(const AntennaFFTParams& params,
+                                     const ManagerOpenCL::DeviceContext& device)
+    : AntennaFFTProcMax(params, &device) {
+}
+
+AntennaFFTProcMax::AntennaFFTProcMax(const AntennaFFTParams& params,
+                                     const ManagerOpenCL::DeviceContext* device)
     : params_(params),
        nFFT_(0),
        engine_(nullptr),
@@ -52,6 +68,7 @@ AntennaFFTProcMax::AntennaFFTProcMax(const AntennaFFTParams& params)
        device_(nullptr),
        plan_handle_(0),
        plan_created_(false),
+       direct_plan_handle_(0),
        pre_callback_userdata_(nullptr),
        post_callback_userdata_(nullptr),
        reduction_kernel_(nullptr),
@@ -72,27 +89,39 @@ AntennaFFTProcMax::AntennaFFTProcMax(const AntennaFFTParams& params)
         throw std::invalid_argument("AntennaFFTParams: invalid parameters");
     }
     
-    // Проверка инициализации OpenCLComputeEngine
-    if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+    if (device) {
+        // Режим нескольких устройств: ресурсы принадлежат DeviceGroup
+        if (!device->IsValid()) {
+            throw std::invalid_argument("AntennaFFTProcMax: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        // Проверка инициализации OpenCLComputeEngine
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
 
-      // Инициализация OpenCL
-      ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+          // Инициализация OpenCL
+          ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
 
-      // Проверка инициализация OpenCL
-      if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
-        throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
-      }
+          // Проверка инициализация OpenCL
+          if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+          }
+        }
+        
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        
+        // Получить контекст и устройство
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        
+        // Получить command queue
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
     }
     
-    engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
-    
-    // Получить контекст и устройство
-    auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
-    context_ = core.GetContext();
-    device_ = core.GetDevice();
-    
-    // Получить command queue
-    queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    svm_caps_ = ManagerOpenCL::SVMCapabilities::Query(device_);
     
     // Вычислить nFFT
     nFFT_ = CalculateNFFT(params_.count_points);
@@ -116,6 +145,10 @@ AntennaFFTProcMax::~AntennaFFTProcMax() {
     if (batch_plan_handle_) {
         clfftDestroyPlan(&batch_plan_handle_);
     }
+    if (direct_plan_handle_) {
+        clfftDestroyPlan(&direct_plan_handle_);
+    }
+    ReleasePulseCompressionResources();
     
     // Освободить параллельные kernel'ы
     ReleaseParallelKernels();
@@ -136,6 +169,30 @@ AntennaFFTProcMax::~AntennaFFTProcMax() {
     if (post_kernel_) {
         clReleaseKernel(post_kernel_);
     }
+    if (zoom_kernel_) {
+        clReleaseKernel(zoom_kernel_);
+    }
+    if (sparse_kernel_) {
+        clReleaseKernel(sparse_kernel_);
+    }
+    if (real_plan_handle_) {
+        clfftDestroyPlan(&real_plan_handle_);
+    }
+    if (inplace_plan_handle_) {
+        clfftDestroyPlan(&inplace_plan_handle_);
+    }
+    if (real_padding_kernel_) {
+        clReleaseKernel(real_padding_kernel_);
+    }
+    if (hermitian_window_kernel_) {
+        clReleaseKernel(hermitian_window_kernel_);
+    }
+    if (layout_padding_kernel_) {
+        clReleaseKernel(layout_padding_kernel_);
+    }
+    if (integration_kernel_) {
+        clReleaseKernel(integration_kernel_);
+    }
 }
 
 AntennaFFTProcMax::AntennaFFTProcMax(AntennaFFTProcMax&& other) noexcept
@@ -145,8 +202,13 @@ AntennaFFTProcMax::AntennaFFTProcMax(AntennaFFTProcMax&& other) noexcept
        context_(other.context_),
        queue_(other.queue_),
        device_(other.device_),
+       svm_caps_(other.svm_caps_),
        plan_handle_(other.plan_handle_),
        plan_created_(other.plan_created_),
+       direct_plan_handle_(other.direct_plan_handle_),
+       inplace_plan_handle_(other.inplace_plan_handle_),
+       input_layout_(other.input_layout_),
+       layout_padding_kernel_(other.layout_padding_kernel_),
        buffer_input_(std::move(other.buffer_input_)),
        buffer_fft_input_(std::move(other.buffer_fft_input_)),
        buffer_fft_output_(std::move(other.buffer_fft_output_)),
@@ -160,6 +222,32 @@ AntennaFFTProcMax::AntennaFFTProcMax(AntennaFFTProcMax&& other) noexcept
        reduction_kernel_(other.reduction_kernel_),
        padding_kernel_(other.padding_kernel_),
        post_kernel_(other.post_kernel_),
+       padding_wg_(other.padding_wg_),
+       reduction_wg_(other.reduction_wg_),
+       pc_reference_(std::move(other.pc_reference_)),
+       pc_callback_userdata_(other.pc_callback_userdata_),
+       pc_forward_plan_(other.pc_forward_plan_),
+       pc_inverse_plan_(other.pc_inverse_plan_),
+       cfar_(std::move(other.cfar_)),
+       zoom_kernel_(other.zoom_kernel_),
+       buffer_zoom_tasks_(std::move(other.buffer_zoom_tasks_)),
+       buffer_zoom_output_(std::move(other.buffer_zoom_output_)),
+       sparse_kernel_(other.sparse_kernel_),
+       buffer_sparse_thresholds_(std::move(other.buffer_sparse_thresholds_)),
+       buffer_sparse_entries_(std::move(other.buffer_sparse_entries_)),
+       buffer_sparse_count_(std::move(other.buffer_sparse_count_)),
+       real_plan_handle_(other.real_plan_handle_),
+       real_padding_kernel_(other.real_padding_kernel_),
+       hermitian_window_kernel_(other.hermitian_window_kernel_),
+       buffer_real_input_(std::move(other.buffer_real_input_)),
+       buffer_real_spectrum_(std::move(other.buffer_real_spectrum_)),
+       buffer_real_window_(std::move(other.buffer_real_window_)),
+       integration_params_(other.integration_params_),
+       integration_kernel_(other.integration_kernel_),
+       buffer_integration_acc_(std::move(other.buffer_integration_acc_)),
+       buffer_integration_window_(std::move(other.buffer_integration_window_)),
+       integration_count_(other.integration_count_),
+       integration_primed_(other.integration_primed_),
        last_profiling_(other.last_profiling_),
        batch_config_(other.batch_config_),
        batch_profiling_(std::move(other.batch_profiling_)),
@@ -171,22 +259,44 @@ AntennaFFTProcMax::AntennaFFTProcMax(AntennaFFTProcMax&& other) noexcept
 
     other.plan_handle_ = 0;
     other.plan_created_ = false;
+    other.direct_plan_handle_ = 0;
+    other.inplace_plan_handle_ = 0;
     other.pre_callback_userdata_ = nullptr;
     other.post_callback_userdata_ = nullptr;
     other.reduction_kernel_ = nullptr;
     other.padding_kernel_ = nullptr;
     other.post_kernel_ = nullptr;
+    other.pc_callback_userdata_ = nullptr;
+    other.pc_forward_plan_ = 0;
+    other.pc_inverse_plan_ = 0;
+    other.zoom_kernel_ = nullptr;
+    other.sparse_kernel_ = nullptr;
+    other.real_plan_handle_ = 0;
+    other.real_padding_kernel_ = nullptr;
+    other.hermitian_window_kernel_ = nullptr;
+    other.layout_padding_kernel_ = nullptr;
+    other.integration_kernel_ = nullptr;
 }
 
 AntennaFFTProcMax& AntennaFFTProcMax::operator=(AntennaFFTProcMax&& other) noexcept {
     if (this != &other) {
         ReleaseFFTPlan();
 
+        if (direct_plan_handle_) clfftDestroyPlan(&direct_plan_handle_);
+        if (inplace_plan_handle_) clfftDestroyPlan(&inplace_plan_handle_);
         if (pre_callback_userdata_) clReleaseMemObject(pre_callback_userdata_);
         if (post_callback_userdata_) clReleaseMemObject(post_callback_userdata_);
         if (reduction_kernel_) clReleaseKernel(reduction_kernel_);
         if (padding_kernel_) clReleaseKernel(padding_kernel_);
         if (post_kernel_) clReleaseKernel(post_kernel_);
+        if (zoom_kernel_) clReleaseKernel(zoom_kernel_);
+        if (sparse_kernel_) clReleaseKernel(sparse_kernel_);
+        if (real_plan_handle_) clfftDestroyPlan(&real_plan_handle_);
+        if (real_padding_kernel_) clReleaseKernel(real_padding_kernel_);
+        if (hermitian_window_kernel_) clReleaseKernel(hermitian_window_kernel_);
+        if (layout_padding_kernel_) clReleaseKernel(layout_padding_kernel_);
+        if (integration_kernel_) clReleaseKernel(integration_kernel_);
+        ReleasePulseCompressionResources();
 
         params_ = other.params_;
         nFFT_ = other.nFFT_;
@@ -194,8 +304,13 @@ AntennaFFTProcMax& AntennaFFTProcMax::operator=(AntennaFFTProcMax&& other) noexc
         context_ = other.context_;
         queue_ = other.queue_;
         device_ = other.device_;
+        svm_caps_ = other.svm_caps_;
         plan_handle_ = other.plan_handle_;
         plan_created_ = other.plan_created_;
+        direct_plan_handle_ = other.direct_plan_handle_;
+        inplace_plan_handle_ = other.inplace_plan_handle_;
+        input_layout_ = other.input_layout_;
+        layout_padding_kernel_ = other.layout_padding_kernel_;
         buffer_input_ = std::move(other.buffer_input_);
         buffer_fft_input_ = std::move(other.buffer_fft_input_);
         buffer_fft_output_ = std::move(other.buffer_fft_output_);
@@ -209,6 +324,32 @@ AntennaFFTProcMax& AntennaFFTProcMax::operator=(AntennaFFTProcMax&& other) noexc
         reduction_kernel_ = other.reduction_kernel_;
         padding_kernel_ = other.padding_kernel_;
         post_kernel_ = other.post_kernel_;
+        padding_wg_ = other.padding_wg_;
+        reduction_wg_ = other.reduction_wg_;
+        pc_reference_ = std::move(other.pc_reference_);
+        pc_callback_userdata_ = other.pc_callback_userdata_;
+        pc_forward_plan_ = other.pc_forward_plan_;
+        pc_inverse_plan_ = other.pc_inverse_plan_;
+        cfar_ = std::move(other.cfar_);
+        zoom_kernel_ = other.zoom_kernel_;
+        buffer_zoom_tasks_ = std::move(other.buffer_zoom_tasks_);
+        buffer_zoom_output_ = std::move(other.buffer_zoom_output_);
+        sparse_kernel_ = other.sparse_kernel_;
+        buffer_sparse_thresholds_ = std::move(other.buffer_sparse_thresholds_);
+        buffer_sparse_entries_ = std::move(other.buffer_sparse_entries_);
+        buffer_sparse_count_ = std::move(other.buffer_sparse_count_);
+        real_plan_handle_ = other.real_plan_handle_;
+        real_padding_kernel_ = other.real_padding_kernel_;
+        hermitian_window_kernel_ = other.hermitian_window_kernel_;
+        buffer_real_input_ = std::move(other.buffer_real_input_);
+        buffer_real_spectrum_ = std::move(other.buffer_real_spectrum_);
+        buffer_real_window_ = std::move(other.buffer_real_window_);
+        integration_params_ = other.integration_params_;
+        integration_kernel_ = other.integration_kernel_;
+        buffer_integration_acc_ = std::move(other.buffer_integration_acc_);
+        buffer_integration_window_ = std::move(other.buffer_integration_window_);
+        integration_count_ = other.integration_count_;
+        integration_primed_ = other.integration_primed_;
         last_profiling_ = other.last_profiling_;
         batch_config_ = other.batch_config_;
         batch_profiling_ = std::move(other.batch_profiling_);
@@ -220,11 +361,23 @@ AntennaFFTProcMax& AntennaFFTProcMax::operator=(AntennaFFTProcMax&& other) noexc
 
         other.plan_handle_ = 0;
         other.plan_created_ = false;
+        other.direct_plan_handle_ = 0;
+        other.inplace_plan_handle_ = 0;
         other.pre_callback_userdata_ = nullptr;
         other.post_callback_userdata_ = nullptr;
         other.reduction_kernel_ = nullptr;
         other.padding_kernel_ = nullptr;
         other.post_kernel_ = nullptr;
+        other.pc_callback_userdata_ = nullptr;
+        other.pc_forward_plan_ = 0;
+        other.pc_inverse_plan_ = 0;
+        other.zoom_kernel_ = nullptr;
+        other.sparse_kernel_ = nullptr;
+        other.real_plan_handle_ = 0;
+        other.real_padding_kernel_ = nullptr;
+        other.hermitian_window_kernel_ = nullptr;
+        other.layout_padding_kernel_ = nullptr;
+        other.integration_kernel_ = nullptr;
     }
     return *this;
 }
@@ -267,14 +420,17 @@ size_t AntennaFFTProcMax::EstimateRequiredMemory() const {
     size_t input_size = params_.beam_count * params_.count_points * sizeof(std::complex<float>);
     
     // FFT буферы: beam_count * nFFT * sizeof(complex<float>) * 2 (input + output)
-    size_t fft_buffers = params_.beam_count * nFFT_ * sizeof(std::complex<float>) * 2;
+    // In-place: один буфер (padding → FFT → post на месте)
+    size_t fft_buffer_count = batch_config_.inplace_fft ? 1 : 2;
+    size_t fft_buffers = params_.beam_count * nFFT_ * sizeof(std::complex<float>) * fft_buffer_count;
     
-    // Pre-callback userdata: 32 bytes (params) + input_size
-    size_t pre_userdata = 32 + input_size;
+    // Pre-callback userdata: 32 bytes (params) + input_size (in-place путь без callback'ов)
+    size_t pre_userdata = batch_config_.inplace_fft ? 0 : 32 + input_size;
     
     // Post-processing буферы: beam_count * out_count_points_fft * (8 + 4) bytes
-    size_t post_buffers = params_.beam_count * params_.out_count_points_fft * 
-                         (sizeof(std::complex<float>) + sizeof(float));
+    size_t post_buffers = batch_config_.inplace_fft ? 0 :
+                          params_.beam_count * params_.out_count_points_fft *
+                          (sizeof(std::complex<float>) + sizeof(float));
     
     // Временные буферы clFFT (оценка ~nFFT * 8 bytes)
     size_t clfft_temp = nFFT_ * sizeof(std::complex<float>);
@@ -284,7 +440,8 @@ size_t AntennaFFTProcMax::EstimateRequiredMemory() const {
 
 bool AntennaFFTProcMax::CheckAvailableMemory(size_t required_memory, double threshold) const {
     // Получить размер глобальной памяти GPU
-    size_t global_memory = ManagerOpenCL::OpenCLCore::GetInstance().GetGlobalMemorySize();
+    cl_ulong global_memory = 0;
+    clGetDeviceInfo(device_, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(cl_ulong), &global_memory, nullptr);
     
     // Рассчитать доступную память с учётом порога
     size_t available_memory = static_cast<size_t>(global_memory * threshold);
@@ -314,6 +471,29 @@ size_t AntennaFFTProcMax::CalculateBatchSize(size_t total_beams, double batch_pe
     return batch_size;
 }
 
+void AntennaFFTProcMax::SetInPlaceFFT(bool enable) {
+    if (batch_config_.inplace_fft == enable) {
+        return;
+    }
+    batch_config_.inplace_fft = enable;
+    
+    // Буферы и планы batch режимов созданы под прежнее расположение результата
+    batch_fft_input_.reset();
+    batch_fft_output_.reset();
+    batch_buffers_size_ = 0;
+    if (batch_plan_handle_) {
+        clfftDestroyPlan(&batch_plan_handle_);
+        batch_plan_handle_ = 0;
+    }
+    batch_plan_beams_ = 0;
+    ReleaseParallelResources();
+    
+    // In-place использует только buffer_fft_input_; out-of-place пути создают output лениво
+    if (enable) {
+        buffer_fft_output_.reset();
+    }
+}
+
 // ════════════════════════════════════════════════════════════════════════════
 // ProcessNew: Автоматический выбор стратегии обработки
 // ════════════════════════════════════════════════════════════════════════════
@@ -332,8 +512,12 @@ AntennaFFTResult AntennaFFTProcMax::ProcessNew(cl_mem input_signal) {
     // 3. Выбрать стратегию
     if (memory_ok ) {
         std::cout << "  → Стратегия: SINGLE BATCH (полная обработка)\n";
-        std::cout << "  → Вызываем Process()\n\n";
         last_used_batch_mode_ = false;
+        if (batch_config_.inplace_fft) {
+            std::cout << "  → Вызываем ProcessInPlace()\n\n";
+            return ProcessInPlace(input_signal);
+        }
+        std::cout << "  → Вызываем Process()\n\n";
         return Process(input_signal);
     } else {
         std::cout << "  → Стратегия: MULTI-BATCH (batch processing)\n";
@@ -343,6 +527,136 @@ AntennaFFTResult AntennaFFTProcMax::ProcessNew(cl_mem input_signal) {
     }
 }
 
+AntennaFFTResult AntennaFFTProcMax::ProcessInPlace(cl_mem input_signal) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessInPlace: input_signal is null");
+    }
+    
+    EnsureInPlacePlan();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
+    
+    // Только buffer_fft_input_: padding → FFT на месте → post_kernel
+    // (index_point — бин FFT, как у Process(cl_mem): тот же post_kernel и шаг nFFT)
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (batch_config_.inplace_fft) {
+        buffer_fft_output_.reset();   // мог остаться после Process() вне in-place режима
+    }
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem fft_data = buffer_fft_input_->Get();
+    
+    cl_event event_padding = nullptr;
+    cl_int err = EnqueueInputPadding(queue_, input_signal, fft_data, params_.beam_count, 0,
+                                     0, nullptr, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding) failed: " + std::to_string(err));
+    }
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        inplace_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_fft,
+        &fft_data, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (in-place) failed: " + std::to_string(status));
+    }
+    
+    cl_event event_post = nullptr;
+    err = EnqueuePostKernel(fft_data, event_fft, &event_post);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT (in-place)");
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (mag+max+phase)");
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_post);
+    
+    return ReadMaximaResult();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// ProcessBeamformed: Beamformer → in-place FFT → post_kernel
+// ════════════════════════════════════════════════════════════════════════════
+
+AntennaFFTResult AntennaFFTProcMax::ProcessBeamformed(cl_mem element_data, Beamformer& beamformer) {
+    if (!element_data) {
+        throw std::invalid_argument("ProcessBeamformed: element_data is null");
+    }
+    if (beamformer.GetNumBeams() != params_.beam_count || beamformer.GetNumSamples() != params_.count_points) {
+        throw std::invalid_argument("ProcessBeamformed: beamformer produces " +
+                                    std::to_string(beamformer.GetNumBeams()) + " x " +
+                                    std::to_string(beamformer.GetNumSamples()) + ", expected " +
+                                    std::to_string(params_.beam_count) + " x " +
+                                    std::to_string(params_.count_points));
+    }
+    
+    EnsureInPlacePlan();
+    
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem fft_data = buffer_fft_input_->Get();
+    
+    // Лучи с шагом nFFT и нулями в хвосте — готовый вход FFT
+    cl_event event_beamform = nullptr;
+    beamformer.Enqueue(element_data, fft_data, nFFT_, 1, &event_beamform);
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        inplace_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_beamform, &event_fft,
+        &fft_data, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_beamform);
+        throw std::runtime_error("clfftEnqueueTransform (in-place) failed: " + std::to_string(status));
+    }
+    
+    cl_event event_post = nullptr;
+    cl_int err = EnqueuePostKernel(fft_data, event_fft, &event_post);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_beamform);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_beamform, "Beamforming");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT (in-place)");
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (mag+max+phase)");
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_beamform);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_post);
+    
+    return ReadMaximaResult();
+}
+
 // ════════════════════════════════════════════════════════════════════════════
 // ProcessWithBatching: Обработка с разбиением на батчи
 // ════════════════════════════════════════════════════════════════════════════
@@ -369,7 +683,8 @@ AntennaFFTResult AntennaFFTProcMax::ProcessWithBatching(cl_mem input_signal) {
     printf("  │  Total beams             │  %10zu  │\n", params_.beam_count);
     printf("  │  Batch size (base)       │  %10zu  │\n", batch_size);
     printf("  │  Number of batches       │  %10zu  │\n", num_batches);
-    printf("  │  Queue pool size         │  %10zu  │\n", ManagerOpenCL::CommandQueuePool::GetPoolSize());
+    printf("  │  Queue pool size         │  %10zu  │\n",
+           engine_ ? ManagerOpenCL::CommandQueuePool::GetPoolSize() : size_t(1));
     std::cout << "\n";
     
     // Очистить профилирование
@@ -413,10 +728,15 @@ AntennaFFTResult AntennaFFTProcMax::ProcessWithBatching(cl_mem input_signal) {
         // Выравниваем на размер complex (8 bytes) для создания буфера
         size_t maxima_complex_elements = (maxima_buf_elements * 32 + 7) / 8;
         
-        batch_fft_input_ = engine_->CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
-        batch_fft_output_ = engine_->CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        batch_fft_input_ = CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        // In-place: FFT пишет в batch_fft_input_, post_kernel читает его же
+        if (batch_config_.inplace_fft) {
+            batch_fft_output_.reset();
+        } else {
+            batch_fft_output_ = CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        }
         // batch_input_buffer_ НЕ НУЖЕН - работаем напрямую с input_signal!
-        batch_maxima_ = engine_->CreateBuffer(maxima_complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        batch_maxima_ = CreateBuffer(maxima_complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
         batch_buffers_size_ = max_batch_beams;
         
         auto t_buf_end = std::chrono::high_resolution_clock::now();
@@ -443,7 +763,7 @@ AntennaFFTResult AntennaFFTProcMax::ProcessWithBatching(cl_mem input_signal) {
         
         clfftSetPlanPrecision(batch_plan_handle_, CLFFT_SINGLE);
         clfftSetLayout(batch_plan_handle_, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
-        clfftSetResultLocation(batch_plan_handle_, CLFFT_OUTOFPLACE);
+        clfftSetResultLocation(batch_plan_handle_, batch_config_.inplace_fft ? CLFFT_INPLACE : CLFFT_OUTOFPLACE);
         clfftSetPlanBatchSize(batch_plan_handle_, max_batch_beams);
         
         size_t strides[1] = {1};
@@ -490,12 +810,12 @@ AntennaFFTResult AntennaFFTProcMax::ProcessWithBatching(cl_mem input_signal) {
         }
         
         // Получить очередь из пула
-        cl_command_queue batch_queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+        cl_command_queue batch_queue = AcquireQueue();
         
         std::cout << "  [Batch " << batch_idx << "] Processing beams " 
                   << start_beam << "-" << (start_beam + beams_in_batch - 1)
                   << " (" << beams_in_batch << " beams, queue " 
-                  << ManagerOpenCL::CommandQueuePool::GetCurrentQueueIndex() << ")\n";
+                  << (engine_ ? ManagerOpenCL::CommandQueuePool::GetCurrentQueueIndex() : size_t(0)) << ")\n";
         
         // Структура для профилирования этого батча
         BatchProfilingData batch_prof;
@@ -599,7 +919,7 @@ std::vector<FFTResult> AntennaFFTProcMax::ProcessBatch(
     
     // ИСПОЛЬЗУЕМ КЭШИРОВАННЫЕ БУФЕРЫ (созданы в ProcessWithBatching)
     cl_mem fft_in = batch_fft_input_->Get();
-    cl_mem fft_out = batch_fft_output_->Get();
+    cl_mem fft_out = batch_config_.inplace_fft ? fft_in : batch_fft_output_->Get();
     cl_mem maxima_out = batch_maxima_->Get();
     
     // ═══════════════════════════════════════════════════════════════════════════
@@ -607,26 +927,12 @@ std::vector<FFTResult> AntennaFFTProcMax::ProcessBatch(
     // ═══════════════════════════════════════════════════════════════════════════
     
     cl_uint batch_beam_count = static_cast<cl_uint>(num_beams);
-    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
     cl_uint nfft = static_cast<cl_uint>(nFFT_);
-    cl_uint beam_offset = static_cast<cl_uint>(start_beam);  // Смещение в лучах
-    
-    // Передаём исходный буфер и offset - БЕЗ КОПИРОВАНИЯ!
-    err = clSetKernelArg(padding_kernel_, 0, sizeof(cl_mem), &input_signal);
-    err |= clSetKernelArg(padding_kernel_, 1, sizeof(cl_mem), &fft_in);
-    err |= clSetKernelArg(padding_kernel_, 2, sizeof(cl_uint), &batch_beam_count);
-    err |= clSetKernelArg(padding_kernel_, 3, sizeof(cl_uint), &count_points);
-    err |= clSetKernelArg(padding_kernel_, 4, sizeof(cl_uint), &nfft);
-    err |= clSetKernelArg(padding_kernel_, 5, sizeof(cl_uint), &beam_offset);  // НОВЫЙ параметр!
-    
-    if (err != CL_SUCCESS) {
-        throw std::runtime_error("ProcessBatch: set padding kernel args failed: " + std::to_string(err));
-    }
     
-    size_t padding_global_size = num_beams * nFFT_;
+    // Передаём исходный буфер и смещение в лучах - БЕЗ КОПИРОВАНИЯ!
     cl_event event_padding = nullptr;
-    err = clEnqueueNDRangeKernel(batch_queue, padding_kernel_, 1, nullptr, 
-                                 &padding_global_size, nullptr, 0, nullptr, &event_padding);
+    err = EnqueueInputPadding(batch_queue, input_signal, fft_in, num_beams, start_beam,
+                              0, nullptr, &event_padding);
     if (err != CL_SUCCESS) {
         throw std::runtime_error("ProcessBatch: padding kernel failed: " + std::to_string(err));
     }
@@ -645,7 +951,7 @@ std::vector<FFTResult> AntennaFFTProcMax::ProcessBatch(
         1, &event_padding,
         &event_fft,
         &fft_in,
-        &fft_out,
+        batch_config_.inplace_fft ? nullptr : &fft_out,
         nullptr
     );
     
@@ -799,6 +1105,11 @@ std::vector<FFTResult> AntennaFFTProcMax::ProcessBatch(
 
 AntennaFFTResult AntennaFFTProcMax::Process(cl_mem input_signal) {
     
+    // pre-callback читает плотный beam-major float2; другую раскладку разбирает layout_padding
+    if (!input_layout_.IsDefault(params_.beam_count, params_.count_points)) {
+        return ProcessInPlace(input_signal);
+    }
+    
     // ═══════════════════════════════════════════════════════════════════════════
     // FFT с pre-callback + отдельный post-kernel
     // EVENT CHAIN для максимальной производительности!
@@ -815,24 +1126,22 @@ AntennaFFTResult AntennaFFTProcMax::Process(cl_mem input_signal) {
     size_t total_fft_size = params_.beam_count * nFFT_;
     
     if (!buffer_fft_input_) {
-        buffer_fft_input_ = engine_->CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     if (!buffer_fft_output_) {
-        buffer_fft_output_ = engine_->CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     
-    cl_uint beam_count = static_cast<cl_uint>(params_.beam_count);
-    cl_uint nfft = static_cast<cl_uint>(nFFT_);
     cl_uint search_range = static_cast<cl_uint>(params_.out_count_points_fft);
     
     if (!buffer_selected_complex_) {
-        buffer_selected_complex_ = engine_->CreateBuffer(
+        buffer_selected_complex_ = CreateBuffer(
             params_.beam_count * search_range, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     if (!buffer_selected_magnitude_) {
         size_t float_elements = params_.beam_count * search_range;
         size_t complex_elements = (float_elements * sizeof(float) + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
-        buffer_selected_magnitude_ = engine_->CreateBuffer(complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_selected_magnitude_ = CreateBuffer(complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     
     if (!post_kernel_) {
@@ -897,73 +1206,105 @@ AntennaFFTResult AntennaFFTProcMax::Process(cl_mem input_signal) {
     // STEP 3: Post-kernel (ОБЪЕДИНЁННЫЙ: magnitude + max + phase)
     // ═══════════════════════════════════════════════════════════════════════════
     
+    cl_event event_post = nullptr;
+    err = EnqueuePostKernel(fft_output, event_fft, &event_post);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_upload);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+
+    // ═══════════════════════════════════════════════════════════════════════════
+    // WAIT & PROFILING
+    // ═══════════════════════════════════════════════════════════════════════════
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = ProfileEvent(event_upload, "Upload");
+    last_profiling_.pre_callback_time_ms = 0.0;
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT + pre-callback");
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (mag+max+phase)");
+    last_profiling_.reduction_time_ms = 0.0;
+    
+    clReleaseEvent(event_upload);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_post);
+
+    // Общее время GPU
+    last_profiling_.total_time_ms =
+        last_profiling_.upload_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    return ReadMaximaResult();
+}
+
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> AntennaFFTProcMax::CreateBuffer(
+    size_t num_elements, ManagerOpenCL::MemoryType type) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, type);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(context_, queue_, num_elements, type);
+}
+
+cl_command_queue AntennaFFTProcMax::AcquireQueue() {
+    return engine_ ? ManagerOpenCL::CommandQueuePool::GetNextQueue() : queue_;
+}
+
+void AntennaFFTProcMax::EnsureMaximaBuffer() {
     // Создать буфер для результатов если его нет
     size_t maxima_size = params_.beam_count * params_.max_peaks_count * sizeof(MaxValue);
     if (!buffer_maxima_) {
         const size_t maxima_elements = (maxima_size + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
-        buffer_maxima_ = engine_->CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_maxima_ = CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
+}
+
+cl_int AntennaFFTProcMax::EnqueuePostKernel(cl_mem fft_output, cl_event wait_event, cl_event* out_event,
+                                            size_t spectrum_stride) {
+    if (!post_kernel_) {
+        CreatePostKernel();
+    }
+    EnsureMaximaBuffer();
     cl_mem maxima_output = buffer_maxima_->Get();
     
+    cl_uint beam_count = static_cast<cl_uint>(params_.beam_count);
+    cl_uint nfft = static_cast<cl_uint>(spectrum_stride != 0 ? spectrum_stride : nFFT_);
+    cl_uint search_range = static_cast<cl_uint>(params_.out_count_points_fft);
     cl_uint max_peaks = static_cast<cl_uint>(params_.max_peaks_count);
     float sample_rate = 12.0e6f;  // 12 МГц по умолчанию
     
-    err = clSetKernelArg(post_kernel_, 0, sizeof(cl_mem), &fft_output);
+    cl_int err = clSetKernelArg(post_kernel_, 0, sizeof(cl_mem), &fft_output);
     err |= clSetKernelArg(post_kernel_, 1, sizeof(cl_mem), &maxima_output);
     err |= clSetKernelArg(post_kernel_, 2, sizeof(cl_uint), &beam_count);
     err |= clSetKernelArg(post_kernel_, 3, sizeof(cl_uint), &nfft);
     err |= clSetKernelArg(post_kernel_, 4, sizeof(cl_uint), &search_range);
     err |= clSetKernelArg(post_kernel_, 5, sizeof(cl_uint), &max_peaks);
     err |= clSetKernelArg(post_kernel_, 6, sizeof(float), &sample_rate);
-    
     if (err != CL_SUCCESS) {
-        clReleaseEvent(event_upload);
-        clReleaseEvent(event_fft);
-        throw std::runtime_error("Failed to set post kernel args: " + std::to_string(err));
+        return err;
     }
     
     // Один work-group = один луч, 256 потоков в группе
     size_t post_global_size = params_.beam_count * 256;
     size_t post_local_size = 256;
-    cl_event event_post = nullptr;
     
-    err = clEnqueueNDRangeKernel(
+    return clEnqueueNDRangeKernel(
         queue_, 
         post_kernel_, 
         1, 
         nullptr, 
         &post_global_size, 
         &post_local_size, 
-        1,                    // num_events_in_wait_list
-        &event_fft,           // WAIT FOR event_fft!
-        &event_post           // OUTPUT EVENT
+        wait_event ? 1 : 0,
+        wait_event ? &wait_event : nullptr,
+        out_event
     );
-    
-    if (err != CL_SUCCESS) {
-        clReleaseEvent(event_upload);
-        clReleaseEvent(event_fft);
-        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
-    }
-
-    // ═══════════════════════════════════════════════════════════════════════════
-    // WAIT & PROFILING
-    // ═══════════════════════════════════════════════════════════════════════════
-    clWaitForEvents(1, &event_post);
-    
-    last_profiling_.upload_time_ms = ProfileEvent(event_upload, "Upload");
-    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT + pre-callback");
-    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (mag+max+phase)");
-    last_profiling_.reduction_time_ms = 0.0;
-    
-    clReleaseEvent(event_upload);
-    clReleaseEvent(event_fft);
-    clReleaseEvent(event_post);
+}
 
-    // ═══════════════════════════════════════════════════════════════════════════
-    // READ RESULTS
-    // ═══════════════════════════════════════════════════════════════════════════
+AntennaFFTResult AntennaFFTProcMax::ReadMaximaResult() {
+    size_t maxima_size = params_.beam_count * params_.max_peaks_count * sizeof(MaxValue);
     std::vector<MaxValue> maxima_result(params_.beam_count * params_.max_peaks_count);
-    err = clEnqueueReadBuffer(
+    cl_int err = clEnqueueReadBuffer(
         queue_,
         buffer_maxima_->Get(),
         CL_TRUE,
@@ -1004,16 +1345,11 @@ AntennaFFTResult AntennaFFTProcMax::Process(cl_mem input_signal) {
         result.results.push_back(std::move(beam_result));
     }
     
-    // Общее время GPU
-    last_profiling_.total_time_ms =
-        last_profiling_.upload_time_ms +
-        last_profiling_.fft_time_ms +
-        last_profiling_.post_callback_time_ms;
-    
     return result;
 }
 
 AntennaFFTResult AntennaFFTProcMax::Process(const std::vector<std::complex<float>>& input_data) {
+    RequireDefaultLayout("Process");
     // Создать буфер на GPU и загрузить данные
     size_t expected_size = params_.beam_count * params_.count_points;
     if (input_data.size() != expected_size) {
@@ -1022,61 +1358,225 @@ AntennaFFTResult AntennaFFTProcMax::Process(const std::vector<std::complex<float
                                    ", got: " + std::to_string(input_data.size()));
     }
     
-    auto buffer = engine_->CreateBufferWithData(input_data, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    // Fine-grain system SVM: ядро читает память хоста напрямую, без копии на устройство
+    if (svm_caps_.fine_grain_system) {
+        return ProcessSVM(input_data.data());
+    }
+    
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
     return Process(buffer->Get());
 }
 
 // ════════════════════════════════════════════════════════════════════════════
-// Управление clFFT планом
+// Zero-copy вход через SVM
 // ════════════════════════════════════════════════════════════════════════════
 
-void AntennaFFTProcMax::CreateOrReuseFFTPlan() {
-    // Проверить кэш
-    PlanCacheKey key{params_.beam_count, params_.count_points, nFFT_, params_.out_count_points_fft, params_.max_peaks_count};
+AntennaFFTResult AntennaFFTProcMax::Process(ManagerOpenCL::IMemoryBuffer* input) {
+    if (!input) {
+        throw std::invalid_argument("AntennaFFTProcMax::Process: input buffer is null");
+    }
     
-    {
-        std::lock_guard<std::mutex> lock(plan_cache_mutex_);
-        auto it = plan_cache_.find(key);
-        if (it != plan_cache_.end()) {
-            plan_handle_ = it->second;
-            plan_created_ = true;
-            return; // Переиспользовать существующий план
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input->GetNumElements() < expected_size) {
+        throw std::invalid_argument("Input buffer too small. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input->GetNumElements()));
+    }
+    
+    if (input->IsSVM()) {
+        RequireDefaultLayout("Process(SVM)");
+        // Coarse-grain SVM нельзя читать ядром пока он отображён на хост
+        if (input->IsMapped()) {
+            input->Unmap();
         }
+        return ProcessSVM(input->GetSVMPointer());
     }
     
-    // Создать новый план
-    size_t clLengths[1] = {nFFT_};
-    clfftStatus status = clfftCreateDefaultPlan(&plan_handle_, context_, CLFFT_1D, clLengths);
-    if (status != CLFFT_SUCCESS) {
-        throw std::runtime_error("clfftCreateDefaultPlan failed with status: " + std::to_string(status));
+    return Process(input->GetCLMem());
+}
+
+AntennaFFTResult AntennaFFTProcMax::ProcessSVM(const void* svm_input) {
+    if (!svm_input) {
+        throw std::invalid_argument("AntennaFFTProcMax::ProcessSVM: pointer is null");
     }
     
-    // Настроить план
-    clfftSetPlanPrecision(plan_handle_, CLFFT_SINGLE);
-    clfftSetLayout(plan_handle_, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
-    clfftSetResultLocation(plan_handle_, CLFFT_OUTOFPLACE);
-    clfftSetPlanBatchSize(plan_handle_, params_.beam_count);
+    size_t input_bytes = params_.beam_count * params_.count_points * sizeof(std::complex<float>);
     
-    size_t strides[1] = {1};
-    size_t dist = nFFT_;
-    clfftSetPlanInStride(plan_handle_, CLFFT_1D, strides);
-    clfftSetPlanOutStride(plan_handle_, CLFFT_1D, strides);
-    clfftSetPlanDistance(plan_handle_, dist, dist);
+    // Без SVM: прозрачный fallback через обычный буфер
+    if (!svm_caps_.svm_supported) {
+        auto buffer = CreateBuffer(params_.beam_count * params_.count_points,
+                                            ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+        cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0, input_bytes,
+                                          svm_input, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("clEnqueueWriteBuffer (SVM fallback) failed: " + std::to_string(err));
+        }
+        return Process(buffer->Get());
+    }
     
-    // Регистрация callback'ов
-    std::string pre_callback = GetPreCallbackSource();
-    std::string post_callback = GetPostCallbackSource();
-
-    // Создать userdata буферы для pre-callback
-    struct PreCallbackUserData {
-        cl_uint beam_count;
-        cl_uint count_points;
-        cl_uint nFFT;
-        cl_uint padding;
-    };
-
-    PreCallbackUserData pre_cb_params = {
-        static_cast<cl_uint>(params_.beam_count),
+    // ═══════════════════════════════════════════════════════════════════════════
+    // padding_kernel читает SVM указатель напрямую → FFT без callback'ов → post
+    // Шаг upload отсутствует: на APU/CPU данные кадра не дублируются
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    CreateDirectInputPlan();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
+    
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_fft_output_) {
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem fft_input = buffer_fft_input_->Get();
+    cl_mem fft_output = buffer_fft_output_->Get();
+    cl_uint beam_count = static_cast<cl_uint>(params_.beam_count);
+    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
+    cl_uint nfft = static_cast<cl_uint>(nFFT_);
+    cl_uint beam_offset = 0;
+    
+    cl_int err = clSetKernelArgSVMPointer(padding_kernel_, 0, svm_input);
+    err |= clSetKernelArg(padding_kernel_, 1, sizeof(cl_mem), &fft_input);
+    err |= clSetKernelArg(padding_kernel_, 2, sizeof(cl_uint), &beam_count);
+    err |= clSetKernelArg(padding_kernel_, 3, sizeof(cl_uint), &count_points);
+    err |= clSetKernelArg(padding_kernel_, 4, sizeof(cl_uint), &nfft);
+    err |= clSetKernelArg(padding_kernel_, 5, sizeof(cl_uint), &beam_offset);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set padding kernel args (SVM): " + std::to_string(err));
+    }
+    
+    cl_event event_padding = nullptr;
+    err = EnqueuePaddingKernel(queue_, total_fft_size, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding SVM) failed: " + std::to_string(err));
+    }
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        direct_plan_handle_,
+        CLFFT_FORWARD,
+        1,
+        &queue_,
+        1,
+        &event_padding,
+        &event_fft,
+        &fft_input,
+        &fft_output,
+        nullptr
+    );
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (SVM) failed: " + std::to_string(status));
+    }
+    
+    cl_event event_post = nullptr;
+    err = EnqueuePostKernel(fft_output, event_fft, &event_post);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding (SVM)");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT");
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (mag+max+phase)");
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_post);
+    
+    return ReadMaximaResult();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Управление clFFT планом
+// ════════════════════════════════════════════════════════════════════════════
+
+clfftPlanHandle AntennaFFTProcMax::CreateBatchedPlan(size_t batch_size, bool in_place) const {
+    clfftPlanHandle plan = 0;
+    size_t clLengths[1] = {nFFT_};
+    clfftStatus status = clfftCreateDefaultPlan(&plan, context_, CLFFT_1D, clLengths);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftCreateDefaultPlan failed with status: " + std::to_string(status));
+    }
+    
+    // Лучи подряд: [beam0: nFFT][beam1: nFFT]...
+    clfftSetPlanPrecision(plan, CLFFT_SINGLE);
+    clfftSetLayout(plan, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
+    clfftSetResultLocation(plan, in_place ? CLFFT_INPLACE : CLFFT_OUTOFPLACE);
+    clfftSetPlanBatchSize(plan, batch_size);
+    
+    size_t strides[1] = {1};
+    size_t dist = nFFT_;
+    clfftSetPlanInStride(plan, CLFFT_1D, strides);
+    clfftSetPlanOutStride(plan, CLFFT_1D, strides);
+    clfftSetPlanDistance(plan, dist, dist);
+    return plan;
+}
+
+void AntennaFFTProcMax::EnsureInPlacePlan() {
+    if (inplace_plan_handle_ != 0) {
+        return;
+    }
+    inplace_plan_handle_ = CreateBatchedPlan(params_.beam_count, true);
+    clfftStatus status = clfftBakePlan(inplace_plan_handle_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clfftDestroyPlan(&inplace_plan_handle_);
+        inplace_plan_handle_ = 0;
+        throw std::runtime_error("clfftBakePlan (in-place) failed: " + std::to_string(status));
+    }
+}
+
+void AntennaFFTProcMax::CreateOrReuseFFTPlan() {
+    // Проверить кэш
+    PlanCacheKey key{context_, params_.beam_count, params_.count_points, nFFT_, params_.out_count_points_fft, params_.max_peaks_count};
+    
+    {
+        std::lock_guard<std::mutex> lock(plan_cache_mutex_);
+        auto it = plan_cache_.find(key);
+        if (it != plan_cache_.end()) {
+            plan_handle_ = it->second;
+            plan_created_ = true;
+            return; // Переиспользовать существующий план
+        }
+    }
+    
+    // Создать новый план
+    plan_handle_ = CreateBatchedPlan(params_.beam_count);
+    clfftStatus status = CLFFT_SUCCESS;
+    
+    // Регистрация callback'ов
+    std::string pre_callback = GetPreCallbackSource();
+    std::string post_callback = GetPostCallbackSource();
+
+    // Создать userdata буферы для pre-callback
+    struct PreCallbackUserData {
+        cl_uint beam_count;
+        cl_uint count_points;
+        cl_uint nFFT;
+        cl_uint padding;
+    };
+
+    PreCallbackUserData pre_cb_params = {
+        static_cast<cl_uint>(params_.beam_count),
         static_cast<cl_uint>(params_.count_points),
         static_cast<cl_uint>(nFFT_),
         0
@@ -1228,6 +1728,22 @@ void AntennaFFTProcMax::CreateFFTPlanNoCallbacks() {
     std::cout << "  Created FFT plan without callbacks (nFFT=" << nFFT_ << ", batch=" << params_.beam_count << ")\n";
 }
 
+void AntennaFFTProcMax::CreateDirectInputPlan() {
+    // План без callback'ов для SVM входа: данные уже разложены padding_kernel
+    if (direct_plan_handle_ != 0) {
+        return;
+    }
+    
+    direct_plan_handle_ = CreateBatchedPlan(params_.beam_count);
+    
+    clfftStatus status = clfftBakePlan(direct_plan_handle_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clfftDestroyPlan(&direct_plan_handle_);
+        direct_plan_handle_ = 0;
+        throw std::runtime_error("clfftBakePlan (SVM) failed: " + std::to_string(status));
+    }
+}
+
 void AntennaFFTProcMax::CreateFFTPlanWithPreCallbackOnly() {
     // Если план уже создан, используем его
     if (plan_created_) {
@@ -1376,24 +1892,25 @@ void AntennaFFTProcMax::CreatePaddingKernel() {
             uint nFFT,                       // Размер FFT
             uint beam_offset                 // Смещение в лучах (для batch processing)
         ) {
-            uint gid = get_global_id(0);
-            
-            // gid = local_beam_idx * nFFT + pos_in_fft
-            uint local_beam_idx = gid / nFFT;
-            uint pos_in_fft = gid % nFFT;
-            
-            if (local_beam_idx >= batch_beam_count) return;
-            
-            // Глобальный индекс луча = local + offset
-            uint global_beam_idx = local_beam_idx + beam_offset;
-            
-            if (pos_in_fft < count_points) {
-                // Читаем из глобального индекса, пишем в локальный
-                uint src_idx = global_beam_idx * count_points + pos_in_fft;
-                output[gid] = input[src_idx];
-            } else {
-                // Zero-padding
-                output[gid] = (float2)(0.0f, 0.0f);
+            // Grid-stride цикл: work-item может обрабатывать несколько точек
+            // (local size и точек на work-item подбирает WorkGroupTuner)
+            uint total = batch_beam_count * nFFT;
+            for (uint gid = get_global_id(0); gid < total; gid += get_global_size(0)) {
+                // gid = local_beam_idx * nFFT + pos_in_fft
+                uint local_beam_idx = gid / nFFT;
+                uint pos_in_fft = gid % nFFT;
+                
+                // Глобальный индекс луча = local + offset
+                uint global_beam_idx = local_beam_idx + beam_offset;
+                
+                if (pos_in_fft < count_points) {
+                    // Читаем из глобального индекса, пишем в локальный
+                    uint src_idx = global_beam_idx * count_points + pos_in_fft;
+                    output[gid] = input[src_idx];
+                } else {
+                    // Zero-padding
+                    output[gid] = (float2)(0.0f, 0.0f);
+                }
             }
         }
     )CL";
@@ -1426,9 +1943,187 @@ void AntennaFFTProcMax::CreatePaddingKernel() {
         throw std::runtime_error("Failed to create padding kernel: " + std::to_string(err));
     }
     
+    // Local size из базы тюнера; если записи нет — подбор при первом запуске
+    ManagerOpenCL::WorkGroupTuner::Lookup("padding_kernel", device_, params_.beam_count * nFFT_, padding_wg_);
+    
     std::cout << "  Created padding_kernel\n";
 }
 
+cl_int AntennaFFTProcMax::EnqueuePaddingKernel(cl_command_queue queue, size_t total_work, cl_event* out_event,
+                                               cl_uint num_wait_events, const cl_event* wait_list) {
+    auto enqueue = [this, total_work](cl_command_queue q, const ManagerOpenCL::WorkGroupConfig& c,
+                                      cl_uint num_events, const cl_event* events, cl_event* ev) {
+        size_t local = c.local_size;
+        size_t work_items = (total_work + c.items_per_work_item - 1) / c.items_per_work_item;
+        size_t global = ((work_items + local - 1) / local) * local;
+        return clEnqueueNDRangeKernel(q, padding_kernel_, 1, nullptr, &global, &local, num_events, events, ev);
+    };
+    
+    if (!padding_wg_.IsValid()) {
+        // Прогоны подбора пишут тот же fft_input — результат перезапишется основным запуском.
+        // Выход может ещё читаться работой из списка ожидания: подбор (один раз) — после неё
+        if (num_wait_events > 0) {
+            cl_int err = clWaitForEvents(num_wait_events, wait_list);
+            if (err != CL_SUCCESS) {
+                return err;
+            }
+        }
+        padding_wg_ = ManagerOpenCL::WorkGroupTuner::Tune(
+            "padding_kernel", padding_kernel_, device_, queue, total_work, 256, {1, 2, 4},
+            [&enqueue](cl_command_queue q, const ManagerOpenCL::WorkGroupConfig& c, cl_event* ev) {
+                return enqueue(q, c, 0, nullptr, ev);
+            });
+    }
+    return enqueue(queue, padding_wg_, num_wait_events, wait_list, out_event);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// РАСКЛАДКА ВХОДА (SAMPLE_MAJOR / int16 IQ / шаги / смещение)
+// ════════════════════════════════════════════════════════════════════════════
+
+void AntennaFFTProcMax::SetInputLayout(const InputLayoutDesc& layout) {
+    if (layout.format == InputSampleFormat::INT16_IQ && !(layout.int16_scale > 0.0f)) {
+        throw std::invalid_argument("AntennaFFTProcMax::SetInputLayout: int16_scale must be > 0");
+    }
+    
+    // Тип входа ядра задаётся при сборке (-DINPUT_INT16)
+    if (layout.format != input_layout_.format && layout_padding_kernel_) {
+        clReleaseKernel(layout_padding_kernel_);
+        layout_padding_kernel_ = nullptr;
+    }
+    input_layout_ = layout;
+}
+
+void AntennaFFTProcMax::RequireDefaultLayout(const char* where) const {
+    if (!input_layout_.IsDefault(params_.beam_count, params_.count_points)) {
+        throw std::invalid_argument(std::string("AntennaFFTProcMax::") + where +
+                                    ": host data must be beam-major float2, use ProcessRawFrame()");
+    }
+}
+
+AntennaFFTResult AntennaFFTProcMax::ProcessRawFrame(const void* frame, size_t bytes) {
+    if (!frame) {
+        throw std::invalid_argument("AntennaFFTProcMax::ProcessRawFrame: frame is null");
+    }
+    size_t required = input_layout_.GetFrameSamples(params_.beam_count, params_.count_points) *
+                      input_layout_.GetSampleBytes();
+    if (bytes < required) {
+        throw std::invalid_argument("Raw frame too small. Expected at least: " +
+                                   std::to_string(required) + " bytes, got: " + std::to_string(bytes));
+    }
+    
+    // Буфер в элементах complex<float>: кадр копируется как есть, разбор — в layout_padding
+    size_t num_elements = (bytes + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
+    auto buffer = CreateBuffer(num_elements, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0, bytes, frame, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (raw frame) failed: " + std::to_string(err));
+    }
+    return Process(buffer->Get());
+}
+
+void AntennaFFTProcMax::CreateLayoutPaddingKernel() {
+    // Общее с IQFrameSource ядро layout_convert (GPU/layout_convert_kernel.hpp):
+    // тайл 16×16 через local memory, чтение подряд по лучам, запись по отсчётам
+    const char* kernel_source = kLayoutConvertKernelSource;
+    
+    cl_int err;
+    const char* sources[] = {kernel_source};
+    size_t lengths[] = {strlen(kernel_source)};
+    
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create layout padding program: " + std::to_string(err));
+    }
+    
+    const char* options = input_layout_.format == InputSampleFormat::INT16_IQ ? "-DINPUT_INT16=1" : nullptr;
+    err = clBuildProgram(program, 1, &device_, options, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Layout padding kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build layout padding program");
+    }
+    
+    layout_padding_kernel_ = clCreateKernel(program, "layout_convert", &err);
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create layout padding kernel: " + std::to_string(err));
+    }
+    
+    std::cout << "  Created layout_padding ("
+              << (input_layout_.format == InputSampleFormat::INT16_IQ ? "int16" : "float32") << ")\n";
+}
+
+cl_int AntennaFFTProcMax::EnqueueInputPadding(
+    cl_command_queue queue, cl_mem input, cl_mem output,
+    size_t num_beams, size_t beam_offset,
+    cl_uint num_wait_events, const cl_event* wait_list, cl_event* out_event) {
+    
+    cl_uint batch_beam_count = static_cast<cl_uint>(num_beams);
+    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
+    cl_uint nfft = static_cast<cl_uint>(nFFT_);
+    cl_uint offset_beams = static_cast<cl_uint>(beam_offset);
+    cl_int err;
+    
+    if (input_layout_.IsDefault(params_.beam_count, params_.count_points)) {
+        if (!padding_kernel_) {
+            CreatePaddingKernel();
+        }
+        err = clSetKernelArg(padding_kernel_, 0, sizeof(cl_mem), &input);
+        err |= clSetKernelArg(padding_kernel_, 1, sizeof(cl_mem), &output);
+        err |= clSetKernelArg(padding_kernel_, 2, sizeof(cl_uint), &batch_beam_count);
+        err |= clSetKernelArg(padding_kernel_, 3, sizeof(cl_uint), &count_points);
+        err |= clSetKernelArg(padding_kernel_, 4, sizeof(cl_uint), &nfft);
+        err |= clSetKernelArg(padding_kernel_, 5, sizeof(cl_uint), &offset_beams);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        return EnqueuePaddingKernel(queue, num_beams * nFFT_, out_event, num_wait_events, wait_list);
+    }
+    
+    // Кадр должен вмещать последний используемый отсчёт
+    size_t input_bytes = 0;
+    err = clGetMemObjectInfo(input, CL_MEM_SIZE, sizeof(input_bytes), &input_bytes, nullptr);
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+    size_t required = input_layout_.GetFrameSamples(params_.beam_count, params_.count_points) *
+                      input_layout_.GetSampleBytes();
+    if (input_bytes < required) {
+        throw std::invalid_argument("Input buffer too small for layout. Expected at least: " +
+                                   std::to_string(required) + " bytes, got: " + std::to_string(input_bytes));
+    }
+    
+    if (!layout_padding_kernel_) {
+        CreateLayoutPaddingKernel();
+    }
+    
+    cl_ulong offset = input_layout_.offset;
+    cl_ulong beam_stride = input_layout_.GetBeamStride(params_.count_points);
+    cl_ulong sample_stride = input_layout_.GetSampleStride(params_.beam_count);
+    float scale = input_layout_.int16_scale;
+    
+    err = SetLayoutConvertArgs(layout_padding_kernel_, input, output, batch_beam_count, count_points, nfft,
+                               offset_beams, offset, beam_stride, sample_stride, scale, nullptr);
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+    
+    const size_t tile = LAYOUT_CONVERT_TILE;
+    size_t local[2] = {tile, tile};
+    size_t global[2] = {
+        ((nFFT_ + tile - 1) / tile) * tile,
+        ((num_beams + tile - 1) / tile) * tile
+    };
+    return clEnqueueNDRangeKernel(queue, layout_padding_kernel_, 2, nullptr, global, local,
+                                  num_wait_events, wait_list, out_event);
+}
+
 void AntennaFFTProcMax::CreatePostKernel() {
     // ═══════════════════════════════════════════════════════════════════════════
     // ОБЪЕДИНЁННЫЙ KERNEL: magnitude + поиск max + фаза + Re/Im + параболическая интерполяция
@@ -1666,19 +2361,18 @@ void AntennaFFTProcMax::CreateParallelKernels(size_t num_streams) {
             uint nFFT,
             uint beam_offset
         ) {
-            uint gid = get_global_id(0);
-            uint local_beam_idx = gid / nFFT;
-            uint pos_in_fft = gid % nFFT;
-            
-            if (local_beam_idx >= batch_beam_count) return;
-            
-            uint global_beam_idx = local_beam_idx + beam_offset;
-            
-            if (pos_in_fft < count_points) {
-                uint src_idx = global_beam_idx * count_points + pos_in_fft;
-                output[gid] = input[src_idx];
-            } else {
-                output[gid] = (float2)(0.0f, 0.0f);
+            uint total = batch_beam_count * nFFT;
+            for (uint gid = get_global_id(0); gid < total; gid += get_global_size(0)) {
+                uint local_beam_idx = gid / nFFT;
+                uint pos_in_fft = gid % nFFT;
+                uint global_beam_idx = local_beam_idx + beam_offset;
+                
+                if (pos_in_fft < count_points) {
+                    uint src_idx = global_beam_idx * count_points + pos_in_fft;
+                    output[gid] = input[src_idx];
+                } else {
+                    output[gid] = (float2)(0.0f, 0.0f);
+                }
             }
         }
     )CL";
@@ -2092,7 +2786,8 @@ void processFFTPost(__global void* output, uint outoffset, __global void* userda
 void AntennaFFTProcMax::CreateMaxReductionKernel() {
     // Kernel для поиска top-N максимумов + вычисления phase
     // Запускается ПОСЛЕ FFT - один work-group на beam (parallel reduction)
-    std::string reduction_kernel_source = R"(
+    std::string reduction_kernel_source =
+        "#define RED_LOCAL_SIZE " + std::to_string(kMaxReductionLocalSize) + "\n" + R"(
 typedef struct {
     uint index;
     float magnitude;
@@ -2101,7 +2796,7 @@ typedef struct {
 } MaxValue;
 
         // Kernel для поиска top-N максимумов и вычисления phase
-        // Один work-group обрабатывает один beam
+        // Один work-group обрабатывает один beam, local_size <= RED_LOCAL_SIZE
 __kernel void findMaximaAndPhase(
             __global const float2* complex_buffer,  // Комплексный спектр после fftshift
             __global const float* magnitude_buffer, // Magnitude после fftshift
@@ -2117,96 +2812,156 @@ __kernel void findMaximaAndPhase(
     if (beam_idx >= beam_count) return;
     
             // Local memory для top-N максимумов этого beam
-            __local MaxValue local_max[8];  // max_peaks_count <= 8
-            __local float local_mag[1024];  // Кэш magnitude для быстрого поиска
-            __local uint local_idx[1024];   // Кэш индексов
+            __local MaxValue local_max[8];            // max_peaks_count <= 8
+            __local float red_mag[RED_LOCAL_SIZE];    // Лучший кандидат каждого потока
+            __local uint red_idx[RED_LOCAL_SIZE];
             
-            // Инициализация top-N (только первые потоки)
-            if (lid < max_peaks_count) {
-                local_max[lid].index = UINT_MAX;
-                local_max[lid].magnitude = -1.0f;
-                local_max[lid].phase = 0.0f;
-                local_max[lid].pad = 0;
-    }
-    barrier(CLK_LOCAL_MEM_FENCE);
-    
-            // Загрузить magnitude в local memory (каждый поток загружает несколько элементов)
             uint base_offset = beam_idx * out_count_points_fft;
-            for (uint i = lid; i < out_count_points_fft; i += local_size) {
-        local_mag[i] = magnitude_buffer[base_offset + i];
-                local_idx[i] = i;
-    }
-    barrier(CLK_LOCAL_MEM_FENCE);
-    
-            // Поиск top-N (только первый поток - простой алгоритм)
-            if (lid == 0) {
-        for (uint k = 0; k < max_peaks_count; ++k) {
-            float max_mag = -1.0f;
-            uint max_idx = UINT_MAX;
             
-                    // Найти максимум среди оставшихся
-                    for (uint i = 0; i < out_count_points_fft; ++i) {
-                if (local_mag[i] > max_mag) {
-                    max_mag = local_mag[i];
-                    max_idx = local_idx[i];
+            for (uint k = 0; k < max_peaks_count; ++k) {
+                // Лучший из ещё не выбранных среди точек потока (шаг local_size)
+                float best_mag = -1.0f;
+                uint best_idx = UINT_MAX;
+                for (uint i = lid; i < out_count_points_fft; i += local_size) {
+                    float mag = magnitude_buffer[base_offset + i];
+                    bool used = false;
+                    for (uint j = 0; j < k; ++j) {
+                        used |= (local_max[j].index == i);
+                    }
+                    if (!used && mag > best_mag) {
+                        best_mag = mag;
+                        best_idx = i;
+                    }
                 }
-            }
-            
-            if (max_idx != UINT_MAX && max_mag > 0.0f) {
-                        // Вычислить phase
-                float2 cval = complex_buffer[base_offset + max_idx];
-                        float phase_deg = atan2(cval.y, cval.x) * 57.2957795f;
-                
-                local_max[k].index = max_idx;
-                local_max[k].magnitude = max_mag;
-                local_max[k].phase = phase_deg;
+                red_mag[lid] = best_mag;
+                red_idx[lid] = best_idx;
+                barrier(CLK_LOCAL_MEM_FENCE);
                 
-                        // Пометить как использованный
-                local_mag[max_idx] = -1.0f;
+                // Максимум по потокам; при равенстве — меньший индекс
+                if (lid == 0) {
+                    for (uint t = 1; t < local_size; ++t) {
+                        if (red_mag[t] > best_mag || (red_mag[t] == best_mag && red_idx[t] < best_idx)) {
+                            best_mag = red_mag[t];
+                            best_idx = red_idx[t];
+                        }
+                    }
+                    
+                    local_max[k].index = UINT_MAX;
+                    local_max[k].magnitude = -1.0f;
+                    local_max[k].phase = 0.0f;
+                    local_max[k].pad = 0;
+                    
+                    if (best_idx != UINT_MAX && best_mag > 0.0f) {
+                        // Вычислить phase
+                        float2 cval = complex_buffer[base_offset + best_idx];
+                        local_max[k].index = best_idx;
+                        local_max[k].magnitude = best_mag;
+                        local_max[k].phase = atan2(cval.y, cval.x) * 57.2957795f;
+                    }
+                }
+                barrier(CLK_LOCAL_MEM_FENCE);
             }
-        }
-    }
-    barrier(CLK_LOCAL_MEM_FENCE);
     
             // Записать результаты в глобальную память
-            if (lid < max_peaks_count) {
-                uint out_idx = beam_idx * max_peaks_count + lid;
-                maxima_buffer[out_idx] = local_max[lid];
+            for (uint k = lid; k < max_peaks_count; k += local_size) {
+                uint out_idx = beam_idx * max_peaks_count + k;
+                maxima_buffer[out_idx] = local_max[k];
     }
 }
 )";
     
-    reduction_program_ = engine_->LoadProgram(reduction_kernel_source);
-    reduction_kernel_ = engine_->GetKernel(reduction_program_, "findMaximaAndPhase");
-}
-
-std::vector<std::vector<FFTMaxResult>> AntennaFFTProcMax::FindMaximaAllBeamsOnGPU(
-    cl_event wait_event, cl_event* out_reduction_event, cl_event* out_read_event) {
-    (void)wait_event;
-    (void)out_reduction_event;
-    (void)out_read_event;
-    if (!post_callback_userdata_) {
-        throw std::runtime_error("post_callback_userdata_ is not initialized");
+    if (engine_) {
+        reduction_program_ = engine_->LoadProgram(reduction_kernel_source);
+        reduction_kernel_ = engine_->GetKernel(reduction_program_, "findMaximaAndPhase");
+        ManagerOpenCL::WorkGroupTuner::Lookup("findMaximaAndPhase", device_, params_.out_count_points_fft, reduction_wg_);
+        return;
     }
     
-    // Layout: params | complex_buffer | magnitude_buffer
-    size_t post_params_size = sizeof(cl_uint) * 4;
-    size_t post_complex_size = params_.beam_count * params_.out_count_points_fft * sizeof(cl_float2);
-    size_t post_magnitude_size = params_.beam_count * params_.out_count_points_fft * sizeof(float);
-    size_t maxima_size = params_.beam_count * params_.max_peaks_count * sizeof(MaxValue);
-    
-    // ═══════════════════════════════════════════════════════════════════════════
-    // ЭТАП 1: Создать kernel если его нет
-    // ═══════════════════════════════════════════════════════════════════════════
+    // Режим DeviceContext: кэш программ engine'а привязан к его контексту
+    cl_int err;
+    const char* sources[] = {reduction_kernel_source.c_str()};
+    size_t lengths[] = {reduction_kernel_source.size()};
     
-    if (!reduction_kernel_) {
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create reduction program: " + std::to_string(err));
+    }
+    
+    err = clBuildProgram(program, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Reduction kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build reduction program");
+    }
+    
+    reduction_kernel_ = clCreateKernel(program, "findMaximaAndPhase", &err);
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create reduction kernel: " + std::to_string(err));
+    }
+    ManagerOpenCL::WorkGroupTuner::Lookup("findMaximaAndPhase", device_, params_.out_count_points_fft, reduction_wg_);
+}
+
+size_t AntennaFFTProcMax::GetReductionLocalSize(cl_command_queue queue) {
+    // local size ограничен RED_LOCAL_SIZE ядра и пределом устройства для ядра
+    size_t max_local = kMaxReductionLocalSize;
+    size_t kernel_wg = 0;
+    if (clGetKernelWorkGroupInfo(reduction_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(kernel_wg), &kernel_wg, nullptr) == CL_SUCCESS && kernel_wg > 0) {
+        max_local = std::min(max_local, kernel_wg);
+    }
+    
+    // Запись базы настроек могла быть получена с другим пределом
+    if (reduction_wg_.IsValid() && reduction_wg_.local_size > max_local) {
+        reduction_wg_ = ManagerOpenCL::WorkGroupConfig{};
+    }
+    
+    if (!reduction_wg_.IsValid()) {
+        // Один work-group на луч: подбирается только local size (поиск top-N от него не зависит)
+        size_t beam_count = params_.beam_count;
+        reduction_wg_ = ManagerOpenCL::WorkGroupTuner::Tune(
+            "findMaximaAndPhase", reduction_kernel_, device_, queue, params_.out_count_points_fft, max_local, {1},
+            [this, beam_count](cl_command_queue q, const ManagerOpenCL::WorkGroupConfig& c, cl_event* ev) {
+                size_t local = c.local_size;
+                size_t global = beam_count * local;
+                return clEnqueueNDRangeKernel(q, reduction_kernel_, 1, nullptr, &global, &local, 0, nullptr, ev);
+            });
+    }
+    return reduction_wg_.local_size;
+}
+
+std::vector<std::vector<FFTMaxResult>> AntennaFFTProcMax::FindMaximaAllBeamsOnGPU(
+    cl_event wait_event, cl_event* out_reduction_event, cl_event* out_read_event) {
+    (void)wait_event;
+    (void)out_reduction_event;
+    (void)out_read_event;
+    if (!post_callback_userdata_) {
+        throw std::runtime_error("post_callback_userdata_ is not initialized");
+    }
+    
+    // Layout: params | complex_buffer | magnitude_buffer
+    size_t post_params_size = sizeof(cl_uint) * 4;
+    size_t post_complex_size = params_.beam_count * params_.out_count_points_fft * sizeof(cl_float2);
+    size_t post_magnitude_size = params_.beam_count * params_.out_count_points_fft * sizeof(float);
+    size_t maxima_size = params_.beam_count * params_.max_peaks_count * sizeof(MaxValue);
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // ЭТАП 1: Создать kernel если его нет
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    if (!reduction_kernel_) {
         CreateMaxReductionKernel();
     }
     
     // Создать буфер для результатов максимумов
     if (!buffer_maxima_) {
         const size_t maxima_elements = (maxima_size + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
-        buffer_maxima_ = engine_->CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_maxima_ = CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     
     // ═══════════════════════════════════════════════════════════════════════════
@@ -2255,15 +3010,9 @@ std::vector<std::vector<FFTMaxResult>> AntennaFFTProcMax::FindMaximaAllBeamsOnGP
     clSetKernelArg(reduction_kernel_, 4, sizeof(cl_uint), &out_count_points_fft);
     clSetKernelArg(reduction_kernel_, 5, sizeof(cl_uint), &max_peaks_count);
     
-    // Один work-group на beam, local_size подбирается автоматически
-    size_t global_work_size = params_.beam_count * 256;  // 256 потоков на beam
-    size_t local_work_size = 256;
-    
-    // Ограничение: out_count_points_fft <= 1024 для local memory
-    if (params_.out_count_points_fft > 1024) {
-        local_work_size = 64;  // Уменьшить для больших размеров
-        global_work_size = params_.beam_count * local_work_size;
-    }
+    // Один work-group на beam, local_size — из WorkGroupTuner
+    size_t local_work_size = GetReductionLocalSize(queue_);
+    size_t global_work_size = params_.beam_count * local_work_size;
     
     cl_event reduction_event = nullptr;
     err = clEnqueueNDRangeKernel(
@@ -2361,7 +3110,7 @@ std::vector<std::vector<FFTMaxResult>> AntennaFFTProcMax::FindMaximaAllBeamsOnGP
     // Создать буфер для результатов максимумов
     if (!buffer_maxima_) {
         const size_t maxima_elements = (maxima_size + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
-        buffer_maxima_ = engine_->CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        buffer_maxima_ = CreateBuffer(maxima_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
     }
     
     // ═══════════════════════════════════════════════════════════════════════════
@@ -2385,15 +3134,9 @@ std::vector<std::vector<FFTMaxResult>> AntennaFFTProcMax::FindMaximaAllBeamsOnGP
         throw std::runtime_error("Failed to set reduction kernel args: " + std::to_string(err));
     }
     
-    // Один work-group на beam, local_size подбирается автоматически
-    size_t global_work_size = params_.beam_count * 256;  // 256 потоков на beam
-    size_t local_work_size = 256;
-    
-    // Ограничение: search_range <= 1024 для local memory
-    if (search_range > 1024) {
-        local_work_size = 64;
-        global_work_size = params_.beam_count * local_work_size;
-    }
+    // Один work-group на beam, local_size — из WorkGroupTuner
+    size_t local_work_size = GetReductionLocalSize(queue_);
+    size_t global_work_size = params_.beam_count * local_work_size;
     
     cl_event reduction_event = nullptr;
     cl_uint num_wait_events = wait_event ? 1 : 0;
@@ -2727,6 +3470,42 @@ void AntennaFFTProcMax::UpdateParams(const AntennaFFTParams& params) {
     
     if (need_rebuild) {
         ReleaseFFTPlan();
+        if (direct_plan_handle_) {
+            clfftDestroyPlan(&direct_plan_handle_);
+            direct_plan_handle_ = 0;
+        }
+        if (inplace_plan_handle_) {
+            clfftDestroyPlan(&inplace_plan_handle_);
+            inplace_plan_handle_ = 0;
+        }
+        // Спектр опоры зависит от nFFT: пересчитается при следующем ProcessPulseCompression()
+        ReleasePulseCompressionResources();
+        if (pc_reference_.size() > params_.count_points) {
+            pc_reference_.resize(params_.count_points);
+        }
+        // R2C план и буферы зависят от nFFT и числа лучей
+        if (real_plan_handle_) {
+            clfftDestroyPlan(&real_plan_handle_);
+            real_plan_handle_ = 0;
+        }
+        // Ядра создаются заново вместе с планом в CreateRealInputResources()
+        if (real_padding_kernel_) {
+            clReleaseKernel(real_padding_kernel_);
+            real_padding_kernel_ = nullptr;
+        }
+        if (hermitian_window_kernel_) {
+            clReleaseKernel(hermitian_window_kernel_);
+            hermitian_window_kernel_ = nullptr;
+        }
+        buffer_real_input_.reset();
+        buffer_real_spectrum_.reset();
+        buffer_real_window_.reset();
+        // Пороги разреженного вывода — по одному на луч
+        buffer_sparse_thresholds_.reset();
+        // Накопитель по окну beam_count × out_count_points_fft
+        buffer_integration_acc_.reset();
+        buffer_integration_window_.reset();
+        ResetIntegration();
         // Буферы будут пересозданы при следующем вызове Process()
         buffer_fft_input_.reset();
         buffer_fft_output_.reset();
@@ -2736,164 +3515,1737 @@ void AntennaFFTProcMax::UpdateParams(const AntennaFFTParams& params) {
 }
 
 // ════════════════════════════════════════════════════════════════════════════
-// ПАРАЛЛЕЛЬНАЯ ОБРАБОТКА БАТЧЕЙ (ProcessWithBatchingNew)
+// СЖАТИЕ ИМПУЛЬСА (согласованный фильтр ЛЧМ)
 // ════════════════════════════════════════════════════════════════════════════
 
-void AntennaFFTProcMax::InitializeParallelResources(size_t max_beams_per_stream, size_t num_streams) {
-    // Освободить старые ресурсы
-    ReleaseParallelResources();
+void AntennaFFTProcMax::SetPulseCompressionReference(const LFMParameters& lfm) {
+    if (!lfm.IsValid()) {
+        throw std::invalid_argument("SetPulseCompressionReference: invalid LFMParameters");
+    }
     
-    // Если num_streams == 0, использовать значение из config
-    if (num_streams == 0) {
-        num_streams = batch_config_.num_parallel_streams;
+    // Та же фаза, что в kernel_lfm_basic: φ(t) = 2π(f_start·t + 0.5·k·t²), k = Δf / duration
+    const size_t length = std::min(lfm.count_points, params_.count_points);
+    const double chirp_rate = static_cast<double>(lfm.f_stop - lfm.f_start) / lfm.duration;
+    std::vector<std::complex<float>> reference(length);
+    for (size_t n = 0; n < length; ++n) {
+        double t = static_cast<double>(n) / lfm.sample_rate;
+        double phase = 2.0 * M_PI * (lfm.f_start * t + 0.5 * chirp_rate * t * t);
+        reference[n] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+    }
+    SetPulseCompressionReference(reference);
+}
+
+void AntennaFFTProcMax::SetPulseCompressionReference(const std::vector<std::complex<float>>& reference) {
+    if (reference.empty() || reference.size() > params_.count_points) {
+        throw std::invalid_argument("SetPulseCompressionReference: reference length must be 1.." +
+                                    std::to_string(params_.count_points) + ", got " +
+                                    std::to_string(reference.size()));
+    }
+    ReleasePulseCompressionResources();
+    pc_reference_ = reference;
+}
+
+std::string AntennaFFTProcMax::GetPulseCompressionCallbackSource() const {
+    // Post-callback: спектр луча × conj(спектр опоры), запись в выходной буфер FFT
+    return R"(
+        typedef struct {
+            uint nFFT;
+            uint beam_count;
+            uint pad0;
+            uint pad1;
+        } PulseCompressionUserData;
+
+        void pulseCompressionPost(__global void* output, uint outoffset, __global void* userdata, float2 fftoutput) {
+            __global PulseCompressionUserData* params = (__global PulseCompressionUserData*)userdata;
+            __global const float2* ref_conj =
+                (__global const float2*)((__global char*)userdata + sizeof(PulseCompressionUserData));
+
+            float2 r = ref_conj[outoffset % params->nFFT];
+            ((__global float2*)output)[outoffset] = (float2)(
+                fftoutput.x * r.x - fftoutput.y * r.y,
+                fftoutput.x * r.y + fftoutput.y * r.x);
+        }
+    )";
+}
+
+void AntennaFFTProcMax::CreatePulseCompressionResources() {
+    if (pc_forward_plan_ != 0) {
+        return;
+    }
+    if (pc_reference_.empty()) {
+        throw std::runtime_error("Pulse compression reference is not set");
     }
     
-    num_parallel_streams_ = num_streams;
-    parallel_resources_.resize(num_parallel_streams_);
+    struct PulseCompressionUserData {
+        cl_uint nFFT;
+        cl_uint beam_count;
+        cl_uint pad0;
+        cl_uint pad1;
+    };
+    const size_t spectrum_bytes = nFFT_ * sizeof(std::complex<float>);
     
-    auto t_start = std::chrono::high_resolution_clock::now();
+    // ═══════════════════════════════════════════════════════════════════════════
+    // 1. Спектр опоры: один FFT длины nFFT (опора дополнена нулями), сопряжение на хосте
+    // ═══════════════════════════════════════════════════════════════════════════
     
-    size_t fft_buf_size = max_beams_per_stream * nFFT_;
-    // Размер буфера для MaxValue результатов (новый unified kernel)
-    // MaxValue: { uint index, real, imag, magnitude, phase, freq_offset, refined_frequency, pad } = 32 bytes
-    size_t maxima_buf_elements = max_beams_per_stream * params_.max_peaks_count;
-    // Выравниваем на размер complex (8 bytes) для создания буфера
-    size_t maxima_complex_elements = (maxima_buf_elements * 32 + 7) / 8;
+    std::vector<std::complex<float>> spectrum(nFFT_, {0.0f, 0.0f});
+    std::copy(pc_reference_.begin(), pc_reference_.end(), spectrum.begin());
     
-    for (size_t i = 0; i < num_parallel_streams_; ++i) {
-        auto& res = parallel_resources_[i];
-        
-        // Создать буферы для этого потока
-        res.fft_input = engine_->CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
-        res.fft_output = engine_->CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
-        res.maxima = engine_->CreateBuffer(maxima_complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
-        
-        // Получить command queue для этого потока
-        res.queue = ManagerOpenCL::CommandQueuePool::GetQueue(i % ManagerOpenCL::CommandQueuePool::GetPoolSize());
-        
-        // Создать FFT план для этого потока
-        size_t clLengths[1] = {nFFT_};
-        clfftStatus status = clfftCreateDefaultPlan(&res.plan_handle, context_, CLFFT_1D, clLengths);
-        if (status != CLFFT_SUCCESS) {
-            throw std::runtime_error("InitializeParallelResources: clfftCreateDefaultPlan failed");
-        }
-        
-        clfftSetPlanPrecision(res.plan_handle, CLFFT_SINGLE);
-        clfftSetLayout(res.plan_handle, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
-        clfftSetResultLocation(res.plan_handle, CLFFT_OUTOFPLACE);
-        clfftSetPlanBatchSize(res.plan_handle, max_beams_per_stream);
-        
-        size_t strides[1] = {1};
-        clfftSetPlanInStride(res.plan_handle, CLFFT_1D, strides);
-        clfftSetPlanOutStride(res.plan_handle, CLFFT_1D, strides);
-        clfftSetPlanDistance(res.plan_handle, nFFT_, nFFT_);
-        
-        status = clfftBakePlan(res.plan_handle, 1, &res.queue, nullptr, nullptr);
-        if (status != CLFFT_SUCCESS) {
-            clfftDestroyPlan(&res.plan_handle);
-            res.plan_handle = 0;
-            throw std::runtime_error("InitializeParallelResources: clfftBakePlan failed");
-        }
-        
-        res.initialized = true;
+    auto ref_time = CreateBuffer(nFFT_, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    auto ref_freq = CreateBuffer(nFFT_, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    cl_mem ref_in = ref_time->Get();
+    cl_mem ref_out = ref_freq->Get();
+    
+    cl_int err = clEnqueueWriteBuffer(queue_, ref_in, CL_TRUE, 0, spectrum_bytes,
+                                      spectrum.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to upload pulse compression reference: " + std::to_string(err));
     }
     
-    parallel_buffers_size_ = max_beams_per_stream;
+    clfftPlanHandle ref_plan = CreateBatchedPlan(1);
+    clfftStatus status = clfftBakePlan(ref_plan, 1, &queue_, nullptr, nullptr);
+    if (status == CLFFT_SUCCESS) {
+        status = clfftEnqueueTransform(ref_plan, CLFFT_FORWARD, 1, &queue_, 0, nullptr, nullptr,
+                                       &ref_in, &ref_out, nullptr);
+    }
+    if (status == CLFFT_SUCCESS) {
+        err = clEnqueueReadBuffer(queue_, ref_out, CL_TRUE, 0, spectrum_bytes,
+                                  spectrum.data(), 0, nullptr, nullptr);
+    }
+    clfftDestroyPlan(&ref_plan);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("Reference FFT failed with status: " + std::to_string(status));
+    }
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to read reference spectrum: " + std::to_string(err));
+    }
     
-    auto t_end = std::chrono::high_resolution_clock::now();
-    double ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
-    printf("  ⏱️  Created %zu parallel streams (max %zu beams each): %.2f ms\n\n", 
-           num_parallel_streams_, max_beams_per_stream, ms);
+    for (auto& value : spectrum) {
+        value = std::conj(value);
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // 2. Userdata post-callback: params | conj(spectrum)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    PulseCompressionUserData pc_params = {
+        static_cast<cl_uint>(nFFT_),
+        static_cast<cl_uint>(params_.beam_count),
+        0, 0
+    };
+    
+    pc_callback_userdata_ = clCreateBuffer(context_, CL_MEM_READ_ONLY,
+                                           sizeof(pc_params) + spectrum_bytes, nullptr, &err);
+    if (err != CL_SUCCESS) {
+        pc_callback_userdata_ = nullptr;
+        throw std::runtime_error("Failed to create pulse compression userdata: " + std::to_string(err));
+    }
+    err = clEnqueueWriteBuffer(queue_, pc_callback_userdata_, CL_FALSE, 0, sizeof(pc_params),
+                               &pc_params, 0, nullptr, nullptr);
+    err |= clEnqueueWriteBuffer(queue_, pc_callback_userdata_, CL_TRUE, sizeof(pc_params), spectrum_bytes,
+                                spectrum.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        ReleasePulseCompressionResources();
+        throw std::runtime_error("Failed to write pulse compression userdata: " + std::to_string(err));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // 3. Планы: прямой (умножение в post-callback) и обратный
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    std::string callback = GetPulseCompressionCallbackSource();
+    pc_forward_plan_ = CreateBatchedPlan(params_.beam_count);
+    status = clfftSetPlanCallback(pc_forward_plan_, "pulseCompressionPost", callback.c_str(), 0,
+                                  POSTCALLBACK, &pc_callback_userdata_, 1);
+    if (status == CLFFT_SUCCESS) {
+        status = clfftBakePlan(pc_forward_plan_, 1, &queue_, nullptr, nullptr);
+    }
+    if (status != CLFFT_SUCCESS) {
+        ReleasePulseCompressionResources();
+        throw std::runtime_error("Pulse compression forward plan failed: " + std::to_string(status));
+    }
+    
+    // Обратное преобразование clFFT нормирует на 1/nFFT (scale по умолчанию)
+    pc_inverse_plan_ = CreateBatchedPlan(params_.beam_count);
+    status = clfftBakePlan(pc_inverse_plan_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        ReleasePulseCompressionResources();
+        throw std::runtime_error("Pulse compression inverse plan failed: " + std::to_string(status));
+    }
 }
 
-void AntennaFFTProcMax::ReleaseParallelResources() {
-    for (auto& res : parallel_resources_) {
-        if (res.plan_handle) {
-            clfftDestroyPlan(&res.plan_handle);
-            res.plan_handle = 0;
-        }
-        res.fft_input.reset();
-        res.fft_output.reset();
-        res.maxima.reset();
-        res.sel_complex.reset();
-        res.sel_magnitude.reset();
-        res.queue = nullptr;
-        res.initialized = false;
+void AntennaFFTProcMax::ReleasePulseCompressionResources() {
+    if (pc_forward_plan_) {
+        clfftDestroyPlan(&pc_forward_plan_);
+        pc_forward_plan_ = 0;
+    }
+    if (pc_inverse_plan_) {
+        clfftDestroyPlan(&pc_inverse_plan_);
+        pc_inverse_plan_ = 0;
+    }
+    if (pc_callback_userdata_) {
+        clReleaseMemObject(pc_callback_userdata_);
+        pc_callback_userdata_ = nullptr;
     }
-    parallel_resources_.clear();
-    parallel_buffers_size_ = 0;
 }
 
-// Запуск батча БЕЗ ожидания (асинхронно на GPU)
-// ИСПОЛЬЗУЕМ kernel'ы по индексу потока для thread-safety!
-// ВАЖНО: FFT план требует ТОЧНЫЙ batch size = parallel_buffers_size_!
-std::vector<FFTResult> AntennaFFTProcMax::ProcessBatchParallelNoWait(
-    cl_mem input_signal,
-    size_t start_beam,
-    size_t num_beams,
-    size_t stream_idx,
-    cl_event* completion_event) {
-    
-    auto& res = parallel_resources_[stream_idx];
-    cl_int err;
+AntennaFFTResult AntennaFFTProcMax::ProcessPulseCompression(const std::vector<std::complex<float>>& input_data) {
+    RequireDefaultLayout("ProcessPulseCompression");
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
     
-    // FFT ПЛАН ТРЕБУЕТ ТОЧНЫЙ BATCH SIZE!
-    // Обрабатываем num_beams, но FFT работает с parallel_buffers_size_
-    size_t fft_batch_size = parallel_buffers_size_;  // Размер плана
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return ProcessPulseCompression(buffer->Get());
+}
+
+AntennaFFTResult AntennaFFTProcMax::ProcessPulseCompression(cl_mem input_signal) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessPulseCompression: input_signal is null");
+    }
     
-    cl_mem fft_in = res.fft_input->Get();
-    cl_mem fft_out = res.fft_output->Get();
-    cl_mem maxima_out = res.maxima->Get();
+    CreatePulseCompressionResources();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
     
-    // ИСПОЛЬЗУЕМ KERNEL ПО ИНДЕКСУ ПОТОКА!
-    cl_kernel pad_kernel = padding_kernels_[stream_idx];
-    cl_kernel pst_kernel = post_kernels_[stream_idx];
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_fft_output_) {
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
     
-    // STEP 1: Padding kernel (обрабатывает num_beams, но пишет в буфер для fft_batch_size)
-    cl_uint batch_beam_count = static_cast<cl_uint>(num_beams);
-    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
-    cl_uint nfft = static_cast<cl_uint>(nFFT_);
-    cl_uint beam_offset = static_cast<cl_uint>(start_beam);
+    // ═══════════════════════════════════════════════════════════════════════════
+    // padding → FFT × conj(ref) → IFFT (обратно в fft_input) → post (top-N по дальности)
+    // ═══════════════════════════════════════════════════════════════════════════
     
-    err = clSetKernelArg(pad_kernel, 0, sizeof(cl_mem), &input_signal);
-    err |= clSetKernelArg(pad_kernel, 1, sizeof(cl_mem), &fft_in);
-    err |= clSetKernelArg(pad_kernel, 2, sizeof(cl_uint), &batch_beam_count);
-    err |= clSetKernelArg(pad_kernel, 3, sizeof(cl_uint), &count_points);
-    err |= clSetKernelArg(pad_kernel, 4, sizeof(cl_uint), &nfft);
-    err |= clSetKernelArg(pad_kernel, 5, sizeof(cl_uint), &beam_offset);
+    cl_mem fft_input = buffer_fft_input_->Get();
+    cl_mem fft_output = buffer_fft_output_->Get();
     
+    cl_event event_padding = nullptr;
+    cl_int err = EnqueueInputPadding(queue_, input_signal, fft_input, params_.beam_count, 0,
+                                     0, nullptr, &event_padding);
     if (err != CL_SUCCESS) {
-        std::cerr << "  ❌ ProcessBatchParallelNoWait: set padding kernel args failed: " << err << "\n";
-        if (completion_event) *completion_event = nullptr;
-        return {};
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding) failed: " + std::to_string(err));
     }
     
-    cl_event event_fill = nullptr;
-    cl_event event_padding = nullptr;
-    
-    // Сначала обнулим весь буфер (если num_beams < fft_batch_size)
-    // ВАЖНО: используем событие чтобы padding kernel ждал завершения!
-    if (num_beams < fft_batch_size) {
-        std::complex<float> zero(0.0f, 0.0f);
-        err = clEnqueueFillBuffer(res.queue, fft_in, &zero, sizeof(zero), 
-                                  0, fft_batch_size * nFFT_ * sizeof(std::complex<float>),
-                                  0, nullptr, &event_fill);
-        if (err != CL_SUCCESS) {
-            std::cerr << "  ❌ ProcessBatchParallelNoWait: FillBuffer failed: " << err << "\n";
-            if (completion_event) *completion_event = nullptr;
-            return {};
-        }
+    cl_event event_forward = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        pc_forward_plan_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_forward,
+        &fft_input, &fft_output, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (pulse compression forward) failed: " +
+                                 std::to_string(status));
     }
     
-    // Заполняем только num_beams реальными данными
-    // Padding kernel зависит от FillBuffer (если был)
-    size_t real_padding_size = num_beams * nFFT_;
-    cl_uint num_wait_events = event_fill ? 1 : 0;
-    cl_event* wait_list = event_fill ? &event_fill : nullptr;
+    cl_event event_inverse = nullptr;
+    status = clfftEnqueueTransform(
+        pc_inverse_plan_, CLFFT_BACKWARD, 1, &queue_,
+        1, &event_forward, &event_inverse,
+        &fft_output, &fft_input, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_forward);
+        throw std::runtime_error("clfftEnqueueTransform (pulse compression inverse) failed: " +
+                                 std::to_string(status));
+    }
     
-    err = clEnqueueNDRangeKernel(res.queue, pad_kernel, 1, nullptr, 
-                                 &real_padding_size, nullptr, 
-                                 num_wait_events, wait_list, &event_padding);
+    cl_event event_post = nullptr;
+    err = EnqueuePostKernel(fft_input, event_inverse, &event_post);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_forward);
+        clReleaseEvent(event_inverse);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding");
+    last_profiling_.fft_time_ms = ProfileEvent(event_forward, "FFT × conj(ref)") +
+                                  ProfileEvent(event_inverse, "IFFT");
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (range max)");
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_forward);
+    clReleaseEvent(event_inverse);
+    clReleaseEvent(event_post);
+    
+    return ReadMaximaResult();
+}
+
+AntennaFFTResult AntennaFFTProcMax::FindMaximaInSpectrum(cl_mem spectrum, size_t spectrum_stride) {
+    if (!spectrum) {
+        throw std::invalid_argument("FindMaximaInSpectrum: spectrum is null");
+    }
+    if (spectrum_stride < params_.out_count_points_fft) {
+        throw std::invalid_argument("FindMaximaInSpectrum: spectrum_stride " + std::to_string(spectrum_stride) +
+                                    " < out_count_points_fft " + std::to_string(params_.out_count_points_fft));
+    }
+    
+    cl_event event_post = nullptr;
+    cl_int err = EnqueuePostKernel(spectrum, nullptr, &event_post, spectrum_stride);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    clWaitForEvents(1, &event_post);
+    last_profiling_.post_callback_time_ms = ProfileEvent(event_post, "Post (external spectrum)");
+    clReleaseEvent(event_post);
+    
+    AntennaFFTResult result = ReadMaximaResult();
+    result.nFFT = spectrum_stride;
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// CFAR ОБНАРУЖЕНИЕ
+// ════════════════════════════════════════════════════════════════════════════
+
+CFARResult AntennaFFTProcMax::ProcessCFAR(const std::vector<std::complex<float>>& input_data,
+                                          const CFARParams& cfar) {
+    RequireDefaultLayout("ProcessCFAR");
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
+    
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return ProcessCFAR(buffer->Get(), cfar);
+}
+
+CFARResult AntennaFFTProcMax::ProcessCFAR(cl_mem input_signal, const CFARParams& cfar) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessCFAR: input_signal is null");
+    }
+    
+    if (!cfar_) {
+        ManagerOpenCL::DeviceContext dc;
+        dc.context = context_;
+        dc.device = device_;
+        dc.queue = queue_;
+        cfar_ = std::make_unique<CFARDetector>(cfar, dc);
+    } else {
+        cfar_->SetParams(cfar);
+    }
+    
+    CreateDirectInputPlan();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
+    
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_fft_output_) {
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // padding → FFT → |X|² (первые out_count_points_fft бинов) → CFAR
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_mem fft_input = buffer_fft_input_->Get();
+    cl_mem fft_output = buffer_fft_output_->Get();
+    
+    cl_event event_padding = nullptr;
+    cl_int err = EnqueueInputPadding(queue_, input_signal, fft_input, params_.beam_count, 0,
+                                     0, nullptr, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding) failed: " + std::to_string(err));
+    }
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        direct_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_fft,
+        &fft_input, &fft_output, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (CFAR) failed: " + std::to_string(status));
+    }
+    
+    const size_t num_cells = std::min(params_.out_count_points_fft, nFFT_);
+    CFARResult result;
+    try {
+        result = cfar_->DetectSpectrum(fft_output, params_.beam_count, num_cells, nFFT_, event_fft);
+    } catch (...) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw;
+    }
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT");
+    last_profiling_.post_callback_time_ms = result.kernel_time_ms;
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// УТОЧНЕНИЕ МАКСИМУМОВ (ZOOM-DTFT)
+// ════════════════════════════════════════════════════════════════════════════
+
+void AntennaFFTProcMax::CreateZoomKernel() {
+    // Одна work-group = одна точка сетки одного максимума
+    // Частота точки: m / denom (denom = nFFT · zoom), фаза по (m·n) mod denom — без потери точности
+    const char* kernel_source = R"CL(
+        #ifndef ZOOM_LOCAL_SIZE
+        #define ZOOM_LOCAL_SIZE 64
+        #endif
+        
+        __kernel void zoom_dtft(
+            __global const float2* input,       // beam_count * count_points
+            __global const long2* tasks,        // (m0, луч) для каждого максимума
+            __global float2* output,            // tasks * points
+            uint count_points,
+            uint points,
+            ulong denom
+        ) {
+            uint group = get_group_id(0);
+            uint task = group / points;
+            uint j = group % points;
+            uint lid = get_local_id(0);
+            uint local_size = get_local_size(0);
+            
+            __local float2 partial[ZOOM_LOCAL_SIZE];   // local_size <= ZOOM_LOCAL_SIZE
+            
+            long2 t = tasks[task];
+            long m = t.x + (long)j;
+            long d = (long)denom;
+            ulong mm = (ulong)(((m % d) + d) % d);
+            __global const float2* x = input + (size_t)t.y * count_points;
+            
+            float2 acc = (float2)(0.0f, 0.0f);
+            for (uint n = lid; n < count_points; n += local_size) {
+                // r < denom: деление во float без fp64
+                ulong r = (mm * (ulong)n) % denom;
+                float angle = -6.28318530718f * ((float)r / (float)denom);
+                float c;
+                float s = sincos(angle, &c);
+                float2 v = x[n];
+                acc += (float2)(v.x * c - v.y * s, v.x * s + v.y * c);
+            }
+            partial[lid] = acc;
+            barrier(CLK_LOCAL_MEM_FENCE);
+            
+            for (uint stride = local_size / 2; stride > 0; stride >>= 1) {
+                if (lid < stride) {
+                    partial[lid] += partial[lid + stride];
+                }
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
+            if (lid == 0) {
+                output[group] = partial[0];
+            }
+        }
+    )CL";
+    
+    cl_int err;
+    const char* sources[] = {kernel_source};
+    size_t lengths[] = {strlen(kernel_source)};
+    
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create zoom program: " + std::to_string(err));
+    }
+    
+    const std::string options = "-D ZOOM_LOCAL_SIZE=" + std::to_string(kZoomLocalSize);
+    err = clBuildProgram(program, 1, &device_, options.c_str(), nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Zoom kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build zoom program");
+    }
+    
+    zoom_kernel_ = clCreateKernel(program, "zoom_dtft", &err);
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create zoom kernel: " + std::to_string(err));
+    }
+}
+
+ZoomFFTResult AntennaFFTProcMax::RefinePeaks(const std::vector<std::complex<float>>& input_data,
+                                             const AntennaFFTResult& coarse, const ZoomFFTParams& zoom) {
+    RequireDefaultLayout("RefinePeaks");
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
+    
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return RefinePeaks(buffer->Get(), coarse, zoom);
+}
+
+ZoomFFTResult AntennaFFTProcMax::RefinePeaks(cl_mem input_signal, const AntennaFFTResult& coarse,
+                                             const ZoomFFTParams& zoom) {
+    if (!input_signal) {
+        throw std::invalid_argument("RefinePeaks: input_signal is null");
+    }
+    // Zoom-DTFT читает input_signal + beam·count_points: только beam-major float2
+    RequireDefaultLayout("RefinePeaks");
+    if (!zoom.IsValid()) {
+        throw std::invalid_argument("ZoomFFTParams: invalid parameters");
+    }
+    if (coarse.results.size() > params_.beam_count) {
+        throw std::invalid_argument("RefinePeaks: coarse result has more beams than the processor");
+    }
+    
+    if (!zoom_kernel_) {
+        CreateZoomKernel();
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Задачи: (луч, максимум) → первая точка сетки m0 (в единицах 1/zoom бина)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    const long long zoom_factor = static_cast<long long>(zoom.zoom_factor);
+    const long long half_points = static_cast<long long>(std::lround(zoom.span_bins * zoom.zoom_factor));
+    const size_t points = static_cast<size_t>(2 * half_points + 1);
+    const long long nfft = static_cast<long long>(nFFT_);
+    const long long half_window = static_cast<long long>(params_.out_count_points_fft / 2);
+    
+    std::vector<cl_long2> task_list;
+    std::vector<size_t> task_coarse;
+    for (size_t beam = 0; beam < coarse.results.size(); ++beam) {
+        for (const auto& peak : coarse.results[beam].max_values) {
+            long long bin = static_cast<long long>(peak.index_point);
+            if (zoom.index_mode == ZoomIndexMode::FFTSHIFT_WINDOW) {
+                bin -= half_window;
+            } else if (bin >= nfft / 2) {
+                bin -= nfft;
+            }
+            cl_long2 task;
+            task.s[0] = static_cast<cl_long>(bin * zoom_factor - half_points);
+            task.s[1] = static_cast<cl_long>(beam);
+            task_list.push_back(task);
+            task_coarse.push_back(peak.index_point);
+        }
+    }
+    
+    ZoomFFTResult result;
+    result.points_per_peak = points;
+    result.beams.resize(coarse.results.size());
+    if (task_list.empty()) {
+        return result;
+    }
+    
+    const size_t tasks = task_list.size();
+    // Буферы в элементах complex<float>: одна задача long2 = 2 элемента
+    const size_t task_elements = tasks * 2;
+    if (!buffer_zoom_tasks_ || buffer_zoom_tasks_->GetNumElements() < task_elements) {
+        buffer_zoom_tasks_ = CreateBuffer(task_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_zoom_output_ || buffer_zoom_output_->GetNumElements() < tasks * points) {
+        buffer_zoom_output_ = CreateBuffer(tasks * points, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_zoom_tasks_->Get(), CL_FALSE, 0,
+                                      tasks * sizeof(cl_long2), task_list.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (zoom tasks) failed: " + std::to_string(err));
+    }
+    
+    cl_mem tasks_mem = buffer_zoom_tasks_->Get();
+    cl_mem output_mem = buffer_zoom_output_->Get();
+    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
+    cl_uint points_arg = static_cast<cl_uint>(points);
+    cl_ulong denom = static_cast<cl_ulong>(nFFT_ * zoom.zoom_factor);
+    
+    err = clSetKernelArg(zoom_kernel_, 0, sizeof(cl_mem), &input_signal);
+    err |= clSetKernelArg(zoom_kernel_, 1, sizeof(cl_mem), &tasks_mem);
+    err |= clSetKernelArg(zoom_kernel_, 2, sizeof(cl_mem), &output_mem);
+    err |= clSetKernelArg(zoom_kernel_, 3, sizeof(cl_uint), &count_points);
+    err |= clSetKernelArg(zoom_kernel_, 4, sizeof(cl_uint), &points_arg);
+    err |= clSetKernelArg(zoom_kernel_, 5, sizeof(cl_ulong), &denom);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set zoom kernel args: " + std::to_string(err));
+    }
+    
+    // Степень двойки <= ZOOM_LOCAL_SIZE (размер partial[]) и пределу устройства для ядра
+    size_t local_size = kZoomLocalSize;
+    size_t kernel_wg = 0;
+    if (clGetKernelWorkGroupInfo(zoom_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(kernel_wg), &kernel_wg, nullptr) == CL_SUCCESS && kernel_wg > 0) {
+        while (local_size > kernel_wg) local_size >>= 1;
+    }
+    size_t global_size = tasks * points * local_size;
+    cl_event event_zoom = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, zoom_kernel_, 1, nullptr, &global_size, &local_size,
+                                 0, nullptr, &event_zoom);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (zoom) failed: " + std::to_string(err));
+    }
+    
+    std::vector<std::complex<float>> grid(tasks * points);
+    err = clEnqueueReadBuffer(queue_, output_mem, CL_TRUE, 0, grid.size() * sizeof(std::complex<float>),
+                              grid.data(), 1, &event_zoom, nullptr);
+    result.kernel_time_ms = ProfileEvent(event_zoom, "Zoom DTFT");
+    clReleaseEvent(event_zoom);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (zoom) failed: " + std::to_string(err));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Максимум сетки + параболическая интерполяция (как в post_kernel)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    for (size_t t = 0; t < tasks; ++t) {
+        const std::complex<float>* row = &grid[t * points];
+        size_t best = 0;
+        for (size_t j = 1; j < points; ++j) {
+            if (std::abs(row[j]) > std::abs(row[best])) best = j;
+        }
+        
+        float offset = 0.0f;
+        if (best > 0 && best + 1 < points) {
+            float y_left = std::abs(row[best - 1]);
+            float y_center = std::abs(row[best]);
+            float y_right = std::abs(row[best + 1]);
+            float denom_p = y_left - 2.0f * y_center + y_right;
+            if (std::fabs(denom_p) > 1e-10f) {
+                offset = std::clamp(0.5f * (y_left - y_right) / denom_p, -0.5f, 0.5f);
+            }
+        }
+        
+        RefinedPeak peak;
+        peak.coarse_index = task_coarse[t];
+        peak.refined_bin = (static_cast<float>(task_list[t].s[0]) + static_cast<float>(best) + offset) /
+                           static_cast<float>(zoom.zoom_factor);
+        peak.frequency_hz = peak.refined_bin * zoom.sample_rate / static_cast<float>(nFFT_);
+        peak.real = row[best].real();
+        peak.imag = row[best].imag();
+        peak.amplitude = std::abs(row[best]);
+        peak.phase = std::atan2(peak.imag, peak.real) * 57.2957795131f;
+        result.beams[static_cast<size_t>(task_list[t].s[1])].push_back(peak);
+    }
+    
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// РАЗРЕЖЕННЫЙ ВЫВОД СПЕКТРА (ПОРОГ + УПЛОТНЕНИЕ)
+// ════════════════════════════════════════════════════════════════════════════
+
+namespace {
+
+// Запись sparse_compact (совпадает с SparseEntry в ядре)
+struct SparseEntryGPU {
+    cl_uint beam;
+    cl_uint bin;
+    cl_float real;
+    cl_float imag;
+    cl_float magnitude;
+};
+
+} // anonymous namespace
+
+void AntennaFFTProcMax::CreateSparseKernel() {
+    // 2D NDRange: (бин, луч). Флаг |X| > порог → inclusive scan в группе →
+    // один atomic_add на группу → запись в слот base + scan - 1
+    const char* kernel_source = R"CL(
+        typedef struct {
+            uint beam;
+            uint bin;
+            float real;
+            float imag;
+            float magnitude;
+        } SparseEntry;
+        
+        __kernel void sparse_compact(
+            __global const float2* spectrum,     // offset + beam * stride + bin
+            __global const float* thresholds,    // beam_count
+            __global SparseEntry* entries,       // max_entries
+            __global uint* count,                // Всего бинов выше порога
+            uint offset,
+            uint stride,
+            uint num_bins,
+            uint max_entries,
+            __local uint* scan                   // local_size
+        ) {
+            uint bin = get_global_id(0);
+            uint beam = get_global_id(1);
+            uint lid = get_local_id(0);
+            uint lsize = get_local_size(0);
+            
+            __local uint group_base;
+            
+            float2 v = (float2)(0.0f, 0.0f);
+            float mag = 0.0f;
+            uint flag = 0u;
+            if (bin < num_bins) {
+                v = spectrum[offset + (size_t)beam * stride + bin];
+                mag = length(v);
+                flag = (mag > thresholds[beam]) ? 1u : 0u;
+            }
+            
+            scan[lid] = flag;
+            barrier(CLK_LOCAL_MEM_FENCE);
+            for (uint step = 1u; step < lsize; step <<= 1) {
+                uint add = (lid >= step) ? scan[lid - step] : 0u;
+                barrier(CLK_LOCAL_MEM_FENCE);
+                scan[lid] += add;
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
+            
+            const uint group_total = scan[lsize - 1u];
+            if (lid == 0u) {
+                group_base = (group_total > 0u) ? atomic_add(count, group_total) : 0u;
+            }
+            barrier(CLK_LOCAL_MEM_FENCE);
+            
+            if (flag) {
+                uint slot = group_base + scan[lid] - 1u;
+                if (slot < max_entries) {
+                    SparseEntry e;
+                    e.beam = beam;
+                    e.bin = bin;
+                    e.real = v.x;
+                    e.imag = v.y;
+                    e.magnitude = mag;
+                    entries[slot] = e;
+                }
+            }
+        }
+    )CL";
+    
+    cl_int err;
+    const char* sources[] = {kernel_source};
+    size_t lengths[] = {strlen(kernel_source)};
+    
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create sparse program: " + std::to_string(err));
+    }
+    
+    err = clBuildProgram(program, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Sparse kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build sparse program");
+    }
+    
+    sparse_kernel_ = clCreateKernel(program, "sparse_compact", &err);
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create sparse kernel: " + std::to_string(err));
+    }
+}
+
+SparseSpectrumResult AntennaFFTProcMax::ExtractSparseSpectrum(const SparseSpectrumParams& sparse) {
+    if (!post_callback_userdata_) {
+        throw std::runtime_error("ExtractSparseSpectrum: no spectrum window (call ProcessNew first)");
+    }
+    // Layout userdata: params (4 × uint = 2 × float2) | complex_buffer | magnitude_buffer
+    const size_t window_offset = sizeof(cl_uint) * 4 / sizeof(cl_float2);
+    return ExtractSparseSpectrum(post_callback_userdata_, params_.out_count_points_fft, sparse, nullptr,
+                                 window_offset);
+}
+
+SparseSpectrumResult AntennaFFTProcMax::ExtractSparseSpectrum(cl_mem spectrum, size_t spectrum_stride,
+                                                              const SparseSpectrumParams& sparse,
+                                                              cl_event wait_event) {
+    return ExtractSparseSpectrum(spectrum, spectrum_stride, sparse, wait_event, 0);
+}
+
+SparseSpectrumResult AntennaFFTProcMax::ExtractSparseSpectrum(cl_mem spectrum, size_t spectrum_stride,
+                                                              const SparseSpectrumParams& sparse,
+                                                              cl_event wait_event, size_t spectrum_offset) {
+    if (!spectrum) {
+        throw std::invalid_argument("ExtractSparseSpectrum: spectrum is null");
+    }
+    if (spectrum_stride == 0) {
+        throw std::invalid_argument("ExtractSparseSpectrum: spectrum_stride must be > 0");
+    }
+    if (!sparse.IsValid(params_.beam_count)) {
+        throw std::invalid_argument("SparseSpectrumParams: invalid parameters");
+    }
+    
+    if (!sparse_kernel_) {
+        CreateSparseKernel();
+    }
+    
+    const size_t num_bins = std::min(params_.out_count_points_fft, spectrum_stride);
+    const size_t entry_elements =
+        (sparse.max_entries * sizeof(SparseEntryGPU) + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
+    
+    if (!buffer_sparse_thresholds_) {
+        buffer_sparse_thresholds_ = CreateBuffer((params_.beam_count + 1) / 2, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    }
+    if (!buffer_sparse_entries_ || buffer_sparse_entries_->GetNumElements() < entry_elements) {
+        buffer_sparse_entries_ = CreateBuffer(entry_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_sparse_count_) {
+        buffer_sparse_count_ = CreateBuffer(1, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Пороги лучей + обнуление счётчика
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    std::vector<float> thresholds = sparse.beam_thresholds;
+    if (thresholds.empty()) {
+        thresholds.assign(params_.beam_count, sparse.threshold);
+    }
+    
+    cl_mem thresholds_mem = buffer_sparse_thresholds_->Get();
+    cl_mem entries_mem = buffer_sparse_entries_->Get();
+    cl_mem count_mem = buffer_sparse_count_->Get();
+    
+    cl_int err = clEnqueueWriteBuffer(queue_, thresholds_mem, CL_FALSE, 0, thresholds.size() * sizeof(float),
+                                      thresholds.data(), 0, nullptr, nullptr);
+    cl_uint zero = 0;
+    err |= clEnqueueFillBuffer(queue_, count_mem, &zero, sizeof(zero), 0, sizeof(cl_uint), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to prepare sparse buffers: " + std::to_string(err));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Уплотнение
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    size_t local_size = 256;
+    size_t kernel_wg = 0;
+    if (clGetKernelWorkGroupInfo(sparse_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(kernel_wg), &kernel_wg, nullptr) == CL_SUCCESS && kernel_wg > 0) {
+        while (local_size > kernel_wg) local_size >>= 1;
+    }
+    
+    cl_uint offset_arg = static_cast<cl_uint>(spectrum_offset);
+    cl_uint stride_arg = static_cast<cl_uint>(spectrum_stride);
+    cl_uint bins_arg = static_cast<cl_uint>(num_bins);
+    cl_uint max_entries = static_cast<cl_uint>(sparse.max_entries);
+    
+    err = clSetKernelArg(sparse_kernel_, 0, sizeof(cl_mem), &spectrum);
+    err |= clSetKernelArg(sparse_kernel_, 1, sizeof(cl_mem), &thresholds_mem);
+    err |= clSetKernelArg(sparse_kernel_, 2, sizeof(cl_mem), &entries_mem);
+    err |= clSetKernelArg(sparse_kernel_, 3, sizeof(cl_mem), &count_mem);
+    err |= clSetKernelArg(sparse_kernel_, 4, sizeof(cl_uint), &offset_arg);
+    err |= clSetKernelArg(sparse_kernel_, 5, sizeof(cl_uint), &stride_arg);
+    err |= clSetKernelArg(sparse_kernel_, 6, sizeof(cl_uint), &bins_arg);
+    err |= clSetKernelArg(sparse_kernel_, 7, sizeof(cl_uint), &max_entries);
+    err |= clSetKernelArg(sparse_kernel_, 8, local_size * sizeof(cl_uint), nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set sparse kernel args: " + std::to_string(err));
+    }
+    
+    size_t global_size[2] = {((num_bins + local_size - 1) / local_size) * local_size, params_.beam_count};
+    size_t local[2] = {local_size, 1};
+    cl_event event_sparse = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, sparse_kernel_, 2, nullptr, global_size, local,
+                                 wait_event ? 1 : 0, wait_event ? &wait_event : nullptr, &event_sparse);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (sparse) failed: " + std::to_string(err));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Счётчик → только занятые записи
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_uint total = 0;
+    err = clEnqueueReadBuffer(queue_, count_mem, CL_TRUE, 0, sizeof(cl_uint), &total, 1, &event_sparse, nullptr);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_sparse);
+        throw std::runtime_error("clEnqueueReadBuffer (sparse count) failed: " + std::to_string(err));
+    }
+    
+    SparseSpectrumResult result;
+    result.total_count = total;
+    result.num_bins = num_bins;
+    result.kernel_time_ms = ProfileEvent(event_sparse, "Sparse compaction");
+    clReleaseEvent(event_sparse);
+    
+    const size_t stored = std::min<size_t>(total, sparse.max_entries);
+    std::vector<SparseEntryGPU> raw(stored);
+    if (stored > 0) {
+        err = clEnqueueReadBuffer(queue_, entries_mem, CL_TRUE, 0, stored * sizeof(SparseEntryGPU),
+                                  raw.data(), 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("clEnqueueReadBuffer (sparse entries) failed: " + std::to_string(err));
+        }
+    }
+    
+    // Порядок между группами зависит от atomic_add — сортируем по (луч, бин)
+    std::sort(raw.begin(), raw.end(), [](const SparseEntryGPU& a, const SparseEntryGPU& b) {
+        return a.beam != b.beam ? a.beam < b.beam : a.bin < b.bin;
+    });
+    
+    result.entries.reserve(stored);
+    for (const auto& r : raw) {
+        SparseSpectrumEntry e;
+        e.beam = r.beam;
+        e.bin = r.bin;
+        e.real = r.real;
+        e.imag = r.imag;
+        e.magnitude = r.magnitude;
+        result.entries.push_back(e);
+    }
+    return result;
+}
+
+SparseSpectrumResult AntennaFFTProcMax::ProcessSparse(const std::vector<std::complex<float>>& input_data,
+                                                      const SparseSpectrumParams& sparse) {
+    RequireDefaultLayout("ProcessSparse");
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
+    
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return ProcessSparse(buffer->Get(), sparse);
+}
+
+SparseSpectrumResult AntennaFFTProcMax::ProcessSparse(cl_mem input_signal, const SparseSpectrumParams& sparse) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessSparse: input_signal is null");
+    }
+    
+    CreateDirectInputPlan();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
+    
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_fft_output_) {
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem fft_input = buffer_fft_input_->Get();
+    cl_mem fft_output = buffer_fft_output_->Get();
+    
+    cl_event event_padding = nullptr;
+    cl_int err = EnqueueInputPadding(queue_, input_signal, fft_input, params_.beam_count, 0,
+                                     0, nullptr, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding) failed: " + std::to_string(err));
+    }
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        direct_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_fft,
+        &fft_input, &fft_output, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (sparse) failed: " + std::to_string(status));
+    }
+    
+    SparseSpectrumResult result;
+    try {
+        result = ExtractSparseSpectrum(fft_output, nFFT_, sparse, event_fft);
+    } catch (...) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw;
+    }
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT");
+    last_profiling_.post_callback_time_ms = result.kernel_time_ms;
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// ВЕЩЕСТВЕННЫЙ ВХОД (R2C FFT)
+// ════════════════════════════════════════════════════════════════════════════
+
+void AntennaFFTProcMax::CreateRealInputResources() {
+    if (real_plan_handle_ != 0) {
+        return;
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // R2C план: [beam: nFFT float] → [beam: nFFT/2 + 1 float2]
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    size_t clLengths[1] = {nFFT_};
+    clfftStatus status = clfftCreateDefaultPlan(&real_plan_handle_, context_, CLFFT_1D, clLengths);
+    if (status != CLFFT_SUCCESS) {
+        real_plan_handle_ = 0;
+        throw std::runtime_error("clfftCreateDefaultPlan (R2C) failed with status: " + std::to_string(status));
+    }
+    
+    clfftSetPlanPrecision(real_plan_handle_, CLFFT_SINGLE);
+    clfftSetLayout(real_plan_handle_, CLFFT_REAL, CLFFT_HERMITIAN_INTERLEAVED);
+    clfftSetResultLocation(real_plan_handle_, CLFFT_OUTOFPLACE);
+    clfftSetPlanBatchSize(real_plan_handle_, params_.beam_count);
+    
+    size_t strides[1] = {1};
+    clfftSetPlanInStride(real_plan_handle_, CLFFT_1D, strides);
+    clfftSetPlanOutStride(real_plan_handle_, CLFFT_1D, strides);
+    clfftSetPlanDistance(real_plan_handle_, nFFT_, nFFT_ / 2 + 1);
+    
+    status = clfftBakePlan(real_plan_handle_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clfftDestroyPlan(&real_plan_handle_);
+        real_plan_handle_ = 0;
+        throw std::runtime_error("clfftBakePlan (R2C) failed: " + std::to_string(status));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // Ядра: padding вещественного входа, окно из половины спектра
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    const char* kernel_source = R"CL(
+        __kernel void real_padding(
+            __global const float* input,        // beam_count * count_points
+            __global float* output,             // beam_count * nFFT
+            uint beam_count,
+            uint count_points,
+            uint nFFT
+        ) {
+            uint gid = get_global_id(0);
+            if (gid >= beam_count * nFFT) return;
+            
+            uint beam = gid / nFFT;
+            uint pos = gid % nFFT;
+            output[gid] = (pos < count_points) ? input[beam * count_points + pos] : 0.0f;
+        }
+        
+        // Окно out_count бинов: позиция i ↔ бин (i - origin) mod nFFT
+        // Бины выше nFFT/2 — сопряжённое зеркало: X[nFFT - k] = conj(X[k])
+        __kernel void hermitian_window(
+            __global const float2* half_spectrum,  // beam_count * (nFFT/2 + 1)
+            __global float2* window,               // beam_count * out_count
+            uint beam_count,
+            uint nFFT,
+            uint out_count,
+            uint origin
+        ) {
+            uint gid = get_global_id(0);
+            if (gid >= beam_count * out_count) return;
+            
+            uint beam = gid / out_count;
+            uint i = gid % out_count;
+            uint half_len = nFFT / 2 + 1;
+            uint k = (i + nFFT - (origin % nFFT)) % nFFT;
+            
+            float2 v;
+            if (k < half_len) {
+                v = half_spectrum[beam * half_len + k];
+            } else {
+                v = half_spectrum[beam * half_len + (nFFT - k)];
+                v.y = -v.y;
+            }
+            window[gid] = v;
+        }
+    )CL";
+    
+    cl_int err;
+    const char* sources[] = {kernel_source};
+    size_t lengths[] = {strlen(kernel_source)};
+    
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create R2C program: " + std::to_string(err));
+    }
+    
+    err = clBuildProgram(program, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "R2C kernels build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build R2C program");
+    }
+    
+    real_padding_kernel_ = clCreateKernel(program, "real_padding", &err);
+    if (err == CL_SUCCESS) {
+        hermitian_window_kernel_ = clCreateKernel(program, "hermitian_window", &err);
+    }
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create R2C kernels: " + std::to_string(err));
+    }
+}
+
+AntennaFFTResult AntennaFFTProcMax::ProcessReal(const std::vector<float>& input_data, bool fftshift_window) {
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
+    
+    // Буферы считаются в complex<float>: два float на элемент
+    auto buffer = CreateBuffer((expected_size + 1) / 2, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(float),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return ProcessReal(buffer->Get(), fftshift_window);
+}
+
+AntennaFFTResult AntennaFFTProcMax::ProcessReal(cl_mem input_signal, bool fftshift_window) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessReal: input_signal is null");
+    }
+    
+    CreateRealInputResources();
+    
+    const size_t half_len = nFFT_ / 2 + 1;
+    const size_t out_count = params_.out_count_points_fft;
+    if (!buffer_real_input_) {
+        buffer_real_input_ = CreateBuffer(params_.beam_count * nFFT_ / 2, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_real_spectrum_) {
+        buffer_real_spectrum_ = CreateBuffer(params_.beam_count * half_len, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_real_window_) {
+        buffer_real_window_ = CreateBuffer(params_.beam_count * out_count, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem real_input = buffer_real_input_->Get();
+    cl_mem real_spectrum = buffer_real_spectrum_->Get();
+    cl_mem real_window = buffer_real_window_->Get();
+    cl_uint beam_count = static_cast<cl_uint>(params_.beam_count);
+    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
+    cl_uint nfft = static_cast<cl_uint>(nFFT_);
+    cl_uint out_count_arg = static_cast<cl_uint>(out_count);
+    cl_uint origin = static_cast<cl_uint>(fftshift_window ? out_count / 2 : 0);
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 1: padding (float)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_int err = clSetKernelArg(real_padding_kernel_, 0, sizeof(cl_mem), &input_signal);
+    err |= clSetKernelArg(real_padding_kernel_, 1, sizeof(cl_mem), &real_input);
+    err |= clSetKernelArg(real_padding_kernel_, 2, sizeof(cl_uint), &beam_count);
+    err |= clSetKernelArg(real_padding_kernel_, 3, sizeof(cl_uint), &count_points);
+    err |= clSetKernelArg(real_padding_kernel_, 4, sizeof(cl_uint), &nfft);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set real padding kernel args: " + std::to_string(err));
+    }
+    
+    size_t local_size = 256;
+    size_t padding_global = ((params_.beam_count * nFFT_ + local_size - 1) / local_size) * local_size;
+    cl_event event_padding = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, real_padding_kernel_, 1, nullptr, &padding_global, &local_size,
+                                 0, nullptr, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (real padding) failed: " + std::to_string(err));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 2: R2C FFT → половина спектра
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        real_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_fft,
+        &real_input, &real_spectrum, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (R2C) failed: " + std::to_string(status));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 3: окно out_count_points_fft из половины спектра → post_kernel
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    err = clSetKernelArg(hermitian_window_kernel_, 0, sizeof(cl_mem), &real_spectrum);
+    err |= clSetKernelArg(hermitian_window_kernel_, 1, sizeof(cl_mem), &real_window);
+    err |= clSetKernelArg(hermitian_window_kernel_, 2, sizeof(cl_uint), &beam_count);
+    err |= clSetKernelArg(hermitian_window_kernel_, 3, sizeof(cl_uint), &nfft);
+    err |= clSetKernelArg(hermitian_window_kernel_, 4, sizeof(cl_uint), &out_count_arg);
+    err |= clSetKernelArg(hermitian_window_kernel_, 5, sizeof(cl_uint), &origin);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("Failed to set hermitian window kernel args: " + std::to_string(err));
+    }
+    
+    size_t window_global = ((params_.beam_count * out_count + local_size - 1) / local_size) * local_size;
+    cl_event event_window = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, hermitian_window_kernel_, 1, nullptr, &window_global, &local_size,
+                                 1, &event_fft, &event_window);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (hermitian window) failed: " + std::to_string(err));
+    }
+    
+    // Строки окна подряд: stride = out_count_points_fft
+    cl_event event_post = nullptr;
+    err = EnqueuePostKernel(real_window, event_window, &event_post, out_count);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        clReleaseEvent(event_window);
+        throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+    }
+    clWaitForEvents(1, &event_post);
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding (real)");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT (R2C)");
+    last_profiling_.post_callback_time_ms =
+        ProfileEvent(event_window, "Hermitian window") + ProfileEvent(event_post, "Post (mag+max+phase)");
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_window);
+    clReleaseEvent(event_post);
+    
+    // post_kernel считает частоту от шага строки окна — пересчёт по nFFT и началу окна
+    AntennaFFTResult result = ReadMaximaResult();
+    const float bin_width = 12.0e6f / static_cast<float>(nFFT_);
+    for (auto& beam : result.results) {
+        if (!beam.max_values.empty()) {
+            float bin = static_cast<float>(beam.max_values[0].index_point) - static_cast<float>(origin) +
+                        beam.freq_offset;
+            beam.refined_frequency = bin * bin_width;
+        }
+    }
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// НЕКОГЕРЕНТНОЕ НАКОПЛЕНИЕ ПО КАДРАМ
+// ════════════════════════════════════════════════════════════════════════════
+
+void AntennaFFTProcMax::SetIntegration(const IntegrationParams& integration) {
+    if (!integration.IsValid()) {
+        throw std::invalid_argument("SetIntegration: frames must be > 0, alpha in (0, 1]");
+    }
+    integration_params_ = integration;
+    ResetIntegration();
+}
+
+void AntennaFFTProcMax::ResetIntegration() {
+    integration_count_ = 0;
+    integration_primed_ = false;
+}
+
+void AntennaFFTProcMax::CreateIntegrationKernel() {
+    const char* kernel_source = R"CL(
+        // Один work-item — один бин окна [0, out_count) луча.
+        // first: накопитель ещё пуст (acc = v); emit: записать окно для post_kernel
+        // с амплитудой acc * norm (sqrt для мощности) и фазой текущего кадра.
+        __kernel void integrate_frame(
+            __global const float2* spectrum,     // beam_count × stride
+            __global float* accumulator,         // beam_count × out_count
+            __global float2* window,             // beam_count × out_count (только emit)
+            uint beam_count,
+            uint stride,
+            uint out_count,
+            uint use_power,
+            uint exponential,
+            float alpha,
+            uint first,
+            uint emit,
+            float norm
+        ) {
+            uint gid = get_global_id(0);
+            if (gid >= beam_count * out_count) return;
+            
+            uint beam = gid / out_count;
+            uint bin = gid % out_count;
+            float2 x = spectrum[beam * stride + bin];
+            float mag2 = x.x * x.x + x.y * x.y;
+            float v = use_power ? mag2 : sqrt(mag2);
+            
+            float acc;
+            if (first) {
+                acc = v;
+            } else if (exponential) {
+                acc = mad(alpha, v - accumulator[gid], accumulator[gid]);
+            } else {
+                acc = accumulator[gid] + v;
+            }
+            accumulator[gid] = acc;
+            
+            if (emit) {
+                float amp = acc * norm;
+                if (use_power) amp = sqrt(amp);
+                float len = sqrt(mag2);
+                window[gid] = len > 0.0f ? x * (amp / len) : (float2)(amp, 0.0f);
+            }
+        }
+    )CL";
+    
+    cl_int err;
+    const char* sources[] = {kernel_source};
+    size_t lengths[] = {strlen(kernel_source)};
+    
+    cl_program program = clCreateProgramWithSource(context_, 1, sources, lengths, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create integration program: " + std::to_string(err));
+    }
+    
+    err = clBuildProgram(program, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size;
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::vector<char> log(log_size);
+        clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG, log_size, log.data(), nullptr);
+        std::cerr << "Integration kernel build error:\n" << log.data() << "\n";
+        clReleaseProgram(program);
+        throw std::runtime_error("Failed to build integration program");
+    }
+    
+    integration_kernel_ = clCreateKernel(program, "integrate_frame", &err);
+    clReleaseProgram(program);
+    
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create integration kernel: " + std::to_string(err));
+    }
+}
+
+IntegrationResult AntennaFFTProcMax::ProcessIntegrated(const std::vector<std::complex<float>>& input_data) {
+    RequireDefaultLayout("ProcessIntegrated");
+    size_t expected_size = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected_size) {
+        throw std::invalid_argument("Input data size mismatch. Expected: " +
+                                   std::to_string(expected_size) +
+                                   ", got: " + std::to_string(input_data.size()));
+    }
+    
+    auto buffer = CreateBuffer(expected_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer->Get(), CL_TRUE, 0,
+                                      expected_size * sizeof(std::complex<float>),
+                                      input_data.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (input) failed: " + std::to_string(err));
+    }
+    return ProcessIntegrated(buffer->Get());
+}
+
+IntegrationResult AntennaFFTProcMax::ProcessIntegrated(cl_mem input_signal) {
+    if (!input_signal) {
+        throw std::invalid_argument("ProcessIntegrated: input_signal is null");
+    }
+    
+    CreateDirectInputPlan();
+    if (!padding_kernel_) {
+        CreatePaddingKernel();
+    }
+    if (!integration_kernel_) {
+        CreateIntegrationKernel();
+    }
+    
+    const size_t out_count = params_.out_count_points_fft;
+    size_t total_fft_size = params_.beam_count * nFFT_;
+    if (!buffer_fft_input_) {
+        buffer_fft_input_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_fft_output_) {
+        buffer_fft_output_ = CreateBuffer(total_fft_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    if (!buffer_integration_acc_) {
+        // float накопитель в элементах complex<float>
+        size_t acc_elements = (params_.beam_count * out_count + 1) / 2;
+        buffer_integration_acc_ = CreateBuffer(acc_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        integration_primed_ = false;
+    }
+    if (!buffer_integration_window_) {
+        buffer_integration_window_ = CreateBuffer(params_.beam_count * out_count, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    
+    cl_mem fft_input = buffer_fft_input_->Get();
+    cl_mem fft_output = buffer_fft_output_->Get();
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 1: padding → FFT
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_event event_padding = nullptr;
+    cl_int err = EnqueueInputPadding(queue_, input_signal, fft_input, params_.beam_count, 0,
+                                     0, nullptr, &event_padding);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (padding) failed: " + std::to_string(err));
+    }
+    
+    cl_event event_fft = nullptr;
+    clfftStatus status = clfftEnqueueTransform(
+        direct_plan_handle_, CLFFT_FORWARD, 1, &queue_,
+        1, &event_padding, &event_fft,
+        &fft_input, &fft_output, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_padding);
+        throw std::runtime_error("clfftEnqueueTransform (integration) failed: " + std::to_string(status));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 2: накопление (+ окно на кадре выдачи)
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    const bool exponential = integration_params_.mode == IntegrationMode::EXPONENTIAL;
+    const size_t frames_integrated = integration_count_ + 1;
+    const bool emit = frames_integrated >= integration_params_.frames;
+    
+    cl_mem acc = buffer_integration_acc_->Get();
+    cl_mem window = buffer_integration_window_->Get();
+    cl_uint beam_count = static_cast<cl_uint>(params_.beam_count);
+    cl_uint stride = static_cast<cl_uint>(nFFT_);
+    cl_uint out_count_arg = static_cast<cl_uint>(out_count);
+    cl_uint use_power = integration_params_.use_power ? 1 : 0;
+    cl_uint exponential_arg = exponential ? 1 : 0;
+    float alpha = integration_params_.alpha;
+    cl_uint first = integration_primed_ ? 0 : 1;
+    cl_uint emit_arg = emit ? 1 : 0;
+    float norm = exponential ? 1.0f : 1.0f / static_cast<float>(frames_integrated);
+    
+    err = clSetKernelArg(integration_kernel_, 0, sizeof(cl_mem), &fft_output);
+    err |= clSetKernelArg(integration_kernel_, 1, sizeof(cl_mem), &acc);
+    err |= clSetKernelArg(integration_kernel_, 2, sizeof(cl_mem), &window);
+    err |= clSetKernelArg(integration_kernel_, 3, sizeof(cl_uint), &beam_count);
+    err |= clSetKernelArg(integration_kernel_, 4, sizeof(cl_uint), &stride);
+    err |= clSetKernelArg(integration_kernel_, 5, sizeof(cl_uint), &out_count_arg);
+    err |= clSetKernelArg(integration_kernel_, 6, sizeof(cl_uint), &use_power);
+    err |= clSetKernelArg(integration_kernel_, 7, sizeof(cl_uint), &exponential_arg);
+    err |= clSetKernelArg(integration_kernel_, 8, sizeof(float), &alpha);
+    err |= clSetKernelArg(integration_kernel_, 9, sizeof(cl_uint), &first);
+    err |= clSetKernelArg(integration_kernel_, 10, sizeof(cl_uint), &emit_arg);
+    err |= clSetKernelArg(integration_kernel_, 11, sizeof(float), &norm);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("Failed to set integration kernel args: " + std::to_string(err));
+    }
+    
+    size_t local_size = 256;
+    size_t global_size = ((params_.beam_count * out_count + local_size - 1) / local_size) * local_size;
+    cl_event event_integrate = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, integration_kernel_, 1, nullptr, &global_size, &local_size,
+                                 1, &event_fft, &event_integrate);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_padding);
+        clReleaseEvent(event_fft);
+        throw std::runtime_error("clEnqueueNDRangeKernel (integration) failed: " + std::to_string(err));
+    }
+    
+    integration_primed_ = true;
+    integration_count_ = frames_integrated;
+    
+    // ═══════════════════════════════════════════════════════════════════════════
+    // STEP 3: раз в frames кадров — post_kernel по окну и чтение top-N
+    // ═══════════════════════════════════════════════════════════════════════════
+    
+    cl_event event_post = nullptr;
+    if (emit) {
+        err = EnqueuePostKernel(window, event_integrate, &event_post, out_count);
+        if (err != CL_SUCCESS) {
+            clReleaseEvent(event_padding);
+            clReleaseEvent(event_fft);
+            clReleaseEvent(event_integrate);
+            throw std::runtime_error("clEnqueueNDRangeKernel (post) failed: " + std::to_string(err));
+        }
+        clWaitForEvents(1, &event_post);
+    } else {
+        clWaitForEvents(1, &event_integrate);
+    }
+    
+    IntegrationResult result;
+    result.ready = emit;
+    result.frames_integrated = frames_integrated;
+    
+    last_profiling_.upload_time_ms = 0.0;
+    last_profiling_.pre_callback_time_ms = ProfileEvent(event_padding, "Padding");
+    last_profiling_.fft_time_ms = ProfileEvent(event_fft, "FFT");
+    result.kernel_time_ms = ProfileEvent(event_integrate, "Integrate");
+    if (event_post) {
+        result.kernel_time_ms += ProfileEvent(event_post, "Post (mag+max+phase)");
+    }
+    last_profiling_.post_callback_time_ms = result.kernel_time_ms;
+    last_profiling_.reduction_time_ms = 0.0;
+    last_profiling_.total_time_ms =
+        last_profiling_.pre_callback_time_ms +
+        last_profiling_.fft_time_ms +
+        last_profiling_.post_callback_time_ms;
+    
+    clReleaseEvent(event_padding);
+    clReleaseEvent(event_fft);
+    clReleaseEvent(event_integrate);
+    if (event_post) {
+        clReleaseEvent(event_post);
+    }
+    
+    if (!emit) {
+        return result;
+    }
+    
+    // Среднее начинается заново; EMA продолжает накапливать
+    integration_count_ = 0;
+    if (!exponential) {
+        integration_primed_ = false;
+    }
+    
+    // post_kernel считает частоту от шага строки окна — пересчёт по nFFT
+    result.maxima = ReadMaximaResult();
+    const float bin_width = 12.0e6f / static_cast<float>(nFFT_);
+    for (auto& beam : result.maxima.results) {
+        if (!beam.max_values.empty()) {
+            beam.refined_frequency =
+                (static_cast<float>(beam.max_values[0].index_point) + beam.freq_offset) * bin_width;
+        }
+    }
+    return result;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// ПАРАЛЛЕЛЬНАЯ ОБРАБОТКА БАТЧЕЙ (ProcessWithBatchingNew)
+// ════════════════════════════════════════════════════════════════════════════
+
+void AntennaFFTProcMax::InitializeParallelResources(size_t max_beams_per_stream, size_t num_streams) {
+    // Освободить старые ресурсы
+    ReleaseParallelResources();
+    
+    // Если num_streams == 0, использовать значение из config
+    if (num_streams == 0) {
+        num_streams = batch_config_.num_parallel_streams;
+    }
+    
+    num_parallel_streams_ = num_streams;
+    parallel_resources_.resize(num_parallel_streams_);
+    
+    auto t_start = std::chrono::high_resolution_clock::now();
+    
+    size_t fft_buf_size = max_beams_per_stream * nFFT_;
+    // Размер буфера для MaxValue результатов (новый unified kernel)
+    // MaxValue: { uint index, real, imag, magnitude, phase, freq_offset, refined_frequency, pad } = 32 bytes
+    size_t maxima_buf_elements = max_beams_per_stream * params_.max_peaks_count;
+    // Выравниваем на размер complex (8 bytes) для создания буфера
+    size_t maxima_complex_elements = (maxima_buf_elements * 32 + 7) / 8;
+    
+    for (size_t i = 0; i < num_parallel_streams_; ++i) {
+        auto& res = parallel_resources_[i];
+        
+        // Создать буферы для этого потока
+        res.fft_input = CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        if (!batch_config_.inplace_fft) {
+            res.fft_output = CreateBuffer(fft_buf_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        }
+        res.maxima = CreateBuffer(maxima_complex_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        
+        // Получить command queue для этого потока
+        res.queue = ManagerOpenCL::CommandQueuePool::GetQueue(i % ManagerOpenCL::CommandQueuePool::GetPoolSize());
+        
+        // Создать FFT план для этого потока
+        size_t clLengths[1] = {nFFT_};
+        clfftStatus status = clfftCreateDefaultPlan(&res.plan_handle, context_, CLFFT_1D, clLengths);
+        if (status != CLFFT_SUCCESS) {
+            throw std::runtime_error("InitializeParallelResources: clfftCreateDefaultPlan failed");
+        }
+        
+        clfftSetPlanPrecision(res.plan_handle, CLFFT_SINGLE);
+        clfftSetLayout(res.plan_handle, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
+        clfftSetResultLocation(res.plan_handle, batch_config_.inplace_fft ? CLFFT_INPLACE : CLFFT_OUTOFPLACE);
+        clfftSetPlanBatchSize(res.plan_handle, max_beams_per_stream);
+        
+        size_t strides[1] = {1};
+        clfftSetPlanInStride(res.plan_handle, CLFFT_1D, strides);
+        clfftSetPlanOutStride(res.plan_handle, CLFFT_1D, strides);
+        clfftSetPlanDistance(res.plan_handle, nFFT_, nFFT_);
+        
+        status = clfftBakePlan(res.plan_handle, 1, &res.queue, nullptr, nullptr);
+        if (status != CLFFT_SUCCESS) {
+            clfftDestroyPlan(&res.plan_handle);
+            res.plan_handle = 0;
+            throw std::runtime_error("InitializeParallelResources: clfftBakePlan failed");
+        }
+        
+        res.initialized = true;
+    }
+    
+    parallel_buffers_size_ = max_beams_per_stream;
+    
+    auto t_end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
+    printf("  ⏱️  Created %zu parallel streams (max %zu beams each): %.2f ms\n\n", 
+           num_parallel_streams_, max_beams_per_stream, ms);
+}
+
+void AntennaFFTProcMax::ReleaseParallelResources() {
+    for (auto& res : parallel_resources_) {
+        if (res.plan_handle) {
+            clfftDestroyPlan(&res.plan_handle);
+            res.plan_handle = 0;
+        }
+        res.fft_input.reset();
+        res.fft_output.reset();
+        res.maxima.reset();
+        res.sel_complex.reset();
+        res.sel_magnitude.reset();
+        res.queue = nullptr;
+        res.initialized = false;
+    }
+    parallel_resources_.clear();
+    parallel_buffers_size_ = 0;
+}
+
+// Запуск батча БЕЗ ожидания (асинхронно на GPU)
+// ИСПОЛЬЗУЕМ kernel'ы по индексу потока для thread-safety!
+// ВАЖНО: FFT план требует ТОЧНЫЙ batch size = parallel_buffers_size_!
+std::vector<FFTResult> AntennaFFTProcMax::ProcessBatchParallelNoWait(
+    cl_mem input_signal,
+    size_t start_beam,
+    size_t num_beams,
+    size_t stream_idx,
+    cl_event* completion_event) {
+    
+    auto& res = parallel_resources_[stream_idx];
+    cl_int err;
+    
+    // FFT ПЛАН ТРЕБУЕТ ТОЧНЫЙ BATCH SIZE!
+    // Обрабатываем num_beams, но FFT работает с parallel_buffers_size_
+    size_t fft_batch_size = parallel_buffers_size_;  // Размер плана
+    
+    cl_mem fft_in = res.fft_input->Get();
+    cl_mem fft_out = res.fft_output ? res.fft_output->Get() : fft_in;  // Нет output → in-place
+    cl_mem maxima_out = res.maxima->Get();
+    
+    // ИСПОЛЬЗУЕМ KERNEL ПО ИНДЕКСУ ПОТОКА!
+    cl_kernel pad_kernel = padding_kernels_[stream_idx];
+    cl_kernel pst_kernel = post_kernels_[stream_idx];
+    
+    // STEP 1: Padding kernel (обрабатывает num_beams, но пишет в буфер для fft_batch_size)
+    cl_uint batch_beam_count = static_cast<cl_uint>(num_beams);
+    cl_uint count_points = static_cast<cl_uint>(params_.count_points);
+    cl_uint nfft = static_cast<cl_uint>(nFFT_);
+    cl_uint beam_offset = static_cast<cl_uint>(start_beam);
+    
+    err = clSetKernelArg(pad_kernel, 0, sizeof(cl_mem), &input_signal);
+    err |= clSetKernelArg(pad_kernel, 1, sizeof(cl_mem), &fft_in);
+    err |= clSetKernelArg(pad_kernel, 2, sizeof(cl_uint), &batch_beam_count);
+    err |= clSetKernelArg(pad_kernel, 3, sizeof(cl_uint), &count_points);
+    err |= clSetKernelArg(pad_kernel, 4, sizeof(cl_uint), &nfft);
+    err |= clSetKernelArg(pad_kernel, 5, sizeof(cl_uint), &beam_offset);
+    
+    if (err != CL_SUCCESS) {
+        std::cerr << "  ❌ ProcessBatchParallelNoWait: set padding kernel args failed: " << err << "\n";
+        if (completion_event) *completion_event = nullptr;
+        return {};
+    }
+    
+    cl_event event_fill = nullptr;
+    cl_event event_padding = nullptr;
+    
+    // Сначала обнулим весь буфер (если num_beams < fft_batch_size)
+    // ВАЖНО: используем событие чтобы padding kernel ждал завершения!
+    if (num_beams < fft_batch_size) {
+        std::complex<float> zero(0.0f, 0.0f);
+        err = clEnqueueFillBuffer(res.queue, fft_in, &zero, sizeof(zero), 
+                                  0, fft_batch_size * nFFT_ * sizeof(std::complex<float>),
+                                  0, nullptr, &event_fill);
+        if (err != CL_SUCCESS) {
+            std::cerr << "  ❌ ProcessBatchParallelNoWait: FillBuffer failed: " << err << "\n";
+            if (completion_event) *completion_event = nullptr;
+            return {};
+        }
+    }
+    
+    // Заполняем только num_beams реальными данными
+    // Padding kernel зависит от FillBuffer (если был)
+    size_t real_padding_size = num_beams * nFFT_;
+    cl_uint num_wait_events = event_fill ? 1 : 0;
+    cl_event* wait_list = event_fill ? &event_fill : nullptr;
+    
+    if (!input_layout_.IsDefault(params_.beam_count, params_.count_points)) {
+        // Нестандартная раскладка: транспонирующий padding (общий kernel, enqueue последовательный)
+        err = EnqueueInputPadding(res.queue, input_signal, fft_in, num_beams, start_beam,
+                                  num_wait_events, wait_list, &event_padding);
+    } else {
+        // Копии padding_kernel на потоках: берём уже подобранную конфигурацию (подбор — в ProcessBatch)
+        size_t* padding_local = nullptr;
+        size_t padding_local_size = padding_wg_.local_size;
+        if (padding_wg_.IsValid()) {
+            size_t work_items = (real_padding_size + padding_wg_.items_per_work_item - 1) /
+                                padding_wg_.items_per_work_item;
+            real_padding_size = ((work_items + padding_local_size - 1) / padding_local_size) * padding_local_size;
+            padding_local = &padding_local_size;
+        }
+        
+        err = clEnqueueNDRangeKernel(res.queue, pad_kernel, 1, nullptr, 
+                                     &real_padding_size, padding_local, 
+                                     num_wait_events, wait_list, &event_padding);
+    }
     
     // Освобождаем event_fill после enqueue (FFT уже "запомнил" зависимость)
     if (event_fill) {
@@ -2916,7 +5268,7 @@ std::vector<FFTResult> AntennaFFTProcMax::ProcessBatchParallelNoWait(
         1, &event_padding,
         &event_fft,
         &fft_in,
-        &fft_out,
+        res.fft_output ? &fft_out : nullptr,
         nullptr
     );
     
@@ -3081,14 +5433,16 @@ AntennaFFTResult AntennaFFTProcMax::ProcessWithBatchingNew(cl_mem input_signal)
                             std::max(batch_size, params_.beam_count - (num_batches - 1) * batch_size);
     
     // Количество параллельных потоков
-    // ОГРАНИЧЕНИЕ: память GPU! Каждый поток требует ~2 × batch_size × nFFT × 8 bytes
-    size_t memory_per_stream = 2 * max_batch_beams * nFFT_ * sizeof(std::complex<float>);
+    // ОГРАНИЧЕНИЕ: память GPU! Каждый поток требует ~2 × batch_size × nFFT × 8 bytes (in-place: × 1)
+    size_t fft_buffer_count = batch_config_.inplace_fft ? 1 : 2;
+    size_t memory_per_stream = fft_buffer_count * max_batch_beams * nFFT_ * sizeof(std::complex<float>);
     size_t total_gpu_memory = ManagerOpenCL::OpenCLCore::GetInstance().GetGlobalMemorySize();
     size_t available_memory = static_cast<size_t>(total_gpu_memory * batch_config_.memory_usage_limit);
     
     // Уже занято: входные данные + batch буферы основного режима
     size_t used_memory = params_.beam_count * params_.count_points * sizeof(std::complex<float>);
-    if (batch_fft_input_) used_memory += batch_buffers_size_ * nFFT_ * sizeof(std::complex<float>) * 2;
+    if (batch_fft_input_) used_memory += batch_buffers_size_ * nFFT_ * sizeof(std::complex<float>);
+    if (batch_fft_output_) used_memory += batch_buffers_size_ * nFFT_ * sizeof(std::complex<float>);
     
     // Проверка на overflow
     size_t free_memory = (available_memory > used_memory) ? (available_memory - used_memory) : 0;
@@ -0,0 +1,377 @@
+#include "GPU/beamformer.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace antenna_fft {
+
+namespace {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ядро: Y[b][t] = Σ_m W[b][m] · X[m][t], тайл BF_BLOCK × BF_BLOCK на группу,
+// get_global_id(2) — номер блока в пакете
+// ════════════════════════════════════════════════════════════════════════════
+
+const char* kBeamformerKernelSource = R"CL(
+#ifndef BF_TILE
+#define BF_TILE 16
+#endif
+#define BF_RB 4
+#define BF_BLOCK (BF_TILE * BF_RB)
+
+__kernel void beamform_gemm(__global const float2* W, __global const float2* X, __global float2* Y,
+                            uint num_beams, uint num_elements, uint num_samples, uint y_stride) {
+    __local float2 Ws[BF_BLOCK][BF_TILE + 1];   // лучи × элементы
+    __local float2 Xs[BF_TILE][BF_BLOCK];       // элементы × отсчёты
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint t0 = get_group_id(0) * BF_BLOCK;
+    uint b0 = get_group_id(1) * BF_BLOCK;
+    size_t m = get_global_id(2);
+    __global const float2* x = X + m * num_elements * num_samples;
+    __global float2* y = Y + m * num_beams * y_stride;
+
+    float2 acc[BF_RB][BF_RB];
+    for (uint i = 0; i < BF_RB; ++i)
+        for (uint j = 0; j < BF_RB; ++j) acc[i][j] = (float2)(0.0f, 0.0f);
+
+    // Группы целиком в хвосте (padding) не читают X; условие одно на группу
+    uint k_end = t0 < num_samples ? num_elements : 0;
+    for (uint k0 = 0; k0 < k_end; k0 += BF_TILE) {
+        for (uint i = 0; i < BF_RB; ++i) {
+            uint b = b0 + ly + i * BF_TILE;
+            uint k = k0 + lx;
+            Ws[ly + i * BF_TILE][lx] = (b < num_beams && k < num_elements) ? W[(size_t)b * num_elements + k]
+                                                                            : (float2)(0.0f, 0.0f);
+        }
+        for (uint j = 0; j < BF_RB; ++j) {
+            uint k = k0 + ly;
+            uint t = t0 + lx + j * BF_TILE;
+            Xs[ly][lx + j * BF_TILE] = (k < num_elements && t < num_samples) ? x[(size_t)k * num_samples + t]
+                                                                              : (float2)(0.0f, 0.0f);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (uint kk = 0; kk < BF_TILE; ++kk) {
+            float2 w[BF_RB], v[BF_RB];
+            for (uint i = 0; i < BF_RB; ++i) w[i] = Ws[ly + i * BF_TILE][kk];
+            for (uint j = 0; j < BF_RB; ++j) v[j] = Xs[kk][lx + j * BF_TILE];
+            for (uint i = 0; i < BF_RB; ++i) {
+                for (uint j = 0; j < BF_RB; ++j) {
+                    acc[i][j].x = mad(w[i].x, v[j].x, mad(-w[i].y, v[j].y, acc[i][j].x));
+                    acc[i][j].y = mad(w[i].x, v[j].y, mad(w[i].y, v[j].x, acc[i][j].y));
+                }
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    for (uint i = 0; i < BF_RB; ++i) {
+        uint b = b0 + ly + i * BF_TILE;
+        if (b >= num_beams) continue;
+        for (uint j = 0; j < BF_RB; ++j) {
+            uint t = t0 + lx + j * BF_TILE;
+            if (t < y_stride) {
+                y[(size_t)b * y_stride + t] = t < num_samples ? acc[i][j] : (float2)(0.0f, 0.0f);
+            }
+        }
+    }
+}
+)CL";
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+Beamformer::Beamformer(const BeamformerParams& params)
+    : Beamformer(params, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+Beamformer::Beamformer(const BeamformerParams& params, const ManagerOpenCL::DeviceContext& device)
+    : Beamformer(params, &device) {
+}
+
+Beamformer::Beamformer(const BeamformerParams& params, const ManagerOpenCL::DeviceContext* device)
+    : params_(params) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("BeamformerParams: invalid parameters");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("Beamformer: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+
+    BuildKernel();
+}
+
+Beamformer::~Beamformer() {
+    if (gemm_kernel_) clReleaseKernel(gemm_kernel_);
+    if (program_) clReleaseProgram(program_);
+}
+
+void Beamformer::BuildKernel() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kBeamformerKernelSource;
+    size_t src_len = std::char_traits<char>::length(kBeamformerKernelSource);
+
+    size_t device_wg = 0;
+    clGetDeviceInfo(device_, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(device_wg), &device_wg, nullptr);
+
+    // Группа tile × tile: CPU устройства могут допускать меньше 256 потоков —
+    // тайл уменьшается вдвое, пока группа не поместится
+    for (tile_ = TILE; ; tile_ >>= 1) {
+        program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Failed to create beamformer program: " + std::to_string(err));
+        }
+
+        const std::string options = "-D BF_TILE=" + std::to_string(tile_);
+        err = clBuildProgram(program_, 1, &device_, options.c_str(), nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            size_t log_size = 0;
+            clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+            std::string log(log_size, '\0');
+            clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+            std::cerr << "Beamformer kernel build error:\n" << log << "\n";
+            throw std::runtime_error("Failed to build beamformer program: " + std::to_string(err));
+        }
+
+        gemm_kernel_ = clCreateKernel(program_, "beamform_gemm", &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Failed to create beamform_gemm kernel: " + std::to_string(err));
+        }
+
+        size_t limit = device_wg;
+        size_t kernel_wg = 0;
+        if (clGetKernelWorkGroupInfo(gemm_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(kernel_wg), &kernel_wg, nullptr) == CL_SUCCESS && kernel_wg > 0) {
+            limit = limit ? std::min(limit, kernel_wg) : kernel_wg;
+        }
+        if (limit == 0 || tile_ * tile_ <= limit) {
+            break;
+        }
+        if (tile_ == 1) {
+            throw std::runtime_error("Beamformer: device work-group limit " + std::to_string(limit) +
+                                     " is too small for beamform_gemm");
+        }
+        clReleaseKernel(gemm_kernel_);
+        clReleaseProgram(program_);
+        gemm_kernel_ = nullptr;
+        program_ = nullptr;
+    }
+}
+
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> Beamformer::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(context_, queue_, num_elements,
+                                                            ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Веса
+// ════════════════════════════════════════════════════════════════════════════
+
+std::vector<float> Beamformer::BeamAngles(const LFMParameters& lfm) {
+    if (lfm.num_beams == 0) {
+        throw std::invalid_argument("Beamformer: num_beams must be > 0");
+    }
+    std::vector<float> angles(lfm.num_beams);
+    if (lfm.angle_stop_deg != lfm.angle_start_deg) {
+        const float range = lfm.angle_stop_deg - lfm.angle_start_deg;
+        for (size_t b = 0; b < lfm.num_beams; ++b) {
+            angles[b] = lfm.num_beams == 1
+                ? lfm.angle_start_deg
+                : lfm.angle_start_deg + range * static_cast<float>(b) / static_cast<float>(lfm.num_beams - 1);
+        }
+    } else {
+        for (size_t b = 0; b < lfm.num_beams; ++b) {
+            angles[b] = lfm.angle_start_deg + lfm.angle_step_deg * static_cast<float>(b);
+        }
+    }
+    return angles;
+}
+
+std::vector<std::complex<float>> Beamformer::SteeringWeights(const std::vector<float>& angles_deg,
+                                                             size_t num_elements, float element_spacing) {
+    std::vector<std::complex<float>> weights(angles_deg.size() * num_elements);
+    const double scale = 1.0 / static_cast<double>(num_elements);
+    for (size_t b = 0; b < angles_deg.size(); ++b) {
+        const double u = std::sin(angles_deg[b] * M_PI / 180.0);
+        for (size_t m = 0; m < num_elements; ++m) {
+            const double phase = 2.0 * M_PI * element_spacing * static_cast<double>(m) * u;
+            weights[b * num_elements + m] = {static_cast<float>(scale * std::cos(phase)),
+                                             static_cast<float>(scale * std::sin(phase))};
+        }
+    }
+    return weights;
+}
+
+Beamformer::WeightSet Beamformer::UploadWeights(const std::vector<std::complex<float>>& weights,
+                                                size_t num_beams) {
+    // Ядро умножает на W как есть: строка — conj(w_b)
+    std::vector<std::complex<float>> rows(weights.size());
+    for (size_t i = 0; i < weights.size(); ++i) rows[i] = std::conj(weights[i]);
+
+    WeightSet set;
+    set.num_beams = num_beams;
+    set.buffer = CreateBuffer(rows.size());
+    set.buffer->WriteToGPU(rows);
+    return set;
+}
+
+void Beamformer::SetSteering(const LFMParameters& lfm) {
+    const SteeringKey key{lfm.num_beams, lfm.angle_start_deg, lfm.angle_stop_deg, lfm.angle_step_deg};
+    auto it = steering_cache_.find(key);
+    if (it == steering_cache_.end()) {
+        auto angles = BeamAngles(lfm);
+        WeightSet set = UploadWeights(SteeringWeights(angles, params_.num_elements, params_.element_spacing),
+                                      lfm.num_beams);
+        set.angles = std::move(angles);
+        it = steering_cache_.emplace(key, std::move(set)).first;
+    }
+    weights_ = it->second.buffer->Get();
+    num_beams_ = it->second.num_beams;
+    angles_ = it->second.angles;
+}
+
+void Beamformer::SetWeights(const std::vector<std::complex<float>>& weights, size_t num_beams) {
+    if (num_beams == 0 || weights.size() != num_beams * params_.num_elements) {
+        throw std::invalid_argument("Beamformer::SetWeights: expected " +
+                                    std::to_string(num_beams * params_.num_elements) + " elements, got " +
+                                    std::to_string(weights.size()));
+    }
+    custom_weights_ = UploadWeights(weights, num_beams);
+    weights_ = custom_weights_.buffer->Get();
+    num_beams_ = num_beams;
+    angles_.clear();
+}
+
+void Beamformer::RequireWeights(const char* where) const {
+    if (!weights_) {
+        throw std::runtime_error(std::string(where) + ": call SetSteering() or SetWeights() first");
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Формирование лучей
+// ════════════════════════════════════════════════════════════════════════════
+
+void Beamformer::Enqueue(cl_mem input, cl_mem output, size_t output_stride, size_t batch_count,
+                         cl_event* out_event, cl_uint num_wait_events, const cl_event* wait_list) {
+    RequireWeights("Beamformer::Enqueue");
+    if (input == nullptr || output == nullptr || batch_count == 0) {
+        throw std::invalid_argument("Beamformer::Enqueue: null buffer or empty batch");
+    }
+    if (output_stride == 0) output_stride = params_.num_samples;
+    if (output_stride < params_.num_samples) {
+        throw std::invalid_argument("Beamformer::Enqueue: output_stride " + std::to_string(output_stride) +
+                                    " < num_samples " + std::to_string(params_.num_samples));
+    }
+
+    cl_uint beams = static_cast<cl_uint>(num_beams_);
+    cl_uint elements = static_cast<cl_uint>(params_.num_elements);
+    cl_uint samples = static_cast<cl_uint>(params_.num_samples);
+    cl_uint stride = static_cast<cl_uint>(output_stride);
+
+    cl_int err = CL_SUCCESS;
+    err |= clSetKernelArg(gemm_kernel_, 0, sizeof(cl_mem), &weights_);
+    err |= clSetKernelArg(gemm_kernel_, 1, sizeof(cl_mem), &input);
+    err |= clSetKernelArg(gemm_kernel_, 2, sizeof(cl_mem), &output);
+    err |= clSetKernelArg(gemm_kernel_, 3, sizeof(cl_uint), &beams);
+    err |= clSetKernelArg(gemm_kernel_, 4, sizeof(cl_uint), &elements);
+    err |= clSetKernelArg(gemm_kernel_, 5, sizeof(cl_uint), &samples);
+    err |= clSetKernelArg(gemm_kernel_, 6, sizeof(cl_uint), &stride);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clSetKernelArg (beamform_gemm) failed: " + std::to_string(err));
+    }
+
+    const size_t block = tile_ * REGISTER_BLOCK;
+    size_t global[3] = {(output_stride + block - 1) / block * tile_, (num_beams_ + block - 1) / block * tile_,
+                        batch_count};
+    size_t local[3] = {tile_, tile_, 1};
+    err = clEnqueueNDRangeKernel(queue_, gemm_kernel_, 3, nullptr, global, local,
+                                 num_wait_events, wait_list, out_event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (beamform_gemm) failed: " + std::to_string(err));
+    }
+}
+
+void Beamformer::Apply(cl_mem input, cl_mem output, size_t output_stride, size_t batch_count) {
+    cl_event event = nullptr;
+    Enqueue(input, output, output_stride, batch_count, &event);
+    cl_int err = clWaitForEvents(1, &event);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event);
+        throw std::runtime_error("clWaitForEvents (beamform_gemm) failed: " + std::to_string(err));
+    }
+
+    last_time_ms_ = 0.0;
+    cl_ulong start = 0, end = 0;
+    if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) == CL_SUCCESS &&
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) == CL_SUCCESS &&
+        end >= start) {
+        last_time_ms_ = (end - start) * 1e-6;
+    }
+    clReleaseEvent(event);
+}
+
+std::vector<std::complex<float>> Beamformer::Apply(const std::vector<std::complex<float>>& input,
+                                                   size_t batch_count) {
+    RequireWeights("Beamformer::Apply");
+    const size_t input_elements = batch_count * params_.num_elements * params_.num_samples;
+    if (batch_count == 0 || input.size() != input_elements) {
+        throw std::invalid_argument("Beamformer::Apply: expected " + std::to_string(input_elements) +
+                                    " elements, got " + std::to_string(input.size()));
+    }
+    const size_t output_elements = batch_count * num_beams_ * params_.num_samples;
+    if (input_capacity_ < input_elements) {
+        buffer_input_ = CreateBuffer(input_elements);
+        input_capacity_ = input_elements;
+    }
+    if (output_capacity_ < output_elements) {
+        buffer_output_ = CreateBuffer(output_elements);
+        output_capacity_ = output_elements;
+    }
+
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_input_->Get(), CL_FALSE, 0,
+                                      input_elements * sizeof(std::complex<float>), input.data(),
+                                      0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (beamformer) failed: " + std::to_string(err));
+    }
+
+    Apply(buffer_input_->Get(), buffer_output_->Get(), params_.num_samples, batch_count);
+
+    std::vector<std::complex<float>> beams(output_elements);
+    err = clEnqueueReadBuffer(queue_, buffer_output_->Get(), CL_TRUE, 0,
+                              output_elements * sizeof(std::complex<float>), beams.data(),
+                              0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (beamformer) failed: " + std::to_string(err));
+    }
+    return beams;
+}
+
+} // namespace antenna_fft
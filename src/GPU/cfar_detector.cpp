@@ -0,0 +1,575 @@
+#include "GPU/cfar_detector.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <stdexcept>
+
+namespace antenna_fft {
+
+namespace {
+
+/// Максимум обучающих ячеек с одной стороны для OS (приватный массив ядра 2·32)
+constexpr size_t kMaxOSTrainingCells = 32;
+
+/// Запись обнаружения на устройстве (16 байт, совпадает с CFARDetectionGPU в ядре)
+struct CFARDetectionGPU {
+    cl_uint index;
+    cl_float value;
+    cl_float noise;
+    cl_uint reserved;
+};
+
+size_t ComplexElementsFor(size_t bytes) {
+    return (bytes + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>);
+}
+
+const char* kCFARKernelSource = R"CL(
+#define CFAR_CA 0u
+#define CFAR_GO 1u
+#define CFAR_SO 2u
+#define CFAR_OS 3u
+#define CFAR_MAX_OS_WINDOW 64
+
+typedef struct {
+    uint index;
+    float value;
+    float noise;
+    uint reserved;
+} CFARDetectionGPU;
+
+// |X|^2 первых num_cells бинов каждого луча → плотный буфер beam × num_cells
+__kernel void cfar_power(
+    __global const float2* spectrum,
+    uint spectrum_stride,
+    uint num_cells,
+    uint beam_count,
+    __global float* power
+) {
+    uint cell = get_global_id(0);
+    uint beam = get_global_id(1);
+    if (cell >= num_cells || beam >= beam_count) return;
+
+    float2 v = spectrum[beam * spectrum_stride + cell];
+    power[beam * num_cells + cell] = v.x * v.x + v.y * v.y;
+}
+
+// Одна work-group = тайл из local_size ячеек одного луча (get_group_id(1))
+__kernel void cfar_detect(
+    __global const float* power,
+    uint num_cells,
+    uint row_stride,
+    uint guard,
+    uint train,
+    uint method,
+    uint os_rank,
+    float alpha,
+    __global CFARDetectionGPU* detections,
+    __global uint* counts,
+    uint max_detections,
+    __local float* tile,       // local_size + 2 * (guard + train)
+    __local float* prefix,     // local_size + 2 * (guard + train) + 1
+    __local float* partial,    // local_size
+    __local uint* scan         // local_size
+) {
+    __local uint group_base;
+
+    const uint beam = get_group_id(1);
+    const uint lid = get_local_id(0);
+    const uint lsize = get_local_size(0);
+    const uint tile_start = get_group_id(0) * lsize;
+    const uint halo = guard + train;
+    const uint tile_len = lsize + 2u * halo;
+    __global const float* row = power + (size_t)beam * row_stride;
+
+    // ─── 1. Тайл с гало; ячейки вне луча = 0 ───
+    for (uint j = lid; j < tile_len; j += lsize) {
+        int src = (int)tile_start - (int)halo + (int)j;
+        tile[j] = (src >= 0 && src < (int)num_cells) ? row[src] : 0.0f;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // ─── 2. Префиксные суммы: prefix[j + 1] = tile[0] + ... + tile[j] ───
+    // Последовательно внутри куска потока, затем scan сумм кусков
+    const uint chunk = (tile_len + lsize - 1u) / lsize;
+    const uint begin = min(lid * chunk, tile_len);
+    const uint end = min(begin + chunk, tile_len);
+    float acc = 0.0f;
+    for (uint j = begin; j < end; ++j) {
+        acc += tile[j];
+        prefix[j + 1u] = acc;
+    }
+    partial[lid] = acc;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint offset = 1u; offset < lsize; offset <<= 1) {
+        float v = (lid >= offset) ? partial[lid - offset] : 0.0f;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        partial[lid] += v;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    const float base = (lid > 0u) ? partial[lid - 1u] : 0.0f;
+    for (uint j = begin; j < end; ++j) {
+        prefix[j + 1u] += base;
+    }
+    if (lid == 0u) prefix[0] = 0.0f;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // ─── 3. Оценка шума и порог ───
+    const int c = (int)(tile_start + lid);
+    const int n = (int)num_cells;
+    uint detected = 0u;
+    float value = 0.0f;
+    float noise = 0.0f;
+
+    if (c < n) {
+        const uint t = lid + halo;   // ячейка в тайле
+        value = tile[t];
+
+        // Число обучающих ячеек внутри луча слева [c-halo, c-guard-1] и справа [c+guard+1, c+halo]
+        int lead_lo = max(c - (int)halo, 0);
+        int lead_hi = min(c - (int)guard - 1, n - 1);
+        int lag_lo = max(c + (int)guard + 1, 0);
+        int lag_hi = min(c + (int)halo, n - 1);
+        int n_lead = max(lead_hi - lead_lo + 1, 0);
+        int n_lag = max(lag_hi - lag_lo + 1, 0);
+
+        if (method == CFAR_OS) {
+            float window[CFAR_MAX_OS_WINDOW];
+            int count = 0;
+            for (uint j = t - halo; j < t - guard; ++j) {
+                int src = (int)tile_start - (int)halo + (int)j;
+                if (src >= 0 && src < n) window[count++] = tile[j];
+            }
+            for (uint j = t + guard + 1u; j <= t + halo; ++j) {
+                int src = (int)tile_start - (int)halo + (int)j;
+                if (src >= 0 && src < n) window[count++] = tile[j];
+            }
+            if (count > 0) {
+                // Частичная сортировка выбором до k-го элемента
+                int k = min((int)os_rank, count);
+                for (int i = 0; i < k; ++i) {
+                    int min_idx = i;
+                    for (int j = i + 1; j < count; ++j) {
+                        if (window[j] < window[min_idx]) min_idx = j;
+                    }
+                    float tmp = window[i];
+                    window[i] = window[min_idx];
+                    window[min_idx] = tmp;
+                }
+                noise = window[k - 1];
+                detected = (value > alpha * noise) ? 1u : 0u;
+            }
+        } else {
+            float sum_lead = prefix[t - guard] - prefix[t - halo];
+            float sum_lag = prefix[t + halo + 1u] - prefix[t + guard + 1u];
+            float mean_lead = (n_lead > 0) ? sum_lead / (float)n_lead : 0.0f;
+            float mean_lag = (n_lag > 0) ? sum_lag / (float)n_lag : 0.0f;
+
+            if (n_lead + n_lag > 0) {
+                if (method == CFAR_CA || n_lead == 0 || n_lag == 0) {
+                    noise = (sum_lead + sum_lag) / (float)(n_lead + n_lag);
+                } else if (method == CFAR_GO) {
+                    noise = fmax(mean_lead, mean_lag);
+                } else {
+                    noise = fmin(mean_lead, mean_lag);
+                }
+                detected = (value > alpha * noise) ? 1u : 0u;
+            }
+        }
+    }
+
+    // ─── 4. Уплотнение: inclusive scan флагов + atomic_add на группу ───
+    scan[lid] = detected;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint offset = 1u; offset < lsize; offset <<= 1) {
+        uint v = (lid >= offset) ? scan[lid - offset] : 0u;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        scan[lid] += v;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    const uint group_total = scan[lsize - 1u];
+    if (lid == 0u) {
+        group_base = (group_total > 0u) ? atomic_add(&counts[beam], group_total) : 0u;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (detected) {
+        uint slot = group_base + scan[lid] - 1u;
+        if (slot < max_detections) {
+            CFARDetectionGPU d;
+            d.index = (uint)c;
+            d.value = value;
+            d.noise = noise;
+            d.reserved = 0u;
+            detections[(size_t)beam * max_detections + slot] = d;
+        }
+    }
+}
+)CL";
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Параметры и результаты
+// ════════════════════════════════════════════════════════════════════════════
+
+std::string CFARMethodToString(CFARMethod method) {
+    switch (method) {
+        case CFARMethod::CA: return "CA";
+        case CFARMethod::GO: return "GO";
+        case CFARMethod::SO: return "SO";
+        case CFARMethod::OS: return "OS";
+    }
+    return "UNKNOWN";
+}
+
+bool CFARParams::IsValid() const {
+    if (training_cells == 0 || max_detections_per_beam == 0) {
+        return false;
+    }
+    if (threshold_factor < 0.0f) {
+        return false;
+    }
+    if (threshold_factor == 0.0f && !(pfa > 0.0 && pfa < 1.0)) {
+        return false;
+    }
+    if (method == CFARMethod::OS) {
+        if (training_cells > kMaxOSTrainingCells || os_rank > 2 * training_cells) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t CFARParams::GetOSRank() const {
+    if (os_rank > 0) {
+        return os_rank;
+    }
+    return std::max<size_t>(1, (3 * 2 * training_cells) / 4);
+}
+
+float CFARParams::GetThresholdFactor() const {
+    if (threshold_factor > 0.0f) {
+        return threshold_factor;
+    }
+
+    const double n = static_cast<double>(2 * training_cells);
+    if (method != CFARMethod::OS) {
+        return static_cast<float>(n * (std::pow(pfa, -1.0 / n) - 1.0));
+    }
+
+    // Pfa(alpha) монотонно убывает по alpha
+    const size_t k = GetOSRank();
+    auto os_pfa = [&](double alpha) {
+        double p = 1.0;
+        for (size_t i = 0; i < k; ++i) {
+            p *= (n - i) / (n - i + alpha);
+        }
+        return p;
+    };
+    double lo = 0.0, hi = 1.0;
+    while (os_pfa(hi) > pfa && hi < 1e9) {
+        hi *= 2.0;
+    }
+    for (int iter = 0; iter < 100; ++iter) {
+        double mid = 0.5 * (lo + hi);
+        if (os_pfa(mid) > pfa) lo = mid; else hi = mid;
+    }
+    return static_cast<float>(hi);
+}
+
+float CFARDetection::GetSNRdB() const {
+    if (noise <= 0.0f) {
+        return 0.0f;
+    }
+    return 10.0f * std::log10(value / noise);
+}
+
+size_t CFARResult::TotalDetections() const {
+    size_t total = 0;
+    for (const auto& beam : beams) {
+        total += beam.detections.size();
+    }
+    return total;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+CFARDetector::CFARDetector(const CFARParams& params)
+    : CFARDetector(params, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+CFARDetector::CFARDetector(const CFARParams& params, const ManagerOpenCL::DeviceContext& device)
+    : CFARDetector(params, &device) {
+}
+
+CFARDetector::CFARDetector(const CFARParams& params, const ManagerOpenCL::DeviceContext* device)
+    : params_(params) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("CFARParams: invalid parameters");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("CFARDetector: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+
+    BuildKernels();
+}
+
+CFARDetector::~CFARDetector() {
+    if (detect_kernel_) clReleaseKernel(detect_kernel_);
+    if (power_kernel_) clReleaseKernel(power_kernel_);
+    if (program_) clReleaseProgram(program_);
+}
+
+void CFARDetector::SetParams(const CFARParams& params) {
+    if (!params.IsValid()) {
+        throw std::invalid_argument("CFARParams: invalid parameters");
+    }
+    params_ = params;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ядра и буферы
+// ════════════════════════════════════════════════════════════════════════════
+
+void CFARDetector::BuildKernels() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kCFARKernelSource;
+    size_t src_len = std::char_traits<char>::length(kCFARKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create CFAR program: " + std::to_string(err));
+    }
+
+    err = clBuildProgram(program_, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "CFAR kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build CFAR program: " + std::to_string(err));
+    }
+
+    detect_kernel_ = clCreateKernel(program_, "cfar_detect", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create cfar_detect kernel: " + std::to_string(err));
+    }
+    power_kernel_ = clCreateKernel(program_, "cfar_power", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create cfar_power kernel: " + std::to_string(err));
+    }
+
+    // Local size: до 256, в пределах ядра (Hillis-Steele scan работает с любым размером)
+    size_t kernel_max = 0;
+    if (clGetKernelWorkGroupInfo(detect_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(size_t), &kernel_max, nullptr) != CL_SUCCESS || kernel_max == 0) {
+        kernel_max = 64;
+    }
+    local_size_ = std::min<size_t>(256, kernel_max);
+}
+
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> CFARDetector::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+        context_, queue_, num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+}
+
+void CFARDetector::EnsureBuffers(size_t beam_count, size_t num_cells, bool need_power) {
+    const size_t detections = beam_count * params_.max_detections_per_beam;
+    if (!buffer_detections_ || detection_capacity_ < detections) {
+        buffer_detections_ = CreateBuffer(ComplexElementsFor(detections * sizeof(CFARDetectionGPU)));
+        detection_capacity_ = detections;
+    }
+    if (!buffer_counts_ || count_capacity_ < beam_count) {
+        buffer_counts_ = CreateBuffer(ComplexElementsFor(beam_count * sizeof(cl_uint)));
+        count_capacity_ = beam_count;
+    }
+    if (need_power && (!buffer_power_ || power_capacity_ < beam_count * num_cells)) {
+        buffer_power_ = CreateBuffer(ComplexElementsFor(beam_count * num_cells * sizeof(float)));
+        power_capacity_ = beam_count * num_cells;
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Обнаружение
+// ════════════════════════════════════════════════════════════════════════════
+
+CFARResult CFARDetector::DetectSpectrum(cl_mem spectrum, size_t beam_count, size_t num_cells,
+                                        size_t spectrum_stride, cl_event wait_event) {
+    if (!spectrum || beam_count == 0 || num_cells == 0 || spectrum_stride < num_cells) {
+        throw std::invalid_argument("CFARDetector::DetectSpectrum: invalid arguments");
+    }
+    EnsureBuffers(beam_count, num_cells, true);
+
+    cl_mem power = buffer_power_->Get();
+    cl_uint stride_arg = static_cast<cl_uint>(spectrum_stride);
+    cl_uint cells_arg = static_cast<cl_uint>(num_cells);
+    cl_uint beams_arg = static_cast<cl_uint>(beam_count);
+
+    cl_int err = clSetKernelArg(power_kernel_, 0, sizeof(cl_mem), &spectrum);
+    err |= clSetKernelArg(power_kernel_, 1, sizeof(cl_uint), &stride_arg);
+    err |= clSetKernelArg(power_kernel_, 2, sizeof(cl_uint), &cells_arg);
+    err |= clSetKernelArg(power_kernel_, 3, sizeof(cl_uint), &beams_arg);
+    err |= clSetKernelArg(power_kernel_, 4, sizeof(cl_mem), &power);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set cfar_power args: " + std::to_string(err));
+    }
+
+    size_t global[2] = {((num_cells + 63) / 64) * 64, beam_count};
+    size_t local[2] = {64, 1};
+    cl_event power_event = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, power_kernel_, 2, nullptr, global, local,
+                                 wait_event ? 1 : 0, wait_event ? &wait_event : nullptr, &power_event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to enqueue cfar_power: " + std::to_string(err));
+    }
+
+    CFARResult result = Detect(power, beam_count, num_cells, num_cells, power_event);
+    clReleaseEvent(power_event);
+    return result;
+}
+
+CFARResult CFARDetector::Detect(cl_mem power, size_t beam_count, size_t num_cells,
+                                size_t row_stride, cl_event wait_event) {
+    if (row_stride == 0) {
+        row_stride = num_cells;
+    }
+    if (!power || beam_count == 0 || num_cells == 0 || row_stride < num_cells) {
+        throw std::invalid_argument("CFARDetector::Detect: invalid arguments");
+    }
+    EnsureBuffers(beam_count, num_cells, false);
+
+    cl_mem detections = buffer_detections_->Get();
+    cl_mem counts = buffer_counts_->Get();
+
+    // Счётчики лучей обнуляются перед каждым запуском
+    cl_uint zero = 0;
+    cl_event fill_event = nullptr;
+    cl_int err = clEnqueueFillBuffer(queue_, counts, &zero, sizeof(cl_uint), 0,
+                                     beam_count * sizeof(cl_uint),
+                                     wait_event ? 1 : 0, wait_event ? &wait_event : nullptr, &fill_event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to clear CFAR counts: " + std::to_string(err));
+    }
+
+    const size_t local = local_size_;
+    const size_t halo = params_.guard_cells + params_.training_cells;
+    const size_t tile_len = local + 2 * halo;
+
+    cl_uint cells_arg = static_cast<cl_uint>(num_cells);
+    cl_uint stride_arg = static_cast<cl_uint>(row_stride);
+    cl_uint guard_arg = static_cast<cl_uint>(params_.guard_cells);
+    cl_uint train_arg = static_cast<cl_uint>(params_.training_cells);
+    cl_uint method_arg = static_cast<cl_uint>(params_.method);
+    cl_uint rank_arg = static_cast<cl_uint>(params_.GetOSRank());
+    cl_float alpha_arg = params_.GetThresholdFactor();
+    cl_uint max_arg = static_cast<cl_uint>(params_.max_detections_per_beam);
+
+    err = clSetKernelArg(detect_kernel_, 0, sizeof(cl_mem), &power);
+    err |= clSetKernelArg(detect_kernel_, 1, sizeof(cl_uint), &cells_arg);
+    err |= clSetKernelArg(detect_kernel_, 2, sizeof(cl_uint), &stride_arg);
+    err |= clSetKernelArg(detect_kernel_, 3, sizeof(cl_uint), &guard_arg);
+    err |= clSetKernelArg(detect_kernel_, 4, sizeof(cl_uint), &train_arg);
+    err |= clSetKernelArg(detect_kernel_, 5, sizeof(cl_uint), &method_arg);
+    err |= clSetKernelArg(detect_kernel_, 6, sizeof(cl_uint), &rank_arg);
+    err |= clSetKernelArg(detect_kernel_, 7, sizeof(cl_float), &alpha_arg);
+    err |= clSetKernelArg(detect_kernel_, 8, sizeof(cl_mem), &detections);
+    err |= clSetKernelArg(detect_kernel_, 9, sizeof(cl_mem), &counts);
+    err |= clSetKernelArg(detect_kernel_, 10, sizeof(cl_uint), &max_arg);
+    err |= clSetKernelArg(detect_kernel_, 11, tile_len * sizeof(cl_float), nullptr);
+    err |= clSetKernelArg(detect_kernel_, 12, (tile_len + 1) * sizeof(cl_float), nullptr);
+    err |= clSetKernelArg(detect_kernel_, 13, local * sizeof(cl_float), nullptr);
+    err |= clSetKernelArg(detect_kernel_, 14, local * sizeof(cl_uint), nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set cfar_detect args: " + std::to_string(err));
+    }
+
+    size_t global[2] = {((num_cells + local - 1) / local) * local, beam_count};
+    size_t local_2d[2] = {local, 1};
+    cl_event detect_event = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, detect_kernel_, 2, nullptr, global, local_2d,
+                                 1, &fill_event, &detect_event);
+    clReleaseEvent(fill_event);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to enqueue cfar_detect: " + std::to_string(err));
+    }
+
+    CFARResult result = ReadResult(beam_count, num_cells, detect_event);
+    clReleaseEvent(detect_event);
+    return result;
+}
+
+CFARResult CFARDetector::ReadResult(size_t beam_count, size_t num_cells, cl_event detect_event) {
+    const size_t max_det = params_.max_detections_per_beam;
+    std::vector<cl_uint> counts(beam_count);
+    std::vector<CFARDetectionGPU> raw(beam_count * max_det);
+
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_counts_->Get(), CL_FALSE, 0,
+                                     beam_count * sizeof(cl_uint), counts.data(),
+                                     1, &detect_event, nullptr);
+    err |= clEnqueueReadBuffer(queue_, buffer_detections_->Get(), CL_TRUE, 0,
+                               raw.size() * sizeof(CFARDetectionGPU), raw.data(),
+                               1, &detect_event, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to read CFAR detections: " + std::to_string(err));
+    }
+
+    CFARResult result;
+    result.num_cells = num_cells;
+    result.threshold_factor = params_.GetThresholdFactor();
+
+    cl_ulong start = 0, end = 0;
+    if (clGetEventProfilingInfo(detect_event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) == CL_SUCCESS &&
+        clGetEventProfilingInfo(detect_event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) == CL_SUCCESS &&
+        end > start) {
+        result.kernel_time_ms = (end - start) * 1e-6;
+    }
+
+    result.beams.resize(beam_count);
+    for (size_t b = 0; b < beam_count; ++b) {
+        CFARBeamResult& beam = result.beams[b];
+        beam.total_count = counts[b];
+        const size_t stored = std::min<size_t>(counts[b], max_det);
+        beam.detections.reserve(stored);
+        for (size_t i = 0; i < stored; ++i) {
+            const CFARDetectionGPU& d = raw[b * max_det + i];
+            CFARDetection det;
+            det.index = d.index;
+            det.value = d.value;
+            det.noise = d.noise;
+            beam.detections.push_back(det);
+        }
+        // Порядок между тайлами зависит от atomic_add — сортируем по ячейке
+        std::sort(beam.detections.begin(), beam.detections.end(),
+                  [](const CFARDetection& a, const CFARDetection& b) { return a.index < b.index; });
+    }
+    return result;
+}
+
+} // namespace antenna_fft
@@ -17,6 +17,10 @@
 #include "ManagerOpenCL/command_queue_pool.hpp"
 #include "ManagerOpenCL/gpu_memory_buffer.hpp"
 #include "ManagerOpenCL/i_memory_buffer.hpp"
+#include "ManagerOpenCL/svm_capabilities.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "ManagerOpenCL/work_group_tuner.hpp"
+#include "ManagerOpenCL/mapped_array_file.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -87,6 +91,46 @@ LagrangeMatrix LagrangeMatrix::LoadFromJSON(const std::string& filepath) {
     return matrix;
 }
 
+LagrangeMatrix LagrangeMatrix::LoadFromBinary(const std::string& filepath) {
+    ManagerOpenCL::MappedArrayFile file(filepath);
+    const auto shape = file.GetShape();
+    if (shape.size() != 2 || shape[0] != LAGRANGE_ROWS || shape[1] != LAGRANGE_COLS || !file.IsContiguous()) {
+        throw std::runtime_error("Invalid matrix dimensions in " + filepath + ": expected " +
+                                 std::to_string(LAGRANGE_ROWS) + "x" + std::to_string(LAGRANGE_COLS));
+    }
+    
+    LagrangeMatrix matrix;
+    for (uint32_t row = 0; row < LAGRANGE_ROWS; ++row) {
+        for (uint32_t col = 0; col < LAGRANGE_COLS; ++col) {
+            const size_t i = row * LAGRANGE_COLS + col;
+            matrix.coefficients[row][col] = file.GetDType() == ManagerOpenCL::ArrayDType::Float32
+                ? file.Data<float>()[i]
+                : static_cast<float>(file.Data<double>()[i]);
+        }
+    }
+    
+    if (!matrix.IsValid()) {
+        throw std::runtime_error("Loaded matrix failed validation");
+    }
+    
+    return matrix;
+}
+
+LagrangeMatrix LagrangeMatrix::Load(const std::string& filepath) {
+    return ManagerOpenCL::MappedArrayFile::IsArrayFile(filepath) ? LoadFromBinary(filepath)
+                                                                 : LoadFromJSON(filepath);
+}
+
+void LagrangeMatrix::SaveBinary(const std::string& filepath) const {
+    std::vector<float> data;
+    data.reserve(LAGRANGE_ROWS * LAGRANGE_COLS);
+    for (const auto& row : coefficients) {
+        data.insert(data.end(), row.begin(), row.end());
+    }
+    ManagerOpenCL::MappedArrayFile::Write(filepath, {LAGRANGE_ROWS, LAGRANGE_COLS}, data,
+                                          "Lagrange fractional delay coefficients");
+}
+
 // ============================================================================
 // ВСТРОЕННЫЙ KERNEL КОД
 // ============================================================================
@@ -155,77 +199,75 @@ __kernel void fractional_delay_kernel(
     const uint num_beams,
     const uint num_samples
 ) {
-    // Глобальный индекс = beam_idx * num_samples + sample_idx
-    uint gid = get_global_id(0);
-    
-    // Определить луч и позицию внутри луча
-    uint beam_idx = gid / num_samples;
-    uint sample_idx = gid % num_samples;
-    
-    // Проверка границ
-    if (beam_idx >= num_beams) {
-        return;
+    // Grid-stride цикл: global size может быть меньше num_beams * num_samples,
+    // тогда work-item обрабатывает несколько отсчётов (подбирается WorkGroupTuner)
+    const uint total = num_beams * num_samples;
+    for (uint gid = get_global_id(0); gid < total; gid += get_global_size(0)) {
+        // Глобальный индекс = beam_idx * num_samples + sample_idx
+        // Определить луч и позицию внутри луча
+        uint beam_idx = gid / num_samples;
+        uint sample_idx = gid % num_samples;
+
+        // Получить параметры задержки для этого луча
+        DelayParams dp = delay_params[beam_idx];
+        int delay_int = dp.delay_integer;
+        uint lag_row = dp.lagrange_row;  // [0..47]
+
+        // Загрузить коэффициенты Лагранжа для этой дробной части
+        // lagrange_matrix[lag_row * 5 + col]
+        float L0 = lagrange_matrix[lag_row * LAGRANGE_COLS + 0];
+        float L1 = lagrange_matrix[lag_row * LAGRANGE_COLS + 1];
+        float L2 = lagrange_matrix[lag_row * LAGRANGE_COLS + 2];
+        float L3 = lagrange_matrix[lag_row * LAGRANGE_COLS + 3];
+        float L4 = lagrange_matrix[lag_row * LAGRANGE_COLS + 4];
+
+        // Вычислить исходный индекс с учётом целой задержки
+        // Для 5-точечной интерполяции Лагранжа:
+        // - При frac=0 (row=0): L1=1.0, значит center соответствует s1
+        // - Окно: [center-1, center, center+1, center+2, center+3]
+        int center = (int)sample_idx - delay_int;
+
+        // Индексы 5 точек для интерполяции (сдвинуты на +1 относительно стандартного)
+        // L0 → s0 = input[center-1]
+        // L1 → s1 = input[center]    ← ЦЕНТР (L1=1.0 при frac=0)
+        // L2 → s2 = input[center+1]
+        // L3 → s3 = input[center+2]
+        // L4 → s4 = input[center+3]
+        int idx0 = center - 1;
+        int idx1 = center;      // Центральная точка (L1=1.0 при frac=0)
+        int idx2 = center + 1;
+        int idx3 = center + 2;
+        int idx4 = center + 3;
+
+        // Смещение в буфере для этого луча
+        uint beam_offset = beam_idx * num_samples;
+
+        // Функция безопасного чтения (с граничным условием = 0)
+        // Используем макрос для inline
+        #define SAFE_READ(idx) \
+            (((idx) >= 0 && (idx) < (int)num_samples) ? \
+             input_buffer[beam_offset + (idx)] : (Complex){0.0f, 0.0f})
+
+        // Читаем 5 точек
+        Complex s0 = SAFE_READ(idx0);
+        Complex s1 = SAFE_READ(idx1);
+        Complex s2 = SAFE_READ(idx2);
+        Complex s3 = SAFE_READ(idx3);
+        Complex s4 = SAFE_READ(idx4);
+
+        #undef SAFE_READ
+
+        // 5-точечная интерполяция Лагранжа:
+        // result = L0*s0 + L1*s1 + L2*s2 + L3*s3 + L4*s4
+        Complex result;
+        result.real = L0 * s0.real + L1 * s1.real + L2 * s2.real + 
+                      L3 * s3.real + L4 * s4.real;
+        result.imag = L0 * s0.imag + L1 * s1.imag + L2 * s2.imag + 
+                      L3 * s3.imag + L4 * s4.imag;
+
+        // Записать результат
+        output_buffer[gid] = result;
     }
-    
-    // Получить параметры задержки для этого луча
-    DelayParams dp = delay_params[beam_idx];
-    int delay_int = dp.delay_integer;
-    uint lag_row = dp.lagrange_row;  // [0..47]
-    
-    // Загрузить коэффициенты Лагранжа для этой дробной части
-    // lagrange_matrix[lag_row * 5 + col]
-    float L0 = lagrange_matrix[lag_row * LAGRANGE_COLS + 0];
-    float L1 = lagrange_matrix[lag_row * LAGRANGE_COLS + 1];
-    float L2 = lagrange_matrix[lag_row * LAGRANGE_COLS + 2];
-    float L3 = lagrange_matrix[lag_row * LAGRANGE_COLS + 3];
-    float L4 = lagrange_matrix[lag_row * LAGRANGE_COLS + 4];
-    
-    // Вычислить исходный индекс с учётом целой задержки
-    // Для 5-точечной интерполяции Лагранжа:
-    // - При frac=0 (row=0): L1=1.0, значит center соответствует s1
-    // - Окно: [center-1, center, center+1, center+2, center+3]
-    int center = (int)sample_idx - delay_int;
-    
-    // Индексы 5 точек для интерполяции (сдвинуты на +1 относительно стандартного)
-    // L0 → s0 = input[center-1]
-    // L1 → s1 = input[center]    ← ЦЕНТР (L1=1.0 при frac=0)
-    // L2 → s2 = input[center+1]
-    // L3 → s3 = input[center+2]
-    // L4 → s4 = input[center+3]
-    int idx0 = center - 1;
-    int idx1 = center;      // Центральная точка (L1=1.0 при frac=0)
-    int idx2 = center + 1;
-    int idx3 = center + 2;
-    int idx4 = center + 3;
-    
-    // Смещение в буфере для этого луча
-    uint beam_offset = beam_idx * num_samples;
-    
-    // Функция безопасного чтения (с граничным условием = 0)
-    // Используем макрос для inline
-    #define SAFE_READ(idx) \
-        (((idx) >= 0 && (idx) < (int)num_samples) ? \
-         input_buffer[beam_offset + (idx)] : (Complex){0.0f, 0.0f})
-    
-    // Читаем 5 точек
-    Complex s0 = SAFE_READ(idx0);
-    Complex s1 = SAFE_READ(idx1);
-    Complex s2 = SAFE_READ(idx2);
-    Complex s3 = SAFE_READ(idx3);
-    Complex s4 = SAFE_READ(idx4);
-    
-    #undef SAFE_READ
-    
-    // 5-точечная интерполяция Лагранжа:
-    // result = L0*s0 + L1*s1 + L2*s2 + L3*s3 + L4*s4
-    Complex result;
-    result.real = L0 * s0.real + L1 * s1.real + L2 * s2.real + 
-                  L3 * s3.real + L4 * s4.real;
-    result.imag = L0 * s0.imag + L1 * s1.imag + L2 * s2.imag + 
-                  L3 * s3.imag + L4 * s4.imag;
-    
-    // Записать результат
-    output_buffer[gid] = result;
 }
 
 // ============================================================================
@@ -252,6 +294,25 @@ __kernel void copy_buffer_kernel(
 FractionalDelayProcessor::FractionalDelayProcessor(
     const FractionalDelayConfig& config,
     const LagrangeMatrix& lagrange_matrix
+)
+    : FractionalDelayProcessor(config, lagrange_matrix,
+                               static_cast<const ManagerOpenCL::DeviceContext*>(nullptr))
+{
+}
+
+FractionalDelayProcessor::FractionalDelayProcessor(
+    const FractionalDelayConfig& config,
+    const LagrangeMatrix& lagrange_matrix,
+    const ManagerOpenCL::DeviceContext& device
+)
+    : FractionalDelayProcessor(config, lagrange_matrix, &device)
+{
+}
+
+FractionalDelayProcessor::FractionalDelayProcessor(
+    const FractionalDelayConfig& config,
+    const LagrangeMatrix& lagrange_matrix,
+    const ManagerOpenCL::DeviceContext* device
 )
     : config_(config),
       lagrange_matrix_(lagrange_matrix),
@@ -261,6 +322,10 @@ FractionalDelayProcessor::FractionalDelayProcessor(
       device_(nullptr),
       kernel_(nullptr),
       program_(nullptr),
+      svm_supported_(false),
+      work_group_size_(0),
+      items_per_work_item_(1),
+      svm_temp_(nullptr),
       total_samples_processed_(0),
       total_calls_(0)
 {
@@ -274,8 +339,12 @@ FractionalDelayProcessor::FractionalDelayProcessor(
         throw std::invalid_argument("LagrangeMatrix: invalid matrix");
     }
     
-    // Проверка инициализации OpenCL
-    if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+    if (device && !device->IsValid()) {
+        throw std::invalid_argument("FractionalDelayProcessor: invalid DeviceContext");
+    }
+    
+    // Проверка инициализации OpenCL (только без DeviceContext)
+    if (!device && !ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
         ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
         
         if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
@@ -286,7 +355,7 @@ FractionalDelayProcessor::FractionalDelayProcessor(
     }
     
     // Инициализация
-    Initialize();
+    Initialize(device);
     
     if (config_.verbose) {
         PrintInfo();
@@ -304,6 +373,7 @@ FractionalDelayProcessor::~FractionalDelayProcessor() {
     if (program_) {
         clReleaseProgram(program_);
     }
+    ReleaseSVMTemp();
     buffer_lagrange_.reset();
     buffer_delays_.reset();
     buffer_temp_.reset();
@@ -324,15 +394,18 @@ FractionalDelayProcessor::FractionalDelayProcessor(
       device_(other.device_),
       kernel_(other.kernel_),
       program_(other.program_),
+      svm_supported_(other.svm_supported_),
       buffer_lagrange_(std::move(other.buffer_lagrange_)),
       buffer_delays_(std::move(other.buffer_delays_)),
       buffer_temp_(std::move(other.buffer_temp_)),
+      svm_temp_(other.svm_temp_),
       last_profiling_(other.last_profiling_),
       total_samples_processed_(other.total_samples_processed_),
       total_calls_(other.total_calls_)
 {
     other.kernel_ = nullptr;
     other.program_ = nullptr;
+    other.svm_temp_ = nullptr;
 }
 
 FractionalDelayProcessor& FractionalDelayProcessor::operator=(
@@ -341,6 +414,7 @@ FractionalDelayProcessor& FractionalDelayProcessor::operator=(
     if (this != &other) {
         if (kernel_) clReleaseKernel(kernel_);
         if (program_) clReleaseProgram(program_);
+        ReleaseSVMTemp();
         
         config_ = other.config_;
         lagrange_matrix_ = std::move(other.lagrange_matrix_);
@@ -350,15 +424,18 @@ FractionalDelayProcessor& FractionalDelayProcessor::operator=(
         device_ = other.device_;
         kernel_ = other.kernel_;
         program_ = other.program_;
+        svm_supported_ = other.svm_supported_;
         buffer_lagrange_ = std::move(other.buffer_lagrange_);
         buffer_delays_ = std::move(other.buffer_delays_);
         buffer_temp_ = std::move(other.buffer_temp_);
+        svm_temp_ = other.svm_temp_;
         last_profiling_ = other.last_profiling_;
         total_samples_processed_ = other.total_samples_processed_;
         total_calls_ = other.total_calls_;
         
         other.kernel_ = nullptr;
         other.program_ = nullptr;
+        other.svm_temp_ = nullptr;
     }
     return *this;
 }
@@ -367,20 +444,28 @@ FractionalDelayProcessor& FractionalDelayProcessor::operator=(
 // ИНИЦИАЛИЗАЦИЯ
 // ============================================================================
 
-void FractionalDelayProcessor::Initialize() {
+void FractionalDelayProcessor::Initialize(const ManagerOpenCL::DeviceContext* device) {
     if (config_.verbose) {
         std::cout << "[FDP] Инициализация FractionalDelayProcessor...\n";
     }
     
     // Получить OpenCL объекты
-    engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
-    auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
-    context_ = core.GetContext();
-    device_ = core.GetDevice();
-    queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    if (device) {
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+    svm_supported_ = ManagerOpenCL::SVMCapabilities::Query(device_).svm_supported;
     
     // Загрузить kernel
     LoadKernel();
+    ResolveWorkGroup();
     
     // Создать буферы
     CreateBuffers();
@@ -441,10 +526,52 @@ void FractionalDelayProcessor::LoadKernel() {
     }
 }
 
+// ============================================================================
+// LOCAL WORK SIZE
+// ============================================================================
+
+void FractionalDelayProcessor::ResolveWorkGroup() {
+    work_group_size_ = 0;
+    items_per_work_item_ = 1;
+    
+    if (!config_.auto_tune) {
+        work_group_size_ = config_.local_work_size;
+        return;
+    }
+    
+    // Запись из базы — сразу; иначе подбор при первом Process (нужны реальные буферы)
+    ManagerOpenCL::WorkGroupConfig wg;
+    size_t total_work = static_cast<size_t>(config_.num_beams) * config_.num_samples;
+    if (ManagerOpenCL::WorkGroupTuner::Lookup("fractional_delay_kernel", device_, total_work, wg)) {
+        work_group_size_ = wg.local_size;
+        items_per_work_item_ = wg.items_per_work_item;
+        if (config_.verbose) {
+            std::cout << "[FDP] Work-group из базы: local=" << work_group_size_
+                      << ", items=" << items_per_work_item_ << "\n";
+        }
+    }
+}
+
+size_t FractionalDelayProcessor::GetGlobalSize(size_t total_work) const {
+    size_t work_items = (total_work + items_per_work_item_ - 1) / items_per_work_item_;
+    return ((work_items + work_group_size_ - 1) / work_group_size_) * work_group_size_;
+}
+
 // ============================================================================
 // СОЗДАНИЕ БУФЕРОВ
 // ============================================================================
 
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> FractionalDelayProcessor::CreateBuffer(
+    size_t num_elements, bool read_only
+) {
+    auto type = read_only ? ManagerOpenCL::MemoryType::GPU_READ_ONLY
+                          : ManagerOpenCL::MemoryType::GPU_READ_WRITE;
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, type);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(context_, queue_, num_elements, type);
+}
+
 void FractionalDelayProcessor::CreateBuffers() {
     if (config_.verbose) {
         std::cout << "[FDP] Создание GPU буферов...\n";
@@ -471,9 +598,9 @@ void FractionalDelayProcessor::CreateBuffers() {
     size_t delays_complex_size = (delays_size + sizeof(Complex) - 1) / sizeof(Complex);
     size_t temp_complex_size = static_cast<size_t>(config_.num_beams) * config_.num_samples;
     
-    buffer_lagrange_ = engine_->CreateBuffer(lagrange_complex_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
-    buffer_delays_ = engine_->CreateBuffer(delays_complex_size, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
-    buffer_temp_ = engine_->CreateBuffer(temp_complex_size, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    buffer_lagrange_ = CreateBuffer(lagrange_complex_size, true);
+    buffer_delays_ = CreateBuffer(delays_complex_size, true);
+    buffer_temp_ = CreateBuffer(temp_complex_size, false);
     
     if (config_.verbose) {
         std::cout << "[FDP] GPU буферы созданы ✅\n";
@@ -564,6 +691,14 @@ double FractionalDelayProcessor::ProfileEvent(cl_event event, const std::string&
 void FractionalDelayProcessor::Process(
     cl_mem gpu_buffer,
     const std::vector<DelayParams>& delays
+) {
+    ProcessInternal(gpu_buffer, nullptr, delays);
+}
+
+void FractionalDelayProcessor::ProcessInternal(
+    cl_mem gpu_buffer,
+    void* svm_ptr,
+    const std::vector<DelayParams>& delays
 ) {
     if (delays.size() != config_.num_beams) {
         throw std::invalid_argument(
@@ -609,8 +744,15 @@ void FractionalDelayProcessor::Process(
     cl_uint num_beams = config_.num_beams;
     cl_uint num_samples = config_.num_samples;
     
-    err = clSetKernelArg(kernel_, 0, sizeof(cl_mem), &gpu_buffer);      // input
-    err |= clSetKernelArg(kernel_, 1, sizeof(cl_mem), &temp_buf);       // output (temp)
+    if (svm_ptr) {
+        // SVM: вход и temp передаются указателями, копий через хост нет
+        EnsureSVMTemp();
+        err = clSetKernelArgSVMPointer(kernel_, 0, svm_ptr);            // input
+        err |= clSetKernelArgSVMPointer(kernel_, 1, svm_temp_);         // output (temp)
+    } else {
+        err = clSetKernelArg(kernel_, 0, sizeof(cl_mem), &gpu_buffer);  // input
+        err |= clSetKernelArg(kernel_, 1, sizeof(cl_mem), &temp_buf);   // output (temp)
+    }
     err |= clSetKernelArg(kernel_, 2, sizeof(cl_mem), &lagrange_buf);   // lagrange matrix
     err |= clSetKernelArg(kernel_, 3, sizeof(cl_mem), &delays_buf);     // delay params
     err |= clSetKernelArg(kernel_, 4, sizeof(cl_uint), &num_beams);
@@ -626,8 +768,25 @@ void FractionalDelayProcessor::Process(
     // ═══════════════════════════════════════════════════════════════════════════
     
     size_t total_work = static_cast<size_t>(num_beams) * num_samples;
-    size_t local_size = config_.local_work_size;
-    size_t global_size = ((total_work + local_size - 1) / local_size) * local_size;
+    
+    if (work_group_size_ == 0) {
+        // Записи в базе нет — подбор на текущих аргументах (temp перезаписывается, вход не меняется)
+        auto wg = ManagerOpenCL::WorkGroupTuner::Tune(
+            "fractional_delay_kernel", kernel_, device_, queue_, total_work,
+            config_.local_work_size, {1, 2, 4, 8},
+            [&](cl_command_queue q, const ManagerOpenCL::WorkGroupConfig& c, cl_event* ev) {
+                size_t local = c.local_size;
+                size_t work_items = (total_work + c.items_per_work_item - 1) / c.items_per_work_item;
+                size_t global = ((work_items + local - 1) / local) * local;
+                return clEnqueueNDRangeKernel(q, kernel_, 1, nullptr, &global, &local,
+                                              0, nullptr, ev);
+            });
+        work_group_size_ = wg.local_size;
+        items_per_work_item_ = wg.items_per_work_item;
+    }
+    
+    size_t local_size = work_group_size_;
+    size_t global_size = GetGlobalSize(total_work);
     
     cl_event event_kernel = nullptr;
     cl_uint num_wait = event_upload ? 1 : 0;
@@ -658,16 +817,29 @@ void FractionalDelayProcessor::Process(
     cl_uint copy_wait = event_kernel ? 1 : 0;
     cl_event* copy_wait_list = event_kernel ? &event_kernel : nullptr;
     
-    err = clEnqueueCopyBuffer(
-        queue_,
-        temp_buf,           // source
-        gpu_buffer,         // destination
-        0, 0,
-        total_work * sizeof(Complex),
-        copy_wait,
-        copy_wait_list,
-        config_.enable_profiling ? &event_copy : nullptr
-    );
+    if (svm_ptr) {
+        err = clEnqueueSVMMemcpy(
+            queue_,
+            CL_FALSE,
+            svm_ptr,            // destination
+            svm_temp_,          // source
+            total_work * sizeof(Complex),
+            copy_wait,
+            copy_wait_list,
+            config_.enable_profiling ? &event_copy : nullptr
+        );
+    } else {
+        err = clEnqueueCopyBuffer(
+            queue_,
+            temp_buf,           // source
+            gpu_buffer,         // destination
+            0, 0,
+            total_work * sizeof(Complex),
+            copy_wait,
+            copy_wait_list,
+            config_.enable_profiling ? &event_copy : nullptr
+        );
+    }
     
     if (err != CL_SUCCESS) {
         if (event_upload) clReleaseEvent(event_upload);
@@ -728,6 +900,86 @@ void FractionalDelayProcessor::ProcessWithDelay(cl_mem gpu_buffer, float delay_s
     Process(gpu_buffer, dp);
 }
 
+// ============================================================================
+// ZERO-COPY ОБРАБОТКА (SVM)
+// ============================================================================
+
+void FractionalDelayProcessor::Process(
+    ManagerOpenCL::IMemoryBuffer* buffer,
+    const std::vector<DelayParams>& delays
+) {
+    if (!buffer) {
+        throw std::invalid_argument("FractionalDelayProcessor::Process: buffer is null");
+    }
+    
+    size_t total_work = static_cast<size_t>(config_.num_beams) * config_.num_samples;
+    if (buffer->GetNumElements() < total_work) {
+        throw std::invalid_argument(
+            "Buffer too small: expected " + std::to_string(total_work) +
+            ", got " + std::to_string(buffer->GetNumElements())
+        );
+    }
+    
+    if (buffer->IsSVM()) {
+        // Coarse-grain SVM должен быть unmapped перед использованием в kernel'е
+        if (buffer->IsMapped()) {
+            buffer->Unmap();
+        }
+        ProcessInternal(nullptr, buffer->GetSVMPointer(), delays);
+    } else {
+        ProcessInternal(buffer->GetCLMem(), nullptr, delays);
+    }
+}
+
+void FractionalDelayProcessor::ProcessSVM(void* svm_ptr, const std::vector<DelayParams>& delays) {
+    if (!svm_ptr) {
+        throw std::invalid_argument("FractionalDelayProcessor::ProcessSVM: pointer is null");
+    }
+    
+    if (svm_supported_) {
+        ProcessInternal(nullptr, svm_ptr, delays);
+        return;
+    }
+    
+    // Fallback без SVM: upload → обработка в buffer_temp_ → download
+    size_t total_work = static_cast<size_t>(config_.num_beams) * config_.num_samples;
+    auto staging = CreateBuffer(total_work, false);
+    
+    cl_int err = clEnqueueWriteBuffer(queue_, staging->Get(), CL_FALSE, 0,
+                                      total_work * sizeof(Complex), svm_ptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to upload input (SVM fallback): " + std::to_string(err));
+    }
+    
+    ProcessInternal(staging->Get(), nullptr, delays);
+    
+    err = clEnqueueReadBuffer(queue_, staging->Get(), CL_TRUE, 0,
+                              total_work * sizeof(Complex), svm_ptr, 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to download result (SVM fallback): " + std::to_string(err));
+    }
+}
+
+void FractionalDelayProcessor::EnsureSVMTemp() {
+    if (svm_temp_) {
+        return;
+    }
+    
+    size_t temp_size = static_cast<size_t>(config_.num_beams) * config_.num_samples * sizeof(Complex);
+    svm_temp_ = clSVMAlloc(context_, CL_MEM_READ_WRITE, temp_size, 0);
+    if (!svm_temp_) {
+        throw std::runtime_error("clSVMAlloc failed for temp buffer (" +
+                                 std::to_string(temp_size) + " bytes)");
+    }
+}
+
+void FractionalDelayProcessor::ReleaseSVMTemp() {
+    if (svm_temp_) {
+        clSVMFree(context_, svm_temp_);
+        svm_temp_ = nullptr;
+    }
+}
+
 // ============================================================================
 // BATCH ОБРАБОТКА
 // ============================================================================
@@ -773,8 +1025,11 @@ void FractionalDelayProcessor::UpdateConfig(const FractionalDelayConfig& new_con
     if (need_rebuild) {
         buffer_delays_.reset();
         buffer_temp_.reset();
+        ReleaseSVMTemp();
         CreateBuffers();
+        UploadLagrangeMatrix();   // CreateBuffers пересоздаёт и buffer_lagrange_
     }
+    ResolveWorkGroup();
 }
 
 // ============================================================================
@@ -790,7 +1045,10 @@ void FractionalDelayProcessor::PrintInfo() const {
     std::cout << "Configuration:\n";
     std::cout << "  - Num beams:       " << config_.num_beams << "\n";
     std::cout << "  - Num samples:     " << config_.num_samples << "\n";
-    std::cout << "  - Local work size: " << config_.local_work_size << "\n";
+    std::cout << "  - Local work size: " << work_group_size_
+              << (work_group_size_ == 0 ? " (auto, не подобран)" : "")
+              << ", items/work-item: " << items_per_work_item_ << "\n";
+    std::cout << "  - Auto-tune:       " << (config_.auto_tune ? "ON" : "OFF") << "\n";
     std::cout << "  - Profiling:       " << (config_.enable_profiling ? "ON" : "OFF") << "\n";
     std::cout << "  - Verbose:         " << (config_.verbose ? "ON" : "OFF") << "\n";
     std::cout << "\n";
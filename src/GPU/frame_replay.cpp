@@ -0,0 +1,385 @@
+#include "GPU/frame_replay.hpp"
+#include "GPU/antenna_fft_proc_max.h"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace antenna_fft {
+
+namespace {
+
+const char kFrameMagic[8] = {'L', 'C', 'H', 'F', 'R', 'A', 'M', 'E'};
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point t0, Clock::time_point t1) {
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// FrameRecorder
+// ════════════════════════════════════════════════════════════════════════════
+
+FrameRecorder::FrameRecorder(const std::string& path, const FrameRecordingInfo& info)
+    : path_(path), start_(Clock::now()) {
+    const bool has_fft = info.fft.IsValid();
+    size_t beams = info.beam_count;
+    size_t points = info.count_points;
+    if (beams == 0 && has_fft) beams = info.fft.beam_count;
+    if (points == 0 && has_fft) points = info.fft.count_points;
+    if (beams == 0 && info.has_fdp) beams = info.fdp.num_beams;
+    if (points == 0 && info.has_fdp) points = info.fdp.num_samples;
+
+    if (beams == 0 || points == 0) {
+        throw std::invalid_argument("FrameRecorder: frame size is not set");
+    }
+    if (has_fft && (info.fft.beam_count != beams || info.fft.count_points != points)) {
+        throw std::invalid_argument("FrameRecorder: AntennaFFTParams do not match frame size");
+    }
+    if (info.has_fdp && (info.fdp.num_beams != beams || info.fdp.num_samples != points || !info.fdp.IsValid())) {
+        throw std::invalid_argument("FrameRecorder: FractionalDelayConfig does not match frame size");
+    }
+    if (!info.delays.empty() && info.delays.size() != beams) {
+        throw std::invalid_argument("FrameRecorder: delays size " + std::to_string(info.delays.size()) +
+                                    " != beam count " + std::to_string(beams));
+    }
+    frame_elements_ = beams * points;
+
+    std::memcpy(header_.magic, kFrameMagic, sizeof(kFrameMagic));
+    header_.version = FrameRecordHeader::VERSION;
+    header_.header_bytes = sizeof(FrameRecordHeader);
+    header_.flags = (has_fft ? FrameRecordHeader::FLAG_FFT : 0u) |
+                    (info.has_fdp ? FrameRecordHeader::FLAG_FDP : 0u) |
+                    (info.has_fdp && info.fdp.auto_tune ? FrameRecordHeader::FLAG_FDP_AUTO_TUNE : 0u);
+    header_.beam_count = static_cast<uint32_t>(beams);
+    header_.count_points = static_cast<uint32_t>(points);
+    header_.out_count_points_fft = has_fft ? static_cast<uint32_t>(info.fft.out_count_points_fft) : 0u;
+    header_.max_peaks_count = has_fft ? static_cast<uint32_t>(info.fft.max_peaks_count) : 0u;
+    header_.fdp_local_work_size = info.has_fdp ? info.fdp.local_work_size : 0u;
+    header_.delay_count = static_cast<uint32_t>(info.delays.size());
+    header_.frames_offset = AlignUp(sizeof(FrameRecordHeader) + info.delays.size() * sizeof(radar::DelayParams),
+                                    FrameRecordHeader::FRAME_ALIGNMENT);
+    header_.frame_count = 0;
+    header_.frame_period_ns = info.frame_period_ns;
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        throw std::runtime_error("FrameRecorder: cannot open file: " + path);
+    }
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    for (const auto& delay : info.delays) {
+        file_.write(reinterpret_cast<const char*>(&delay.delay_integer), sizeof(delay.delay_integer));
+        file_.write(reinterpret_cast<const char*>(&delay.lagrange_row), sizeof(delay.lagrange_row));
+    }
+    const size_t padding = header_.frames_offset - sizeof(FrameRecordHeader) -
+                           info.delays.size() * sizeof(radar::DelayParams);
+    const char zeros[FrameRecordHeader::FRAME_ALIGNMENT] = {};
+    file_.write(zeros, static_cast<std::streamsize>(padding));
+    if (!file_) {
+        throw std::runtime_error("FrameRecorder: write failed: " + path);
+    }
+}
+
+FrameRecorder::~FrameRecorder() {
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+void FrameRecorder::Append(const std::complex<float>* frame, uint64_t timestamp_ns) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("FrameRecorder: recording is closed");
+    }
+    FrameRecordEntry entry{};
+    entry.timestamp_ns = timestamp_ns != UINT64_MAX
+        ? timestamp_ns
+        : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count());
+    entry.index = frame_count_;
+    file_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    file_.write(reinterpret_cast<const char*>(frame),
+                static_cast<std::streamsize>(frame_elements_ * sizeof(std::complex<float>)));
+    if (!file_) {
+        throw std::runtime_error("FrameRecorder: write failed: " + path_);
+    }
+    ++frame_count_;
+}
+
+void FrameRecorder::Append(const std::vector<std::complex<float>>& frame, uint64_t timestamp_ns) {
+    if (frame.size() != frame_elements_) {
+        throw std::invalid_argument("FrameRecorder: frame has " + std::to_string(frame.size()) +
+                                    " elements, expected " + std::to_string(frame_elements_));
+    }
+    Append(frame.data(), timestamp_ns);
+}
+
+void FrameRecorder::Append(cl_mem frame, cl_command_queue queue, uint64_t timestamp_ns) {
+    // Метка — момент готовности кадра, а не окончания чтения
+    if (timestamp_ns == UINT64_MAX) {
+        timestamp_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count());
+    }
+    scratch_.resize(frame_elements_);
+    cl_int err = clEnqueueReadBuffer(queue, frame, CL_TRUE, 0, frame_elements_ * sizeof(std::complex<float>),
+                                     scratch_.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("FrameRecorder: clEnqueueReadBuffer failed: " + std::to_string(err));
+    }
+    Append(scratch_.data(), timestamp_ns);
+}
+
+void FrameRecorder::Close() {
+    if (!file_.is_open()) return;
+    header_.frame_count = frame_count_;
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    file_.close();
+    if (file_.fail()) {
+        throw std::runtime_error("FrameRecorder: failed to finalize: " + path_);
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// FrameRecording
+// ════════════════════════════════════════════════════════════════════════════
+
+bool FrameRecording::IsRecordingFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kFrameMagic)] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, kFrameMagic, sizeof(kFrameMagic)) == 0;
+}
+
+FrameRecording::FrameRecording(const std::string& path) : path_(path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("FrameRecording: cannot open file: " + path);
+    }
+    const uint64_t file_size = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    FrameRecordHeader header{};
+    if (file_size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kFrameMagic, sizeof(kFrameMagic)) != 0) {
+        throw std::runtime_error("FrameRecording: not a frame recording: " + path);
+    }
+    if (header.version != FrameRecordHeader::VERSION || header.header_bytes != sizeof(FrameRecordHeader)) {
+        throw std::runtime_error("FrameRecording: unsupported version " + std::to_string(header.version) +
+                                 ": " + path);
+    }
+    if (header.beam_count == 0 || header.count_points == 0 ||
+        (header.delay_count != 0 && header.delay_count != header.beam_count) ||
+        header.frames_offset < sizeof(header) + uint64_t(header.delay_count) * sizeof(radar::DelayParams) ||
+        header.frames_offset > file_size) {
+        throw std::runtime_error("FrameRecording: corrupted header: " + path);
+    }
+
+    info_.beam_count = header.beam_count;
+    info_.count_points = header.count_points;
+    info_.frame_period_ns = header.frame_period_ns;
+    if (header.flags & FrameRecordHeader::FLAG_FFT) {
+        info_.fft = AntennaFFTParams(header.beam_count, header.count_points, header.out_count_points_fft,
+                                     header.max_peaks_count);
+    }
+    info_.has_fdp = (header.flags & FrameRecordHeader::FLAG_FDP) != 0;
+    if (info_.has_fdp) {
+        info_.fdp.num_beams = header.beam_count;
+        info_.fdp.num_samples = header.count_points;
+        info_.fdp.local_work_size = header.fdp_local_work_size;
+        info_.fdp.verbose = false;
+        info_.fdp.auto_tune = (header.flags & FrameRecordHeader::FLAG_FDP_AUTO_TUNE) != 0;
+    }
+    info_.delays.resize(header.delay_count);
+    for (auto& delay : info_.delays) {
+        file.read(reinterpret_cast<char*>(&delay.delay_integer), sizeof(delay.delay_integer));
+        file.read(reinterpret_cast<char*>(&delay.lagrange_row), sizeof(delay.lagrange_row));
+    }
+
+    // Число кадров — по длине файла: запись без Close() тоже читается
+    const size_t elements = GetFrameElements();
+    const uint64_t frame_bytes = elements * sizeof(std::complex<float>);
+    uint64_t count = (file_size - header.frames_offset) / (sizeof(FrameRecordEntry) + frame_bytes);
+    if (header.frame_count != 0) count = std::min<uint64_t>(count, header.frame_count);
+
+    timestamps_ns_.resize(count);
+    frames_.resize(count * elements);
+    file.seekg(static_cast<std::streamoff>(header.frames_offset));
+    for (size_t i = 0; i < count; ++i) {
+        FrameRecordEntry entry{};
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        file.read(reinterpret_cast<char*>(frames_.data() + i * elements), static_cast<std::streamsize>(frame_bytes));
+        timestamps_ns_[i] = entry.timestamp_ns;
+    }
+    if (!file) {
+        throw std::runtime_error("FrameRecording: read failed: " + path);
+    }
+}
+
+const std::complex<float>* FrameRecording::GetFrame(size_t index) const {
+    if (index >= GetFrameCount()) {
+        throw std::out_of_range("FrameRecording: frame " + std::to_string(index) + " of " +
+                                std::to_string(GetFrameCount()));
+    }
+    return frames_.data() + index * GetFrameElements();
+}
+
+uint64_t FrameRecording::GetFramePeriodNs() const {
+    if (info_.frame_period_ns != 0) return info_.frame_period_ns;
+    const size_t count = GetFrameCount();
+    if (count < 2) return 0;
+    return (timestamps_ns_.back() - timestamps_ns_.front()) / (count - 1);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Статистика
+// ════════════════════════════════════════════════════════════════════════════
+
+LatencySummary LatencySummary::From(std::vector<double> samples_ms) {
+    LatencySummary summary;
+    if (samples_ms.empty()) return summary;
+    std::sort(samples_ms.begin(), samples_ms.end());
+    const size_t n = samples_ms.size();
+    // Медиана и p99 (nearest-rank); этой же сводкой lch_bench считает этапы
+    size_t rank = static_cast<size_t>(std::ceil(0.99 * n));
+    rank = std::clamp<size_t>(rank, 1, n);
+    summary.min_ms = samples_ms.front();
+    summary.median_ms = (n % 2 == 1) ? samples_ms[n / 2] : 0.5 * (samples_ms[n / 2 - 1] + samples_ms[n / 2]);
+    summary.p99_ms = samples_ms[rank - 1];
+    summary.max_ms = samples_ms.back();
+    summary.mean_ms = std::accumulate(samples_ms.begin(), samples_ms.end(), 0.0) / samples_ms.size();
+    return summary;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// FrameReplayer
+// ════════════════════════════════════════════════════════════════════════════
+
+FrameReplayer::FrameReplayer(const FrameRecording& recording) : recording_(recording) {
+    if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+        throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+    }
+    if (recording_.GetFrameCount() == 0) {
+        throw std::invalid_argument("FrameReplayer: recording has no frames: " + recording_.GetPath());
+    }
+    engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+    queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    buffer_frame_ = engine_->CreateBuffer(recording_.GetFrameElements(), ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+}
+
+ReplayStats FrameReplayer::Run(const ReplayOptions& options, const FrameHandler& handler) {
+    if (options.queue_depth == 0 || options.loops == 0 || options.rate_hz < 0.0) {
+        throw std::invalid_argument("FrameReplayer: invalid ReplayOptions");
+    }
+    const size_t recorded = recording_.GetFrameCount();
+    const size_t total = recorded * options.loops;
+    const size_t frame_bytes = recording_.GetFrameElements() * sizeof(std::complex<float>);
+    cl_mem frame = buffer_frame_->Get();
+
+    auto process = [&](size_t index) {
+        cl_int err = clEnqueueWriteBuffer(queue_, frame, CL_TRUE, 0, frame_bytes,
+                                          recording_.GetFrame(index % recorded), 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("FrameReplayer: clEnqueueWriteBuffer failed: " + std::to_string(err));
+        }
+        handler(frame, index % recorded);
+    };
+
+    for (size_t i = 0; i < options.warmup; ++i) process(i);
+
+    // Момент прихода кадра k от начала воспроизведения; max speed — без расписания
+    const bool paced = options.recorded_timing || options.rate_hz > 0.0;
+    const uint64_t period_ns = recording_.GetFramePeriodNs();
+    const uint64_t span_ns = recording_.GetTimestampNs(recorded - 1) - recording_.GetTimestampNs(0) + period_ns;
+    auto arrival_ns = [&](size_t k) -> uint64_t {
+        if (options.recorded_timing) {
+            return (k / recorded) * span_ns + (recording_.GetTimestampNs(k % recorded) - recording_.GetTimestampNs(0));
+        }
+        return static_cast<uint64_t>(static_cast<double>(k) * 1e9 / options.rate_hz);
+    };
+
+    ReplayStats stats;
+    stats.frames_offered = total;
+    stats.latency_ms.reserve(total);
+    stats.service_ms.reserve(total);
+
+    const auto t0 = Clock::now();
+    size_t next = 0;
+    while (next < total) {
+        auto now = Clock::now();
+        Clock::time_point arrival = now;
+        if (paced) {
+            arrival = t0 + std::chrono::nanoseconds(arrival_ns(next));
+            if (arrival > now) {
+                std::this_thread::sleep_until(arrival);
+                now = Clock::now();
+            }
+            // Пришедшие, пока обработчик был занят: старше queue_depth последних — сброс
+            const uint64_t elapsed_ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count());
+            size_t arrived = next + 1;
+            while (arrived < total && arrival_ns(arrived) <= elapsed_ns) ++arrived;
+            if (arrived - next > options.queue_depth) {
+                const size_t dropped = arrived - next - options.queue_depth;
+                stats.frames_dropped += dropped;
+                next += dropped;
+                arrival = t0 + std::chrono::nanoseconds(arrival_ns(next));
+            }
+        }
+
+        const auto start = Clock::now();
+        process(next);
+        const auto end = Clock::now();
+        stats.latency_ms.push_back(ElapsedMs(arrival, end));
+        stats.service_ms.push_back(ElapsedMs(start, end));
+        ++stats.frames_processed;
+        ++next;
+    }
+
+    stats.wall_ms = ElapsedMs(t0, Clock::now());
+    if (stats.wall_ms > 0.0) {
+        stats.frames_per_sec = stats.frames_processed * 1000.0 / stats.wall_ms;
+        stats.samples_per_sec = stats.frames_per_sec * recording_.GetFrameElements();
+    }
+    stats.latency = LatencySummary::From(stats.latency_ms);
+    stats.service = LatencySummary::From(stats.service_ms);
+    return stats;
+}
+
+ReplayStats FrameReplayer::RunPipeline(const ReplayOptions& options, const radar::LagrangeMatrix* lagrange) {
+    const FrameRecordingInfo& info = recording_.GetInfo();
+    const bool has_fft = info.fft.IsValid();
+    if (!has_fft && !info.has_fdp) {
+        throw std::invalid_argument("FrameReplayer: recording has no pipeline parameters");
+    }
+    if (info.has_fdp && !lagrange) {
+        throw std::invalid_argument("FrameReplayer: recording needs LagrangeMatrix for FractionalDelayProcessor");
+    }
+
+    std::unique_ptr<radar::FractionalDelayProcessor> fdp;
+    std::vector<radar::DelayParams> delays = info.delays;
+    if (info.has_fdp) {
+        fdp = std::make_unique<radar::FractionalDelayProcessor>(info.fdp, *lagrange);
+        if (delays.empty()) delays.resize(info.beam_count);
+    }
+    std::unique_ptr<AntennaFFTProcMax> fft;
+    if (has_fft) fft = std::make_unique<AntennaFFTProcMax>(info.fft);
+
+    // Оба Process возвращают управление после clFinish своей очереди
+    return Run(options, [&](cl_mem frame, size_t) {
+        if (fdp) fdp->Process(frame, delays);
+        if (fft) fft->Process(frame);
+    });
+}
+
+} // namespace antenna_fft
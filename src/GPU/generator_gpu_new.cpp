@@ -5,6 +5,8 @@
 #include "ManagerOpenCL/kernel_program.hpp"
 #include "ManagerOpenCL/command_queue_pool.hpp"
 #include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
 
 // Параметры сигнала
 #include "interface/lfm_parameters.h"
@@ -36,7 +38,23 @@ namespace radar
   // ════════════════════════════════════════════════════════════════════════════
 
   GeneratorGPU::GeneratorGPU(const LFMParameters &params)
+      : GeneratorGPU(params, static_cast<const ManagerOpenCL::DeviceContext *>(nullptr))
+  {
+  }
+
+  GeneratorGPU::GeneratorGPU(const LFMParameters &params,
+                             const ManagerOpenCL::DeviceContext &device)
+      : GeneratorGPU(params, &device)
+  {
+  }
+
+  GeneratorGPU::GeneratorGPU(const LFMParameters &params,
+                             const ManagerOpenCL::DeviceContext *device)
       : engine_(nullptr),
+        context_(nullptr),
+        device_(nullptr),
+        queue_(nullptr),
+        device_program_(nullptr),
         params_(params),
         num_samples_(0),
         num_beams_(params.num_beams),
@@ -60,17 +78,34 @@ namespace radar
           "check f_start, f_stop, sample_rate, num_beams, duration/count_points");
     }
 
-    // ✅ Получить engine (ДОЛЖЕН быть инициализирован!)
-    try
+    if (device)
     {
-      engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+      // ✅ Режим нескольких устройств: контекст и очередь принадлежат DeviceGroup
+      if (!device->IsValid())
+      {
+        throw std::invalid_argument("[GeneratorGPU] invalid DeviceContext");
+      }
+      context_ = device->context;
+      device_ = device->device;
+      queue_ = device->queue;
     }
-    catch (const std::exception &e)
+    else
     {
-      throw std::runtime_error(
-          "[GeneratorGPU] OpenCLComputeEngine not initialized.\n"
-          "Call ManagerOpenCL::OpenCLCore::Initialize() → CommandQueuePool::Initialize() → "
-          "OpenCLComputeEngine::Initialize() before creating GeneratorGPU");
+      // ✅ Получить engine (ДОЛЖЕН быть инициализирован!)
+      try
+      {
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+      }
+      catch (const std::exception &e)
+      {
+        throw std::runtime_error(
+            "[GeneratorGPU] OpenCLComputeEngine not initialized.\n"
+            "Call ManagerOpenCL::OpenCLCore::Initialize() → CommandQueuePool::Initialize() → "
+            "OpenCLComputeEngine::Initialize() before creating GeneratorGPU");
+      }
+      auto &core = ManagerOpenCL::OpenCLCore::GetInstance();
+      context_ = core.GetContext();
+      device_ = core.GetDevice();
     }
 
     // ✅ Инициализировать (получить контекст из engine)
@@ -97,6 +132,17 @@ namespace radar
     // ✅ ВАЖНО: Ресурсы управляются OpenCLComputeEngine
     // Не вызываем clRelease* - engine сам управляет жизненным циклом
     // Просто обнуляем указатели
+    // (в режиме DeviceContext kernels и программа наши - освобождаем)
+    if (device_program_)
+    {
+      for (cl_kernel k : {kernel_lfm_basic_, kernel_lfm_delayed_, kernel_lfm_combined_, kernel_sinusoid_combined_})
+      {
+        if (k)
+          clReleaseKernel(k);
+      }
+      clReleaseProgram(device_program_);
+      device_program_ = nullptr;
+    }
 
     kernel_lfm_basic_ = nullptr;
     kernel_lfm_delayed_ = nullptr;
@@ -115,6 +161,10 @@ namespace radar
   // Move семантика
   GeneratorGPU::GeneratorGPU(GeneratorGPU &&other) noexcept
       : engine_(other.engine_),
+        context_(other.context_),
+        device_(other.device_),
+        queue_(other.queue_),
+        device_program_(other.device_program_),
         params_(other.params_),
         num_samples_(other.num_samples_),
         num_beams_(other.num_beams_),
@@ -131,6 +181,8 @@ namespace radar
   {
 
     other.engine_ = nullptr;
+    other.context_ = nullptr;
+    other.device_program_ = nullptr;
     other.kernel_lfm_basic_ = nullptr;
     other.kernel_lfm_delayed_ = nullptr;
     other.buffer_signal_base_.reset();
@@ -146,6 +198,15 @@ namespace radar
     if (this != &other)
     {
       // Очистить текущие ресурсы
+      if (device_program_)
+      {
+        for (cl_kernel k : {kernel_lfm_basic_, kernel_lfm_delayed_, kernel_lfm_combined_, kernel_sinusoid_combined_})
+        {
+          if (k)
+            clReleaseKernel(k);
+        }
+        clReleaseProgram(device_program_);
+      }
       kernel_lfm_basic_ = nullptr;
       kernel_lfm_delayed_ = nullptr;
       kernel_program_ = nullptr;
@@ -158,6 +219,10 @@ namespace radar
 
       // Переместить от other
       engine_ = other.engine_;
+      context_ = other.context_;
+      device_ = other.device_;
+      queue_ = other.queue_;
+      device_program_ = other.device_program_;
       params_ = other.params_;
       num_samples_ = other.num_samples_;
       num_beams_ = other.num_beams_;
@@ -174,6 +239,8 @@ namespace radar
 
       // Обнулить в other
       other.engine_ = nullptr;
+      other.context_ = nullptr;
+      other.device_program_ = nullptr;
       other.kernel_lfm_basic_ = nullptr;
       other.kernel_lfm_delayed_ = nullptr;
       other.buffer_signal_base_.reset();
@@ -218,6 +285,43 @@ namespace radar
     std::cout << "  - Total size: " << total_size_ << std::endl;
   }
 
+  std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> GeneratorGPU::CreateBuffer(
+      size_t num_elements, bool read_only)
+  {
+    auto type = read_only ? ManagerOpenCL::MemoryType::GPU_READ_ONLY
+                          : ManagerOpenCL::MemoryType::GPU_WRITE_ONLY;
+    if (engine_)
+    {
+      return engine_->CreateBuffer(num_elements, type);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(context_, queue_, num_elements, type);
+  }
+
+  template <typename T>
+  std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> GeneratorGPU::CreateTypedBuffer(
+      const std::vector<T> &data)
+  {
+    if (engine_)
+    {
+      return engine_->CreateTypedBufferWithData(data, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+    }
+    if (data.empty())
+    {
+      throw std::invalid_argument("[GeneratorGPU] CreateTypedBuffer: data vector is empty");
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+        context_, queue_,
+        static_cast<const void *>(data.data()),
+        data.size() * sizeof(T),
+        data.size(),
+        ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+  }
+
+  cl_command_queue GeneratorGPU::AcquireQueue() const
+  {
+    return queue_ ? queue_ : ManagerOpenCL::CommandQueuePool::GetNextQueue();
+  }
+
   void GeneratorGPU::LoadKernels()
   {
     // ✅ Получить исходный код
@@ -225,6 +329,47 @@ namespace radar
 
     std::cout << "[GeneratorGPU] Loading kernels from GPU engine..." << std::endl;
 
+    if (!engine_)
+    {
+      // ✅ Режим DeviceContext: кэш программ engine'а привязан к его контексту
+      const char *src_ptr = source.c_str();
+      size_t src_len = source.size();
+      cl_int err = CL_SUCCESS;
+      device_program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+      if (err != CL_SUCCESS)
+      {
+        throw std::runtime_error(
+            "[GeneratorGPU] clCreateProgramWithSource failed: " + std::to_string(err));
+      }
+
+      err = clBuildProgram(device_program_, 1, &device_, nullptr, nullptr, nullptr);
+      if (err != CL_SUCCESS)
+      {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(device_program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(device_program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        clReleaseProgram(device_program_);
+        device_program_ = nullptr;
+        throw std::runtime_error("[GeneratorGPU] clBuildProgram failed: " + std::to_string(err) + "\n" + log);
+      }
+
+      cl_kernel *kernels[] = {&kernel_lfm_basic_, &kernel_lfm_delayed_, &kernel_lfm_combined_, &kernel_sinusoid_combined_};
+      const char *names[] = {"kernel_lfm_basic", "kernel_lfm_delayed", "kernel_lfm_combined", "kernel_sinusoid_combined"};
+      for (size_t i = 0; i < 4; ++i)
+      {
+        *kernels[i] = clCreateKernel(device_program_, names[i], &err);
+        if (err != CL_SUCCESS)
+        {
+          throw std::runtime_error(
+              std::string("[GeneratorGPU] Failed to create ") + names[i] + ": " + std::to_string(err));
+        }
+      }
+
+      std::cout << "[GeneratorGPU] ✅ Kernels loaded successfully (device context)" << std::endl;
+      return;
+    }
+
     // ✅ Получить или скомпилировать программу (с кэшем!)
     kernel_program_ = engine_->LoadProgram(source);
     if (!kernel_program_)
@@ -547,8 +692,8 @@ __kernel void kernel_sinusoid_combined(
       throw std::invalid_argument("[GeneratorGPU] Invalid kernel or output_buffer");
     }
 
-    // ✅ Используем CommandQueuePool для получения очереди
-    cl_command_queue queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    // ✅ Очередь устройства либо следующая из CommandQueuePool
+    cl_command_queue queue = AcquireQueue();
 
     cl_int err = CL_SUCCESS;
 
@@ -633,7 +778,7 @@ __kernel void kernel_sinusoid_combined(
 
   cl_mem GeneratorGPU::signal_base()
   {
-    if (!engine_)
+    if (!context_)
     {
       throw std::runtime_error("[GeneratorGPU] OpenCLComputeEngine not initialized");
     }
@@ -646,7 +791,7 @@ __kernel void kernel_sinusoid_combined(
     std::cout << "[GeneratorGPU] Generating signal_base()..." << std::endl;
 
     // ✅ Создать GPU буфер через engine
-    auto output = engine_->CreateBuffer(total_size_, ManagerOpenCL::MemoryType::GPU_WRITE_ONLY);
+    auto output = CreateBuffer(total_size_, false);
 
     try
     {
@@ -673,7 +818,7 @@ __kernel void kernel_sinusoid_combined(
       size_t num_delay_params)
   {
 
-    if (!engine_)
+    if (!context_)
     {
       throw std::runtime_error("[GeneratorGPU] OpenCLComputeEngine not initialized");
     }
@@ -701,14 +846,13 @@ __kernel void kernel_sinusoid_combined(
     try
     {
       // ✅ Создать GPU буфер для параметров задержки
-      auto delay_gpu_buffer = engine_->CreateBufferWithData(
+      auto delay_gpu_buffer = CreateTypedBuffer(
           std::vector<std::complex<float>>(
               reinterpret_cast<const std::complex<float> *>(m_delay),
-              reinterpret_cast<const std::complex<float> *>(m_delay) + num_delay_params),
-          ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+              reinterpret_cast<const std::complex<float> *>(m_delay) + num_delay_params));
 
       // ✅ Создать GPU буфер для выходных данных
-      auto output = engine_->CreateBuffer(total_size_, ManagerOpenCL::MemoryType::GPU_WRITE_ONLY);
+      auto output = CreateBuffer(total_size_, false);
 
       // ✅ Выполнить kernel
       ExecuteKernel(kernel_lfm_delayed_, output->Get(), delay_gpu_buffer->Get());
@@ -731,7 +875,7 @@ __kernel void kernel_sinusoid_combined(
       const CombinedDelayParam* combined_delays,
       size_t num_delay_params) {
 
-      if (!engine_) {
+      if (!context_) {
           throw std::runtime_error("GeneratorGPU: Engine not initialized");
       }
       if (!kernel_lfm_combined_) {
@@ -757,16 +901,10 @@ __kernel void kernel_sinusoid_combined(
           );
 
           // ✅ Шаг 2: Загрузить на GPU через типобезопасный API
-          auto combined_gpu_buffer = engine_->CreateTypedBufferWithData(
-              combined_host,
-              ManagerOpenCL::MemoryType::GPU_READ_ONLY
-          );
+          auto combined_gpu_buffer = CreateTypedBuffer(combined_host);
 
           // ✅ Шаг 3: Создать выходной буфер
-          auto output = engine_->CreateBuffer(
-              total_size_,
-              ManagerOpenCL::MemoryType::GPU_WRITE_ONLY
-          );
+          auto output = CreateBuffer(total_size_, false);
 
           // ✅ Шаг 4: Выполнить kernel
           ExecuteKernel(
@@ -793,7 +931,7 @@ __kernel void kernel_sinusoid_combined(
       const SinusoidGenParams& params,
       const RaySinusoidMap& map_ray)
   {
-      if (!engine_) {
+      if (!context_) {
           throw std::runtime_error("[GeneratorGPU] OpenCLComputeEngine not initialized");
       }
 
@@ -871,26 +1009,20 @@ __kernel void kernel_sinusoid_combined(
           // ШАГ 2: Создать буфер параметров на GPU
           // ════════════════════════════════════════════════════════════════
           
-          auto params_buffer = engine_->CreateTypedBufferWithData(
-              ray_params_array,
-              ManagerOpenCL::MemoryType::GPU_READ_ONLY
-          );
+          auto params_buffer = CreateTypedBuffer(ray_params_array);
 
           // ════════════════════════════════════════════════════════════════
           // ШАГ 3: Создать выходной буфер
           // ════════════════════════════════════════════════════════════════
           
           size_t total_size = params.num_rays * params.count_points;
-          auto output = engine_->CreateBuffer(
-              total_size,
-              ManagerOpenCL::MemoryType::GPU_WRITE_ONLY
-          );
+          auto output = CreateBuffer(total_size, false);
 
           // ════════════════════════════════════════════════════════════════
           // ШАГ 4: Установить аргументы kernel
           // ════════════════════════════════════════════════════════════════
           
-          cl_command_queue queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+          cl_command_queue queue = AcquireQueue();
           cl_int err = CL_SUCCESS;
 
           cl_mem output_mem = output->Get();
@@ -979,7 +1111,7 @@ __kernel void kernel_sinusoid_combined(
 
   void GeneratorGPU::ClearGPU()
   {
-    if (!engine_)
+    if (!context_)
     {
       throw std::runtime_error("[GeneratorGPU] OpenCLComputeEngine not initialized");
     }
@@ -987,7 +1119,14 @@ __kernel void kernel_sinusoid_combined(
     std::cout << "[GeneratorGPU] Syncing GPU..." << std::endl;
 
     // ✅ Дождаться завершения всех операций
-    engine_->Finish();
+    if (engine_)
+    {
+      engine_->Finish();
+    }
+    else
+    {
+      clFinish(queue_);
+    }
 
     std::cout << "[GeneratorGPU] ✅ GPU synced" << std::endl;
   }
@@ -1042,7 +1181,7 @@ __kernel void kernel_sinusoid_combined(
     try
     {
       // ✅ Получить валидную очередь
-      cl_command_queue queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+      cl_command_queue queue = AcquireQueue();
       if (!queue)
       {
         std::cerr << "❌ GetSignalAsVector: Invalid command queue" << std::endl;
@@ -1115,8 +1254,6 @@ __kernel void kernel_sinusoid_combined(
 
     ClearGPU();
 
-    auto &core = ManagerOpenCL::OpenCLCore::GetInstance();
-
     // ✅ Проверка, что хотя бы один буфер создан
     ManagerOpenCL::GPUMemoryBuffer* active_buffer = nullptr;
     if (buffer_signal_sinusoid_ && buffer_signal_sinusoid_->Get())
@@ -1142,8 +1279,8 @@ __kernel void kernel_sinusoid_combined(
     }
 
     ManagerOpenCL::GPUMemoryBuffer buffer(
-        core.GetContext(),
-        ManagerOpenCL::CommandQueuePool::GetNextQueue(),
+        context_,
+        AcquireQueue(),
         active_buffer->Get(), // Получаем cl_mem из активного буфера
         total_size_,
         ManagerOpenCL::MemoryType::GPU_READ_ONLY);
@@ -1173,8 +1310,6 @@ __kernel void kernel_sinusoid_combined(
     // ШАГ 2: Получить engine и OpenCLCore
     // ════════════════════════════════════════════════════════════════════════
 
-    auto &core = ManagerOpenCL::OpenCLCore::GetInstance();
-
     // ════════════════════════════════════════════════════════════════════════
     // ШАГ 3: Обернуть raw cl_mem в GPUMemoryBuffer (NON-OWNING!)
     // ════════════════════════════════════════════════════════════════════════
@@ -1213,8 +1348,8 @@ __kernel void kernel_sinusoid_combined(
     try
     {
       ManagerOpenCL::GPUMemoryBuffer buffer(
-          core.GetContext(),                     // контекст OpenCL
-          ManagerOpenCL::CommandQueuePool::GetNextQueue(), // очередь для операции
+          context_,                     // контекст OpenCL
+          AcquireQueue(), // очередь для операции
           active_buffer->Get(),                  // cl_mem из активного буфера (НЕ удалится!)
           total_size_,                           // всего элементов (num_beams * num_samples)
           ManagerOpenCL::MemoryType::GPU_READ_ONLY         // тип: только чтение
@@ -1265,7 +1400,7 @@ cl_mem GeneratorGPU::signal_combined_delays(
         ManagerOpenCL::MemoryType::GPU_READ_ONLY
     );
     
-    auto output = engine_->CreateBuffer(total_size_, ManagerOpenCL::MemoryType::GPU_WRITE_ONLY);
+    auto output = CreateBuffer(total_size_, false);
     ExecuteKernel(kernel_lfm_combined_, output->Get(), combined_gpu_buffer->Get());
     
     buffer_signal_combined_ = std::move(output);
@@ -0,0 +1,441 @@
+#include "GPU/iq_frame_source.hpp"
+#include "GPU/layout_convert_kernel.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include "ManagerOpenCL/mapped_array_file.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace antenna_fft {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+IQFrameSource::IQFrameSource(const std::string& path, const IQFrameSourceConfig& config)
+    : IQFrameSource(path, config, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+IQFrameSource::IQFrameSource(const std::string& path, const IQFrameSourceConfig& config,
+                             const ManagerOpenCL::DeviceContext& device)
+    : IQFrameSource(path, config, &device) {
+}
+
+IQFrameSource::IQFrameSource(const std::string& path, const IQFrameSourceConfig& config,
+                             const ManagerOpenCL::DeviceContext* device)
+    : config_(config), path_(path) {
+    if (!config_.IsValid()) {
+        throw std::invalid_argument("IQFrameSourceConfig: invalid parameters");
+    }
+    frame_bytes_ = config_.GetFrameBytes();
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("IQFrameSource: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+
+    OpenFile(path);
+    try {
+        cl_int err = CL_SUCCESS;
+        transfer_queue_ = clCreateCommandQueue(context_, device_, CL_QUEUE_PROFILING_ENABLE, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("IQFrameSource: clCreateCommandQueue failed: " + std::to_string(err));
+        }
+        BuildKernels();
+        CreateRing();
+
+        const size_t channels = config_.channel_count;
+        if (engine_) {
+            buffer_channels_ = engine_->CreateBuffer(2 * channels, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+            buffer_frame_ = engine_->CreateBuffer(channels * config_.samples_per_frame,
+                                                  ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        } else {
+            buffer_channels_ = std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+                context_, queue_, 2 * channels, ManagerOpenCL::MemoryType::GPU_READ_ONLY);
+            buffer_frame_ = std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+                context_, queue_, channels * config_.samples_per_frame, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        }
+        SetChannelCorrection(config_.dc_offset, config_.gain);
+    } catch (...) {
+        ReleaseRing();
+        if (convert_kernel_) clReleaseKernel(convert_kernel_);
+        if (transpose_kernel_) clReleaseKernel(transpose_kernel_);
+        if (program_) clReleaseProgram(program_);
+        if (transfer_queue_) clReleaseCommandQueue(transfer_queue_);
+        CloseFile();
+        throw;
+    }
+}
+
+IQFrameSource::~IQFrameSource() {
+    Drain();
+    ReleaseRing();
+    if (convert_kernel_) clReleaseKernel(convert_kernel_);
+    if (transpose_kernel_) clReleaseKernel(transpose_kernel_);
+    if (program_) clReleaseProgram(program_);
+    if (transfer_queue_) clReleaseCommandQueue(transfer_queue_);
+    CloseFile();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Файл
+// ════════════════════════════════════════════════════════════════════════════
+
+void IQFrameSource::OpenFile(const std::string& path) {
+    // Заголовок контейнера читается отдельно: MappedArrayFile отображает и
+    // подкачивает весь файл, для записи в десятки ГБ это не нужно
+    uint64_t file_bytes = 0;
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            throw std::runtime_error("IQFrameSource: cannot open " + path);
+        }
+        file_bytes = static_cast<uint64_t>(in.tellg());
+    }
+
+    uint64_t data_bytes = 0;
+    if (ManagerOpenCL::MappedArrayFile::IsArrayFile(path)) {
+        ManagerOpenCL::BinaryArrayHeader header{};
+        std::ifstream in(path, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("IQFrameSource: cannot read header of " + path);
+        }
+        if (static_cast<ManagerOpenCL::ArrayDType>(header.dtype) != ManagerOpenCL::ArrayDType::ComplexInt16) {
+            throw std::invalid_argument("IQFrameSource: " + path + " holds " +
+                                        ManagerOpenCL::ArrayDTypeName(static_cast<ManagerOpenCL::ArrayDType>(header.dtype)) +
+                                        ", expected complex_int16");
+        }
+        if (header.payload_offset > file_bytes || header.payload_bytes > file_bytes - header.payload_offset) {
+            throw std::runtime_error("IQFrameSource: " + path + " is truncated");
+        }
+        const size_t last_dim = header.ndim > 0 && header.ndim <= ManagerOpenCL::BinaryArrayHeader::MAX_DIMS
+                                    ? static_cast<size_t>(header.shape[header.ndim - 1]) : 0;
+        if (config_.layout == InputLayout::SAMPLE_MAJOR && header.ndim >= 2 && last_dim != config_.channel_count) {
+            throw std::invalid_argument("IQFrameSource: " + path + " has " + std::to_string(last_dim) +
+                                        " channels, config " + std::to_string(config_.channel_count));
+        }
+        data_offset_ = header.payload_offset;
+        data_bytes = header.payload_bytes;
+    } else {
+        if (config_.header_bytes > file_bytes) {
+            throw std::runtime_error("IQFrameSource: " + path + " is shorter than header_bytes");
+        }
+        data_offset_ = config_.header_bytes;
+        data_bytes = file_bytes - config_.header_bytes;
+    }
+
+    // Неполный последний кадр отбрасывается
+    frame_count_ = static_cast<size_t>(data_bytes / frame_bytes_);
+    if (frame_count_ == 0) {
+        throw std::runtime_error("IQFrameSource: " + path + " holds less than one frame (" +
+                                 std::to_string(data_bytes) + " of " + std::to_string(frame_bytes_) + " bytes)");
+    }
+
+#ifdef _WIN32
+    file_.open(path, std::ios::binary);
+    if (!file_.is_open()) {
+        throw std::runtime_error("IQFrameSource: cannot open " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("IQFrameSource: cannot open " + path);
+    }
+    mapping_bytes_ = static_cast<size_t>(file_bytes);
+    void* mapping = ::mmap(nullptr, mapping_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping_bytes_ = 0;
+        throw std::runtime_error("IQFrameSource: mmap failed for " + path);
+    }
+    mapping_ = static_cast<const uint8_t*>(mapping);
+    // Чтение подряд: ядро подкачивает вперёд, без WILLNEED на весь файл
+    ::madvise(mapping, mapping_bytes_, MADV_SEQUENTIAL);
+#endif
+}
+
+void IQFrameSource::CloseFile() {
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(const_cast<uint8_t*>(mapping_), mapping_bytes_);
+    }
+#endif
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+    if (file_.is_open()) file_.close();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ресурсы устройства
+// ════════════════════════════════════════════════════════════════════════════
+
+void IQFrameSource::BuildKernels() {
+    cl_int err = CL_SUCCESS;
+    // Общее с AntennaFFTProcMax ядро разбора кадра (GPU/layout_convert_kernel.hpp)
+    const char* src_ptr = kLayoutConvertKernelSource;
+    size_t src_len = std::char_traits<char>::length(kLayoutConvertKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create IQ program: " + std::to_string(err));
+    }
+
+    err = clBuildProgram(program_, 1, &device_, "-DINPUT_INT16=1", nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "IQ kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build IQ program: " + std::to_string(err));
+    }
+
+    convert_kernel_ = clCreateKernel(program_, "layout_convert_rows", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create layout_convert_rows kernel: " + std::to_string(err));
+    }
+    transpose_kernel_ = clCreateKernel(program_, "layout_convert", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create layout_convert kernel: " + std::to_string(err));
+    }
+}
+
+void IQFrameSource::CreateRing() {
+    ring_.resize(config_.ring_size);
+    for (Slot& slot : ring_) {
+        cl_int err = CL_SUCCESS;
+        slot.pinned = clCreateBuffer(context_, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, frame_bytes_, nullptr, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("IQFrameSource: pinned clCreateBuffer failed: " + std::to_string(err));
+        }
+        slot.host = clEnqueueMapBuffer(transfer_queue_, slot.pinned, CL_TRUE, CL_MAP_WRITE, 0, frame_bytes_,
+                                       0, nullptr, nullptr, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("IQFrameSource: clEnqueueMapBuffer failed: " + std::to_string(err));
+        }
+        slot.raw = clCreateBuffer(context_, CL_MEM_READ_ONLY, frame_bytes_, nullptr, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("IQFrameSource: clCreateBuffer failed: " + std::to_string(err));
+        }
+    }
+}
+
+void IQFrameSource::ReleaseRing() {
+    for (Slot& slot : ring_) {
+        if (slot.upload) clReleaseEvent(slot.upload);
+        if (slot.convert) clReleaseEvent(slot.convert);
+        if (slot.host) clEnqueueUnmapMemObject(transfer_queue_, slot.pinned, slot.host, 0, nullptr, nullptr);
+    }
+    if (transfer_queue_) clFinish(transfer_queue_);
+    for (Slot& slot : ring_) {
+        if (slot.pinned) clReleaseMemObject(slot.pinned);
+        if (slot.raw) clReleaseMemObject(slot.raw);
+    }
+    ring_.clear();
+}
+
+void IQFrameSource::SetChannelCorrection(const std::vector<std::complex<float>>& dc_offset,
+                                         const std::vector<float>& gain) {
+    const size_t channels = config_.channel_count;
+    if ((!dc_offset.empty() && dc_offset.size() != channels) || (!gain.empty() && gain.size() != channels)) {
+        throw std::invalid_argument("IQFrameSource::SetChannelCorrection: expected " + std::to_string(channels) +
+                                    " values per channel");
+    }
+    config_.dc_offset = dc_offset;
+    config_.gain = gain;
+
+    // float4 на канал; общий масштаб — аргумент ядра (после коррекции)
+    std::vector<cl_float4> channel(channels);
+    for (size_t c = 0; c < channels; ++c) {
+        const std::complex<float> dc = dc_offset.empty() ? std::complex<float>(0.0f, 0.0f) : dc_offset[c];
+        const float g = gain.empty() ? 1.0f : gain[c];
+        channel[c] = {{dc.real(), dc.imag(), g, 0.0f}};
+    }
+    // Кадры в очереди могут читать старые значения: запись после них (та же in-order очередь)
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_channels_->Get(), CL_TRUE, 0, channels * sizeof(cl_float4),
+                                      channel.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (IQ channels) failed: " + std::to_string(err));
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Кадры
+// ════════════════════════════════════════════════════════════════════════════
+
+double IQFrameSource::EventMs(cl_event event) {
+    cl_ulong start = 0, end = 0;
+    if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) == CL_SUCCESS &&
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) == CL_SUCCESS &&
+        end >= start) {
+        return (end - start) * 1e-6;
+    }
+    return 0.0;
+}
+
+void IQFrameSource::Prefetch(size_t frame) {
+    Slot& slot = ring_[frame % ring_.size()];
+
+    // pinned буфер свободен только после окончания прошлой загрузки из него
+    // (обычно уже освобождена в NextFrame: слот переиспользуется после преобразования)
+    if (slot.upload) {
+        clWaitForEvents(1, &slot.upload);
+        clReleaseEvent(slot.upload);
+        slot.upload = nullptr;
+    }
+
+    auto t0 = Clock::now();
+    const uint64_t offset = data_offset_ + static_cast<uint64_t>(frame) * frame_bytes_;
+#ifdef _WIN32
+    file_.seekg(static_cast<std::streamoff>(offset));
+    if (!file_.read(static_cast<char*>(slot.host), static_cast<std::streamsize>(frame_bytes_))) {
+        throw std::runtime_error("IQFrameSource: read failed for frame " + std::to_string(frame) + " of " + path_);
+    }
+#else
+    std::memcpy(slot.host, mapping_ + offset, frame_bytes_);
+    // Прочитанные страницы больше не нужны: RSS не растёт с длиной записи
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t done = static_cast<size_t>(offset + frame_bytes_) / page * page;
+    if (done > released_bytes_) {
+        ::madvise(const_cast<uint8_t*>(mapping_) + released_bytes_, done - released_bytes_, MADV_DONTNEED);
+        released_bytes_ = done;
+    }
+#endif
+    stats_.host_copy_ms += ElapsedMs(t0);
+
+    // raw слота перезаписывается после преобразования прошлого кадра слота (другая очередь)
+    cl_uint wait_count = slot.convert ? 1 : 0;
+    cl_int err = clEnqueueWriteBuffer(transfer_queue_, slot.raw, CL_FALSE, 0, frame_bytes_, slot.host,
+                                      wait_count, slot.convert ? &slot.convert : nullptr, &slot.upload);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (IQ frame) failed: " + std::to_string(err));
+    }
+    if (slot.convert) {
+        clReleaseEvent(slot.convert);
+        slot.convert = nullptr;
+    }
+    clFlush(transfer_queue_);
+    stats_.bytes_uploaded += frame_bytes_;
+}
+
+bool IQFrameSource::NextFrame(cl_mem output) {
+    if (output == nullptr) {
+        throw std::invalid_argument("IQFrameSource::NextFrame: null output buffer");
+    }
+    if (next_frame_ >= frame_count_) return false;
+
+    // Кольцо заполнено вперёд на ring_size кадров (слот текущего кадра — первым)
+    const size_t end = std::min(frame_count_, next_frame_ + ring_.size());
+    while (prefetched_ < end) {
+        Prefetch(prefetched_++);
+    }
+
+    Slot& slot = ring_[next_frame_ % ring_.size()];
+    const cl_uint channels = static_cast<cl_uint>(config_.channel_count);
+    const cl_uint samples = static_cast<cl_uint>(config_.samples_per_frame);
+    cl_mem channel = buffer_channels_->Get();
+    const bool sample_major = config_.layout == InputLayout::SAMPLE_MAJOR;
+    cl_kernel kernel = sample_major ? transpose_kernel_ : convert_kernel_;
+    const cl_ulong beam_stride = sample_major ? 1 : samples;
+    const cl_ulong sample_stride = sample_major ? channels : 1;
+    cl_int err = SetLayoutConvertArgs(kernel, slot.raw, output, channels, samples, samples, 0, 0,
+                                      beam_stride, sample_stride, config_.scale, channel);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clSetKernelArg (IQ convert) failed: " + std::to_string(err));
+    }
+    // SAMPLE_MAJOR — тайлы TILE × TILE, BEAM_MAJOR — строки группами TILE²
+    const size_t wg = sample_major ? TILE : TILE * TILE;
+    size_t global[2] = {(samples + wg - 1) / wg * wg,
+                        sample_major ? (channels + TILE - 1) / TILE * TILE : channels};
+    size_t local[2] = {wg, sample_major ? TILE : 1};
+    err = clEnqueueNDRangeKernel(queue_, kernel, 2, nullptr, global, local, 1, &slot.upload, &slot.convert);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (IQ convert) failed: " + std::to_string(err));
+    }
+
+    auto t0 = Clock::now();
+    err = clWaitForEvents(1, &slot.convert);
+    stats_.wait_ms += ElapsedMs(t0);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("IQFrameSource: frame " + std::to_string(next_frame_) +
+                                 " conversion failed: " + std::to_string(err));
+    }
+    // Преобразование ждало загрузку — её событие завершено
+    stats_.upload_ms += EventMs(slot.upload);
+    stats_.convert_ms += EventMs(slot.convert);
+    clReleaseEvent(slot.upload);
+    slot.upload = nullptr;
+    ++stats_.frames;
+    ++next_frame_;
+    return true;
+}
+
+bool IQFrameSource::NextFrame() {
+    return NextFrame(buffer_frame_->Get());
+}
+
+cl_mem IQFrameSource::GetFrameBuffer() const {
+    return buffer_frame_->Get();
+}
+
+void IQFrameSource::Drain() {
+    if (transfer_queue_) clFinish(transfer_queue_);
+    if (queue_) clFinish(queue_);
+    for (Slot& slot : ring_) {
+        if (slot.upload) {
+            clReleaseEvent(slot.upload);
+            slot.upload = nullptr;
+        }
+        if (slot.convert) {
+            clReleaseEvent(slot.convert);
+            slot.convert = nullptr;
+        }
+    }
+}
+
+void IQFrameSource::Seek(size_t frame) {
+    if (frame > frame_count_) {
+        throw std::out_of_range("IQFrameSource::Seek: frame " + std::to_string(frame) + " of " +
+                                std::to_string(frame_count_));
+    }
+    // Загруженные вперёд кадры отбрасываются
+    Drain();
+    next_frame_ = frame;
+    prefetched_ = frame;
+    released_bytes_ = 0;
+}
+
+} // namespace antenna_fft
@@ -0,0 +1,103 @@
+#include "GPU/layout_convert_kernel.hpp"
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Ядра: input — кадр в раскладке (offset, beam_stride, sample_stride),
+// output — beam_count × row_length float2, channel — float4 на луч или NULL
+// ════════════════════════════════════════════════════════════════════════════
+
+const char* const kLayoutConvertKernelSource = R"CL(
+#define TILE 16
+
+#ifdef INPUT_INT16
+typedef short2 sample_t;
+#define TO_FLOAT2(v) convert_float2(v)
+#define APPLY_SCALE(v) ((v) * scale)
+#else
+typedef float2 sample_t;
+#define TO_FLOAT2(v) (v)
+#define APPLY_SCALE(v) (v)
+#endif
+
+inline float2 load_sample(__global const sample_t* input, __global const float4* channel,
+                          uint beam, uint pos, ulong offset, ulong beam_stride, ulong sample_stride,
+                          float scale) {
+    float2 v = TO_FLOAT2(input[offset + (ulong)beam * beam_stride + (ulong)pos * sample_stride]);
+    if (channel) {
+        float4 c = channel[beam];
+        v = (v - c.xy) * c.z;
+    }
+    return APPLY_SCALE(v);
+}
+
+// Тайл через local memory: при чтении соседние work-item'ы берут соседние
+// лучи (SAMPLE_MAJOR — подряд в памяти), при записи — соседние отсчёты строки.
+// +1 в строке тайла убирает конфликты банков.
+__kernel __attribute__((reqd_work_group_size(TILE, TILE, 1)))
+void layout_convert(__global const sample_t* input, __global float2* output,
+                    uint beam_count, uint count_points, uint row_length, uint beam_offset,
+                    ulong offset, ulong beam_stride, ulong sample_stride, float scale,
+                    __global const float4* channel) {
+    __local float2 tile[TILE][TILE + 1];
+
+    uint lx = get_local_id(0);
+    uint ly = get_local_id(1);
+    uint pos0 = get_group_id(0) * TILE;
+    uint beam0 = get_group_id(1) * TILE;
+
+    // Чтение: lx — луч, ly — отсчёт
+    uint beam = beam0 + lx;
+    uint pos = pos0 + ly;
+    float2 v = (float2)(0.0f, 0.0f);
+    if (beam < beam_count && pos < count_points) {
+        v = load_sample(input, channel, beam + beam_offset, pos, offset, beam_stride, sample_stride, scale);
+    }
+    tile[ly][lx] = v;
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Запись: lx — отсчёт, ly — луч (хвост pos >= count_points — нули)
+    beam = beam0 + ly;
+    pos = pos0 + lx;
+    if (beam < beam_count && pos < row_length) {
+        output[(size_t)beam * row_length + pos] = tile[lx][ly];
+    }
+}
+
+// Строки уже подряд (sample_stride == 1): чтение и запись подряд без тайла
+__kernel void layout_convert_rows(__global const sample_t* input, __global float2* output,
+                                  uint beam_count, uint count_points, uint row_length, uint beam_offset,
+                                  ulong offset, ulong beam_stride, ulong sample_stride, float scale,
+                                  __global const float4* channel) {
+    uint pos = get_global_id(0);
+    uint beam = get_global_id(1);
+    if (pos >= row_length || beam >= beam_count) return;
+    float2 v = (float2)(0.0f, 0.0f);
+    if (pos < count_points) {
+        v = load_sample(input, channel, beam + beam_offset, pos, offset, beam_stride, sample_stride, scale);
+    }
+    output[(size_t)beam * row_length + pos] = v;
+}
+)CL";
+
+cl_int SetLayoutConvertArgs(cl_kernel kernel, cl_mem input, cl_mem output,
+                            cl_uint beam_count, cl_uint count_points, cl_uint row_length,
+                            cl_uint beam_offset, cl_ulong offset, cl_ulong beam_stride,
+                            cl_ulong sample_stride, float scale, cl_mem channel) {
+    cl_int err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &output);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &beam_count);
+    err |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &count_points);
+    err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &row_length);
+    err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &beam_offset);
+    err |= clSetKernelArg(kernel, 6, sizeof(cl_ulong), &offset);
+    err |= clSetKernelArg(kernel, 7, sizeof(cl_ulong), &beam_stride);
+    err |= clSetKernelArg(kernel, 8, sizeof(cl_ulong), &sample_stride);
+    err |= clSetKernelArg(kernel, 9, sizeof(float), &scale);
+    // NULL буфер — аргумент-указатель NULL в ядре (без коррекции канала)
+    err |= clSetKernelArg(kernel, 10, sizeof(cl_mem), &channel);
+    return err;
+}
+
+} // namespace antenna_fft
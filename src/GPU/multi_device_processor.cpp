@@ -0,0 +1,346 @@
+#include "GPU/multi_device_processor.hpp"
+#include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "interface/DelayParameter.h"
+
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// ════════════════════════════════════════════════════════════════════════════
+// Общий запуск: один поток хоста на устройство с лучами
+// ════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Выполнить job(i) для каждого устройства с count > 0 параллельно
+ * @return Время выполнения на устройство (мс), 0 для устройств без лучей
+ * @throws Первое исключение, выброшенное любым job
+ */
+template <typename Job>
+std::vector<double> RunOnDevices(const std::vector<ManagerOpenCL::BeamRange>& ranges, Job job) {
+    std::vector<double> elapsed_ms(ranges.size(), 0.0);
+    std::vector<std::exception_ptr> errors(ranges.size());
+    std::vector<std::thread> threads;
+    threads.reserve(ranges.size());
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (ranges[i].count == 0) {
+            continue;
+        }
+        threads.emplace_back([&, i]() {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                job(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            elapsed_ms[i] = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+    return elapsed_ms;
+}
+
+bool SamePartition(const std::vector<ManagerOpenCL::BeamRange>& a,
+                   const std::vector<ManagerOpenCL::BeamRange>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].start != b[i].start || a[i].count != b[i].count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Загрузить срез хоста в новый буфер устройства
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> UploadSlice(
+    const ManagerOpenCL::DeviceContext& dc, const std::complex<float>* data, size_t num_elements) {
+    auto buffer = std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+        dc.context, dc.queue, num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    cl_int err = clEnqueueWriteBuffer(dc.queue, buffer->Get(), CL_FALSE, 0,
+                                      num_elements * sizeof(std::complex<float>), data,
+                                      0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (device " + std::to_string(dc.index) +
+                                 ") failed: " + std::to_string(err));
+    }
+    return buffer;
+}
+
+} // anonymous namespace
+
+namespace antenna_fft {
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceAntennaFFT
+// ════════════════════════════════════════════════════════════════════════════
+
+MultiDeviceAntennaFFT::MultiDeviceAntennaFFT(const AntennaFFTParams& params,
+                                             ManagerOpenCL::DeviceGroup& group)
+    : params_(params), group_(group) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("MultiDeviceAntennaFFT: invalid AntennaFFTParams");
+    }
+    if (group_.Size() == 0) {
+        throw std::invalid_argument("MultiDeviceAntennaFFT: empty DeviceGroup");
+    }
+    processors_.resize(group_.Size());
+    Repartition();
+}
+
+void MultiDeviceAntennaFFT::Repartition() {
+    auto ranges = group_.PartitionBeams(params_.beam_count);
+    if (SamePartition(ranges, ranges_)) {
+        return;
+    }
+    ranges_ = ranges;
+
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+        if (ranges_[i].count == 0) {
+            processors_[i].reset();
+            continue;
+        }
+        AntennaFFTParams device_params = params_;
+        device_params.beam_count = ranges_[i].count;
+        if (processors_[i]) {
+            processors_[i]->UpdateParams(device_params);
+        } else {
+            processors_[i] = std::make_unique<AntennaFFTProcMax>(device_params, group_.Get(i));
+        }
+    }
+}
+
+AntennaFFTResult MultiDeviceAntennaFFT::Process(const std::vector<std::complex<float>>& input_data) {
+    const size_t expected = params_.beam_count * params_.count_points;
+    if (input_data.size() != expected) {
+        throw std::invalid_argument("MultiDeviceAntennaFFT: input size mismatch. Expected: " +
+                                    std::to_string(expected) + ", got: " +
+                                    std::to_string(input_data.size()));
+    }
+
+    Repartition();
+
+    std::vector<AntennaFFTResult> partial(ranges_.size());
+    device_ms_ = RunOnDevices(ranges_, [&](size_t i) {
+        const auto& r = ranges_[i];
+        auto buffer = UploadSlice(group_.Get(i), input_data.data() + r.start * params_.count_points,
+                                  r.count * params_.count_points);
+        partial[i] = processors_[i]->Process(buffer->Get());
+    });
+
+    if (adaptive_) {
+        group_.UpdateWeights(ranges_, device_ms_);
+    }
+
+    // Объединение: диапазоны идут подряд, порядок лучей сохраняется
+    AntennaFFTResult result(params_.beam_count, 0, params_.task_id, params_.module_name);
+    for (auto& p : partial) {
+        if (result.nFFT == 0) {
+            result.nFFT = p.nFFT;
+        }
+        for (auto& beam : p.results) {
+            result.results.push_back(std::move(beam));
+        }
+    }
+    return result;
+}
+
+} // namespace antenna_fft
+
+namespace radar {
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceFractionalDelay
+// ════════════════════════════════════════════════════════════════════════════
+
+MultiDeviceFractionalDelay::MultiDeviceFractionalDelay(const FractionalDelayConfig& config,
+                                                       const LagrangeMatrix& lagrange_matrix,
+                                                       ManagerOpenCL::DeviceGroup& group)
+    : config_(config), lagrange_matrix_(lagrange_matrix), group_(group) {
+    if (!config_.IsValid()) {
+        throw std::invalid_argument("MultiDeviceFractionalDelay: invalid FractionalDelayConfig");
+    }
+    if (group_.Size() == 0) {
+        throw std::invalid_argument("MultiDeviceFractionalDelay: empty DeviceGroup");
+    }
+    processors_.resize(group_.Size());
+    Repartition();
+}
+
+void MultiDeviceFractionalDelay::Repartition() {
+    auto ranges = group_.PartitionBeams(config_.num_beams);
+    if (SamePartition(ranges, ranges_)) {
+        return;
+    }
+    ranges_ = ranges;
+
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+        if (ranges_[i].count == 0) {
+            processors_[i].reset();
+            continue;
+        }
+        FractionalDelayConfig device_config = config_;
+        device_config.num_beams = static_cast<uint32_t>(ranges_[i].count);
+        if (processors_[i]) {
+            processors_[i]->UpdateConfig(device_config);
+        } else {
+            processors_[i] = std::make_unique<FractionalDelayProcessor>(
+                device_config, lagrange_matrix_, group_.Get(i));
+        }
+    }
+}
+
+void MultiDeviceFractionalDelay::Process(std::vector<std::complex<float>>& data,
+                                         const std::vector<DelayParams>& delays) {
+    const size_t expected = static_cast<size_t>(config_.num_beams) * config_.num_samples;
+    if (data.size() != expected) {
+        throw std::invalid_argument("MultiDeviceFractionalDelay: data size mismatch. Expected: " +
+                                    std::to_string(expected) + ", got: " +
+                                    std::to_string(data.size()));
+    }
+    if (delays.size() != config_.num_beams) {
+        throw std::invalid_argument("MultiDeviceFractionalDelay: expected " +
+                                    std::to_string(config_.num_beams) + " delays, got " +
+                                    std::to_string(delays.size()));
+    }
+
+    Repartition();
+
+    device_ms_ = RunOnDevices(ranges_, [&](size_t i) {
+        const auto& r = ranges_[i];
+        const auto& dc = group_.Get(i);
+        std::complex<float>* slice = data.data() + r.start * config_.num_samples;
+        size_t slice_elements = r.count * config_.num_samples;
+
+        auto buffer = UploadSlice(dc, slice, slice_elements);
+        std::vector<DelayParams> slice_delays(delays.begin() + r.start,
+                                              delays.begin() + r.start + r.count);
+        processors_[i]->Process(buffer->Get(), slice_delays);
+
+        cl_int err = clEnqueueReadBuffer(dc.queue, buffer->Get(), CL_TRUE, 0,
+                                         slice_elements * sizeof(std::complex<float>), slice,
+                                         0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("clEnqueueReadBuffer (device " + std::to_string(i) +
+                                     ") failed: " + std::to_string(err));
+        }
+    });
+
+    if (adaptive_) {
+        group_.UpdateWeights(ranges_, device_ms_);
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// MultiDeviceGenerator
+// ════════════════════════════════════════════════════════════════════════════
+
+MultiDeviceGenerator::MultiDeviceGenerator(const LFMParameters& params,
+                                           ManagerOpenCL::DeviceGroup& group)
+    : params_(params), group_(group) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("MultiDeviceGenerator: invalid LFMParameters");
+    }
+    if (group_.Size() == 0) {
+        throw std::invalid_argument("MultiDeviceGenerator: empty DeviceGroup");
+    }
+    generators_.resize(group_.Size());
+    Repartition();
+}
+
+void MultiDeviceGenerator::Repartition() {
+    auto ranges = group_.PartitionBeams(params_.num_beams);
+    if (SamePartition(ranges, ranges_)) {
+        return;
+    }
+    ranges_ = ranges;
+
+    // GeneratorGPU не умеет менять num_beams — пересоздаём (ядра компилируются заново)
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+        generators_[i].reset();
+        if (ranges_[i].count == 0) {
+            continue;
+        }
+        LFMParameters device_params = params_;
+        device_params.num_beams = ranges_[i].count;
+        generators_[i] = std::make_unique<GeneratorGPU>(device_params, group_.Get(i));
+    }
+}
+
+std::vector<std::complex<float>> MultiDeviceGenerator::SignalBase() {
+    return Run(Kind::BASE, nullptr, nullptr);
+}
+
+std::vector<std::complex<float>> MultiDeviceGenerator::SignalDelayed(const DelayParameter* m_delay,
+                                                                     size_t num_delay_params) {
+    if (!m_delay || num_delay_params != params_.num_beams) {
+        throw std::invalid_argument("MultiDeviceGenerator::SignalDelayed: expected " +
+                                    std::to_string(params_.num_beams) + " delay parameters");
+    }
+    return Run(Kind::DELAYED, m_delay, nullptr);
+}
+
+std::vector<std::complex<float>> MultiDeviceGenerator::SignalCombinedDelays(
+    const CombinedDelayParam* combined_delays, size_t num_delay_params) {
+    if (!combined_delays || num_delay_params != params_.num_beams) {
+        throw std::invalid_argument("MultiDeviceGenerator::SignalCombinedDelays: expected " +
+                                    std::to_string(params_.num_beams) + " delay parameters");
+    }
+    return Run(Kind::COMBINED, nullptr, combined_delays);
+}
+
+std::vector<std::complex<float>> MultiDeviceGenerator::Run(Kind kind,
+                                                           const DelayParameter* delays,
+                                                           const CombinedDelayParam* combined) {
+    Repartition();
+
+    const size_t num_samples = params_.count_points;
+    std::vector<std::complex<float>> result(params_.num_beams * num_samples);
+
+    device_ms_ = RunOnDevices(ranges_, [&](size_t i) {
+        const auto& r = ranges_[i];
+        const auto& dc = group_.Get(i);
+        auto& gen = *generators_[i];
+        cl_mem signal = nullptr;
+        switch (kind) {
+            case Kind::BASE:
+                signal = gen.signal_base();
+                break;
+            case Kind::DELAYED:
+                signal = gen.signal_valedation(delays + r.start, r.count);
+                break;
+            case Kind::COMBINED:
+                signal = gen.signal_combined_delays(combined + r.start, r.count);
+                break;
+        }
+
+        // Чтение напрямую: GetSignalAsVectorAll() берёт "последний" буфер по приоритету типа
+        cl_int err = clEnqueueReadBuffer(dc.queue, signal, CL_TRUE, 0,
+                                         r.count * num_samples * sizeof(std::complex<float>),
+                                         result.data() + r.start * num_samples,
+                                         0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("MultiDeviceGenerator: clEnqueueReadBuffer (device " +
+                                     std::to_string(i) + ") failed: " + std::to_string(err));
+        }
+    });
+
+    if (adaptive_) {
+        group_.UpdateWeights(ranges_, device_ms_);
+    }
+    return result;
+}
+
+} // namespace radar
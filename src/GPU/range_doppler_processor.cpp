@@ -0,0 +1,588 @@
+#include "GPU/range_doppler_processor.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace antenna_fft {
+
+namespace {
+
+/// Пик на устройстве (32 байта, совпадает с RDPeakGPU в ядре)
+struct RDPeakGPU {
+    cl_uint range_bin;
+    cl_uint doppler_row;     ///< Строка карты (со сдвигом)
+    cl_float magnitude;
+    cl_float real;
+    cl_float imag;
+    cl_uint pad[3];
+};
+
+/// Размер __local массивов rd_top_n (RD_TOP_N_LOCAL) — верхняя граница его local size
+constexpr size_t kTopNMaxLocalSize = 256;
+
+size_t NextPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+const char* kRangeDopplerKernelSource = R"CL(
+typedef struct {
+    uint range_bin;
+    uint doppler_row;
+    float magnitude;
+    float real;
+    float imag;
+    uint pad[3];
+} RDPeakGPU;
+
+// Спектр (импульсы × лучи × nRange) → карта (лучи × nDoppler × out_range), fftshift по доплеру
+__kernel void rd_power_map(
+    __global const float2* spectrum,
+    __global float* map,
+    uint beam_count,
+    uint n_range,
+    uint n_doppler,
+    uint out_range
+) {
+    uint r = get_global_id(0);
+    uint d = get_global_id(1);
+    uint beam = get_global_id(2);
+    if (r >= out_range) return;
+
+    float2 v = spectrum[((size_t)d * beam_count + beam) * n_range + r];
+    uint row = (d + n_doppler / 2u) % n_doppler;
+    map[((size_t)beam * n_doppler + row) * out_range + r] = v.x * v.x + v.y * v.y;
+}
+
+#ifndef RD_TOP_N_LOCAL
+#define RD_TOP_N_LOCAL 256
+#endif
+
+// top-N по карте луча: максимум каждого потока → N лучших (как post_kernel)
+// local size <= RD_TOP_N_LOCAL
+__kernel void rd_top_n(
+    __global const float* map,
+    __global const float2* spectrum,
+    __global RDPeakGPU* peaks,
+    uint beam_count,
+    uint n_range,
+    uint n_doppler,
+    uint out_range,
+    uint max_peaks
+) {
+    uint beam = get_group_id(0);
+    uint lid = get_local_id(0);
+    uint lsize = get_local_size(0);
+
+    __local float local_val[RD_TOP_N_LOCAL];
+    __local uint local_idx[RD_TOP_N_LOCAL];
+
+    const uint cells = n_doppler * out_range;
+    __global const float* beam_map = map + (size_t)beam * cells;
+
+    float best = -1.0f;
+    uint best_idx = 0u;
+    for (uint i = lid; i < cells; i += lsize) {
+        float v = beam_map[i];
+        if (v > best) {
+            best = v;
+            best_idx = i;
+        }
+    }
+    local_val[lid] = best;
+    local_idx[lid] = best_idx;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (lid == 0u) {
+        for (uint peak = 0u; peak < max_peaks; ++peak) {
+            float top = -1.0f;
+            uint top_lid = 0u;
+            for (uint j = 0u; j < lsize; ++j) {
+                if (local_val[j] > top) {
+                    top = local_val[j];
+                    top_lid = j;
+                }
+            }
+
+            RDPeakGPU p;
+            uint idx = local_idx[top_lid];
+            p.doppler_row = idx / out_range;
+            p.range_bin = idx % out_range;
+            p.magnitude = top > 0.0f ? sqrt(top) : 0.0f;
+            uint d = (p.doppler_row + n_doppler - n_doppler / 2u) % n_doppler;
+            float2 c = spectrum[((size_t)d * beam_count + beam) * n_range + p.range_bin];
+            p.real = c.x;
+            p.imag = c.y;
+            p.pad[0] = 0u; p.pad[1] = 0u; p.pad[2] = 0u;
+            peaks[beam * max_peaks + peak] = p;
+
+            local_val[top_lid] = -1.0f;
+        }
+    }
+}
+)CL";
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+RangeDopplerProcessor::RangeDopplerProcessor(const RangeDopplerParams& params)
+    : RangeDopplerProcessor(params, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+RangeDopplerProcessor::RangeDopplerProcessor(const RangeDopplerParams& params,
+                                             const ManagerOpenCL::DeviceContext& device)
+    : RangeDopplerProcessor(params, &device) {
+}
+
+RangeDopplerProcessor::RangeDopplerProcessor(const RangeDopplerParams& params,
+                                             const ManagerOpenCL::DeviceContext* device)
+    : params_(params) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("RangeDopplerParams: invalid parameters");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("RangeDopplerProcessor: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+
+    n_range_ = NextPow2(params_.count_points);
+    n_doppler_ = NextPow2(params_.pulse_count);
+    out_range_ = params_.out_range_bins == 0 ? n_range_ : std::min(params_.out_range_bins, n_range_);
+
+    clfftSetupData fft_setup;
+    clfftInitSetupData(&fft_setup);
+    clfftStatus status = clfftSetup(&fft_setup);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftSetup failed with status: " + std::to_string(status));
+    }
+
+    const size_t cube_size = n_doppler_ * params_.beam_count * n_range_;
+    buffer_cube_ = CreateBuffer(cube_size);
+    buffer_work_ = CreateBuffer(cube_size);
+    const size_t map_floats = params_.beam_count * n_doppler_ * out_range_;
+    buffer_map_ = CreateBuffer((map_floats + 1) / 2);
+    const size_t peak_bytes = params_.beam_count * params_.max_peaks_count * sizeof(RDPeakGPU);
+    buffer_peaks_ = CreateBuffer((peak_bytes + sizeof(std::complex<float>) - 1) / sizeof(std::complex<float>));
+
+    // Хвосты дальности и лишние импульсы остаются нулями: SetPulse их не трогает
+    const cl_float2 zero = {{0.0f, 0.0f}};
+    cl_int err = clEnqueueFillBuffer(queue_, buffer_cube_->Get(), &zero, sizeof(zero), 0,
+                                     cube_size * sizeof(std::complex<float>), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to clear pulse cube: " + std::to_string(err));
+    }
+
+    CreatePlans();
+    BuildKernels();
+}
+
+RangeDopplerProcessor::~RangeDopplerProcessor() {
+    if (fast_plan_) clfftDestroyPlan(&fast_plan_);
+    if (slow_plan_) clfftDestroyPlan(&slow_plan_);
+    if (map_kernel_) clReleaseKernel(map_kernel_);
+    if (peaks_kernel_) clReleaseKernel(peaks_kernel_);
+    if (program_) clReleaseProgram(program_);
+}
+
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> RangeDopplerProcessor::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+        context_, queue_, num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Планы clFFT и ядра
+// ════════════════════════════════════════════════════════════════════════════
+
+void RangeDopplerProcessor::CreatePlans() {
+    const size_t beams = params_.beam_count;
+
+    // fast-time: строки дальности подряд, [pulse][beam][range]
+    size_t fast_len[1] = {n_range_};
+    clfftStatus status = clfftCreateDefaultPlan(&fast_plan_, context_, CLFFT_1D, fast_len);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftCreateDefaultPlan (fast-time) failed: " + std::to_string(status));
+    }
+    size_t fast_strides[1] = {1};
+    clfftSetPlanPrecision(fast_plan_, CLFFT_SINGLE);
+    clfftSetLayout(fast_plan_, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
+    clfftSetResultLocation(fast_plan_, CLFFT_OUTOFPLACE);
+    clfftSetPlanBatchSize(fast_plan_, n_doppler_ * beams);
+    clfftSetPlanInStride(fast_plan_, CLFFT_1D, fast_strides);
+    clfftSetPlanOutStride(fast_plan_, CLFFT_1D, fast_strides);
+    clfftSetPlanDistance(fast_plan_, n_range_, n_range_);
+    status = clfftBakePlan(fast_plan_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftBakePlan (fast-time) failed: " + std::to_string(status));
+    }
+
+    // slow-time: ячейка (beam, range) — столбец с шагом beams·nRange; соседние столбцы через 1
+    size_t slow_len[1] = {n_doppler_};
+    status = clfftCreateDefaultPlan(&slow_plan_, context_, CLFFT_1D, slow_len);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftCreateDefaultPlan (slow-time) failed: " + std::to_string(status));
+    }
+    size_t slow_strides[1] = {beams * n_range_};
+    clfftSetPlanPrecision(slow_plan_, CLFFT_SINGLE);
+    clfftSetLayout(slow_plan_, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
+    clfftSetResultLocation(slow_plan_, CLFFT_INPLACE);
+    clfftSetPlanBatchSize(slow_plan_, beams * n_range_);
+    clfftSetPlanInStride(slow_plan_, CLFFT_1D, slow_strides);
+    clfftSetPlanOutStride(slow_plan_, CLFFT_1D, slow_strides);
+    clfftSetPlanDistance(slow_plan_, 1, 1);
+    status = clfftBakePlan(slow_plan_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftBakePlan (slow-time) failed: " + std::to_string(status));
+    }
+}
+
+void RangeDopplerProcessor::BuildKernels() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kRangeDopplerKernelSource;
+    size_t src_len = std::char_traits<char>::length(kRangeDopplerKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create range-Doppler program: " + std::to_string(err));
+    }
+    const std::string options = "-D RD_TOP_N_LOCAL=" + std::to_string(kTopNMaxLocalSize);
+    err = clBuildProgram(program_, 1, &device_, options.c_str(), nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "Range-Doppler kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build range-Doppler program: " + std::to_string(err));
+    }
+
+    map_kernel_ = clCreateKernel(program_, "rd_power_map", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create rd_power_map kernel: " + std::to_string(err));
+    }
+    peaks_kernel_ = clCreateKernel(program_, "rd_top_n", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create rd_top_n kernel: " + std::to_string(err));
+    }
+
+    // local size rd_top_n: не больше RD_TOP_N_LOCAL, предела устройства и предела ядра
+    size_t limit = kTopNMaxLocalSize;
+    size_t device_wg = 0;
+    if (clGetDeviceInfo(device_, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(device_wg), &device_wg, nullptr) == CL_SUCCESS &&
+        device_wg > 0) {
+        limit = std::min(limit, device_wg);
+    }
+    size_t kernel_wg = 0;
+    if (clGetKernelWorkGroupInfo(peaks_kernel_, device_, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(kernel_wg), &kernel_wg, nullptr) == CL_SUCCESS && kernel_wg > 0) {
+        limit = std::min(limit, kernel_wg);
+    }
+    peaks_local_size_ = kTopNMaxLocalSize;
+    while (peaks_local_size_ > limit) peaks_local_size_ >>= 1;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Загрузка импульсов
+// ════════════════════════════════════════════════════════════════════════════
+
+void RangeDopplerProcessor::SetPulse(size_t pulse_index, cl_mem snapshot) {
+    if (pulse_index >= params_.pulse_count) {
+        throw std::out_of_range("RangeDopplerProcessor::SetPulse: pulse_index " +
+                                std::to_string(pulse_index) + " >= " + std::to_string(params_.pulse_count));
+    }
+    if (!snapshot) {
+        throw std::invalid_argument("RangeDopplerProcessor::SetPulse: snapshot is null");
+    }
+
+    // beam_count строк по count_points → строки куба по nRange (хвост остаётся нулём)
+    const size_t elem = sizeof(std::complex<float>);
+    size_t src_origin[3] = {0, 0, 0};
+    size_t dst_origin[3] = {0, pulse_index * params_.beam_count, 0};
+    size_t region[3] = {params_.count_points * elem, params_.beam_count, 1};
+    cl_int err = clEnqueueCopyBufferRect(queue_, snapshot, buffer_cube_->Get(),
+                                         src_origin, dst_origin, region,
+                                         params_.count_points * elem, 0,
+                                         n_range_ * elem, 0,
+                                         0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueCopyBufferRect (pulse) failed: " + std::to_string(err));
+    }
+    computed_ = false;
+}
+
+void RangeDopplerProcessor::SetPulse(size_t pulse_index, const std::vector<std::complex<float>>& snapshot) {
+    const size_t expected = params_.beam_count * params_.count_points;
+    if (snapshot.size() != expected) {
+        throw std::invalid_argument("Pulse size mismatch. Expected: " + std::to_string(expected) +
+                                    ", got: " + std::to_string(snapshot.size()));
+    }
+    if (pulse_index >= params_.pulse_count) {
+        throw std::out_of_range("RangeDopplerProcessor::SetPulse: pulse_index " +
+                                std::to_string(pulse_index) + " >= " + std::to_string(params_.pulse_count));
+    }
+
+    const size_t elem = sizeof(std::complex<float>);
+    size_t buffer_origin[3] = {0, pulse_index * params_.beam_count, 0};
+    size_t host_origin[3] = {0, 0, 0};
+    size_t region[3] = {params_.count_points * elem, params_.beam_count, 1};
+    cl_int err = clEnqueueWriteBufferRect(queue_, buffer_cube_->Get(), CL_TRUE,
+                                          buffer_origin, host_origin, region,
+                                          n_range_ * elem, 0,
+                                          params_.count_points * elem, 0,
+                                          snapshot.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBufferRect (pulse) failed: " + std::to_string(err));
+    }
+    computed_ = false;
+}
+
+void RangeDopplerProcessor::SetCube(const std::vector<std::complex<float>>& pulses) {
+    const size_t expected = params_.pulse_count * params_.beam_count * params_.count_points;
+    if (pulses.size() != expected) {
+        throw std::invalid_argument("Cube size mismatch. Expected: " + std::to_string(expected) +
+                                    ", got: " + std::to_string(pulses.size()));
+    }
+
+    // Одна rect-запись: все импульсы × лучи — строки по count_points
+    const size_t elem = sizeof(std::complex<float>);
+    size_t buffer_origin[3] = {0, 0, 0};
+    size_t host_origin[3] = {0, 0, 0};
+    size_t region[3] = {params_.count_points * elem, params_.pulse_count * params_.beam_count, 1};
+    cl_int err = clEnqueueWriteBufferRect(queue_, buffer_cube_->Get(), CL_TRUE,
+                                          buffer_origin, host_origin, region,
+                                          n_range_ * elem, 0,
+                                          params_.count_points * elem, 0,
+                                          pulses.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBufferRect (cube) failed: " + std::to_string(err));
+    }
+    computed_ = false;
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Обработка
+// ════════════════════════════════════════════════════════════════════════════
+
+double RangeDopplerProcessor::EventMs(cl_event event) const {
+    cl_ulong start = 0, end = 0;
+    if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr) != CL_SUCCESS ||
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr) != CL_SUCCESS ||
+        end < start) {
+        return 0.0;
+    }
+    return (end - start) * 1e-6;
+}
+
+int RangeDopplerProcessor::DopplerBin(size_t shifted_row) const {
+    return static_cast<int>(shifted_row) - static_cast<int>(n_doppler_ / 2);
+}
+
+void RangeDopplerProcessor::Compute() {
+    cl_mem cube = buffer_cube_->Get();
+    cl_mem work = buffer_work_->Get();
+    cl_mem map = buffer_map_->Get();
+
+    cl_event event_fast = nullptr;
+    clfftStatus status = clfftEnqueueTransform(fast_plan_, CLFFT_FORWARD, 1, &queue_,
+                                               0, nullptr, &event_fast, &cube, &work, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftEnqueueTransform (fast-time) failed: " + std::to_string(status));
+    }
+
+    cl_event event_slow = nullptr;
+    status = clfftEnqueueTransform(slow_plan_, CLFFT_FORWARD, 1, &queue_,
+                                   1, &event_fast, &event_slow, &work, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        clReleaseEvent(event_fast);
+        throw std::runtime_error("clfftEnqueueTransform (slow-time) failed: " + std::to_string(status));
+    }
+
+    cl_uint beams = static_cast<cl_uint>(params_.beam_count);
+    cl_uint n_range = static_cast<cl_uint>(n_range_);
+    cl_uint n_doppler = static_cast<cl_uint>(n_doppler_);
+    cl_uint out_range = static_cast<cl_uint>(out_range_);
+    cl_int err = clSetKernelArg(map_kernel_, 0, sizeof(cl_mem), &work);
+    err |= clSetKernelArg(map_kernel_, 1, sizeof(cl_mem), &map);
+    err |= clSetKernelArg(map_kernel_, 2, sizeof(cl_uint), &beams);
+    err |= clSetKernelArg(map_kernel_, 3, sizeof(cl_uint), &n_range);
+    err |= clSetKernelArg(map_kernel_, 4, sizeof(cl_uint), &n_doppler);
+    err |= clSetKernelArg(map_kernel_, 5, sizeof(cl_uint), &out_range);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_fast);
+        clReleaseEvent(event_slow);
+        throw std::runtime_error("Failed to set rd_power_map args: " + std::to_string(err));
+    }
+
+    size_t global[3] = {((out_range_ + 63) / 64) * 64, n_doppler_, params_.beam_count};
+    size_t local[3] = {64, 1, 1};
+    cl_event event_map = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, map_kernel_, 3, nullptr, global, local,
+                                 1, &event_slow, &event_map);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_fast);
+        clReleaseEvent(event_slow);
+        throw std::runtime_error("clEnqueueNDRangeKernel (rd_power_map) failed: " + std::to_string(err));
+    }
+
+    clWaitForEvents(1, &event_map);
+    last_fast_ms_ = EventMs(event_fast);
+    last_slow_ms_ = EventMs(event_slow);
+    last_map_ms_ = EventMs(event_map);
+    clReleaseEvent(event_fast);
+    clReleaseEvent(event_slow);
+    clReleaseEvent(event_map);
+    computed_ = true;
+}
+
+RangeDopplerResult RangeDopplerProcessor::FindPeaks() {
+    if (!computed_) {
+        throw std::runtime_error("RangeDopplerProcessor::FindPeaks: call Compute() first");
+    }
+
+    cl_mem map = buffer_map_->Get();
+    cl_mem work = buffer_work_->Get();
+    cl_mem peaks = buffer_peaks_->Get();
+    cl_uint beams = static_cast<cl_uint>(params_.beam_count);
+    cl_uint n_range = static_cast<cl_uint>(n_range_);
+    cl_uint n_doppler = static_cast<cl_uint>(n_doppler_);
+    cl_uint out_range = static_cast<cl_uint>(out_range_);
+    cl_uint max_peaks = static_cast<cl_uint>(params_.max_peaks_count);
+
+    cl_int err = clSetKernelArg(peaks_kernel_, 0, sizeof(cl_mem), &map);
+    err |= clSetKernelArg(peaks_kernel_, 1, sizeof(cl_mem), &work);
+    err |= clSetKernelArg(peaks_kernel_, 2, sizeof(cl_mem), &peaks);
+    err |= clSetKernelArg(peaks_kernel_, 3, sizeof(cl_uint), &beams);
+    err |= clSetKernelArg(peaks_kernel_, 4, sizeof(cl_uint), &n_range);
+    err |= clSetKernelArg(peaks_kernel_, 5, sizeof(cl_uint), &n_doppler);
+    err |= clSetKernelArg(peaks_kernel_, 6, sizeof(cl_uint), &out_range);
+    err |= clSetKernelArg(peaks_kernel_, 7, sizeof(cl_uint), &max_peaks);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to set rd_top_n args: " + std::to_string(err));
+    }
+
+    size_t local = peaks_local_size_;
+    size_t global = params_.beam_count * local;
+    cl_event event_peaks = nullptr;
+    err = clEnqueueNDRangeKernel(queue_, peaks_kernel_, 1, nullptr, &global, &local, 0, nullptr, &event_peaks);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueNDRangeKernel (rd_top_n) failed: " + std::to_string(err));
+    }
+
+    std::vector<RDPeakGPU> raw(params_.beam_count * params_.max_peaks_count);
+    err = clEnqueueReadBuffer(queue_, peaks, CL_TRUE, 0, raw.size() * sizeof(RDPeakGPU), raw.data(),
+                              1, &event_peaks, nullptr);
+    if (err != CL_SUCCESS) {
+        clReleaseEvent(event_peaks);
+        throw std::runtime_error("clEnqueueReadBuffer (peaks) failed: " + std::to_string(err));
+    }
+
+    RangeDopplerResult result;
+    result.n_range = n_range_;
+    result.n_doppler = n_doppler_;
+    result.fast_time_ms = last_fast_ms_;
+    result.slow_time_ms = last_slow_ms_;
+    result.map_ms = last_map_ms_;
+    result.search_ms = EventMs(event_peaks);
+    clReleaseEvent(event_peaks);
+
+    const float doppler_step = params_.pulse_repetition_frequency / static_cast<float>(n_doppler_);
+    result.peaks.resize(params_.beam_count);
+    for (size_t beam = 0; beam < params_.beam_count; ++beam) {
+        for (size_t i = 0; i < params_.max_peaks_count; ++i) {
+            const RDPeakGPU& p = raw[beam * params_.max_peaks_count + i];
+            RangeDopplerPeak peak;
+            peak.range_bin = p.range_bin;
+            peak.doppler_bin = DopplerBin(p.doppler_row);
+            peak.doppler_hz = peak.doppler_bin * doppler_step;
+            peak.magnitude = p.magnitude;
+            peak.real = p.real;
+            peak.imag = p.imag;
+            peak.phase = std::atan2(p.imag, p.real) * 57.2957795131f;
+            result.peaks[beam].push_back(peak);
+        }
+    }
+    return result;
+}
+
+RangeDopplerCFARResult RangeDopplerProcessor::DetectCFAR(const CFARParams& cfar) {
+    if (!computed_) {
+        throw std::runtime_error("RangeDopplerProcessor::DetectCFAR: call Compute() first");
+    }
+    if (!cfar_) {
+        ManagerOpenCL::DeviceContext dc;
+        dc.context = context_;
+        dc.device = device_;
+        dc.queue = queue_;
+        cfar_ = std::make_unique<CFARDetector>(cfar, dc);
+    } else {
+        cfar_->SetParams(cfar);
+    }
+
+    // Каждая доплеровская строка карты — отдельная линия CFAR по дальности
+    CFARResult lines = cfar_->Detect(buffer_map_->Get(), params_.beam_count * n_doppler_, out_range_);
+
+    RangeDopplerCFARResult result;
+    result.kernel_time_ms = lines.kernel_time_ms;
+    result.beams.resize(params_.beam_count);
+    for (size_t line = 0; line < lines.beams.size(); ++line) {
+        const size_t beam = line / n_doppler_;
+        const size_t row = line % n_doppler_;
+        result.dropped += lines.beams[line].total_count - lines.beams[line].detections.size();
+        for (const auto& d : lines.beams[line].detections) {
+            RangeDopplerDetection det;
+            det.range_bin = d.index;
+            det.doppler_bin = DopplerBin(row);
+            det.power = d.value;
+            det.noise = d.noise;
+            result.beams[beam].push_back(det);
+        }
+    }
+    return result;
+}
+
+RangeDopplerResult RangeDopplerProcessor::Process() {
+    Compute();
+    return FindPeaks();
+}
+
+std::vector<float> RangeDopplerProcessor::ReadPowerMap() {
+    if (!computed_) {
+        throw std::runtime_error("RangeDopplerProcessor::ReadPowerMap: call Compute() first");
+    }
+    std::vector<float> map(params_.beam_count * n_doppler_ * out_range_);
+    cl_int err = clEnqueueReadBuffer(queue_, buffer_map_->Get(), CL_TRUE, 0, map.size() * sizeof(float),
+                                     map.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (power map) failed: " + std::to_string(err));
+    }
+    return map;
+}
+
+cl_mem RangeDopplerProcessor::GetPowerMapBuffer() const {
+    return buffer_map_->Get();
+}
+
+} // namespace antenna_fft
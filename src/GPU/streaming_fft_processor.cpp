@@ -0,0 +1,410 @@
+#include "GPU/streaming_fft_processor.hpp"
+#include "ManagerOpenCL/opencl_core.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace antenna_fft {
+
+namespace {
+
+size_t NextPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+const char* kStreamingKernelSource = R"CL(
+// product[b][k] = spectrum[b][k] * H[k]
+__kernel void stream_multiply(
+    __global const float2* spectrum,
+    __global const float2* filter,
+    __global float2* product,
+    uint fft_size,
+    uint total
+) {
+    uint gid = get_global_id(0);
+    if (gid >= total) return;
+
+    float2 x = spectrum[gid];
+    float2 h = filter[gid % fft_size];
+    product[gid] = (float2)(x.x * h.x - x.y * h.y, x.x * h.y + x.y * h.x);
+}
+
+// Overlap-add: выход = y[0..L) + хвост, новый хвост = y[L..N) + хвост сдвинутый на L
+__kernel void stream_overlap_add(
+    __global const float2* time,      // beam × N (результат IFFT)
+    __global const float2* tail_in,   // beam × T
+    __global float2* tail_out,        // beam × T
+    __global float2* output,          // beam × L
+    uint block_size,
+    uint fft_size,
+    uint overlap
+) {
+    uint i = get_global_id(0);
+    uint beam = get_global_id(1);
+    __global const float2* y = time + (size_t)beam * fft_size;
+    __global const float2* t_in = tail_in + (size_t)beam * overlap;
+
+    if (i < block_size) {
+        float2 v = y[i];
+        if (i < overlap) v += t_in[i];
+        output[(size_t)beam * block_size + i] = v;
+    }
+    if (i < overlap) {
+        float2 v = y[block_size + i];
+        if (i + block_size < overlap) v += t_in[i + block_size];
+        tail_out[(size_t)beam * overlap + i] = v;
+    }
+}
+)CL";
+
+} // anonymous namespace
+
+// ════════════════════════════════════════════════════════════════════════════
+// Конструкторы
+// ════════════════════════════════════════════════════════════════════════════
+
+StreamingFFTProcessor::StreamingFFTProcessor(const StreamingFFTParams& params)
+    : StreamingFFTProcessor(params, static_cast<const ManagerOpenCL::DeviceContext*>(nullptr)) {
+}
+
+StreamingFFTProcessor::StreamingFFTProcessor(const StreamingFFTParams& params,
+                                             const ManagerOpenCL::DeviceContext& device)
+    : StreamingFFTProcessor(params, &device) {
+}
+
+StreamingFFTProcessor::StreamingFFTProcessor(const StreamingFFTParams& params,
+                                             const ManagerOpenCL::DeviceContext* device)
+    : params_(params) {
+    if (!params_.IsValid()) {
+        throw std::invalid_argument("StreamingFFTParams: invalid parameters");
+    }
+
+    if (device) {
+        if (!device->IsValid()) {
+            throw std::invalid_argument("StreamingFFTProcessor: invalid DeviceContext");
+        }
+        context_ = device->context;
+        device_ = device->device;
+        queue_ = device->queue;
+    } else {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            throw std::runtime_error("OpenCLComputeEngine not initialized. Call Initialize() first.");
+        }
+        engine_ = &ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        auto& core = ManagerOpenCL::OpenCLCore::GetInstance();
+        context_ = core.GetContext();
+        device_ = core.GetDevice();
+        queue_ = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+    }
+
+    fft_size_ = params_.fft_size != 0 ? params_.fft_size
+                                      : NextPow2(params_.block_size + params_.filter_length - 1);
+    overlap_ = fft_size_ - params_.block_size;
+
+    clfftSetupData fft_setup;
+    clfftInitSetupData(&fft_setup);
+    clfftStatus status = clfftSetup(&fft_setup);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftSetup failed with status: " + std::to_string(status));
+    }
+
+    const size_t frame_size = params_.beam_count * fft_size_;
+    buffer_frame_ = CreateBuffer(frame_size);
+    buffer_spectrum_ = CreateBuffer(frame_size);
+    buffer_product_ = CreateBuffer(frame_size);
+    buffer_filter_ = CreateBuffer(fft_size_);
+    const size_t overlap_size = std::max<size_t>(params_.beam_count * overlap_, 1);
+    buffer_overlap_[0] = CreateBuffer(overlap_size);
+    if (params_.method == StreamingMethod::OVERLAP_ADD) {
+        buffer_overlap_[1] = CreateBuffer(overlap_size);
+    }
+
+    CreatePlan();
+    BuildKernels();
+
+    // H = 1 до SetFilter
+    SetFilter({std::complex<float>(1.0f, 0.0f)});
+    Reset();
+}
+
+StreamingFFTProcessor::~StreamingFFTProcessor() {
+    if (plan_) clfftDestroyPlan(&plan_);
+    if (multiply_kernel_) clReleaseKernel(multiply_kernel_);
+    if (accumulate_kernel_) clReleaseKernel(accumulate_kernel_);
+    if (program_) clReleaseProgram(program_);
+}
+
+std::unique_ptr<ManagerOpenCL::GPUMemoryBuffer> StreamingFFTProcessor::CreateBuffer(size_t num_elements) {
+    if (engine_) {
+        return engine_->CreateBuffer(num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+    }
+    return std::make_unique<ManagerOpenCL::GPUMemoryBuffer>(
+        context_, queue_, num_elements, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// План clFFT и ядра
+// ════════════════════════════════════════════════════════════════════════════
+
+void StreamingFFTProcessor::CreatePlan() {
+    size_t lengths[1] = {fft_size_};
+    clfftStatus status = clfftCreateDefaultPlan(&plan_, context_, CLFFT_1D, lengths);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftCreateDefaultPlan (streaming) failed: " + std::to_string(status));
+    }
+
+    size_t strides[1] = {1};
+    clfftSetPlanPrecision(plan_, CLFFT_SINGLE);
+    clfftSetLayout(plan_, CLFFT_COMPLEX_INTERLEAVED, CLFFT_COMPLEX_INTERLEAVED);
+    clfftSetResultLocation(plan_, CLFFT_OUTOFPLACE);
+    clfftSetPlanBatchSize(plan_, params_.beam_count);
+    clfftSetPlanInStride(plan_, CLFFT_1D, strides);
+    clfftSetPlanOutStride(plan_, CLFFT_1D, strides);
+    clfftSetPlanDistance(plan_, fft_size_, fft_size_);
+
+    status = clfftBakePlan(plan_, 1, &queue_, nullptr, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftBakePlan (streaming) failed: " + std::to_string(status));
+    }
+}
+
+void StreamingFFTProcessor::BuildKernels() {
+    cl_int err = CL_SUCCESS;
+    const char* src_ptr = kStreamingKernelSource;
+    size_t src_len = std::char_traits<char>::length(kStreamingKernelSource);
+
+    program_ = clCreateProgramWithSource(context_, 1, &src_ptr, &src_len, &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create streaming program: " + std::to_string(err));
+    }
+    err = clBuildProgram(program_, 1, &device_, nullptr, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        clGetProgramBuildInfo(program_, device_, CL_PROGRAM_BUILD_LOG, log_size, &log[0], nullptr);
+        std::cerr << "Streaming kernel build error:\n" << log << "\n";
+        throw std::runtime_error("Failed to build streaming program: " + std::to_string(err));
+    }
+
+    multiply_kernel_ = clCreateKernel(program_, "stream_multiply", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create stream_multiply kernel: " + std::to_string(err));
+    }
+    accumulate_kernel_ = clCreateKernel(program_, "stream_overlap_add", &err);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("Failed to create stream_overlap_add kernel: " + std::to_string(err));
+    }
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Фильтр и состояние
+// ════════════════════════════════════════════════════════════════════════════
+
+void StreamingFFTProcessor::SetFilter(const std::vector<std::complex<float>>& impulse_response) {
+    if (impulse_response.empty() || impulse_response.size() > params_.filter_length) {
+        throw std::invalid_argument("StreamingFFTProcessor::SetFilter: length must be 1.." +
+                                    std::to_string(params_.filter_length) + ", got " +
+                                    std::to_string(impulse_response.size()));
+    }
+
+    // H[k] = Σ h[m] e^{-j2πkm/N}; фильтр задаётся редко, прямое ДПФ на хосте
+    std::vector<std::complex<float>> spectrum(fft_size_);
+    for (size_t k = 0; k < fft_size_; ++k) {
+        std::complex<double> acc(0.0, 0.0);
+        for (size_t m = 0; m < impulse_response.size(); ++m) {
+            double angle = -2.0 * M_PI * static_cast<double>((k * m) % fft_size_) / fft_size_;
+            acc += std::complex<double>(impulse_response[m]) * std::polar(1.0, angle);
+        }
+        spectrum[k] = std::complex<float>(acc);
+    }
+
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_filter_->Get(), CL_TRUE, 0,
+                                      fft_size_ * sizeof(std::complex<float>), spectrum.data(),
+                                      0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (filter) failed: " + std::to_string(err));
+    }
+}
+
+void StreamingFFTProcessor::Reset() {
+    const cl_float2 zero = {{0.0f, 0.0f}};
+    for (auto& buffer : buffer_overlap_) {
+        if (!buffer) continue;
+        cl_int err = clEnqueueFillBuffer(queue_, buffer->Get(), &zero, sizeof(zero), 0,
+                                         buffer->GetNumElements() * sizeof(std::complex<float>),
+                                         0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Failed to clear streaming overlap: " + std::to_string(err));
+        }
+    }
+    clFinish(queue_);
+    overlap_index_ = 0;
+    samples_processed_ = 0;
+}
+
+cl_mem StreamingFFTProcessor::GetBlockSpectrum() const {
+    return buffer_spectrum_->Get();
+}
+
+// ════════════════════════════════════════════════════════════════════════════
+// Обработка блока
+// ════════════════════════════════════════════════════════════════════════════
+
+void StreamingFFTProcessor::CopyRows(cl_mem src, size_t src_offset, size_t src_pitch,
+                                     cl_mem dst, size_t dst_offset, size_t dst_pitch,
+                                     size_t row_elements) {
+    if (row_elements == 0) {
+        return;
+    }
+    const size_t elem = sizeof(std::complex<float>);
+    size_t src_origin[3] = {src_offset * elem, 0, 0};
+    size_t dst_origin[3] = {dst_offset * elem, 0, 0};
+    size_t region[3] = {row_elements * elem, params_.beam_count, 1};
+    cl_int err = clEnqueueCopyBufferRect(queue_, src, dst, src_origin, dst_origin, region,
+                                         src_pitch * elem, 0, dst_pitch * elem, 0,
+                                         0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueCopyBufferRect (streaming) failed: " + std::to_string(err));
+    }
+}
+
+void StreamingFFTProcessor::ProcessBlock(cl_mem input, cl_mem output) {
+    if (!input) {
+        throw std::invalid_argument("StreamingFFTProcessor::ProcessBlock: input is null");
+    }
+    if (!output && params_.method == StreamingMethod::OVERLAP_ADD) {
+        // Хвост OA копится из выхода IFFT — без него следующий блок будет неверным
+        throw std::invalid_argument("StreamingFFTProcessor: OVERLAP_ADD needs an output buffer");
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    const size_t L = params_.block_size;
+    const size_t N = fft_size_;
+    const size_t T = overlap_;
+    cl_mem frame = buffer_frame_->Get();
+    cl_mem spectrum = buffer_spectrum_->Get();
+    cl_mem product = buffer_product_->Get();
+    const bool overlap_save = params_.method == StreamingMethod::OVERLAP_SAVE;
+
+    // ─── Кадр ───
+    if (overlap_save) {
+        cl_mem history = buffer_overlap_[0]->Get();
+        CopyRows(history, 0, T, frame, 0, N, T);
+        CopyRows(input, 0, L, frame, T, N, L);
+        // История следующего блока: последние T отсчётов кадра
+        CopyRows(frame, L, N, history, 0, T, T);
+    } else {
+        const cl_float2 zero = {{0.0f, 0.0f}};
+        cl_int err = clEnqueueFillBuffer(queue_, frame, &zero, sizeof(zero), 0,
+                                         params_.beam_count * N * sizeof(std::complex<float>),
+                                         0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Failed to clear streaming frame: " + std::to_string(err));
+        }
+        CopyRows(input, 0, L, frame, 0, N, L);
+    }
+
+    // ─── Спектр кадра ───
+    clfftStatus status = clfftEnqueueTransform(plan_, CLFFT_FORWARD, 1, &queue_, 0, nullptr, nullptr,
+                                               &frame, &spectrum, nullptr);
+    if (status != CLFFT_SUCCESS) {
+        throw std::runtime_error("clfftEnqueueTransform (streaming forward) failed: " + std::to_string(status));
+    }
+
+    if (output) {
+        // ─── × H → IFFT (в кадр) ───
+        cl_mem filter = buffer_filter_->Get();
+        cl_uint fft_size = static_cast<cl_uint>(N);
+        cl_uint total = static_cast<cl_uint>(params_.beam_count * N);
+        cl_int err = clSetKernelArg(multiply_kernel_, 0, sizeof(cl_mem), &spectrum);
+        err |= clSetKernelArg(multiply_kernel_, 1, sizeof(cl_mem), &filter);
+        err |= clSetKernelArg(multiply_kernel_, 2, sizeof(cl_mem), &product);
+        err |= clSetKernelArg(multiply_kernel_, 3, sizeof(cl_uint), &fft_size);
+        err |= clSetKernelArg(multiply_kernel_, 4, sizeof(cl_uint), &total);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Failed to set stream_multiply args: " + std::to_string(err));
+        }
+        size_t local = 256;
+        size_t global = ((params_.beam_count * N + local - 1) / local) * local;
+        err = clEnqueueNDRangeKernel(queue_, multiply_kernel_, 1, nullptr, &global, &local, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("clEnqueueNDRangeKernel (stream_multiply) failed: " + std::to_string(err));
+        }
+
+        status = clfftEnqueueTransform(plan_, CLFFT_BACKWARD, 1, &queue_, 0, nullptr, nullptr,
+                                       &product, &frame, nullptr);
+        if (status != CLFFT_SUCCESS) {
+            throw std::runtime_error("clfftEnqueueTransform (streaming inverse) failed: " + std::to_string(status));
+        }
+
+        // ─── Выход ───
+        if (overlap_save) {
+            CopyRows(frame, T, N, output, 0, L, L);
+        } else {
+            cl_mem tail_in = buffer_overlap_[overlap_index_]->Get();
+            cl_mem tail_out = buffer_overlap_[1 - overlap_index_]->Get();
+            cl_uint block = static_cast<cl_uint>(L);
+            cl_uint overlap = static_cast<cl_uint>(T);
+            err = clSetKernelArg(accumulate_kernel_, 0, sizeof(cl_mem), &frame);
+            err |= clSetKernelArg(accumulate_kernel_, 1, sizeof(cl_mem), &tail_in);
+            err |= clSetKernelArg(accumulate_kernel_, 2, sizeof(cl_mem), &tail_out);
+            err |= clSetKernelArg(accumulate_kernel_, 3, sizeof(cl_mem), &output);
+            err |= clSetKernelArg(accumulate_kernel_, 4, sizeof(cl_uint), &block);
+            err |= clSetKernelArg(accumulate_kernel_, 5, sizeof(cl_uint), &fft_size);
+            err |= clSetKernelArg(accumulate_kernel_, 6, sizeof(cl_uint), &overlap);
+            if (err != CL_SUCCESS) {
+                throw std::runtime_error("Failed to set stream_overlap_add args: " + std::to_string(err));
+            }
+            size_t local_2d[2] = {64, 1};
+            size_t global_2d[2] = {((std::max(L, T) + 63) / 64) * 64, params_.beam_count};
+            err = clEnqueueNDRangeKernel(queue_, accumulate_kernel_, 2, nullptr, global_2d, local_2d,
+                                         0, nullptr, nullptr);
+            if (err != CL_SUCCESS) {
+                throw std::runtime_error("clEnqueueNDRangeKernel (stream_overlap_add) failed: " + std::to_string(err));
+            }
+            overlap_index_ = 1 - overlap_index_;
+        }
+    }
+
+    clFinish(queue_);
+    samples_processed_ += L;
+    last_block_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<std::complex<float>> StreamingFFTProcessor::ProcessBlock(const std::vector<std::complex<float>>& input) {
+    const size_t expected = params_.beam_count * params_.block_size;
+    if (input.size() != expected) {
+        throw std::invalid_argument("Block size mismatch. Expected: " + std::to_string(expected) +
+                                    ", got: " + std::to_string(input.size()));
+    }
+    if (!buffer_io_) {
+        buffer_io_ = CreateBuffer(expected);
+    }
+
+    cl_int err = clEnqueueWriteBuffer(queue_, buffer_io_->Get(), CL_FALSE, 0,
+                                      expected * sizeof(std::complex<float>), input.data(),
+                                      0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueWriteBuffer (block) failed: " + std::to_string(err));
+    }
+
+    // Вход копируется в кадр до записи выхода (in-order очередь) — один буфер на оба
+    ProcessBlock(buffer_io_->Get(), buffer_io_->Get());
+
+    std::vector<std::complex<float>> output(expected);
+    err = clEnqueueReadBuffer(queue_, buffer_io_->Get(), CL_TRUE, 0,
+                              expected * sizeof(std::complex<float>), output.data(),
+                              0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer (block) failed: " + std::to_string(err));
+    }
+    return output;
+}
+
+} // namespace antenna_fft
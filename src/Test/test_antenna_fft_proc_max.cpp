@@ -1,11 +1,20 @@
 #include "Test/test_antenna_fft_proc_max.hpp"
 #include "GPU/antenna_fft_proc_max.h"
+#include "GPU/beamformer.hpp"
 #include "GPU/fft_result_printer.hpp"  // Новый класс для вывода
+#include "GPU/fractional_delay_processor.hpp"
 #include "GPU/generator_gpu_new.h"
 #include "interface/lfm_parameters.h"
 #include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
 
 namespace test_antenna_fft_proc_max {
 
@@ -411,6 +420,799 @@ void test_process_new_large() {
     }
 }
 
+void test_pulse_compression() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 8: Pulse compression (matched filter)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        
+        const size_t NUM_BEAMS = 4;
+        const size_t COUNT_POINTS = 4096;
+        const size_t PULSE_POINTS = 512;
+        
+        // Опорный импульс: 512 отсчётов, 0.1..2 МГц при 12 МГц
+        LFMParameters pulse;
+        pulse.f_start = 1.0e5f;
+        pulse.f_stop = 2.0e6f;
+        pulse.sample_rate = 12.0e6f;
+        pulse.num_beams = NUM_BEAMS;
+        pulse.count_points = PULSE_POINTS;
+        if (!pulse.IsValid()) {
+            throw std::runtime_error("invalid LFM parameters");
+        }
+        
+        // Вход: импульс с задержкой 100 + 300·beam отсчётов, вне импульса — нули
+        const double chirp_rate = (pulse.f_stop - pulse.f_start) / pulse.duration;
+        std::vector<std::complex<float>> input(NUM_BEAMS * COUNT_POINTS, {0.0f, 0.0f});
+        std::vector<size_t> delays;
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            size_t delay = 100 + 300 * beam;
+            delays.push_back(delay);
+            for (size_t n = 0; n < PULSE_POINTS; ++n) {
+                double t = static_cast<double>(n) / pulse.sample_rate;
+                double phase = 2.0 * M_PI * (pulse.f_start * t + 0.5 * chirp_rate * t * t);
+                input[beam * COUNT_POINTS + delay + n] = {static_cast<float>(std::cos(phase)),
+                                                          static_cast<float>(std::sin(phase))};
+            }
+        }
+        
+        // Поиск по первым 2048 отсчётам дальности
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 2048, 3,
+                                             "test_pulse_compression", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        processor.SetPulseCompressionReference(pulse);
+        
+        auto result = processor.ProcessPulseCompression(input);
+        
+        bool all_ok = true;
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            const auto& peaks = result.results[beam].max_values;
+            size_t found = peaks.empty() ? 0 : peaks[0].index_point;
+            float amplitude = peaks.empty() ? 0.0f : peaks[0].amplitude;
+            bool ok = !peaks.empty() && found == delays[beam];
+            printf("  beam %zu: delay %4zu → peak %4zu, |y| = %.1f (≈%zu) %s\n",
+                   beam, delays[beam], found, amplitude, PULSE_POINTS, ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+        
+        std::cout << processor.GetProfilingStats() << "\n";
+        
+        // Повторный вызов использует кэшированный спектр опоры
+        auto result2 = processor.ProcessPulseCompression(input);
+        all_ok = all_ok && !result2.results[0].max_values.empty() &&
+                 result2.results[0].max_values[0].index_point == delays[0];
+        
+        if (!all_ok) {
+            throw std::runtime_error("compressed peaks do not match delays");
+        }
+        std::cout << "\n✅ Test 8 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 8 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_zoom_refinement() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 9: Zoom-DTFT refinement of coarse maxima\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        
+        const size_t NUM_BEAMS = 3;
+        const size_t COUNT_POINTS = 1000;
+        
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 512, 3,
+                                             "test_zoom_refinement", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        const double nfft = static_cast<double>(processor.GetNFFT());
+        
+        // Тон луча между бинами: 100.37, 150.81, 201.5 бина nFFT, фаза 30°·(beam + 1)
+        std::vector<double> true_bins = {100.37, 150.81, 201.5};
+        std::vector<double> true_phases;
+        std::vector<std::complex<float>> input(NUM_BEAMS * COUNT_POINTS);
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            double phase0 = 30.0 * (beam + 1) * M_PI / 180.0;
+            true_phases.push_back(phase0);
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                double arg = 2.0 * M_PI * true_bins[beam] * n / nfft + phase0;
+                input[beam * COUNT_POINTS + n] = {static_cast<float>(std::cos(arg)),
+                                                  static_cast<float>(std::sin(arg))};
+            }
+        }
+        
+        auto coarse = processor.Process(input);
+        
+        antenna_fft::ZoomFFTParams zoom;
+        zoom.zoom_factor = 32;
+        zoom.span_bins = 1.0f;
+        zoom.index_mode = antenna_fft::ZoomIndexMode::FFT_BIN;
+        auto refined = processor.RefinePeaks(input, coarse, zoom);
+        
+        printf("  nFFT = %zu, %zu points per peak, kernel %.3f ms\n",
+               processor.GetNFFT(), refined.points_per_peak, refined.kernel_time_ms);
+        
+        bool all_ok = refined.beams.size() == NUM_BEAMS;
+        for (size_t beam = 0; all_ok && beam < NUM_BEAMS; ++beam) {
+            if (refined.beams[beam].empty()) {
+                all_ok = false;
+                break;
+            }
+            const auto& peak = refined.beams[beam][0];
+            double bin_err = std::fabs(peak.refined_bin - true_bins[beam]);
+            // Фаза тона в точке сетки: отстаёт от φ0 на π·Δ·(N-1)/nFFT, Δ <= 1/(2·zoom)
+            double phase_err = std::fabs(std::remainder(peak.phase * M_PI / 180.0 - true_phases[beam],
+                                                        2.0 * M_PI)) * 180.0 / M_PI;
+            bool ok = bin_err < 0.01 && phase_err < 5.0 &&
+                      std::fabs(peak.amplitude - COUNT_POINTS) < 0.01 * COUNT_POINTS;
+            printf("  Beam %zu: coarse %zu → %.4f (true %.2f, err %.4f), phase err %.2f°, |X| = %.1f %s\n",
+                   beam, peak.coarse_index, peak.refined_bin, true_bins[beam], bin_err,
+                   phase_err, peak.amplitude, ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+        
+        if (!all_ok) {
+            throw std::runtime_error("zoom refinement mismatch");
+        }
+        std::cout << "\n✅ Test 9 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 9 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_sparse_spectrum() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 10: Sparse spectrum output (threshold + compaction)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        
+        const size_t NUM_BEAMS = 4;
+        const size_t COUNT_POINTS = 512;    // nFFT = 1024
+        
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 1024, 3,
+                                             "test_sparse_spectrum", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        const size_t nfft = processor.GetNFFT();
+        
+        // Луч b: тоны на чётных бинах (без утечки на чётные соседи) 40 + 100·b и 600 - 50·b
+        std::vector<std::set<size_t>> expected(NUM_BEAMS);
+        std::vector<std::complex<float>> input(NUM_BEAMS * COUNT_POINTS, {0.0f, 0.0f});
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            for (size_t bin : {40 + 100 * beam, 600 - 50 * beam}) {
+                expected[beam].insert(bin);
+                for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                    double arg = 2.0 * M_PI * bin * n / nfft;
+                    input[beam * COUNT_POINTS + n] += std::complex<float>(
+                        static_cast<float>(std::cos(arg)), static_cast<float>(std::sin(arg)));
+                }
+            }
+        }
+        
+        // Тон: |X| = COUNT_POINTS в своём бине, боковые (нечётный сдвиг) <= 2N/π ≈ 0.64·N
+        antenna_fft::SparseSpectrumParams sparse;
+        sparse.threshold = 0.8f * COUNT_POINTS;
+        auto result = processor.ProcessSparse(input, sparse);
+        
+        bool all_ok = !result.Overflowed() && result.num_bins == std::min<size_t>(1024, nfft);
+        std::vector<std::set<size_t>> found(NUM_BEAMS);
+        for (const auto& e : result.entries) {
+            found[e.beam].insert(e.bin);
+            all_ok = all_ok && std::fabs(e.magnitude - COUNT_POINTS) < 0.01f * COUNT_POINTS;
+        }
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            bool ok = found[beam] == expected[beam];
+            printf("  Beam %zu: %zu bins above threshold %s\n", beam, found[beam].size(), ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+        printf("  Global threshold: %zu entries of %zu bins, kernel %.3f ms\n",
+               result.total_count, NUM_BEAMS * result.num_bins, result.kernel_time_ms);
+        
+        // Порог на луч: луч 1 выше своих тонов → пуст
+        sparse.beam_thresholds.assign(NUM_BEAMS, 0.8f * COUNT_POINTS);
+        sparse.beam_thresholds[1] = 2.0f * COUNT_POINTS;
+        auto per_beam = processor.ProcessSparse(input, sparse);
+        bool beam_ok = per_beam.total_count == 2 * (NUM_BEAMS - 1);
+        for (const auto& e : per_beam.entries) beam_ok = beam_ok && e.beam != 1;
+        printf("  Per-beam threshold (beam 1 muted): %zu entries %s\n", per_beam.total_count, beam_ok ? "✅" : "❌");
+        all_ok = all_ok && beam_ok;
+        
+        // Переполнение: порог ниже нуля → все бины, ёмкость 100
+        antenna_fft::SparseSpectrumParams all_bins;
+        all_bins.threshold = -1.0f;
+        all_bins.max_entries = 100;
+        auto overflow = processor.ProcessSparse(input, all_bins);
+        bool overflow_ok = overflow.Overflowed() && overflow.entries.size() == 100 &&
+                           overflow.total_count == NUM_BEAMS * overflow.num_bins;
+        printf("  Overflow: %zu stored of %zu %s\n", overflow.entries.size(), overflow.total_count,
+               overflow_ok ? "✅" : "❌");
+        all_ok = all_ok && overflow_ok;
+        
+        if (!all_ok) {
+            throw std::runtime_error("sparse spectrum mismatch");
+        }
+        std::cout << "\n✅ Test 10 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 10 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_real_input() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 11: Real input (R2C FFT + Hermitian window)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        
+        const size_t NUM_BEAMS = 4;
+        const size_t COUNT_POINTS = 1000;   // nFFT = 2048
+        
+        // Окно out = nFFT/2: в режиме бинов FFT — только положительные частоты (без зеркальных двойников)
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 1024, 3,
+                                             "test_real_input", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        const double nfft = static_cast<double>(processor.GetNFFT());
+        
+        // Луч b: cos на 50.3 + 30·b бина (фаза 20°·b) + 0.5·cos на 200 + 10·b бина
+        std::vector<float> real_input(NUM_BEAMS * COUNT_POINTS);
+        std::vector<std::complex<float>> complex_input(NUM_BEAMS * COUNT_POINTS);
+        std::vector<size_t> main_bins;
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            double k1 = 50.3 + 30.0 * beam;
+            double k2 = 200.0 + 10.0 * beam;
+            double phase = 20.0 * beam * M_PI / 180.0;
+            main_bins.push_back(static_cast<size_t>(std::lround(k1)));
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                double v = std::cos(2.0 * M_PI * k1 * n / nfft + phase) +
+                           0.5 * std::cos(2.0 * M_PI * k2 * n / nfft);
+                real_input[beam * COUNT_POINTS + n] = static_cast<float>(v);
+                complex_input[beam * COUNT_POINTS + n] = {static_cast<float>(v), 0.0f};
+            }
+        }
+        
+        // Эталон — комплексный путь на расширенных до float2 данных
+        auto reference = processor.Process(complex_input);
+        double complex_ms = processor.GetLastProfilingResults().fft_time_ms;
+        auto real = processor.ProcessReal(real_input);
+        double real_ms = processor.GetLastProfilingResults().fft_time_ms;
+        
+        bool all_ok = real.results.size() == NUM_BEAMS && reference.results.size() == NUM_BEAMS;
+        for (size_t beam = 0; all_ok && beam < NUM_BEAMS; ++beam) {
+            const auto& r = real.results[beam];
+            const auto& c = reference.results[beam];
+            bool ok = r.max_values.size() == c.max_values.size() && !r.max_values.empty() &&
+                      r.max_values[0].index_point == main_bins[beam];
+            for (size_t i = 0; ok && i < r.max_values.size(); ++i) {
+                ok = r.max_values[i].index_point == c.max_values[i].index_point &&
+                     std::fabs(r.max_values[i].amplitude - c.max_values[i].amplitude) <
+                         1e-3f * c.max_values[i].amplitude &&
+                     std::fabs(std::remainder(r.max_values[i].phase - c.max_values[i].phase, 360.0f)) < 0.5f;
+            }
+            ok = ok && std::fabs(r.refined_frequency - c.refined_frequency) < 1.0f;
+            printf("  Beam %zu: peak %zu (|X| = %.1f, %.1f Hz) vs complex %zu %s\n",
+                   beam, r.max_values.empty() ? 0 : r.max_values[0].index_point,
+                   r.max_values.empty() ? 0.0f : r.max_values[0].amplitude, r.refined_frequency,
+                   c.max_values.empty() ? 0 : c.max_values[0].index_point, ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+        printf("  FFT time: R2C %.3f ms vs C2C %.3f ms\n", real_ms, complex_ms);
+        
+        // Окно после fftshift: главный тон и его зеркало симметрично относительно центра
+        auto shifted = processor.ProcessReal(real_input, true);
+        const size_t center = params.out_count_points_fft / 2;
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            const auto& peaks = shifted.results[beam].max_values;
+            bool ok = peaks.size() >= 2;
+            if (ok) {
+                std::set<size_t> top2 = {peaks[0].index_point, peaks[1].index_point};
+                ok = top2 == std::set<size_t>{center - main_bins[beam], center + main_bins[beam]} &&
+                     std::fabs(peaks[0].amplitude - peaks[1].amplitude) < 1e-3f * peaks[0].amplitude &&
+                     std::fabs(std::fabs(shifted.results[beam].refined_frequency) -
+                               reference.results[beam].refined_frequency) < 1.0f;
+            }
+            printf("  Beam %zu (fftshift): mirror pair around %zu %s\n", beam, center, ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+        
+        if (!all_ok) {
+            throw std::runtime_error("R2C result mismatch");
+        }
+        std::cout << "\n✅ Test 11 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 11 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_inplace_fft() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 12: In-place FFT mode (ProcessNew / parallel batches)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        
+        const size_t NUM_BEAMS = 12;
+        const size_t COUNT_POINTS = 4096;
+        
+        // Луч b: три тона разной амплитуды + шум
+        std::mt19937 rng(38);
+        std::normal_distribution<float> gauss(0.0f, 0.1f);
+        std::vector<std::complex<float>> input(NUM_BEAMS * COUNT_POINTS);
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                std::complex<double> v(0.0, 0.0);
+                for (size_t t = 0; t < 3; ++t) {
+                    double bin = 100.0 + 150.0 * t + 37.0 * beam;
+                    v += (3.0 - t) * std::polar(1.0, 2.0 * M_PI * bin * n / (2.0 * COUNT_POINTS));
+                }
+                input[beam * COUNT_POINTS + n] = std::complex<float>(v) +
+                                                 std::complex<float>(gauss(rng), gauss(rng));
+            }
+        }
+        auto input_buffer = engine.CreateBufferWithData(input);
+        
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 2048, 3,
+                                             "test_inplace_fft", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        
+        // Эталон: out-of-place
+        auto reference = processor.Process(input_buffer->Get());
+        
+        auto compare = [&](const antenna_fft::AntennaFFTResult& r) {
+            if (r.results.size() != NUM_BEAMS) return false;
+            for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+                const auto& a = r.results[beam].max_values;
+                const auto& b = reference.results[beam].max_values;
+                if (a.size() != b.size()) return false;
+                for (size_t i = 0; i < a.size(); ++i) {
+                    if (a[i].index_point != b[i].index_point ||
+                        std::fabs(a[i].amplitude - b[i].amplitude) > 1e-3f * b[i].amplitude) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        
+        // Оба пути сообщают бин FFT: сильнейший тон луча — бин 100 + 37·beam при nFFT = 2·COUNT_POINTS
+        bool index_ok = processor.GetNFFT() == 2 * COUNT_POINTS;
+        for (size_t beam = 0; beam < NUM_BEAMS && index_ok; ++beam) {
+            const auto& peaks = reference.results[beam].max_values;
+            index_ok = !peaks.empty() && peaks[0].index_point == 100 + 37 * beam;
+        }
+        printf("  Process (out-of-place): индексы — бины FFT: %s\n", index_ok ? "✅" : "❌");
+        
+        processor.SetInPlaceFFT(true);
+        auto single = processor.ProcessNew(input_buffer->Get());
+        bool single_ok = compare(single);
+        printf("  ProcessNew (in-place, single batch): %s\n", single_ok ? "✅" : "❌");
+        
+        auto parallel = processor.ProcessWithBatchingNew(input_buffer->Get());
+        bool parallel_ok = compare(parallel);
+        printf("  ProcessWithBatchingNew (in-place): %s\n", parallel_ok ? "✅" : "❌");
+        
+        processor.SetInPlaceFFT(false);
+        auto parallel_oop = processor.ProcessWithBatchingNew(input_buffer->Get());
+        bool oop_ok = compare(parallel_oop);
+        printf("  ProcessWithBatchingNew (out-of-place): %s\n", oop_ok ? "✅" : "❌");
+        
+        // После возврата в out-of-place Process() снова создаёт FFT output
+        auto reference_again = processor.Process(input_buffer->Get());
+        bool again_ok = compare(reference_again);
+        printf("  Process (out-of-place, после in-place): %s\n", again_ok ? "✅" : "❌");
+        
+        if (!index_ok || !single_ok || !parallel_ok || !oop_ok || !again_ok) {
+            throw std::runtime_error("in-place result mismatch");
+        }
+        std::cout << "\n✅ Test 12 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 12 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_input_layout() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 13: Input layout (sample-major / int16 IQ / strides)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        
+        const size_t NUM_BEAMS = 20;     // Не кратно тайлу 16
+        const size_t COUNT_POINTS = 1000;
+        const size_t HEADER = 8;         // Заголовок кадра АЦП (отсчётов)
+        
+        // Луч b: три тона, амплитуды в пределах int16 после масштаба
+        std::vector<std::complex<float>> beam_major(NUM_BEAMS * COUNT_POINTS);
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                std::complex<double> v(0.0, 0.0);
+                for (size_t t = 0; t < 3; ++t) {
+                    double bin = 50.0 + 120.0 * t + 11.0 * beam;
+                    v += 0.25 * (3.0 - t) * std::polar(1.0, 2.0 * M_PI * bin * n / 2048.0);
+                }
+                beam_major[beam * COUNT_POINTS + n] = std::complex<float>(v);
+            }
+        }
+        auto reference_buffer = engine.CreateBufferWithData(beam_major);
+        
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 1024, 3,
+                                             "test_input_layout", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        auto reference = processor.Process(reference_buffer->Get());
+        
+        auto compare = [&](const antenna_fft::AntennaFFTResult& r, float tolerance) {
+            if (r.results.size() != NUM_BEAMS) return false;
+            for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+                const auto& a = r.results[beam].max_values;
+                const auto& b = reference.results[beam].max_values;
+                if (a.size() != b.size()) return false;
+                for (size_t i = 0; i < a.size(); ++i) {
+                    if (a[i].index_point != b[i].index_point ||
+                        std::fabs(a[i].amplitude - b[i].amplitude) > tolerance * b[i].amplitude) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        
+        // 1. SAMPLE_MAJOR float2 (порядок АЦП) через cl_mem
+        std::vector<std::complex<float>> sample_major(NUM_BEAMS * COUNT_POINTS);
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                sample_major[n * NUM_BEAMS + beam] = beam_major[beam * COUNT_POINTS + n];
+            }
+        }
+        auto sample_buffer = engine.CreateBufferWithData(sample_major);
+        
+        antenna_fft::InputLayoutDesc layout;
+        layout.layout = antenna_fft::InputLayout::SAMPLE_MAJOR;
+        processor.SetInputLayout(layout);
+        bool float_ok = compare(processor.Process(sample_buffer->Get()), 1e-3f);
+        printf("  SAMPLE_MAJOR float32 (Process): %s\n", float_ok ? "✅" : "❌");
+        
+        bool batch_ok = compare(processor.ProcessWithBatchingNew(sample_buffer->Get()), 1e-3f);
+        printf("  SAMPLE_MAJOR float32 (ProcessWithBatchingNew): %s\n", batch_ok ? "✅" : "❌");
+        
+        // 2. SAMPLE_MAJOR int16 IQ с заголовком кадра (сырой кадр с хоста)
+        const float scale = 1.0f / 8192.0f;
+        std::vector<int16_t> raw(2 * (HEADER + NUM_BEAMS * COUNT_POINTS), 0x7F7F);
+        for (size_t i = 0; i < sample_major.size(); ++i) {
+            raw[2 * (HEADER + i)]     = static_cast<int16_t>(std::lround(sample_major[i].real() / scale));
+            raw[2 * (HEADER + i) + 1] = static_cast<int16_t>(std::lround(sample_major[i].imag() / scale));
+        }
+        layout.format = antenna_fft::InputSampleFormat::INT16_IQ;
+        layout.offset = HEADER;
+        layout.int16_scale = scale;
+        processor.SetInputLayout(layout);
+        bool int16_ok = compare(processor.ProcessRawFrame(raw.data(), raw.size() * sizeof(int16_t)), 1e-2f);
+        printf("  SAMPLE_MAJOR int16 + header (ProcessRawFrame): %s\n", int16_ok ? "✅" : "❌");
+        
+        // 3. BEAM_MAJOR с шагом луча больше count_points (выравнивание строк)
+        const size_t ROW_PITCH = 1024;
+        std::vector<std::complex<float>> strided(NUM_BEAMS * ROW_PITCH, std::complex<float>(9.0f, 9.0f));
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            std::copy(beam_major.begin() + beam * COUNT_POINTS, beam_major.begin() + (beam + 1) * COUNT_POINTS,
+                      strided.begin() + beam * ROW_PITCH);
+        }
+        auto strided_buffer = engine.CreateBufferWithData(strided);
+        antenna_fft::InputLayoutDesc pitched;
+        pitched.beam_stride = ROW_PITCH;
+        processor.SetInputLayout(pitched);
+        bool stride_ok = compare(processor.Process(strided_buffer->Get()), 1e-3f);
+        printf("  BEAM_MAJOR row pitch %zu: %s\n", ROW_PITCH, stride_ok ? "✅" : "❌");
+        
+        // 4. Данные хоста complex<float> при нестандартной раскладке — ошибка
+        bool rejected = false;
+        try {
+            processor.Process(beam_major);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        printf("  Host vector rejected for custom layout: %s\n", rejected ? "✅" : "❌");
+        
+        // RefinePeaks читает вход напрямую — с шагом строки тоже ошибка, а не чужие отсчёты
+        bool zoom_rejected = false;
+        try {
+            processor.RefinePeaks(strided_buffer->Get(), reference, antenna_fft::ZoomFFTParams());
+        } catch (const std::invalid_argument&) {
+            zoom_rejected = true;
+        }
+        printf("  RefinePeaks rejected for custom layout: %s\n", zoom_rejected ? "✅" : "❌");
+        
+        if (!float_ok || !batch_ok || !int16_ok || !stride_ok || !rejected || !zoom_rejected) {
+            throw std::runtime_error("input layout result mismatch");
+        }
+        std::cout << "\n✅ Test 13 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 13 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_integration() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 14: Non-coherent multi-frame integration\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        
+        const size_t NUM_BEAMS = 8;
+        const size_t COUNT_POINTS = 4096;
+        const size_t FRAMES = 16;
+        
+        // Слабый тон (бин 300 + 40·b) в шуме: в одном кадре на грани обнаружения
+        std::mt19937 rng(40);
+        std::normal_distribution<float> gauss(0.0f, 1.0f);
+        auto make_frame = [&]() {
+            std::vector<std::complex<float>> frame(NUM_BEAMS * COUNT_POINTS);
+            for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+                double bin = 300.0 + 40.0 * beam;
+                for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                    frame[beam * COUNT_POINTS + n] =
+                        std::complex<float>(0.05 * std::polar(1.0, 2.0 * M_PI * bin * n / (2.0 * COUNT_POINTS))) +
+                        std::complex<float>(gauss(rng), gauss(rng));
+                }
+            }
+            return frame;
+        };
+        
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 2048, 3,
+                                             "test_integration", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        
+        auto hits = [&](const antenna_fft::AntennaFFTResult& r) {
+            size_t count = 0;
+            for (size_t beam = 0; beam < r.results.size(); ++beam) {
+                const auto& peaks = r.results[beam].max_values;
+                if (!peaks.empty() && peaks[0].index_point == 300 + 40 * beam) ++count;
+            }
+            return count;
+        };
+        
+        for (auto mode : {antenna_fft::IntegrationMode::AVERAGE, antenna_fft::IntegrationMode::EXPONENTIAL}) {
+            antenna_fft::IntegrationParams integration;
+            integration.frames = FRAMES;
+            integration.mode = mode;
+            integration.alpha = 1.0f / FRAMES;
+            processor.SetIntegration(integration);
+            
+            size_t single_hits = 0;
+            size_t ready_count = 0;
+            antenna_fft::IntegrationResult last;
+            for (size_t f = 0; f < 2 * FRAMES; ++f) {
+                auto frame = make_frame();
+                if (f == 0) {
+                    single_hits = hits(processor.Process(engine.CreateBufferWithData(frame)->Get()));
+                }
+                auto r = processor.ProcessIntegrated(frame);
+                if (r.ready) {
+                    ++ready_count;
+                    last = r;
+                }
+            }
+            
+            const char* name = mode == antenna_fft::IntegrationMode::AVERAGE ? "AVERAGE" : "EXPONENTIAL";
+            size_t integrated_hits = hits(last.maxima);
+            printf("  %-11s: single frame %zu/%zu, integrated %zu/%zu (%zu readbacks / %zu frames)\n",
+                   name, single_hits, NUM_BEAMS, integrated_hits, NUM_BEAMS, ready_count, 2 * FRAMES);
+            
+            if (ready_count != 2 || last.frames_integrated != FRAMES || integrated_hits != NUM_BEAMS) {
+                throw std::runtime_error(std::string("integration mismatch (") + name + ")");
+            }
+        }
+        std::cout << "\n✅ Test 14 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 14 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
+void test_beamforming() {
+    std::cout << "\n═══════════════════════════════════════════════════════════\n";
+    std::cout << "  Test 15: Digital beamforming (tiled complex GEMM Y = W·X)\n";
+    std::cout << "═══════════════════════════════════════════════════════════\n\n";
+    
+    try {
+        if (!ManagerOpenCL::OpenCLComputeEngine::IsInitialized()) {
+            ManagerOpenCL::OpenCLComputeEngine::Initialize(ManagerOpenCL::DeviceType::GPU);
+        }
+        auto& engine = ManagerOpenCL::OpenCLComputeEngine::GetInstance();
+        using cf = std::complex<float>;
+        
+        const size_t NUM_ELEMENTS = 40;     // не кратно тайлу 16
+        const size_t NUM_BEAMS = 16;
+        const size_t COUNT_POINTS = 1000;   // nFFT = 2048: хвост строки — padding
+        const size_t TARGET_BEAM = 5;
+        
+        LFMParameters lfm;
+        lfm.num_beams = NUM_BEAMS;
+        lfm.angle_start_deg = -30.0f;
+        lfm.angle_stop_deg = 30.0f;
+        lfm.count_points = COUNT_POINTS;
+        
+        antenna_fft::BeamformerParams bf_params;
+        bf_params.num_elements = NUM_ELEMENTS;
+        bf_params.num_samples = COUNT_POINTS;
+        antenna_fft::Beamformer beamformer(bf_params);
+        beamformer.SetSteering(lfm);
+        const auto angles = beamformer.GetAngles();
+        
+        // Плоская волна с угла луча TARGET_BEAM (тон) + шум
+        std::mt19937 rng(23);
+        std::normal_distribution<float> noise(0.0f, 0.1f);
+        const double u = std::sin(angles[TARGET_BEAM] * M_PI / 180.0);
+        std::vector<cf> elements(NUM_ELEMENTS * COUNT_POINTS);
+        for (size_t m = 0; m < NUM_ELEMENTS; ++m) {
+            for (size_t t = 0; t < COUNT_POINTS; ++t) {
+                const double phase = 2.0 * M_PI * (0.5 * m * u + 0.1 * t);
+                elements[m * COUNT_POINTS + t] = cf(std::polar(1.0, phase)) + cf(noise(rng), noise(rng));
+            }
+        }
+        
+        // Эталон на CPU: y_b = w_b^H x
+        const auto weights = antenna_fft::Beamformer::SteeringWeights(angles, NUM_ELEMENTS, 0.5f);
+        std::vector<cf> reference(NUM_BEAMS * COUNT_POINTS);
+        for (size_t b = 0; b < NUM_BEAMS; ++b) {
+            for (size_t t = 0; t < COUNT_POINTS; ++t) {
+                std::complex<double> acc(0.0, 0.0);
+                for (size_t m = 0; m < NUM_ELEMENTS; ++m) {
+                    acc += std::conj(std::complex<double>(weights[b * NUM_ELEMENTS + m])) *
+                           std::complex<double>(elements[m * COUNT_POINTS + t]);
+                }
+                reference[b * COUNT_POINTS + t] = cf(acc);
+            }
+        }
+        
+        // ─── 1. Хостовая перегрузка против эталона, максимум мощности на TARGET_BEAM ───
+        auto beams = beamformer.Apply(elements);
+        double num = 0.0, den = 0.0;
+        std::vector<double> power(NUM_BEAMS, 0.0);
+        for (size_t i = 0; i < beams.size(); ++i) {
+            num += std::norm(beams[i] - reference[i]);
+            den += std::norm(reference[i]);
+            power[i / COUNT_POINTS] += std::norm(beams[i]);
+        }
+        const double rel = std::sqrt(num / den);
+        const size_t peak_beam = std::max_element(power.begin(), power.end()) - power.begin();
+        printf("  %zu elements -> %zu beams x %zu samples: rel error %.3g, %.3f ms\n",
+               NUM_ELEMENTS, NUM_BEAMS, COUNT_POINTS, rel, beamformer.GetLastTimeMs());
+        printf("  peak power at beam %zu (%.1f deg), expected %zu\n",
+               peak_beam, angles[peak_beam], TARGET_BEAM);
+        if (!(rel < 1e-5) || peak_beam != TARGET_BEAM) {
+            throw std::runtime_error("beamformer output mismatch");
+        }
+        
+        // ─── 2. Шаг строки nFFT: хвост обнуляется поверх мусора ───
+        const size_t STRIDE = 2048;
+        auto element_buffer = engine.CreateBufferWithData(elements);
+        auto padded_buffer = engine.CreateBufferWithData(std::vector<cf>(NUM_BEAMS * STRIDE, cf(7.0f, -7.0f)));
+        beamformer.Apply(element_buffer->Get(), padded_buffer->Get(), STRIDE);
+        auto padded = padded_buffer->ReadFromGPU();
+        bool padding_ok = true;
+        for (size_t b = 0; b < NUM_BEAMS && padding_ok; ++b) {
+            for (size_t t = 0; t < STRIDE; ++t) {
+                const cf expected = t < COUNT_POINTS ? beams[b * COUNT_POINTS + t] : cf(0.0f, 0.0f);
+                if (padded[b * STRIDE + t] != expected) {
+                    padding_ok = false;
+                    break;
+                }
+            }
+        }
+        printf("  stride %zu: zero tail %s\n", STRIDE, padding_ok ? "✅" : "❌");
+        if (!padding_ok) {
+            throw std::runtime_error("beamformer padding mismatch");
+        }
+
+        // ─── 2б. Загрузка X в другой очереди, GEMM ждёт её события ───
+        auto upload_buffer = engine.CreateBuffer(NUM_ELEMENTS * COUNT_POINTS, ManagerOpenCL::MemoryType::GPU_READ_WRITE);
+        cl_command_queue upload_queue = ManagerOpenCL::CommandQueuePool::GetNextQueue();
+        cl_event upload_event = nullptr;
+        cl_int err = clEnqueueWriteBuffer(upload_queue, upload_buffer->Get(), CL_FALSE, 0,
+                                          elements.size() * sizeof(cf), elements.data(),
+                                          0, nullptr, &upload_event);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("clEnqueueWriteBuffer (upload) failed: " + std::to_string(err));
+        }
+        clFlush(upload_queue);
+        cl_event gemm_event = nullptr;
+        beamformer.Enqueue(upload_buffer->Get(), padded_buffer->Get(), STRIDE, 1,
+                           &gemm_event, 1, &upload_event);
+        clWaitForEvents(1, &gemm_event);
+        clReleaseEvent(gemm_event);
+        clReleaseEvent(upload_event);
+        const bool chained_ok = padded_buffer->ReadFromGPU() == padded;
+        printf("  GEMM after upload event (tile %zu): %s\n", beamformer.GetTile(), chained_ok ? "✅" : "❌");
+        if (!chained_ok) {
+            throw std::runtime_error("beamformer wait list mismatch");
+        }
+
+        // ─── 3. Кэш весов по набору углов ───
+        beamformer.SetSteering(lfm);
+        const size_t cached_same = beamformer.GetCachedSteeringCount();
+        LFMParameters narrow = lfm;
+        narrow.angle_start_deg = -10.0f;
+        narrow.angle_stop_deg = 10.0f;
+        beamformer.SetSteering(narrow);
+        const size_t cached_new = beamformer.GetCachedSteeringCount();
+        beamformer.SetSteering(lfm);
+        printf("  steering cache: %zu after repeat, %zu after new angles\n", cached_same, cached_new);
+        if (cached_same != 1 || cached_new != 2 || beamformer.GetCachedSteeringCount() != 2) {
+            throw std::runtime_error("steering cache mismatch");
+        }
+        
+        // ─── 4. Beamformer → FFT → top-N против Process(Y) ───
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 512, 3,
+                                             "test_beamforming", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        auto beams_buffer = engine.CreateBufferWithData(beams);
+        auto expected = processor.Process(beams_buffer->Get());
+        auto fused = processor.ProcessBeamformed(element_buffer->Get(), beamformer);
+        
+        bool fused_ok = fused.results.size() == NUM_BEAMS;
+        for (size_t beam = 0; beam < NUM_BEAMS && fused_ok; ++beam) {
+            const auto& a = fused.results[beam].max_values;
+            const auto& b = expected.results[beam].max_values;
+            if (a.size() != b.size()) {
+                fused_ok = false;
+                break;
+            }
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i].index_point != b[i].index_point ||
+                    std::fabs(a[i].amplitude - b[i].amplitude) > 1e-3f * b[i].amplitude) {
+                    fused_ok = false;
+                    break;
+                }
+            }
+        }
+        printf("  ProcessBeamformed vs Process(Y): %s\n", fused_ok ? "✅" : "❌");
+        if (!fused_ok) {
+            throw std::runtime_error("ProcessBeamformed mismatch");
+        }
+        
+        std::cout << "\n✅ Test 15 passed!\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test 15 failed: " << e.what() << "\n";
+        throw;
+    }
+}
+
 void run_all_tests() {
     std::cout << "\n";
     std::cout << "╔═══════════════════════════════════════════════════════════╗\n";
@@ -429,6 +1231,30 @@ void run_all_tests() {
 //        test_process_new_small();
         test_process_new_large();
         
+        // Сжатие импульса
+        test_pulse_compression();
+        
+        // Уточнение частоты и фазы максимумов
+        test_zoom_refinement();
+        
+        // Разреженный вывод спектра
+        test_sparse_spectrum();
+        
+        // Вещественный вход (R2C)
+        test_real_input();
+        
+        // In-place FFT (меньше памяти на батч)
+        test_inplace_fft();
+        
+        // Раскладка входа (порядок АЦП, int16)
+        test_input_layout();
+        
+        // Некогерентное накопление по кадрам
+        test_integration();
+        
+        // Формирование лучей (GEMM) перед FFT
+        test_beamforming();
+        
         std::cout << "\n";
         std::cout << "╔═══════════════════════════════════════════════════════════╗\n";
         std::cout << "║     All Tests Completed                                  ║\n";
@@ -0,0 +1,263 @@
+/**
+ * @file test_cfar_detector.cpp
+ * @brief Тесты CFAR обнаружения (CFARDetector и AntennaFFTProcMax::ProcessCFAR)
+ *
+ * Тестовые сценарии:
+ * 1. CA / GO / SO / OS против CPU эталона на экспоненциальном шуме с целями у краёв
+ *    и соседними, переполнение max_detections_per_beam, ProcessCFAR по тонам в шуме
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/cfar_detector.hpp"
+#include "GPU/antenna_fft_proc_max.h"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+// ============================================================================
+// CPU ЭТАЛОН
+// ============================================================================
+
+/// CPU эталон CFAR (та же обработка краёв, что и в ядре): множество обнаруженных ячеек
+std::set<size_t> cfar_reference(const float* row, size_t num_cells, const antenna_fft::CFARParams& p,
+                                std::vector<float>& ratio) {
+    const float alpha = p.GetThresholdFactor();
+    const long guard = static_cast<long>(p.guard_cells);
+    const long halo = guard + static_cast<long>(p.training_cells);
+    const long n = static_cast<long>(num_cells);
+    std::set<size_t> detected;
+    ratio.assign(num_cells, 0.0f);
+
+    for (long c = 0; c < n; ++c) {
+        std::vector<float> lead, lag;
+        for (long j = c - halo; j <= c - guard - 1; ++j) if (j >= 0 && j < n) lead.push_back(row[j]);
+        for (long j = c + guard + 1; j <= c + halo; ++j) if (j >= 0 && j < n) lag.push_back(row[j]);
+        if (lead.empty() && lag.empty()) continue;
+
+        double sum_lead = 0.0, sum_lag = 0.0;
+        for (float v : lead) sum_lead += v;
+        for (float v : lag) sum_lag += v;
+        double noise;
+        if (p.method == antenna_fft::CFARMethod::OS) {
+            std::vector<float> all(lead);
+            all.insert(all.end(), lag.begin(), lag.end());
+            std::sort(all.begin(), all.end());
+            noise = all[std::min(p.GetOSRank(), all.size()) - 1];
+        } else if (p.method == antenna_fft::CFARMethod::CA || lead.empty() || lag.empty()) {
+            noise = (sum_lead + sum_lag) / (lead.size() + lag.size());
+        } else if (p.method == antenna_fft::CFARMethod::GO) {
+            noise = std::max(sum_lead / lead.size(), sum_lag / lag.size());
+        } else {
+            noise = std::min(sum_lead / lead.size(), sum_lag / lag.size());
+        }
+        ratio[c] = static_cast<float>(row[c] / (alpha * noise));
+        if (row[c] > alpha * noise) detected.insert(static_cast<size_t>(c));
+    }
+    return detected;
+}
+
+// ============================================================================
+// ТЕСТ 1: CFAR (CA / GO / SO / OS)
+// ============================================================================
+
+bool TestCFARDetection() {
+    PrintHeader("🧪 ТЕСТ 1: CFAR detection (CA / GO / SO / OS)");
+
+    try {
+        auto& engine = OpenCLComputeEngine::GetInstance();
+
+        // ─── 1. CFARDetector на синтетической мощности против CPU эталона ───
+        const size_t NUM_BEAMS = 3;
+        const size_t NUM_CELLS = 1000;   // не кратно local size: последний тайл неполный
+        std::mt19937 rng(12345);
+        std::exponential_distribution<float> noise_dist(1.0f);
+        std::vector<float> power(NUM_BEAMS * NUM_CELLS);
+        for (auto& v : power) v = noise_dist(rng);
+        // Цели: у краёв, соседние (511/512 — за защитными ячейками) и одиночные
+        const size_t targets[] = {0, 250, 270, 511, 512, 998};
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            for (size_t t : targets) power[beam * NUM_CELLS + t] = 200.0f + 50.0f * beam;
+        }
+
+        // float-мощность в буфер через complex<float>: пара соседних ячеек на элемент
+        std::vector<std::complex<float>> packed(power.size() / 2);
+        for (size_t i = 0; i < packed.size(); ++i) {
+            packed[i] = {power[2 * i], power[2 * i + 1]};
+        }
+        auto power_buffer = engine.CreateBufferWithData(packed);
+
+        bool all_ok = true;
+        for (auto method : {antenna_fft::CFARMethod::CA, antenna_fft::CFARMethod::GO,
+                            antenna_fft::CFARMethod::SO, antenna_fft::CFARMethod::OS}) {
+            antenna_fft::CFARParams cfar;
+            cfar.method = method;
+            cfar.guard_cells = 2;
+            cfar.training_cells = 12;
+            cfar.pfa = 1e-4;
+            cfar.max_detections_per_beam = 128;
+
+            antenna_fft::CFARDetector detector(cfar);
+            auto result = detector.Detect(power_buffer->Get(), NUM_BEAMS, NUM_CELLS);
+
+            size_t mismatches = 0;
+            for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+                std::vector<float> ratio;
+                auto expected = cfar_reference(&power[beam * NUM_CELLS], NUM_CELLS, cfar, ratio);
+                std::set<size_t> got;
+                for (const auto& d : result.beams[beam].detections) got.insert(d.index);
+
+                // Расхождение допустимо только у ячеек на самом пороге (порядок суммирования)
+                for (size_t c = 0; c < NUM_CELLS; ++c) {
+                    if ((expected.count(c) != 0) != (got.count(c) != 0) &&
+                        std::fabs(ratio[c] - 1.0f) > 1e-3f) {
+                        ++mismatches;
+                    }
+                }
+                for (size_t t : targets) {
+                    if (!got.count(t)) ++mismatches;
+                }
+                if (result.beams[beam].total_count != result.beams[beam].detections.size()) ++mismatches;
+            }
+
+            bool ok = mismatches == 0;
+            printf("  %s: alpha = %6.2f, detections = %3zu, kernel %.3f ms %s\n",
+                   antenna_fft::CFARMethodToString(method).c_str(), result.threshold_factor,
+                   result.TotalDetections(), result.kernel_time_ms, ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+
+        // Переполнение: счётчик считает все, в выходе только ёмкость
+        {
+            antenna_fft::CFARParams cfar;
+            cfar.threshold_factor = 0.5f;   // почти все ячейки выше порога
+            cfar.max_detections_per_beam = 16;
+            antenna_fft::CFARDetector detector(cfar);
+            auto result = detector.Detect(power_buffer->Get(), NUM_BEAMS, NUM_CELLS);
+            bool ok = result.beams[0].Overflowed() && result.beams[0].detections.size() == 16;
+            printf("  overflow: total %zu, stored %zu %s\n", result.beams[0].total_count,
+                   result.beams[0].detections.size(), ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+
+        // ─── 2. ProcessCFAR: тоны на сетке бинов в шуме ───
+        const size_t COUNT_POINTS = 1024;
+        antenna_fft::AntennaFFTParams params(NUM_BEAMS, COUNT_POINTS, 512, 3, "test_cfar", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        const size_t nfft = processor.GetNFFT();
+
+        std::normal_distribution<float> gauss(0.0f, 1.0f);
+        std::vector<std::complex<float>> input(NUM_BEAMS * COUNT_POINTS);
+        std::vector<std::vector<size_t>> tone_bins(NUM_BEAMS);
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            tone_bins[beam] = {100 + 20 * beam, 300 + 40 * beam};
+            for (size_t n = 0; n < COUNT_POINTS; ++n) {
+                std::complex<float> v(gauss(rng), gauss(rng));
+                for (size_t bin : tone_bins[beam]) {
+                    double phase = 2.0 * M_PI * bin * n / nfft;
+                    v += std::complex<float>(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase)));
+                }
+                input[beam * COUNT_POINTS + n] = v;
+            }
+        }
+
+        antenna_fft::CFARParams cfar;
+        cfar.method = antenna_fft::CFARMethod::OS;
+        cfar.guard_cells = 2;
+        cfar.training_cells = 16;
+        cfar.pfa = 1e-6;
+        auto result = processor.ProcessCFAR(input, cfar);
+
+        for (size_t beam = 0; beam < NUM_BEAMS; ++beam) {
+            std::set<size_t> got;
+            bool near_tone = true;
+            for (const auto& d : result.beams[beam].detections) {
+                got.insert(d.index);
+                bool near = false;
+                for (size_t bin : tone_bins[beam]) {
+                    near = near || (d.index + 8 >= bin && d.index <= bin + 8);
+                }
+                near_tone = near_tone && near;
+            }
+            bool ok = near_tone;
+            for (size_t bin : tone_bins[beam]) ok = ok && got.count(bin);
+            printf("  beam %zu: tones %zu, %zu → %zu detections %s\n", beam,
+                   tone_bins[beam][0], tone_bins[beam][1], got.size(), ok ? "✅" : "❌");
+            all_ok = all_ok && ok;
+        }
+
+        std::cout << processor.GetProfilingStats() << "\n";
+
+        if (!all_ok) {
+            throw std::runtime_error("CFAR detections do not match reference");
+        }
+        PrintResult(true, "CFAR Detection Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "CFAR Detection Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 CFARDetector TEST SUITE");
+
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+
+        int passed = 0;
+        int total = 1;
+
+        if (TestCFARDetection()) passed++;
+
+        PrintHeader("📊 РЕЗУЛЬТАТЫ");
+        std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+        return (passed == total) ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ FATAL ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
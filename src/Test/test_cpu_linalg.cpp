@@ -0,0 +1,449 @@
+/**
+ * @file test_cpu_linalg.cpp
+ * @brief Тесты CPU линейной алгебры (cpu_linalg) без OpenCL устройства
+ *
+ * Тестовые сценарии:
+ * 1. HermitianCPUInverter: L·L^H = R, ||R·R^-1 - I||_F, пакет по потокам совпадает с одиночным;
+ *    для 341 × 341 — PASS/FAIL по цели < 4 мс (только вывод, на результат не влияет)
+ * 2. MVDR веса решением системы: совпадение с R^{-1}s / (s^H R^{-1} s), w^H s = 1, R·x = b
+ * 3. SlidingCovariance: дрейф L L^H от точной суммы окна, веса против полного разложения, порция длиннее окна
+ * 4. SolveRefined: разложение в float + уточнение, обратная ошибка на порядки ниже решения в float
+ *
+ * Исполняемый файл не линкуется с OpenCL: матрицы читаются ReadComplexMatrixCSV
+ * (matrix_csv.cpp собирается вместе с тестом) из Matrix/data — запускать из корня репозитория.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "CPU/hermitian_cpu_inverter.hpp"
+#include "CPU/sliding_covariance.hpp"
+#include "ManagerOpenCL/matrix_csv.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using cpu_linalg::HermitianCPUInverter;
+using cpu_linalg::SlidingCovariance;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+/// Цель Matrix/README.md: < 4 мс на обращение одной матрицы 341 × 341
+constexpr size_t kInverseTargetSize = 341;
+constexpr double kInverseTargetMs = 4.0;
+
+/// Матрица из Matrix/data с диагональной нагрузкой loading·trace/n
+std::vector<std::complex<float>> LoadWithLoading(const std::string& path, size_t& n, float loading) {
+    auto R = ManagerOpenCL::ReadComplexMatrixCSV(path, &n);
+    float trace = 0.0f;
+    for (size_t i = 0; i < n; ++i) trace += R[i * n + i].real();
+    for (size_t i = 0; i < n; ++i) R[i * n + i] += loading * trace / n;
+    return R;
+}
+
+/// ||A·A_inv - I||_F (как HermitianInverter::FrobeniusError, без OpenCL)
+float FrobeniusError(const std::vector<std::complex<float>>& A,
+                     const std::vector<std::complex<float>>& A_inv, size_t n) {
+    float error = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            std::complex<float> sum(0.0f, 0.0f);
+            for (size_t k = 0; k < n; ++k) sum += A[i * n + k] * A_inv[k * n + j];
+            if (i == j) sum -= 1.0f;
+            error += std::norm(sum);
+        }
+    }
+    return std::sqrt(error);
+}
+
+/// Векторы наведения эквидистантной решётки (d = λ/2) на -40°, -20°, ... с шагом 20°
+std::vector<std::complex<float>> MakeSteering(size_t n, size_t count) {
+    std::vector<std::complex<float>> steering(count * n);
+    for (size_t v = 0; v < count; ++v) {
+        const float theta = (-40.0f + 20.0f * v) * static_cast<float>(M_PI) / 180.0f;
+        for (size_t k = 0; k < n; ++k) {
+            steering[v * n + k] = std::polar(1.0f, static_cast<float>(M_PI) * k * std::sin(theta));
+        }
+    }
+    return steering;
+}
+
+/// Обратная ошибка η = max_r ||b - R x||_inf / (||R||_inf ||x||_inf + ||b||_inf) в double
+template <typename Solution>
+double BackwardError(const std::vector<std::complex<float>>& R, const std::vector<std::complex<float>>& rhs,
+                     const Solution& solution, size_t offset, size_t n, size_t num_rhs) {
+    using cd = std::complex<double>;
+    double r_norm = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double row = 0.0;
+        for (size_t k = 0; k < n; ++k) row += std::abs(cd(R[i * n + k]));
+        r_norm = std::max(r_norm, row);
+    }
+    double worst = 0.0;
+    for (size_t r = 0; r < num_rhs; ++r) {
+        double res = 0.0, x_max = 0.0, b_max = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            cd sum(0.0, 0.0);
+            for (size_t k = 0; k < n; ++k) sum += cd(R[i * n + k]) * cd(solution[offset + r * n + k]);
+            res = std::max(res, std::abs(cd(rhs[r * n + i]) - sum));
+            x_max = std::max(x_max, std::abs(cd(solution[offset + r * n + i])));
+            b_max = std::max(b_max, std::abs(cd(rhs[r * n + i])));
+        }
+        worst = std::max(worst, res / (r_norm * x_max + b_max));
+    }
+    return worst;
+}
+
+// ============================================================================
+// ТЕСТ 1: HermitianCPUInverter
+// ============================================================================
+
+bool TestCPUHermitianInverse() {
+    PrintHeader("🧪 ТЕСТ 1: CPU Hermitian inverse (SIMD Cholesky, thread pool)");
+
+    try {
+        std::cout << "  ISA: " << HermitianCPUInverter::GetISA() << "\n";
+
+        struct Case { const char* path; float tolerance; };
+        for (const Case& c : {Case{"Matrix/data/R_85.csv", 1e-2f}, Case{"Matrix/data/R_341.csv", 5e-2f}}) {
+            size_t n = 0;
+            auto R = LoadWithLoading(c.path, n, 1e-2f);
+            float trace = 0.0f;
+            for (size_t i = 0; i < n; ++i) trace += R[i * n + i].real();
+
+            HermitianCPUInverter inverter(n);
+
+            // L·L^H = R
+            auto L = inverter.Factor(R);
+            float factor_error = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j <= i; ++j) {
+                    std::complex<float> sum(0.0f, 0.0f);
+                    for (size_t k = 0; k <= j; ++k) sum += L[i * n + k] * std::conj(L[j * n + k]);
+                    factor_error = std::max(factor_error, std::abs(sum - R[i * n + j]) / trace);
+                }
+            }
+
+            auto R_inv = inverter.Invert(R);
+            const float error = FrobeniusError(R, R_inv, n);
+            const double single_ms = inverter.GetLastStats().total_ms;
+
+            // Пакет: матрицы по потокам, результат совпадает с одиночным
+            const size_t BATCH = 2 * inverter.GetThreadCount();
+            std::vector<std::complex<float>> batch;
+            for (size_t b = 0; b < BATCH; ++b) batch.insert(batch.end(), R.begin(), R.end());
+            auto inverse = inverter.InvertBatched(batch, BATCH);
+            float batch_diff = 0.0f;
+            for (size_t i = 0; i < BATCH * n * n; ++i) {
+                batch_diff = std::max(batch_diff, std::abs(inverse[i] - R_inv[i % (n * n)]));
+            }
+            const auto stats = inverter.GetLastStats();
+
+            printf("  n = %3zu: ||R·R^-1 - I||_F = %.3g, max|LL^H - R|/tr = %.2g, batch diff %.2g\n",
+                   n, error, factor_error, batch_diff);
+            printf("           single %.3f ms, batch %zu on %zu threads: %.3f ms/matrix\n",
+                   single_ms, BATCH, stats.threads, stats.ms_per_matrix);
+            // Цель Matrix/README.md — только для 341 × 341; время не влияет на результат теста
+            if (n == kInverseTargetSize) {
+                printf("           target < %.0f ms: single %s, batched %s\n", kInverseTargetMs,
+                       single_ms < kInverseTargetMs ? "PASS" : "FAIL",
+                       stats.ms_per_matrix < kInverseTargetMs ? "PASS" : "FAIL");
+            }
+
+            if (!(error < c.tolerance) || !(factor_error < 1e-5f) || batch_diff != 0.0f) {
+                throw std::runtime_error(std::string("CPU inverse mismatch for ") + c.path);
+            }
+        }
+
+        // Не положительно определённая матрица в пакете — исключение из потока пула
+        bool rejected = false;
+        try {
+            HermitianCPUInverter inverter(4);
+            std::vector<std::complex<float>> batch(3 * 16, std::complex<float>(0.0f, 0.0f));
+            for (size_t b = 0; b < 3; ++b) {
+                for (size_t i = 0; i < 4; ++i) batch[b * 16 + i * 5] = 1.0f;
+            }
+            batch[2 * 16 + 10] = -1.0f;
+            inverter.InvertBatched(batch, 3);
+        } catch (const std::runtime_error& e) {
+            rejected = std::string(e.what()).find("matrix 2") != std::string::npos &&
+                       std::string(e.what()).find("column 2") != std::string::npos;
+        }
+        printf("  Indefinite matrix rejected: %s\n", rejected ? "yes" : "no");
+        if (!rejected) {
+            throw std::runtime_error("indefinite matrix not reported");
+        }
+
+        PrintResult(true, "CPU Hermitian Inverse Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "CPU Hermitian Inverse Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 2: MVDR веса и Solve без явного обращения
+// ============================================================================
+
+bool TestMVDRWeights() {
+    PrintHeader("🧪 ТЕСТ 2: MVDR weights via Cholesky solve (no explicit inverse)");
+
+    try {
+        using cf = std::complex<float>;
+
+        size_t n = 0;
+        auto R = LoadWithLoading("Matrix/data/R_341.csv", n, 1e-2f);
+        const size_t NUM_VECTORS = 5;
+        const auto steering = MakeSteering(n, NUM_VECTORS);
+
+        // Эталон: явное обращение, w = R^{-1}s / (s^H R^{-1} s)
+        HermitianCPUInverter inverter(n);
+        auto R_inv = inverter.Invert(R);
+        const double invert_ms = inverter.GetLastStats().total_ms;
+        std::vector<cf> reference(NUM_VECTORS * n);
+        for (size_t v = 0; v < NUM_VECTORS; ++v) {
+            std::complex<double> response(0.0, 0.0);
+            for (size_t i = 0; i < n; ++i) {
+                std::complex<double> sum(0.0, 0.0);
+                for (size_t k = 0; k < n; ++k) {
+                    sum += std::complex<double>(R_inv[i * n + k]) * std::complex<double>(steering[v * n + k]);
+                }
+                reference[v * n + i] = cf(sum);
+                response += std::conj(std::complex<double>(steering[v * n + i])) * sum;
+            }
+            for (size_t i = 0; i < n; ++i) reference[v * n + i] /= static_cast<float>(response.real());
+        }
+
+        // Относительное отличие от эталона и max|w^H s - 1|
+        auto weights = inverter.MVDRWeights(R, steering, NUM_VECTORS);
+        const auto stats = inverter.GetLastStats();
+        float diff = 0.0f, distortion = 0.0f;
+        for (size_t v = 0; v < NUM_VECTORS; ++v) {
+            float num = 0.0f, den = 0.0f;
+            cf gain(0.0f, 0.0f);
+            for (size_t i = 0; i < n; ++i) {
+                num += std::norm(weights[v * n + i] - reference[v * n + i]);
+                den += std::norm(reference[v * n + i]);
+                gain += std::conj(weights[v * n + i]) * steering[v * n + i];
+            }
+            diff = std::max(diff, std::sqrt(num / den));
+            distortion = std::max(distortion, std::abs(gain - cf(1.0f, 0.0f)));
+        }
+        printf("  n = %zu, %zu vectors: rel diff %.3g, max|w^H s - 1| = %.3g\n", n, NUM_VECTORS, diff, distortion);
+        printf("      factor %.3f ms + solve %.3f ms = %.3f ms (explicit inverse %.3f ms)\n",
+               stats.factor_ms, stats.solve_ms, stats.total_ms, invert_ms);
+        if (!(diff < 1e-2f) || !(distortion < 1e-4f)) {
+            throw std::runtime_error("CPU MVDR weights mismatch");
+        }
+
+        // Solve без нормировки: R·x = b
+        auto x = inverter.Solve(R, steering, NUM_VECTORS);
+        float residual = 0.0f;
+        for (size_t v = 0; v < NUM_VECTORS; ++v) {
+            for (size_t i = 0; i < n; ++i) {
+                cf sum(0.0f, 0.0f);
+                for (size_t k = 0; k < n; ++k) sum += R[i * n + k] * x[v * n + k];
+                residual = std::max(residual, std::abs(sum - steering[v * n + i]));
+            }
+        }
+        printf("  Solve: max|R·x - b| = %.3g\n", residual);
+        if (!(residual < 1e-2f)) {
+            throw std::runtime_error("CPU solve residual too large");
+        }
+
+        PrintResult(true, "MVDR Weights Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "MVDR Weights Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 3: Скользящее окно (SlidingCovariance)
+// ============================================================================
+
+bool TestSlidingCovariance() {
+    PrintHeader("🧪 ТЕСТ 3: Sliding-window Cholesky (rank-k update/downdate)");
+
+    try {
+        using cf = std::complex<float>;
+
+        const size_t CHANNELS = 85;
+        const size_t WINDOW = 4 * CHANNELS;
+        const size_t STEP = 8;
+        const size_t REFACTOR_INTERVAL = 16;
+        const size_t PUSHES = 3 * WINDOW / STEP;    // окно заполняется и сдвигается дважды
+
+        auto rel_error = [](const std::vector<cf>& a, const std::vector<cf>& b) {
+            double num = 0.0, den = 0.0;
+            for (size_t i = 0; i < a.size(); ++i) {
+                num += std::norm(a[i] - b[i]);
+                den += std::norm(b[i]);
+            }
+            return static_cast<float>(std::sqrt(num / den));
+        };
+
+        // Помеха (20 дБ над шумом) с медленно меняющимся направлением
+        std::mt19937 rng(22);
+        std::normal_distribution<float> noise(0.0f, std::sqrt(0.5f));
+        size_t time = 0;
+        auto make_block = [&](size_t count) {
+            std::vector<cf> x(CHANNELS * count);
+            for (size_t t = 0; t < count; ++t, ++time) {
+                const float u = 0.3f + 1e-4f * time;
+                const cf s = 10.0f * cf(noise(rng), noise(rng));
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    x[c * count + t] = s * std::polar(1.0f, static_cast<float>(M_PI) * c * u) + cf(noise(rng), noise(rng));
+                }
+            }
+            return x;
+        };
+        std::vector<cf> look(CHANNELS);
+        for (size_t c = 0; c < CHANNELS; ++c) look[c] = std::polar(1.0f, static_cast<float>(M_PI) * c * -0.1f);
+
+        // ─── 1. Сдвиг по STEP снимков против точной суммы окна ───
+        SlidingCovariance window(CHANNELS, WINDOW, 1e-2f, REFACTOR_INTERVAL);
+        HermitianCPUInverter reference(CHANNELS);
+        float worst_drift = 0.0f, worst_weights = 0.0f;
+        size_t refactors = 0;
+        double update_ms = 0.0;
+        for (size_t p = 0; p < PUSHES; ++p) {
+            window.Push(make_block(STEP), STEP);
+            const auto& stats = window.GetLastStats();
+            if (stats.refactored) {
+                ++refactors;
+            } else {
+                update_ms += stats.total_ms;
+            }
+            if (p % 16 == 7 || p + 1 == PUSHES) {
+                const auto exact = window.GetExactCovariance();
+                worst_drift = std::max(worst_drift, rel_error(window.GetCovariance(), exact));
+                worst_weights = std::max(worst_weights, rel_error(window.MVDRWeights(look, 1),
+                                                                  reference.MVDRWeights(exact, look, 1)));
+            }
+        }
+        reference.Invert(window.GetExactCovariance());
+        printf("  n = %zu, window %zu, step %zu: %zu pushes, %zu refactors\n",
+               CHANNELS, WINDOW, STEP, PUSHES, refactors);
+        printf("  ||LL^H/K - R||/||R|| <= %.3g, weights rel diff <= %.3g\n", worst_drift, worst_weights);
+        printf("  update %.3f ms / push vs full inverse %.3f ms\n",
+               update_ms / (PUSHES - refactors), reference.GetLastStats().total_ms);
+        if (window.GetFilled() != WINDOW || refactors != PUSHES / REFACTOR_INTERVAL ||
+            !(worst_drift < 1e-4f) || !(worst_weights < 1e-2f)) {
+            throw std::runtime_error("sliding covariance mismatch");
+        }
+
+        // ─── 2. Без переразложений и порция длиннее окна ───
+        SlidingCovariance no_refactor(CHANNELS, WINDOW, 1e-2f, 0);
+        for (size_t p = 0; p < PUSHES; ++p) no_refactor.Push(make_block(STEP), STEP);
+        const float drift = rel_error(no_refactor.GetCovariance(), no_refactor.GetExactCovariance());
+        no_refactor.Push(make_block(2 * WINDOW + 5), 2 * WINDOW + 5);
+        const float long_drift = rel_error(no_refactor.GetCovariance(), no_refactor.GetExactCovariance());
+        printf("  no refactor: drift %.3g after %zu pushes, %.3g after block of %zu\n",
+               drift, PUSHES, long_drift, 2 * WINDOW + 5);
+        if (!(drift < 1e-4f) || !(long_drift < 1e-4f) || no_refactor.GetFilled() != WINDOW) {
+            throw std::runtime_error("sliding covariance drift too large");
+        }
+
+        PrintResult(true, "Sliding Covariance Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Sliding Covariance Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 4: Смешанная точность (SolveRefined)
+// ============================================================================
+
+bool TestMixedPrecision() {
+    PrintHeader("🧪 ТЕСТ 4: Mixed-precision solve (FP32 Cholesky + refinement in double)");
+
+    try {
+        // Малая диагональная нагрузка: κ(R) ~ 1e4, решение в float теряет ~4 знака
+        size_t n = 0;
+        const auto R = LoadWithLoading("Matrix/data/R_341.csv", n, 1e-4f);
+        const size_t NUM_RHS = 4;
+        std::vector<std::complex<float>> rhs(NUM_RHS * n);
+        for (size_t r = 0; r < NUM_RHS; ++r) {
+            for (size_t k = 0; k < n; ++k) rhs[r * n + k] = std::polar(1.0f, 0.37f * k * (r + 1));
+        }
+
+        HermitianCPUInverter inverter(n);
+        const double float_eta = BackwardError(R, rhs, inverter.Solve(R, rhs, NUM_RHS), 0, n, NUM_RHS);
+        auto refined = inverter.SolveRefined(R, rhs, NUM_RHS);
+        const auto stats = inverter.GetLastStats();
+        const double refined_eta = BackwardError(R, rhs, refined, 0, n, NUM_RHS);
+        printf("  n = %zu: eta float %.3g -> refined %.3g (reported %.3g, %zu iterations)\n",
+               n, float_eta, refined_eta, stats.residual, stats.refine_iterations);
+        printf("      factor %.3f ms + solve/refine %.3f ms\n", stats.factor_ms, stats.refine_ms);
+        if (!(refined_eta < 1e-12) || !(refined_eta < 1e-3 * float_eta) || stats.refine_iterations == 0) {
+            throw std::runtime_error("CPU refinement did not converge");
+        }
+
+        PrintResult(true, "Mixed Precision Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Mixed Precision Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 cpu_linalg TEST SUITE");
+
+    int passed = 0;
+    int total = 4;
+
+    if (TestCPUHermitianInverse()) passed++;
+    if (TestMVDRWeights())         passed++;
+    if (TestSlidingCovariance())   passed++;
+    if (TestMixedPrecision())      passed++;
+
+    PrintHeader("📊 РЕЗУЛЬТАТЫ");
+    std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+    return (passed == total) ? 0 : 1;
+}
@@ -9,6 +9,9 @@
  * 4. Batch обработка нескольких лучей
  * 5. Интеграция с GeneratorGPU
  * 6. Профилирование GPU
+ * 7. Zero-copy вход через IMemoryBuffer (SVM если доступен)
+ * 8. Несколько устройств (DeviceGroup, под-устройства CPU через device fission)
+ * 9. Автоподбор work-group (WorkGroupTuner) совпадает с фиксированным local size
  * 
  * @author LCH-Farrow01 Project
  * @version 2.0
@@ -21,6 +24,10 @@
 #include "ManagerOpenCL/opencl_core.hpp"
 #include "ManagerOpenCL/command_queue_pool.hpp"
 #include "ManagerOpenCL/gpu_memory_buffer.hpp"
+#include "ManagerOpenCL/hybrid_buffer.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "ManagerOpenCL/work_group_tuner.hpp"
+#include "GPU/multi_device_processor.hpp"
 #include <CL/cl.h>
 
 #include <iostream>
@@ -29,6 +36,7 @@
 #include <cmath>
 #include <chrono>
 #include <complex>
+#include <cstdio>
 
 using namespace radar;
 using namespace ManagerOpenCL;
@@ -535,6 +543,207 @@ bool TestPerformance() {
     }
 }
 
+// ============================================================================
+// ТЕСТ 7: Zero-copy вход через IMemoryBuffer (SVM)
+// ============================================================================
+
+bool TestSVMInput() {
+    PrintHeader("🧪 ТЕСТ 7: IMemoryBuffer / SVM вход (zero-copy)");
+    
+    try {
+        auto config = FractionalDelayConfig::Diagnostic();
+        config.num_beams = 2;
+        config.num_samples = 128;
+        config.verbose = false;
+        
+        auto lagrange = LagrangeMatrix::LoadFromJSON("lagrange_matrix.json");
+        FractionalDelayProcessor processor(config, lagrange);
+        
+        std::vector<std::complex<float>> test_data(config.num_beams * config.num_samples, {0.0f, 0.0f});
+        test_data[0 * config.num_samples + 20] = {1.0f, 0.0f};
+        test_data[1 * config.num_samples + 30] = {1.0f, 0.0f};
+        
+        // Лучшая доступная стратегия: SVM если поддерживается, иначе regular
+        auto& engine = OpenCLComputeEngine::GetInstance();
+        auto strategy = engine.GetSVMCapabilities().GetBestSVMStrategy();
+        auto buffer = engine.CreateBufferWithStrategy(test_data.size(), strategy);
+        buffer->Write(test_data);
+        
+        std::cout << "  Стратегия: " << MemoryStrategyToString(buffer->GetStrategy()) << "\n";
+        
+        std::vector<DelayParams> delays(config.num_beams, DelayParams(5, 0));
+        processor.Process(buffer.get(), delays);
+        
+        auto result = buffer->Read();
+        
+        float peak0 = std::abs(result[0 * config.num_samples + 25]);
+        float peak1 = std::abs(result[1 * config.num_samples + 35]);
+        
+        std::cout << "  Луч 0, позиция 25: " << peak0 << " (ожидалось ~1.0)\n";
+        std::cout << "  Луч 1, позиция 35: " << peak1 << " (ожидалось ~1.0)\n";
+        
+        bool success = (peak0 > 0.9f && peak1 > 0.9f);
+        PrintResult(success, "SVM Input Test");
+        return success;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "SVM Input Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 8: Несколько устройств (DeviceGroup)
+// ============================================================================
+
+bool TestMultiDevice() {
+    PrintHeader("🧪 ТЕСТ 8: Несколько устройств (DeviceGroup)");
+    
+    try {
+        // 2 под-устройства CPU (PoCL поддерживает fission); иначе — все GPU
+        std::unique_ptr<DeviceGroup> group;
+        try {
+            group = std::make_unique<DeviceGroup>(DeviceGroup::FromSubDevices(DeviceType::CPU, 2));
+        } catch (const std::exception& e) {
+            std::cout << "  Device fission недоступен (" << e.what() << "), используем GPU\n";
+            group = std::make_unique<DeviceGroup>(DeviceGroup::FromAllDevices(DeviceType::GPU));
+        }
+        std::cout << group->ToString();
+        
+        // Разбиение: сумма лучей сохраняется, диапазоны подряд
+        group->SetWeights(std::vector<double>(group->Size(), 1.0));
+        auto ranges = group->PartitionBeams(7);
+        size_t covered = 0;
+        bool partition_ok = true;
+        for (const auto& r : ranges) {
+            partition_ok = partition_ok && (r.start == covered);
+            covered += r.count;
+        }
+        partition_ok = partition_ok && (covered == 7);
+        
+        auto config = FractionalDelayConfig::Diagnostic();
+        config.num_beams = 5;
+        config.num_samples = 128;
+        config.verbose = false;
+        
+        auto lagrange = LagrangeMatrix::LoadFromJSON("lagrange_matrix.json");
+        MultiDeviceFractionalDelay processor(config, lagrange, *group);
+        
+        // Импульс в каждом луче на позиции 10 + beam, задержка = beam + 1 отсчёт
+        std::vector<std::complex<float>> data(config.num_beams * config.num_samples, {0.0f, 0.0f});
+        std::vector<DelayParams> delays;
+        for (uint32_t b = 0; b < config.num_beams; ++b) {
+            data[b * config.num_samples + 10 + b] = {1.0f, 0.0f};
+            delays.emplace_back(static_cast<int32_t>(b + 1), 0);
+        }
+        
+        // Два прохода: второй идёт с весами, обновлёнными по замеру
+        auto data_copy = data;
+        processor.Process(data, delays);
+        processor.Process(data_copy, delays);
+        
+        bool peaks_ok = true;
+        for (uint32_t b = 0; b < config.num_beams; ++b) {
+            size_t expected = b * config.num_samples + 10 + 2 * b + 1;
+            float peak = std::abs(data[expected]);
+            float peak2 = std::abs(data_copy[expected]);
+            std::cout << "  Луч " << b << ": |x[" << (10 + 2 * b + 1) << "]| = " << peak
+                      << " / " << peak2 << " (ожидалось ~1.0)\n";
+            peaks_ok = peaks_ok && peak > 0.9f && peak2 > 0.9f;
+        }
+        std::cout << group->ToString();
+        
+        bool success = partition_ok && peaks_ok;
+        PrintResult(success, "Multi-Device Test");
+        return success;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Multi-Device Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 9: Автоподбор work-group (WorkGroupTuner)
+// ============================================================================
+
+bool TestWorkGroupTuner() {
+    PrintHeader("🧪 ТЕСТ 9: Автоподбор work-group (WorkGroupTuner)");
+    
+    try {
+        // Отдельная база, чтобы тест всегда выполнял подбор
+        WorkGroupTunerConfig tuner_config;
+        tuner_config.db_path = "Reports/tuning/test_work_group_db.csv";
+        tuner_config.verbose = true;
+        WorkGroupTuner::SetConfig(tuner_config);
+        std::remove(tuner_config.db_path.c_str());
+        
+        auto config = FractionalDelayConfig::Diagnostic();
+        config.num_beams = 8;
+        config.num_samples = 4096;
+        config.verbose = false;
+        
+        auto lagrange = LagrangeMatrix::LoadFromJSON("lagrange_matrix.json");
+        
+        std::vector<std::complex<float>> input(config.num_beams * config.num_samples);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = {std::sin(0.01f * i), std::cos(0.013f * i)};
+        }
+        std::vector<DelayParams> delays;
+        for (uint32_t b = 0; b < config.num_beams; ++b) {
+            delays.emplace_back(static_cast<int32_t>(b), b * 5 % LAGRANGE_ROWS);
+        }
+        
+        auto& engine = OpenCLComputeEngine::GetInstance();
+        auto run = [&](FractionalDelayProcessor& processor) {
+            auto buffer = engine.CreateBufferWithData(input, MemoryType::GPU_READ_WRITE);
+            processor.Process(buffer->Get(), delays);
+            return buffer->ReadFromGPU();
+        };
+        
+        // Эталон: фиксированный local size без подбора
+        auto fixed_config = config;
+        fixed_config.auto_tune = false;
+        FractionalDelayProcessor fixed(fixed_config, lagrange);
+        auto expected = run(fixed);
+        
+        FractionalDelayProcessor tuned(config, lagrange);
+        auto actual = run(tuned);
+        
+        ManagerOpenCL::WorkGroupConfig wg;
+        bool saved = WorkGroupTuner::Lookup("fractional_delay_kernel",
+                                            OpenCLCore::GetInstance().GetDevice(),
+                                            input.size(), wg);
+        std::cout << "  Подобрано: local=" << wg.local_size
+                  << ", items/work-item=" << wg.items_per_work_item
+                  << ", " << wg.time_ms << " ms\n";
+        
+        // Второй процессор берёт конфигурацию из базы при создании
+        WorkGroupTuner::Clear();
+        FractionalDelayProcessor reloaded(config, lagrange);
+        auto reloaded_result = run(reloaded);
+        
+        float mse = CalculateMSE(expected, actual);
+        float mse_reloaded = CalculateMSE(expected, reloaded_result);
+        std::cout << "  MSE (tuned vs fixed):    " << mse << "\n";
+        std::cout << "  MSE (reloaded vs fixed): " << mse_reloaded << "\n";
+        
+        WorkGroupTuner::SetConfig(WorkGroupTunerConfig{});
+        
+        bool success = saved && wg.IsValid() && mse < 1e-10f && mse_reloaded < 1e-10f;
+        PrintResult(success, "Work-Group Tuner Test");
+        return success;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        WorkGroupTuner::SetConfig(WorkGroupTunerConfig{});
+        PrintResult(false, "Work-Group Tuner Test");
+        return false;
+    }
+}
+
 // ============================================================================
 // MAIN
 // ============================================================================
@@ -557,7 +766,7 @@ int main() {
         
         // Запустить тесты
         int passed = 0;
-        int total = 6;
+        int total = 9;
         
         if (TestZeroDelay())          passed++;
         if (TestIntegerDelay())       passed++;
@@ -565,6 +774,9 @@ int main() {
         if (TestBatchProcessing())    passed++;
         if (TestGeneratorIntegration()) passed++;
         if (TestPerformance())        passed++;
+        if (TestSVMInput())           passed++;
+        if (TestMultiDevice())        passed++;
+        if (TestWorkGroupTuner())     passed++;
         
         // Итоги
         PrintHeader("📊 РЕЗУЛЬТАТЫ");
@@ -0,0 +1,205 @@
+/**
+ * @file test_frame_replay.cpp
+ * @brief Тесты записи кадров с параметрами и воспроизведения (FrameRecorder / FrameReplayer)
+ *
+ * Тестовые сценарии:
+ * 1. Формат без потерь, максимальная скорость, сброс кадров при темпе выше обслуживания,
+ *    конвейер FDP → AntennaFFTProcMax из параметров записи в темпе записи
+ *
+ * Таблица Лагранжа читается из lagrange_matrix.json — запускать из корня репозитория.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/frame_replay.hpp"
+#include "GPU/fractional_delay_processor.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include <CL/cl.h>
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+// ============================================================================
+// ТЕСТ 1: Запись и воспроизведение кадров
+// ============================================================================
+
+bool TestFrameReplay() {
+    PrintHeader("🧪 ТЕСТ 1: Frame record/replay (FrameRecorder / FrameReplayer)");
+
+    try {
+        using cf = std::complex<float>;
+
+        const size_t BEAMS = 8;
+        const size_t SAMPLES = 1024;
+        const size_t FRAMES = 6;
+        const uint64_t PERIOD_NS = 1000000;   // 1 мс
+
+        std::vector<std::vector<cf>> frames(FRAMES, std::vector<cf>(BEAMS * SAMPLES));
+        for (size_t f = 0; f < FRAMES; ++f) {
+            for (size_t b = 0; b < BEAMS; ++b) {
+                for (size_t t = 0; t < SAMPLES; ++t) {
+                    const float phase = 2.0f * static_cast<float>(M_PI) * (0.01f * (b + 1) * t + 0.1f * f);
+                    frames[f][b * SAMPLES + t] = cf(std::cos(phase), std::sin(phase));
+                }
+            }
+        }
+
+        // ─── 1. Запись: кадры + AntennaFFTParams + FDP + задержки ───
+        antenna_fft::FrameRecordingInfo info;
+        info.fft = antenna_fft::AntennaFFTParams(BEAMS, SAMPLES, 512, 3, "test_frame_replay", "test_module");
+        info.has_fdp = true;
+        info.fdp.num_beams = BEAMS;
+        info.fdp.num_samples = SAMPLES;
+        info.fdp.verbose = false;
+        for (size_t b = 0; b < BEAMS; ++b) {
+            info.delays.push_back(radar::DelayParams::FromSamples(0.37f * static_cast<float>(b)));
+        }
+
+        const std::string path = (std::filesystem::temp_directory_path() / "lch_test_frames.lchrec").string();
+        {
+            antenna_fft::FrameRecorder recorder(path, info);
+            for (size_t f = 0; f < FRAMES; ++f) recorder.Append(frames[f], f * PERIOD_NS);
+        }
+
+        antenna_fft::FrameRecording recording(path);
+        const auto& loaded = recording.GetInfo();
+        bool params_ok = loaded.fft.beam_count == BEAMS && loaded.fft.count_points == SAMPLES &&
+                         loaded.fft.out_count_points_fft == 512 && loaded.fft.max_peaks_count == 3 &&
+                         loaded.has_fdp && loaded.fdp.num_beams == BEAMS && loaded.fdp.num_samples == SAMPLES &&
+                         loaded.fdp.local_work_size == info.fdp.local_work_size &&
+                         loaded.delays.size() == BEAMS && recording.GetFramePeriodNs() == PERIOD_NS;
+        for (size_t b = 0; b < BEAMS && params_ok; ++b) {
+            params_ok = loaded.delays[b].delay_integer == info.delays[b].delay_integer &&
+                        loaded.delays[b].lagrange_row == info.delays[b].lagrange_row;
+        }
+        bool frames_ok = recording.GetFrameCount() == FRAMES;
+        for (size_t f = 0; f < FRAMES && frames_ok; ++f) {
+            frames_ok = std::memcmp(recording.GetFrame(f), frames[f].data(), frames[f].size() * sizeof(cf)) == 0;
+        }
+        printf("  recording: %zu frames, params %s, frames bit-exact %s\n",
+               recording.GetFrameCount(), params_ok ? "✅" : "❌", frames_ok ? "✅" : "❌");
+        if (!params_ok || !frames_ok) {
+            throw std::runtime_error("recording round trip mismatch");
+        }
+
+        // ─── 2. Максимальная скорость: все кадры, на устройстве — кадры записи ───
+        antenna_fft::FrameReplayer replayer(recording);
+        antenna_fft::ReplayOptions options;
+        options.loops = 2;
+        bool device_ok = true;
+        auto max_stats = replayer.Run(options, [&](cl_mem frame, size_t index) {
+            std::vector<cf> host(BEAMS * SAMPLES);
+            auto queue = CommandQueuePool::GetNextQueue();
+            clEnqueueReadBuffer(queue, frame, CL_TRUE, 0, host.size() * sizeof(cf), host.data(), 0, nullptr, nullptr);
+            device_ok = device_ok && host == frames[index];
+        });
+        printf("  max speed: %zu/%zu processed, %zu dropped, %.1f frames/s, latency median %.3f ms\n",
+               max_stats.frames_processed, max_stats.frames_offered, max_stats.frames_dropped,
+               max_stats.frames_per_sec, max_stats.latency.median_ms);
+        if (max_stats.frames_offered != 2 * FRAMES || max_stats.frames_processed != 2 * FRAMES ||
+            max_stats.frames_dropped != 0 || !device_ok) {
+            throw std::runtime_error("max speed replay mismatch");
+        }
+
+        // ─── 3. 2 кГц против обработчика на 2 мс, очередь 1: старшие кадры сбрасываются ───
+        options.loops = 1;
+        options.rate_hz = 2000.0;
+        auto paced_stats = replayer.Run(options, [](cl_mem, size_t) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        });
+        printf("  2 kHz, 2 ms handler: %zu processed, %zu dropped, latency p99 %.3f ms\n",
+               paced_stats.frames_processed, paced_stats.frames_dropped, paced_stats.latency.p99_ms);
+        if (paced_stats.frames_dropped == 0 ||
+            paced_stats.frames_processed + paced_stats.frames_dropped != paced_stats.frames_offered ||
+            paced_stats.latency.min_ms < paced_stats.service.min_ms) {
+            throw std::runtime_error("paced replay drop accounting mismatch");
+        }
+
+        // ─── 4. Конвейер из параметров записи в темпе записи ───
+        auto lagrange = radar::LagrangeMatrix::LoadFromJSON("lagrange_matrix.json");
+        options.rate_hz = 0.0;
+        options.recorded_timing = true;
+        options.queue_depth = FRAMES;
+        auto pipeline_stats = replayer.RunPipeline(options, &lagrange);
+        printf("  FDP → AntennaFFTProcMax, recorded timing: %zu processed, %zu dropped, service median %.3f ms, wall %.2f ms\n",
+               pipeline_stats.frames_processed, pipeline_stats.frames_dropped,
+               pipeline_stats.service.median_ms, pipeline_stats.wall_ms);
+
+        std::filesystem::remove(path);
+        if (pipeline_stats.frames_processed + pipeline_stats.frames_dropped != FRAMES ||
+            pipeline_stats.wall_ms < (FRAMES - 1) * PERIOD_NS * 1e-6) {
+            throw std::runtime_error("pipeline replay mismatch");
+        }
+
+        PrintResult(true, "Frame Replay Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Frame Replay Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 FrameReplay TEST SUITE");
+
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+
+        int passed = 0;
+        int total = 1;
+
+        if (TestFrameReplay()) passed++;
+
+        PrintHeader("📊 РЕЗУЛЬТАТЫ");
+        std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+        return (passed == total) ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ FATAL ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
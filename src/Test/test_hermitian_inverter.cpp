@@ -0,0 +1,461 @@
+/**
+ * @file test_hermitian_inverter.cpp
+ * @brief Тесты HermitianInverter и CovarianceEstimator (эрмитовы матрицы на OpenCL)
+ *
+ * Тестовые сценарии:
+ * 1. R_85 / R_341 из Matrix/data пакетом, ||A·A^-1 - I||_F; отказ на неопределённой матрице
+ * 2. MVDR веса пакетом (MVDRWeights) против HermitianCPUInverter, w^H s = 1
+ * 3. CovarianceEstimator: пакет против эталона, точная эрмитовость, X → R → MVDR веса без хоста
+ * 4. SolveRefinedBatched: fp64 или float-float невязка, обратная ошибка на порядки ниже решения в float
+ *
+ * Матрицы читаются из Matrix/data — запускать из корня репозитория.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/hermitian_inverter.hpp"
+#include "ManagerOpenCL/covariance_estimator.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include "CPU/hermitian_cpu_inverter.hpp"
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+/// Диагональная нагрузка loading·trace/n
+std::vector<std::complex<float>> WithLoading(std::vector<std::complex<float>> R, size_t n, float loading) {
+    float trace = 0.0f;
+    for (size_t i = 0; i < n; ++i) trace += R[i * n + i].real();
+    for (size_t i = 0; i < n; ++i) R[i * n + i] += loading * trace / n;
+    return R;
+}
+
+/// Векторы наведения эквидистантной решётки (d = λ/2) на -40°, -20°, ... с шагом 20°
+std::vector<std::complex<float>> MakeSteering(size_t n, size_t count) {
+    std::vector<std::complex<float>> steering(count * n);
+    for (size_t v = 0; v < count; ++v) {
+        const float theta = (-40.0f + 20.0f * v) * static_cast<float>(M_PI) / 180.0f;
+        for (size_t k = 0; k < n; ++k) {
+            steering[v * n + k] = std::polar(1.0f, static_cast<float>(M_PI) * k * std::sin(theta));
+        }
+    }
+    return steering;
+}
+
+/// Обратная ошибка η = max_r ||b - R x||_inf / (||R||_inf ||x||_inf + ||b||_inf) в double
+template <typename Solution>
+double BackwardError(const std::vector<std::complex<float>>& R, const std::vector<std::complex<float>>& rhs,
+                     const Solution& solution, size_t offset, size_t n, size_t num_rhs) {
+    using cd = std::complex<double>;
+    double r_norm = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double row = 0.0;
+        for (size_t k = 0; k < n; ++k) row += std::abs(cd(R[i * n + k]));
+        r_norm = std::max(r_norm, row);
+    }
+    double worst = 0.0;
+    for (size_t r = 0; r < num_rhs; ++r) {
+        double res = 0.0, x_max = 0.0, b_max = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            cd sum(0.0, 0.0);
+            for (size_t k = 0; k < n; ++k) sum += cd(R[i * n + k]) * cd(solution[offset + r * n + k]);
+            res = std::max(res, std::abs(cd(rhs[r * n + i]) - sum));
+            x_max = std::max(x_max, std::abs(cd(solution[offset + r * n + i])));
+            b_max = std::max(b_max, std::abs(cd(rhs[r * n + i])));
+        }
+        worst = std::max(worst, res / (r_norm * x_max + b_max));
+    }
+    return worst;
+}
+
+// ============================================================================
+// ТЕСТ 1: Пакетное обращение (Cholesky)
+// ============================================================================
+
+bool TestHermitianInverse() {
+    PrintHeader("🧪 ТЕСТ 1: Batched Hermitian inverse (OpenCL Cholesky)");
+
+    try {
+        // Ковариационные матрицы из Matrix/data плохо обусловлены: без диагональной
+        // нагрузки ошибка float Cholesky ~0.7 (85) и ~2 (341), с 1e-2·trace/n — < 1e-2
+        struct Case { const char* path; float tolerance; };
+        for (const Case& c : {Case{"Matrix/data/R_85.csv", 1e-2f}, Case{"Matrix/data/R_341.csv", 5e-2f}}) {
+            size_t n = 0;
+            auto R = HermitianInverter::LoadMatrixCSV(c.path, &n);
+            HermitianInverter inverter(n);
+
+            // Без нагрузки — только вывод (как compute_frobenius_error в Matrix/)
+            float raw_error = HermitianInverter::FrobeniusError(R, inverter.Invert(R), n);
+
+            // Пакет: одна матрица с разной нагрузкой
+            const size_t BATCH = 8;
+            std::vector<std::complex<float>> batch;
+            batch.reserve(BATCH * n * n);
+            for (size_t b = 0; b < BATCH; ++b) {
+                auto Rb = WithLoading(R, n, 1e-2f * (1.0f + 0.25f * b));
+                batch.insert(batch.end(), Rb.begin(), Rb.end());
+            }
+            auto inverse = inverter.InvertBatched(batch, BATCH);
+            const auto stats = inverter.GetLastStats();
+
+            float worst = 0.0f;
+            for (size_t b = 0; b < BATCH; ++b) {
+                std::vector<std::complex<float>> A(batch.begin() + b * n * n, batch.begin() + (b + 1) * n * n);
+                std::vector<std::complex<float>> A_inv(inverse.begin() + b * n * n, inverse.begin() + (b + 1) * n * n);
+                worst = std::max(worst, HermitianInverter::FrobeniusError(A, A_inv, n));
+            }
+            printf("  n = %3zu (padded %3zu): raw ||R·R^-1 - I||_F = %.3g, loaded batch of %zu worst = %.3g\n",
+                   n, inverter.GetPaddedSize(), raw_error, BATCH, worst);
+            printf("             factor %.3f ms, L^-1 %.3f ms, W^H W %.3f ms (%.3f ms / matrix)\n",
+                   stats.factor_ms, stats.invert_ms, stats.product_ms, stats.total_ms / BATCH);
+            if (!(worst < c.tolerance)) {
+                throw std::runtime_error(std::string("inverse error too large for ") + c.path);
+            }
+        }
+
+        // Не положительно определённая матрица — исключение с номером столбца
+        bool rejected = false;
+        try {
+            HermitianInverter inverter(4);
+            std::vector<std::complex<float>> bad(16, std::complex<float>(0.0f, 0.0f));
+            bad[0] = bad[5] = bad[15] = 1.0f;
+            bad[10] = -1.0f;
+            inverter.Invert(bad);
+        } catch (const std::runtime_error& e) {
+            rejected = std::string(e.what()).find("column 2") != std::string::npos;
+        }
+        printf("  Indefinite matrix rejected: %s\n", rejected ? "yes" : "no");
+        if (!rejected) {
+            throw std::runtime_error("indefinite matrix not reported");
+        }
+
+        // Тот же код на CPU OpenCL устройстве (если есть)
+        std::unique_ptr<DeviceGroup> cpu;
+        try {
+            cpu = std::make_unique<DeviceGroup>(DeviceGroup::FromAllDevices(DeviceType::CPU, 1));
+        } catch (const std::runtime_error& e) {
+            std::cout << "  CPU OpenCL device not available (" << e.what() << "), skipped\n";
+        }
+        if (cpu) {
+            size_t n = 0;
+            auto R = HermitianInverter::LoadMatrixCSV("Matrix/data/R_85.csv", &n);
+            R = WithLoading(std::move(R), n, 1e-2f);
+            HermitianInverter inverter(n, cpu->Get(0));
+            float error = HermitianInverter::FrobeniusError(R, inverter.Invert(R), n);
+            printf("  CPU device %s: error %.3g, %.3f ms\n", cpu->Get(0).name.c_str(), error,
+                   inverter.GetLastStats().total_ms);
+            if (!(error < 1e-2f)) {
+                throw std::runtime_error("inverse error too large on CPU device");
+            }
+        }
+
+        PrintResult(true, "Hermitian Inverse Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Hermitian Inverse Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 2: MVDR веса пакетом
+// ============================================================================
+
+bool TestMVDRWeights() {
+    PrintHeader("🧪 ТЕСТ 2: Batched MVDR weights via Cholesky solve");
+
+    try {
+        using cf = std::complex<float>;
+
+        size_t n = 0;
+        auto R = HermitianInverter::LoadMatrixCSV("Matrix/data/R_341.csv", &n);
+        R = WithLoading(std::move(R), n, 1e-2f);
+        const size_t NUM_VECTORS = 5;
+        const auto steering = MakeSteering(n, NUM_VECTORS);
+
+        // Эталон — CPU решение (проверено против явной обратной в test_cpu_linalg)
+        const auto reference = cpu_linalg::HermitianCPUInverter(n).MVDRWeights(R, steering, NUM_VECTORS);
+
+        // Пакет из двух одинаковых матриц, векторы общие
+        HermitianInverter inverter(n);
+        const size_t BATCH = 2;
+        std::vector<cf> batch;
+        for (size_t b = 0; b < BATCH; ++b) batch.insert(batch.end(), R.begin(), R.end());
+        auto weights = inverter.MVDRWeights(batch, steering, NUM_VECTORS, BATCH);
+        const auto stats = inverter.GetLastStats();
+
+        for (size_t b = 0; b < BATCH; ++b) {
+            const size_t offset = b * NUM_VECTORS * n;
+            float diff = 0.0f, distortion = 0.0f;
+            for (size_t v = 0; v < NUM_VECTORS; ++v) {
+                float num = 0.0f, den = 0.0f;
+                cf gain(0.0f, 0.0f);
+                for (size_t i = 0; i < n; ++i) {
+                    const cf w = weights[offset + v * n + i];
+                    num += std::norm(w - reference[v * n + i]);
+                    den += std::norm(reference[v * n + i]);
+                    gain += std::conj(w) * steering[v * n + i];
+                }
+                diff = std::max(diff, std::sqrt(num / den));
+                distortion = std::max(distortion, std::abs(gain - cf(1.0f, 0.0f)));
+            }
+            printf("  matrix %zu: rel diff %.3g, max|w^H s - 1| = %.3g\n", b, diff, distortion);
+            if (!(diff < 5e-2f) || !(distortion < 1e-3f)) {
+                throw std::runtime_error("OpenCL MVDR weights mismatch");
+            }
+        }
+        printf("      factor %.3f ms + solve %.3f ms per batch of %zu\n", stats.factor_ms, stats.solve_ms, BATCH);
+
+        PrintResult(true, "MVDR Weights Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "MVDR Weights Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 3: Ковариационная матрица на устройстве (CovarianceEstimator)
+// ============================================================================
+
+bool TestCovarianceEstimation() {
+    PrintHeader("🧪 ТЕСТ 3: Sample covariance on device (R = XX^H/K + δI)");
+
+    try {
+        auto& engine = OpenCLComputeEngine::GetInstance();
+        using cf = std::complex<float>;
+
+        const size_t CHANNELS = 85;       // не кратно TILE
+        const size_t SNAPSHOTS = 4 * CHANNELS;
+        const float LOADING = 0.1f;
+
+        // Решётка λ/2: помеха с -20° (амплитуда 10) и шум
+        auto steering_at = [&](float degrees) {
+            std::vector<cf> a(CHANNELS);
+            const float u = std::sin(degrees * static_cast<float>(M_PI) / 180.0f);
+            for (size_t k = 0; k < CHANNELS; ++k) a[k] = std::polar(1.0f, static_cast<float>(M_PI) * k * u);
+            return a;
+        };
+        const auto interferer = steering_at(-20.0f);
+        std::mt19937 rng(21);
+        std::normal_distribution<float> noise(0.0f, std::sqrt(0.5f));
+        auto make_block = [&]() {
+            std::vector<cf> x(CHANNELS * SNAPSHOTS);
+            for (size_t t = 0; t < SNAPSHOTS; ++t) {
+                const cf s = 10.0f * cf(noise(rng), noise(rng));
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    x[c * SNAPSHOTS + t] = s * interferer[c] + cf(noise(rng), noise(rng));
+                }
+            }
+            return x;
+        };
+        auto reference = [&](const cf* x) {
+            std::vector<cf> R(CHANNELS * CHANNELS);
+            for (size_t i = 0; i < CHANNELS; ++i) {
+                for (size_t j = 0; j < CHANNELS; ++j) {
+                    std::complex<double> sum(0.0, 0.0);
+                    for (size_t t = 0; t < SNAPSHOTS; ++t) {
+                        sum += std::complex<double>(x[i * SNAPSHOTS + t]) * std::conj(std::complex<double>(x[j * SNAPSHOTS + t]));
+                    }
+                    R[i * CHANNELS + j] = cf(sum / static_cast<double>(SNAPSHOTS)) + (i == j ? LOADING : 0.0f);
+                }
+            }
+            return R;
+        };
+
+        // ─── 1. Пакет из двух блоков против эталона, точная эрмитовость ───
+        const size_t BATCH = 2;
+        std::vector<cf> blocks;
+        for (size_t b = 0; b < BATCH; ++b) {
+            auto x = make_block();
+            blocks.insert(blocks.end(), x.begin(), x.end());
+        }
+        CovarianceEstimator estimator(CHANNELS, SNAPSHOTS);
+        auto R = estimator.Estimate(blocks, BATCH, LOADING);
+
+        float max_error = 0.0f, max_ref = 0.0f;
+        bool hermitian = true;
+        for (size_t b = 0; b < BATCH; ++b) {
+            const auto ref = reference(blocks.data() + b * CHANNELS * SNAPSHOTS);
+            const cf* r = R.data() + b * CHANNELS * CHANNELS;
+            for (size_t i = 0; i < CHANNELS; ++i) {
+                for (size_t j = 0; j < CHANNELS; ++j) {
+                    max_error = std::max(max_error, std::abs(r[i * CHANNELS + j] - ref[i * CHANNELS + j]));
+                    max_ref = std::max(max_ref, std::abs(ref[i * CHANNELS + j]));
+                    hermitian = hermitian && r[i * CHANNELS + j] == std::conj(r[j * CHANNELS + i]);
+                }
+            }
+        }
+        printf("  %zu x %zu snapshots, batch %zu: max rel error %.3g, hermitian %s, %.3f ms\n",
+               CHANNELS, SNAPSHOTS, BATCH, max_error / max_ref, hermitian ? "yes" : "no",
+               estimator.GetLastTimeMs());
+        if (!(max_error / max_ref < 1e-5f) || !hermitian) {
+            throw std::runtime_error("covariance mismatch");
+        }
+
+        // ─── 2. Без хоста: X (строки с шагом nFFT) → R → MVDR веса ───
+        const size_t ROW_STRIDE = SNAPSHOTS + 12;
+        const auto x = make_block();
+        std::vector<cf> strided(CHANNELS * ROW_STRIDE, cf(1e3f, 1e3f));   // хвост строк не должен читаться
+        for (size_t c = 0; c < CHANNELS; ++c) {
+            std::copy(x.begin() + c * SNAPSHOTS, x.begin() + (c + 1) * SNAPSHOTS, strided.begin() + c * ROW_STRIDE);
+        }
+        const auto look = steering_at(10.0f);
+        auto x_buffer = engine.CreateBufferWithData(strided);
+        auto steering_buffer = engine.CreateBufferWithData(look);
+        auto covariance_buffer = engine.CreateBuffer(CHANNELS * CHANNELS, MemoryType::GPU_READ_WRITE);
+        auto weights_buffer = engine.CreateBuffer(CHANNELS, MemoryType::GPU_READ_WRITE);
+
+        HermitianInverter inverter(CHANNELS);
+        estimator.Estimate(x_buffer->Get(), covariance_buffer->Get(), 1, LOADING, ROW_STRIDE);
+        inverter.MVDRWeights(covariance_buffer->Get(), steering_buffer->Get(), weights_buffer->Get(), 1, 1);
+        auto weights = weights_buffer->ReadFromGPU();
+
+        auto expected = cpu_linalg::HermitianCPUInverter(CHANNELS).MVDRWeights(reference(x.data()), look, 1);
+        float diff = 0.0f, norm = 0.0f;
+        cf look_gain(0.0f, 0.0f), jam_gain(0.0f, 0.0f);
+        for (size_t k = 0; k < CHANNELS; ++k) {
+            diff += std::norm(weights[k] - expected[k]);
+            norm += std::norm(expected[k]);
+            look_gain += std::conj(weights[k]) * look[k];
+            jam_gain += std::conj(weights[k]) * interferer[k];
+        }
+        const float suppression_db = 20.0f * std::log10(std::abs(jam_gain) / std::abs(look_gain));
+        printf("  Device pipeline: weights rel diff %.3g, |w^H a(10°)| = %.4f, interferer %.1f dB\n",
+               std::sqrt(diff / norm), std::abs(look_gain), suppression_db);
+        if (!(std::sqrt(diff / norm) < 1e-2f) || !(std::abs(std::abs(look_gain) - 1.0f) < 1e-3f) ||
+            !(suppression_db < -30.0f)) {
+            throw std::runtime_error("device covariance → MVDR mismatch");
+        }
+
+        PrintResult(true, "Covariance Estimation Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Covariance Estimation Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 4: Смешанная точность пакетом (SolveRefinedBatched)
+// ============================================================================
+
+bool TestMixedPrecision() {
+    PrintHeader("🧪 ТЕСТ 4: Mixed-precision batched solve (FP32 Cholesky + refinement)");
+
+    try {
+        using cf = std::complex<float>;
+
+        // Малая диагональная нагрузка: κ(R) ~ 1e4, решение в float теряет ~4 знака
+        size_t n = 0;
+        auto R = HermitianInverter::LoadMatrixCSV("Matrix/data/R_341.csv", &n);
+        R = WithLoading(std::move(R), n, 1e-4f);
+        const size_t NUM_RHS = 4;
+        std::vector<cf> rhs(NUM_RHS * n);
+        for (size_t r = 0; r < NUM_RHS; ++r) {
+            for (size_t k = 0; k < n; ++k) rhs[r * n + k] = std::polar(1.0f, 0.37f * k * (r + 1));
+        }
+
+        // fp64 или float-float невязка, пакет из двух матриц
+        HermitianInverter inverter(n);
+        const size_t BATCH = 2;
+        std::vector<cf> matrices, batch_rhs;
+        for (size_t b = 0; b < BATCH; ++b) {
+            matrices.insert(matrices.end(), R.begin(), R.end());
+            batch_rhs.insert(batch_rhs.end(), rhs.begin(), rhs.end());
+        }
+        auto refined = inverter.SolveRefinedBatched(matrices, batch_rhs, NUM_RHS, BATCH);
+        const auto stats = inverter.GetLastStats();
+        printf("  %s residual: eta %.3g -> %.3g, %zu iterations\n",
+               inverter.HasFP64() ? "fp64" : "float-float",
+               stats.initial_residual, stats.residual, stats.refine_iterations);
+        for (size_t b = 0; b < BATCH; ++b) {
+            const double eta = BackwardError(R, rhs, refined, b * NUM_RHS * n, n, NUM_RHS);
+            printf("  matrix %zu: eta %.3g\n", b, eta);
+            if (!(eta < 1e-11) || !(eta < 1e-3 * stats.initial_residual)) {
+                throw std::runtime_error("OpenCL refinement did not converge");
+            }
+        }
+        printf("      factor %.3f ms + solve %.3f ms + refine %.3f ms per batch of %zu\n",
+               stats.factor_ms, stats.solve_ms, stats.refine_ms, BATCH);
+
+        PrintResult(true, "Mixed Precision Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Mixed Precision Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 HermitianInverter TEST SUITE");
+
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+
+        int passed = 0;
+        int total = 4;
+
+        if (TestHermitianInverse())     passed++;
+        if (TestMVDRWeights())          passed++;
+        if (TestCovarianceEstimation()) passed++;
+        if (TestMixedPrecision())       passed++;
+
+        PrintHeader("📊 РЕЗУЛЬТАТЫ");
+        std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+        return (passed == total) ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ FATAL ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,240 @@
+/**
+ * @file test_iq_frame_source.cpp
+ * @brief Тесты IQFrameSource (кадры из записи int16 IQ)
+ *
+ * Тестовые сценарии:
+ * 1. mmap → pinned кольцо → int16 → float2 с DC/усилением на устройстве против хоста:
+ *    сырой SAMPLE_MAJOR файл с заголовком, Seek, контейнер BEAM_MAJOR, кадр → AntennaFFTProcMax
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/iq_frame_source.hpp"
+#include "GPU/antenna_fft_proc_max.h"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/mapped_array_file.hpp"
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+// ============================================================================
+// ТЕСТ 1: Запись int16 IQ → кадры на устройстве
+// ============================================================================
+
+bool TestIQFrameSource() {
+    PrintHeader("🧪 ТЕСТ 1: int16 IQ capture source (mmap + pinned ring + device conversion)");
+
+    try {
+        auto& engine = OpenCLComputeEngine::GetInstance();
+        using cf = std::complex<float>;
+
+        const size_t CHANNELS = 12;         // не кратно тайлу 16
+        const size_t SAMPLES = 1000;
+        const size_t FRAMES = 5;
+        const size_t HEADER = 64;
+        const size_t FRAME_VALUES = CHANNELS * SAMPLES;
+
+        // Тон на канал + постоянная составляющая АЦП
+        std::vector<cf> dc(CHANNELS);
+        std::vector<float> gain(CHANNELS);
+        for (size_t c = 0; c < CHANNELS; ++c) {
+            dc[c] = cf(100.0f + c, -50.0f);
+            gain[c] = 1.0f + 0.1f * c;
+        }
+        auto adc = [&](size_t frame, size_t c, size_t t, bool imag) {
+            const double phase = 2.0 * M_PI * (0.02 * (c + 1) * (frame * SAMPLES + t));
+            const double v = 8000.0 * (imag ? std::sin(phase) : std::cos(phase)) + (imag ? dc[c].imag() : dc[c].real());
+            return static_cast<int16_t>(std::lround(v));
+        };
+
+        // Сырой файл в порядке АЦП ([отсчёт][канал]) + заголовок + неполный хвост;
+        // тот же сигнал beam-major в контейнере MappedArrayFile
+        const auto dir = std::filesystem::temp_directory_path();
+        const std::string raw_path = (dir / "lch_test_capture.iq").string();
+        const std::string array_path = (dir / "lch_test_capture.bin").string();
+        std::vector<int16_t> sample_major(FRAMES * FRAME_VALUES * 2), beam_major(FRAMES * FRAME_VALUES * 2);
+        std::vector<std::vector<cf>> reference(FRAMES, std::vector<cf>(FRAME_VALUES));
+        for (size_t f = 0; f < FRAMES; ++f) {
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                for (size_t t = 0; t < SAMPLES; ++t) {
+                    const int16_t re = adc(f, c, t, false), im = adc(f, c, t, true);
+                    const size_t s = f * FRAME_VALUES + t * CHANNELS + c;
+                    const size_t b = f * FRAME_VALUES + c * SAMPLES + t;
+                    sample_major[2 * s] = re;
+                    sample_major[2 * s + 1] = im;
+                    beam_major[2 * b] = re;
+                    beam_major[2 * b + 1] = im;
+                    reference[f][c * SAMPLES + t] = (cf(re, im) - dc[c]) * (gain[c] / 32768.0f);
+                }
+            }
+        }
+        {
+            std::ofstream out(raw_path, std::ios::binary | std::ios::trunc);
+            const std::vector<char> header(HEADER, 'H');
+            out.write(header.data(), HEADER);
+            out.write(reinterpret_cast<const char*>(sample_major.data()),
+                      static_cast<std::streamsize>(sample_major.size() * sizeof(int16_t)));
+            out.write(header.data(), HEADER);
+        }
+        MappedArrayFile::Write(array_path, ArrayDType::ComplexInt16,
+                                              {FRAMES, CHANNELS, SAMPLES}, beam_major.data(), "beam-major capture");
+
+        auto frame_error = [](const std::vector<cf>& a, const std::vector<cf>& b) {
+            float err = 0.0f;
+            for (size_t i = 0; i < a.size(); ++i) err = std::max(err, std::abs(a[i] - b[i]));
+            return err;
+        };
+
+        antenna_fft::IQFrameSourceConfig config;
+        config.channel_count = CHANNELS;
+        config.samples_per_frame = SAMPLES;
+        config.header_bytes = HEADER;
+        config.dc_offset = dc;
+        config.gain = gain;
+        auto output = engine.CreateBuffer(FRAME_VALUES, MemoryType::GPU_READ_WRITE);
+
+        // ─── 1. SAMPLE_MAJOR сырой файл: все кадры, конец записи ───
+        float worst = 0.0f;
+        size_t frames_read = 0;
+        {
+            antenna_fft::IQFrameSource source(raw_path, config);
+            while (source.NextFrame(output->Get())) {
+                worst = std::max(worst, frame_error(output->ReadFromGPU(), reference[frames_read]));
+                ++frames_read;
+            }
+            const auto& stats = source.GetStats();
+            printf("  raw SAMPLE_MAJOR: %zu/%zu frames, max error %.3g\n", frames_read, source.GetFrameCount(), worst);
+            printf("      host copy %.3f ms, upload %.3f ms (%llu bytes int16), convert %.3f ms, wait %.3f ms\n",
+                   stats.host_copy_ms, stats.upload_ms, static_cast<unsigned long long>(stats.bytes_uploaded),
+                   stats.convert_ms, stats.wait_ms);
+            if (frames_read != FRAMES || source.GetFrameCount() != FRAMES || !(worst < 1e-6f) ||
+                stats.bytes_uploaded != FRAMES * config.GetFrameBytes()) {
+                throw std::runtime_error("raw capture mismatch");
+            }
+
+            // ─── 2. Seek назад и новая коррекция каналов ───
+            source.Seek(2);
+            source.NextFrame(output->Get());
+            const float seek_error = frame_error(output->ReadFromGPU(), reference[2]);
+            source.SetChannelCorrection({}, {});
+            source.NextFrame(output->Get());
+            auto uncorrected = output->ReadFromGPU();
+            bool uncorrected_ok = true;
+            for (size_t c = 0; c < CHANNELS && uncorrected_ok; ++c) {
+                const cf raw(adc(3, c, 0, false), adc(3, c, 0, true));
+                uncorrected_ok = std::abs(uncorrected[c * SAMPLES] - raw / 32768.0f) < 1e-6f;
+            }
+            printf("  seek to frame 2: error %.3g, correction reset %s\n", seek_error, uncorrected_ok ? "✅" : "❌");
+            if (!(seek_error < 1e-6f) || !uncorrected_ok) {
+                throw std::runtime_error("seek / channel correction mismatch");
+            }
+        }
+
+        // ─── 3. BEAM_MAJOR контейнер, кольцо из одного слота ───
+        config.layout = antenna_fft::InputLayout::BEAM_MAJOR;
+        config.header_bytes = 0;
+        config.ring_size = 1;
+        antenna_fft::IQFrameSource array_source(array_path, config);
+        worst = 0.0f;
+        frames_read = 0;
+        while (array_source.NextFrame(output->Get())) {
+            worst = std::max(worst, frame_error(output->ReadFromGPU(), reference[frames_read]));
+            ++frames_read;
+        }
+        printf("  container BEAM_MAJOR: %zu frames, max error %.3g\n", frames_read, worst);
+        if (frames_read != FRAMES || !(worst < 1e-6f)) {
+            throw std::runtime_error("container capture mismatch");
+        }
+
+        // ─── 4. Кадр источника → AntennaFFTProcMax против Process(хостовый эталон) ───
+        antenna_fft::AntennaFFTParams params(CHANNELS, SAMPLES, 512, 3, "test_iq_frame_source", "test_module");
+        antenna_fft::AntennaFFTProcMax processor(params);
+        array_source.Seek(0);
+        array_source.NextFrame();
+        auto from_capture = processor.Process(array_source.GetFrameBuffer());
+        auto expected = processor.Process(reference[0]);
+        bool peaks_ok = from_capture.results.size() == CHANNELS;
+        for (size_t c = 0; c < CHANNELS && peaks_ok; ++c) {
+            const auto& a = from_capture.results[c].max_values;
+            const auto& b = expected.results[c].max_values;
+            peaks_ok = !a.empty() && a.size() == b.size() && a[0].index_point == b[0].index_point;
+        }
+        printf("  AntennaFFTProcMax on capture frame vs host frame: %s\n", peaks_ok ? "✅" : "❌");
+
+        std::filesystem::remove(raw_path);
+        std::filesystem::remove(array_path);
+        if (!peaks_ok) {
+            throw std::runtime_error("processing of capture frame mismatch");
+        }
+
+        PrintResult(true, "IQ Frame Source Test");
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "IQ Frame Source Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 IQFrameSource TEST SUITE");
+
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+
+        int passed = 0;
+        int total = 1;
+
+        if (TestIQFrameSource()) passed++;
+
+        PrintHeader("📊 РЕЗУЛЬТАТЫ");
+        std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+        return (passed == total) ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ FATAL ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
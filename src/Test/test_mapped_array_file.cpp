@@ -0,0 +1,261 @@
+/**
+ * @file test_mapped_array_file.cpp
+ * @brief Тесты бинарного контейнера массивов MappedArrayFile (mmap) против CSV/JSON загрузчиков
+ *
+ * Тестовые сценарии:
+ * 1. CSV → .bin: те же значения, payload выровнен на 64; загрузка на устройство из mmap (если есть OpenCL)
+ * 2. Таблица Лагранжа: JSON → .bin → Load без потерь
+ * 3. Обрезанный файл, чужой dtype и поля заголовка, переполняющие size/extent, отклоняются
+ *
+ * OpenCL устройство не требуется: без него проверка загрузки на устройство пропускается.
+ * Данные читаются из Matrix/data и lagrange_matrix.json — запускать из корня репозитория.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/mapped_array_file.hpp"
+#include "ManagerOpenCL/matrix_csv.hpp"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "GPU/fractional_delay_processor.hpp"
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// ============================================================================
+// ТЕСТ 1: CSV → .bin
+// ============================================================================
+
+bool TestMatrixRoundTrip(bool has_device) {
+    PrintHeader("🧪 ТЕСТ 1: Binary array container (mmap) vs CSV loader");
+
+    const std::string matrix_bin = TempPath("lch_test_R_341.bin");
+    try {
+        using clock = std::chrono::high_resolution_clock;
+        auto ms_since = [](clock::time_point t0) {
+            return std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+        };
+
+        auto t0 = clock::now();
+        size_t n = 0;
+        auto csv = ReadComplexMatrixCSV("Matrix/data/R_341.csv", &n);
+        const double csv_ms = ms_since(t0);
+        MappedArrayFile::ConvertMatrixCSV("Matrix/data/R_341.csv", matrix_bin);
+
+        t0 = clock::now();
+        MappedArrayFile file(matrix_bin);
+        const double mmap_ms = ms_since(t0);
+
+        const bool shape_ok = file.GetShape() == std::vector<size_t>{n, n} && file.IsContiguous() &&
+                              reinterpret_cast<uintptr_t>(file.GetData()) % 64 == 0;
+        const bool data_ok = std::memcmp(file.GetData(), csv.data(), csv.size() * sizeof(csv[0])) == 0;
+        printf("  R_341: %zu x %zu %s, CSV parse %.2f ms, mmap %.2f ms\n",
+               n, n, ArrayDTypeName(file.GetDType()), csv_ms, mmap_ms);
+        printf("  shape/alignment %s, data %s\n", shape_ok ? "✅" : "❌", data_ok ? "✅" : "❌");
+
+        // Загрузка на устройство прямо из отображения
+        bool upload_ok = true;
+        if (has_device) {
+            t0 = clock::now();
+            auto buffer = OpenCLComputeEngine::GetInstance().CreateBufferWithData(
+                file.Data<std::complex<float>>(), file.GetNumElements());
+            const double upload_ms = ms_since(t0);
+            upload_ok = buffer->ReadFromGPU() == csv;
+            printf("  device copy from mmap %s (%.2f ms)\n", upload_ok ? "✅" : "❌", upload_ms);
+        } else {
+            std::cout << "  OpenCL device not available, device copy skipped\n";
+        }
+
+        std::filesystem::remove(matrix_bin);
+        bool success = shape_ok && data_ok && upload_ok;
+        PrintResult(success, "Matrix Container Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove(matrix_bin);
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Matrix Container Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 2: Таблица Лагранжа JSON → .bin
+// ============================================================================
+
+bool TestLagrangeRoundTrip() {
+    PrintHeader("🧪 ТЕСТ 2: Lagrange table JSON -> bin -> Load");
+
+    const std::string lagrange_bin = TempPath("lch_test_lagrange.bin");
+    try {
+        auto lagrange = radar::LagrangeMatrix::LoadFromJSON("lagrange_matrix.json");
+        lagrange.SaveBinary(lagrange_bin);
+        auto reloaded = radar::LagrangeMatrix::Load(lagrange_bin);
+        std::filesystem::remove(lagrange_bin);
+
+        const bool success = reloaded.coefficients == lagrange.coefficients;
+        printf("  Lagrange %ux%u JSON -> bin: %s\n", radar::LAGRANGE_ROWS, radar::LAGRANGE_COLS,
+               success ? "✅" : "❌");
+        PrintResult(success, "Lagrange Container Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove(lagrange_bin);
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Lagrange Container Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 3: Повреждённые файлы отклоняются
+// ============================================================================
+
+bool TestRejectsInvalid() {
+    PrintHeader("🧪 ТЕСТ 3: Truncated file, dtype mismatch and overflowing header fields");
+
+    const std::string matrix_bin = TempPath("lch_test_valid.bin");
+    const std::string truncated_bin = TempPath("lch_test_truncated.bin");
+    try {
+        MappedArrayFile::ConvertMatrixCSV("Matrix/data/R_341.csv", matrix_bin);
+
+        // ─── 1. Обрезанный файл и чужой dtype ───
+        {
+            std::ifstream in(matrix_bin, std::ios::binary);
+            std::vector<char> head(4096);
+            in.read(head.data(), static_cast<std::streamsize>(head.size()));
+            std::ofstream out(truncated_bin, std::ios::binary | std::ios::trunc);
+            out.write(head.data(), static_cast<std::streamsize>(head.size()));
+        }
+        bool truncated_rejected = false;
+        try {
+            MappedArrayFile truncated(truncated_bin);
+        } catch (const std::runtime_error&) {
+            truncated_rejected = true;
+        }
+        bool dtype_rejected = false;
+        try {
+            MappedArrayFile file(matrix_bin);
+            file.Data<float>();
+        } catch (const std::runtime_error&) {
+            dtype_rejected = true;
+        }
+        printf("  truncated file rejected %s, dtype mismatch rejected %s\n",
+               truncated_rejected ? "✅" : "❌", dtype_rejected ? "✅" : "❌");
+
+        // ─── 2. Поля заголовка, переполняющие size/extent ───
+        auto rejects_patched = [&](const std::function<void(BinaryArrayHeader&)>& patch) {
+            MappedArrayFile::Write(truncated_bin, {4, 4}, std::vector<float>(16, 1.0f));
+            BinaryArrayHeader header;
+            {
+                std::ifstream in(truncated_bin, std::ios::binary);
+                in.read(reinterpret_cast<char*>(&header), sizeof(header));
+            }
+            patch(header);
+            {
+                std::fstream io(truncated_bin, std::ios::binary | std::ios::in | std::ios::out);
+                io.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            }
+            try {
+                MappedArrayFile patched(truncated_bin);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        const bool description_rejected = rejects_patched([](BinaryArrayHeader& h) {
+            h.description_bytes = UINT64_MAX - 64;
+        });
+        const bool stride_rejected = rejects_patched([](BinaryArrayHeader& h) {
+            h.strides[0] = UINT64_MAX / 2 - (UINT64_MAX / 2) % 4;   // (shape-1)·stride переполняет
+        });
+        const bool shape_rejected = rejects_patched([](BinaryArrayHeader& h) {
+            h.shape[0] = UINT64_MAX / 2;
+            h.shape[1] = 4;
+        });
+        printf("  overflowing description %s, stride %s, shape %s rejected\n",
+               description_rejected ? "✅" : "❌", stride_rejected ? "✅" : "❌", shape_rejected ? "✅" : "❌");
+
+        std::filesystem::remove(matrix_bin);
+        std::filesystem::remove(truncated_bin);
+        bool success = truncated_rejected && dtype_rejected && description_rejected &&
+                       stride_rejected && shape_rejected;
+        PrintResult(success, "Invalid Container Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove(matrix_bin);
+        std::filesystem::remove(truncated_bin);
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Invalid Container Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 MappedArrayFile TEST SUITE");
+
+    // Устройство нужно только для проверки загрузки из mmap
+    bool has_device = false;
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+        has_device = true;
+    } catch (const std::exception& e) {
+        std::cout << "  OpenCL недоступен (" << e.what() << "), тесты только на CPU\n";
+    }
+
+    int passed = 0;
+    int total = 3;
+
+    if (TestMatrixRoundTrip(has_device)) passed++;
+    if (TestLagrangeRoundTrip())         passed++;
+    if (TestRejectsInvalid())            passed++;
+
+    PrintHeader("📊 РЕЗУЛЬТАТЫ");
+    std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+    return (passed == total) ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_multi_device_processor.cpp
+ * @brief Тесты MultiDeviceGenerator / MultiDeviceAntennaFFT против одного устройства
+ *
+ * Тестовые сценарии:
+ * 1. GeneratorGPU на DeviceContext (без OpenCLComputeEngine) == GeneratorGPU на engine
+ * 2. MultiDeviceGenerator на группе из одного устройства == GeneratorGPU на engine
+ * 3. MultiDeviceAntennaFFT на группе из одного устройства == AntennaFFTProcMax на engine
+ *
+ * Группа из одного устройства проверяет путь DeviceContext (свой контекст,
+ * очередь, программа) без зависимости от числа устройств на машине.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "GPU/multi_device_processor.hpp"
+#include "GPU/generator_gpu_new.h"
+#include "GPU/antenna_fft_proc_max.h"
+#include "interface/lfm_parameters.h"
+#include "ManagerOpenCL/opencl_compute_engine.hpp"
+#include "ManagerOpenCL/command_queue_pool.hpp"
+#include "ManagerOpenCL/device_group.hpp"
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+LFMParameters MakeParams() {
+    LFMParameters params;
+    params.f_start = 100.0f;
+    params.f_stop = 500.0f;
+    params.sample_rate = 12.0e6f;
+    params.num_beams = 6;
+    params.count_points = 2048;
+    params.angle_step_deg = 0.5f;
+    return params;
+}
+
+std::vector<std::complex<float>> ReadSignal(cl_mem buffer, cl_command_queue queue, size_t count) {
+    std::vector<std::complex<float>> host(count);
+    cl_int err = clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0, count * sizeof(std::complex<float>),
+                                     host.data(), 0, nullptr, nullptr);
+    if (err != CL_SUCCESS) {
+        throw std::runtime_error("clEnqueueReadBuffer failed: " + std::to_string(err));
+    }
+    return host;
+}
+
+/// Эталон: GeneratorGPU на OpenCLComputeEngine
+std::vector<std::complex<float>> EngineSignal(const LFMParameters& params) {
+    radar::GeneratorGPU generator(params);
+    cl_mem signal = generator.signal_base();
+    CommandQueuePool::FinishAll();
+    return ReadSignal(signal, CommandQueuePool::GetNextQueue(), params.num_beams * params.count_points);
+}
+
+float MaxError(const std::vector<std::complex<float>>& a, const std::vector<std::complex<float>>& b) {
+    if (a.size() != b.size()) return INFINITY;
+    float err = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) err = std::max(err, std::abs(a[i] - b[i]));
+    return err;
+}
+
+// ============================================================================
+// ТЕСТ 1: GeneratorGPU на DeviceContext
+// ============================================================================
+
+bool TestGeneratorDeviceContext(const DeviceGroup& group) {
+    PrintHeader("🧪 ТЕСТ 1: GeneratorGPU(params, DeviceContext)");
+
+    try {
+        const auto params = MakeParams();
+        const auto expected = EngineSignal(params);
+
+        const DeviceContext& device = group.Get(0);
+        radar::GeneratorGPU generator(params, device);
+        cl_mem signal = generator.signal_base();
+        const auto actual = ReadSignal(signal, device.queue, params.num_beams * params.count_points);
+
+        const float err = MaxError(expected, actual);
+        std::cout << "  max |DeviceContext - engine| = " << err << "\n";
+
+        bool success = err < 1e-5f;
+        PrintResult(success, "Generator DeviceContext Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Generator DeviceContext Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 2: MultiDeviceGenerator на одном устройстве
+// ============================================================================
+
+bool TestMultiDeviceGenerator(DeviceGroup& group) {
+    PrintHeader("🧪 ТЕСТ 2: MultiDeviceGenerator (одно устройство)");
+
+    try {
+        const auto params = MakeParams();
+        const auto expected = EngineSignal(params);
+
+        radar::MultiDeviceGenerator generator(params, group);
+        const auto actual = generator.SignalBase();
+        const auto& ranges = generator.GetLastPartition();
+
+        const float err = MaxError(expected, actual);
+        std::cout << "  лучей на устройстве 0: " << ranges.at(0).count
+                  << ", max |multi - engine| = " << err << "\n";
+
+        bool success = ranges.size() == 1 && ranges[0].count == params.num_beams && err < 1e-5f;
+        PrintResult(success, "Multi-Device Generator Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Multi-Device Generator Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 3: MultiDeviceAntennaFFT на одном устройстве
+// ============================================================================
+
+bool TestMultiDeviceAntennaFFT(DeviceGroup& group) {
+    PrintHeader("🧪 ТЕСТ 3: MultiDeviceAntennaFFT (одно устройство)");
+
+    try {
+        const auto lfm = MakeParams();
+        const auto input = EngineSignal(lfm);
+        antenna_fft::AntennaFFTParams params(lfm.num_beams, lfm.count_points, 512, 3,
+                                             "test_multi_device", "test_module");
+
+        antenna_fft::AntennaFFTProcMax single(params);
+        const auto expected = single.Process(input);
+
+        antenna_fft::MultiDeviceAntennaFFT multi(params, group);
+        const auto actual = multi.Process(input);
+
+        bool peaks_ok = actual.results.size() == expected.results.size() &&
+                        expected.results.size() == params.beam_count;
+        for (size_t b = 0; b < expected.results.size() && peaks_ok; ++b) {
+            const auto& e = expected.results[b].max_values;
+            const auto& a = actual.results[b].max_values;
+            peaks_ok = !e.empty() && e.size() == a.size();
+            for (size_t k = 0; k < e.size() && peaks_ok; ++k) {
+                peaks_ok = e[k].index_point == a[k].index_point &&
+                           std::abs(e[k].amplitude - a[k].amplitude) <= 1e-4f * std::max(1.0f, e[k].amplitude);
+            }
+            std::cout << "  Луч " << b << ": пик " << (e.empty() ? 0 : e[0].index_point)
+                      << " / " << (a.empty() ? 0 : a[0].index_point) << "\n";
+        }
+
+        PrintResult(peaks_ok, "Multi-Device AntennaFFT Test");
+        return peaks_ok;
+
+    } catch (const std::exception& e) {
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Multi-Device AntennaFFT Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 Multi-Device Processor TEST SUITE");
+
+    try {
+        OpenCLComputeEngine::Initialize(DeviceType::GPU);
+
+        // Одно устройство того же типа, что и engine: свой контекст и очередь
+        auto group = DeviceGroup::FromAllDevices(DeviceType::GPU, 1);
+        std::cout << group.ToString();
+
+        int passed = 0;
+        int total = 3;
+
+        if (TestGeneratorDeviceContext(group)) passed++;
+        if (TestMultiDeviceGenerator(group))   passed++;
+        if (TestMultiDeviceAntennaFFT(group))  passed++;
+
+        PrintHeader("📊 РЕЗУЛЬТАТЫ");
+        std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+        return (passed == total) ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ FATAL ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
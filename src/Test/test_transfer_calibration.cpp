@@ -0,0 +1,297 @@
+/**
+ * @file test_transfer_calibration.cpp
+ * @brief Тесты модели передач TransferCalibration на синтетических измерениях
+ *
+ * Тестовые сценарии:
+ * 1. FitModel: линейные времена t = latency + size / bandwidth восстанавливаются точно,
+ *    одна точка — без латентности, нет измерений — оценка 0
+ * 2. SelectStrategy: порог REGULAR / SVM_COARSE по размеру и сдвиг порога весами
+ *    frequent_host_write/read
+ * 3. Кэш: LoadFromFile → SaveToFile → LoadFromFile без потерь, чужой device_key и
+ *    повреждённый файл отклоняются
+ *
+ * OpenCL устройство не требуется: измерения задаются файлом кэша.
+ *
+ * @author LCH-Farrow01 Project
+ * @date 2026-10-16
+ */
+
+#include "ManagerOpenCL/transfer_calibration.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ManagerOpenCL;
+
+namespace {
+
+// ============================================================================
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ============================================================================
+
+void PrintHeader(const std::string& text) {
+    std::cout << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+    std::cout << "  " << text << "\n";
+    std::cout << "════════════════════════════════════════════════════════════════\n";
+}
+
+void PrintResult(bool success, const std::string& test_name) {
+    if (success) {
+        std::cout << "  ✅ " << test_name << " PASSED\n";
+    } else {
+        std::cout << "  ❌ " << test_name << " FAILED\n";
+    }
+}
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+const char* kDeviceKey = "synthetic_device_1.0";
+const std::vector<size_t> kSizes = {4 * 1024, 256 * 1024, 4 * 1024 * 1024, 32 * 1024 * 1024};
+
+/// Линейная модель одной операции: t = latency_ms + size / bytes_per_ms
+struct Line {
+    double latency_ms;
+    double bytes_per_ms;
+    double At(size_t size) const { return latency_ms + size / bytes_per_ms; }
+};
+
+/// Профиль стратегии: write/read/kernel
+struct Profile {
+    MemoryStrategy strategy;
+    Line write, read, kernel;
+};
+
+// REGULAR: короткая латентность, 10 GB/s по PCIe, ядро 100 GB/s.
+// SVM_COARSE: Map/Unmap дороже (0.2 мс), зато 20 GB/s, ядро 50 GB/s.
+// Равенство стоимостей при весе передач w: s = 0.36·w / (w·1e-7 - 1e-8):
+// w = 1 → 4.0 МБ, w = 4 → 3.69 МБ.
+const Profile kRegular = {MemoryStrategy::REGULAR_BUFFER, {0.02, 1e7}, {0.02, 1e7}, {0.005, 1e8}};
+const Profile kCoarse  = {MemoryStrategy::SVM_COARSE_GRAIN, {0.2, 2e7}, {0.2, 2e7}, {0.005, 5e7}};
+
+/// Файл кэша в формате TransferCalibration::SaveToFile
+void WriteCache(const std::string& path, const std::string& device_key,
+                const std::vector<Profile>& profiles, const std::vector<size_t>& sizes) {
+    std::ofstream out(path);
+    out << "# lch transfer calibration v2\n";
+    out << "device=" << device_key << "\n";
+    out << "strategy,size_bytes,write_ms,read_ms,kernel_ms\n";
+    out << std::setprecision(9);
+    for (const auto& p : profiles) {
+        for (size_t size : sizes) {
+            out << MemoryStrategyToString(p.strategy) << ',' << size << ',' << p.write.At(size) << ','
+                << p.read.At(size) << ',' << p.kernel.At(size) << "\n";
+        }
+    }
+}
+
+bool Near(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+// ============================================================================
+// ТЕСТ 1: FitModel на синтетических временах
+// ============================================================================
+
+bool TestFitModel() {
+    PrintHeader("🧪 ТЕСТ 1: FitModel on synthetic linear timings");
+
+    const std::string path = TempPath("lch_test_calib_fit.csv");
+    try {
+        WriteCache(path, kDeviceKey, {kRegular, kCoarse}, kSizes);
+        TransferCalibration calib;
+        if (!calib.LoadFromFile(path, kDeviceKey)) {
+            throw std::runtime_error("synthetic cache not loaded");
+        }
+
+        // Оценка вне измеренных точек совпадает с исходной прямой
+        bool fit_ok = true;
+        for (const Profile& p : {kRegular, kCoarse}) {
+            for (size_t size : {size_t(1000), size_t(1) << 20, size_t(100) << 20}) {
+                const double w = calib.Estimate(p.strategy, TransferCalibration::Op::WRITE, size);
+                const double r = calib.Estimate(p.strategy, TransferCalibration::Op::READ, size);
+                const double k = calib.Estimate(p.strategy, TransferCalibration::Op::KERNEL, size);
+                fit_ok = fit_ok && Near(w, p.write.At(size)) && Near(r, p.read.At(size)) &&
+                         Near(k, p.kernel.At(size));
+            }
+        }
+        printf("  REGULAR write 1 MB: %.4f ms (expected %.4f)\n",
+               calib.Estimate(MemoryStrategy::REGULAR_BUFFER, TransferCalibration::Op::WRITE, 1 << 20),
+               kRegular.write.At(1 << 20));
+        printf("  linear fit %s\n", fit_ok ? "✅" : "❌");
+
+        // Одна точка: bandwidth = size / t, латентность 0
+        WriteCache(path, kDeviceKey, {kRegular}, {kSizes.back()});
+        TransferCalibration single;
+        single.LoadFromFile(path, kDeviceKey);
+        const double t_one = kRegular.write.At(kSizes.back());
+        const bool single_ok = Near(single.Estimate(MemoryStrategy::REGULAR_BUFFER,
+                                                    TransferCalibration::Op::WRITE, kSizes.back() / 2),
+                                    t_one / 2);
+        // Стратегия без измерений — оценка 0
+        const bool missing_ok = single.Estimate(MemoryStrategy::SVM_FINE_GRAIN,
+                                                TransferCalibration::Op::WRITE, kSizes.back()) == 0.0 &&
+                                single.GetStrategies().size() == 1;
+        printf("  single point %s, missing strategy %s\n", single_ok ? "✅" : "❌", missing_ok ? "✅" : "❌");
+
+        std::filesystem::remove(path);
+        bool success = fit_ok && single_ok && missing_ok;
+        PrintResult(success, "FitModel Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove(path);
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "FitModel Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 2: Пороги SelectStrategy
+// ============================================================================
+
+bool TestSelectStrategy() {
+    PrintHeader("🧪 ТЕСТ 2: SelectStrategy thresholds and transfer weights");
+
+    const std::string path = TempPath("lch_test_calib_select.csv");
+    try {
+        WriteCache(path, kDeviceKey, {kRegular, kCoarse}, kSizes);
+        TransferCalibration calib;
+        if (!calib.LoadFromFile(path, kDeviceKey)) {
+            throw std::runtime_error("synthetic cache not loaded");
+        }
+        std::filesystem::remove(path);
+
+        const BufferUsageHint plain = BufferUsageHint::Default();
+        const BufferUsageHint frequent = BufferUsageHint::FrequentTransfer();
+        struct Case {
+            size_t size;
+            const BufferUsageHint& hint;
+            MemoryStrategy expected;
+            const char* name;
+        };
+        const Case cases[] = {
+            {1 << 20,          plain,    MemoryStrategy::REGULAR_BUFFER,   "1 MB default"},
+            {3800 * 1000,      plain,    MemoryStrategy::REGULAR_BUFFER,   "3.8 MB default (below 4.0 MB)"},
+            {3800 * 1000,      frequent, MemoryStrategy::SVM_COARSE_GRAIN, "3.8 MB frequent (above 3.69 MB)"},
+            {16 << 20,         plain,    MemoryStrategy::SVM_COARSE_GRAIN, "16 MB default"},
+            {64 * 1024,        frequent, MemoryStrategy::REGULAR_BUFFER,   "64 KB frequent"},
+        };
+
+        bool success = true;
+        for (const Case& c : cases) {
+            const MemoryStrategy got = calib.SelectStrategy(c.size, c.hint);
+            const bool ok = got == c.expected;
+            success = success && ok;
+            printf("  %-34s -> %-18s %s\n", c.name, MemoryStrategyToString(got).c_str(), ok ? "✅" : "❌");
+        }
+
+        // Без измерений — REGULAR
+        const bool empty_ok = TransferCalibration().SelectStrategy(16 << 20, plain) ==
+                              MemoryStrategy::REGULAR_BUFFER;
+        printf("  empty calibration -> REGULAR %s\n", empty_ok ? "✅" : "❌");
+
+        success = success && empty_ok;
+        PrintResult(success, "SelectStrategy Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove(path);
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "SelectStrategy Test");
+        return false;
+    }
+}
+
+// ============================================================================
+// ТЕСТ 3: Кэш save/load
+// ============================================================================
+
+bool TestCacheRoundTrip() {
+    PrintHeader("🧪 ТЕСТ 3: Cache save/load round trip");
+
+    const std::string source = TempPath("lch_test_calib_source.csv");
+    const std::string saved = (std::filesystem::path(TempPath("lch_test_calib_dir")) / "saved.csv").string();
+    auto cleanup = [&] {
+        std::filesystem::remove(source);
+        std::filesystem::remove_all(TempPath("lch_test_calib_dir"));
+    };
+    try {
+        WriteCache(source, kDeviceKey, {kRegular, kCoarse}, kSizes);
+        TransferCalibration original;
+        if (!original.LoadFromFile(source, kDeviceKey)) {
+            throw std::runtime_error("synthetic cache not loaded");
+        }
+
+        // SaveToFile создаёт каталог
+        original.SaveToFile(saved);
+        TransferCalibration reloaded;
+        const bool loaded = reloaded.LoadFromFile(saved, kDeviceKey);
+
+        bool same = loaded && reloaded.GetSamples().size() == original.GetSamples().size() &&
+                    reloaded.GetDeviceKey() == kDeviceKey && reloaded.IsFromCache();
+        for (size_t i = 0; same && i < original.GetSamples().size(); ++i) {
+            const TransferSample& a = original.GetSamples()[i];
+            const TransferSample& b = reloaded.GetSamples()[i];
+            same = a.strategy == b.strategy && a.size_bytes == b.size_bytes && a.write_ms == b.write_ms &&
+                   a.read_ms == b.read_ms && a.kernel_ms == b.kernel_ms;
+        }
+        printf("  %zu samples saved and reloaded %s\n", original.GetSamples().size(), same ? "✅" : "❌");
+
+        // Чужое устройство, повреждённая строка, нет файла
+        TransferCalibration other;
+        const bool key_rejected = !other.LoadFromFile(saved, "other_device") && !other.IsValid();
+        {
+            std::ofstream out(saved, std::ios::app);
+            out << "SVM_UNKNOWN,4096,1,1,1\n";
+        }
+        const bool corrupt_rejected = !other.LoadFromFile(saved, kDeviceKey);
+        const bool missing_rejected = !other.LoadFromFile(TempPath("lch_test_calib_missing.csv"), kDeviceKey);
+        printf("  foreign key %s, corrupt line %s, missing file %s rejected\n",
+               key_rejected ? "✅" : "❌", corrupt_rejected ? "✅" : "❌", missing_rejected ? "✅" : "❌");
+
+        cleanup();
+        bool success = same && key_rejected && corrupt_rejected && missing_rejected;
+        PrintResult(success, "Cache Round Trip Test");
+        return success;
+
+    } catch (const std::exception& e) {
+        cleanup();
+        std::cerr << "  Exception: " << e.what() << "\n";
+        PrintResult(false, "Cache Round Trip Test");
+        return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    PrintHeader("🚀 TransferCalibration TEST SUITE");
+
+    int passed = 0;
+    int total = 3;
+
+    if (TestFitModel())       passed++;
+    if (TestSelectStrategy()) passed++;
+    if (TestCacheRoundTrip()) passed++;
+
+    PrintHeader("📊 РЕЗУЛЬТАТЫ");
+    std::cout << "\n  Пройдено: " << passed << " / " << total << "\n\n";
+
+    return (passed == total) ? 0 : 1;
+}